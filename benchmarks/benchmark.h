@@ -0,0 +1,189 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_BENCHMARK_H
+#define EDDL_BENCHMARK_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+// Peak resident set size of the process so far (kB)
+inline long peak_rss_kb(){
+#ifndef _WIN32
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+inline int bench_threads(){
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+struct BenchResult {
+    string name;  // family/case
+    string family;
+    string config;
+    int iterations;
+    double mean_ms;
+    double min_ms;
+    double gflops;  // 0 => not applicable
+    double throughput;
+    string throughput_unit;
+    long peak_rss_kb;  // process high-water mark after the benchmark
+};
+
+
+/*
+ * Minimal benchmark runner without external dependencies.
+ *
+ *   BenchSuite suite("micro", argc, argv);
+ *   if (suite.selected("mult2D/1024")) {
+ *       ... setup ...
+ *       suite.run("mult2D/1024", "mult2D", "1024x1024x1024", flops, items, "items/s", [&](){ ... });
+ *       ... teardown ...
+ *   }
+ *   return suite.finish();
+ *
+ * Options: --filter <substring>  --min-time <seconds>  --warmup <iterations>  --out <file.json>
+ */
+class BenchSuite {
+public:
+    string suite;
+    string filter;
+    string out;
+    double min_time;
+    int warmup;
+    vector<BenchResult> results;
+
+    BenchSuite(const string &suite, int argc, char **argv){
+        this->suite = suite;
+        this->min_time = 0.5;
+        this->warmup = 1;
+
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (arg == "--filter" && has_value) filter = argv[++i];
+            else if (arg == "--min-time" && has_value) min_time = atof(argv[++i]);
+            else if (arg == "--warmup" && has_value) warmup = atoi(argv[++i]);
+            else if (arg == "--out" && has_value) out = argv[++i];
+            else {
+                fprintf(stderr, "Usage: %s [--filter <substring>] [--min-time <seconds>] [--warmup <iterations>] [--out <file.json>]\n", argv[0]);
+                exit(1);
+            }
+        }
+    }
+
+    bool selected(const string &name){
+        return filter.empty() || name.find(filter) != string::npos;
+    }
+
+    // flops and items are per call of fn
+    void run(const string &name, const string &family, const string &config, double flops,
+             double items, const string &unit, const function<void()> &fn){
+        if (!selected(name)) return;
+
+        for (int i = 0; i < warmup; i++) fn();
+
+        int iterations = 0;
+        double total = 0.0, best = 1e30;
+        while (total < min_time * 1000.0 || iterations < 3) {
+            auto t1 = chrono::high_resolution_clock::now();
+            fn();
+            auto t2 = chrono::high_resolution_clock::now();
+            double ms = chrono::duration<double, milli>(t2 - t1).count();
+            total += ms;
+            best = std::min(best, ms);
+            iterations++;
+        }
+
+        record(name, family, config, iterations, total / iterations, best, flops, items, unit);
+    }
+
+    // For callers that time several phases of the same iteration themselves
+    void record(const string &name, const string &family, const string &config, int iterations,
+                double mean_ms, double min_ms, double flops, double items, const string &unit){
+        BenchResult r;
+        r.name = name;
+        r.family = family;
+        r.config = config;
+        r.iterations = iterations;
+        r.mean_ms = mean_ms;
+        r.min_ms = min_ms;
+        r.gflops = (flops > 0.0) ? flops / (r.mean_ms * 1e6) : 0.0;
+        r.throughput = items / (r.mean_ms / 1000.0);
+        r.throughput_unit = unit;
+        r.peak_rss_kb = peak_rss_kb();
+        results.push_back(r);
+
+        fprintf(stderr, "%-50s %10.4f ms %10.2f GFLOP/s %14.1f %s\n", name.c_str(), r.mean_ms, r.gflops, r.throughput, unit.c_str());
+    }
+
+    string json(){
+        string s;
+        char buf[1024];
+        snprintf(buf, sizeof(buf), "{\n  \"suite\": \"%s\",\n  \"eddl_version\": \"0.8\",\n  \"threads\": %d,\n  \"min_time_s\": %g,\n  \"peak_rss_kb\": %ld,\n  \"results\": [",
+                 suite.c_str(), bench_threads(), min_time, peak_rss_kb());
+        s += buf;
+        for (int i = 0; i < results.size(); i++) {
+            BenchResult &r = results[i];
+            snprintf(buf, sizeof(buf),
+                     "%s\n    {\"name\": \"%s\", \"family\": \"%s\", \"config\": \"%s\", \"iterations\": %d, "
+                     "\"mean_ms\": %.6f, \"min_ms\": %.6f, \"gflops\": %.4f, \"throughput\": %.4f, "
+                     "\"throughput_unit\": \"%s\", \"peak_rss_kb\": %ld}",
+                     (i ? "," : ""), r.name.c_str(), r.family.c_str(), r.config.c_str(), r.iterations,
+                     r.mean_ms, r.min_ms, r.gflops, r.throughput, r.throughput_unit.c_str(), r.peak_rss_kb);
+            s += buf;
+        }
+        s += "\n  ]\n}\n";
+        return s;
+    }
+
+    int finish(){
+        string s = json();
+        if (out.empty()) {
+            cout << s;
+        } else {
+            ofstream ofs(out);
+            if (!ofs.good()) {
+                fprintf(stderr, "Could not write %s\n", out.c_str());
+                return 1;
+            }
+            ofs << s;
+        }
+        return 0;
+    }
+};
+
+#endif //EDDL_BENCHMARK_H
@@ -0,0 +1,196 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "eddl/apis/eddl.h"
+#include "eddl/serialization/exchange/eddl_exchange.h"
+
+#include "../benchmark.h"
+
+using namespace eddl;
+
+//////////////////////////////////
+// exchange_benchmarks.cpp:
+// Gradient all-reduce between local workers
+// (threads) with the exchange messages, over
+// in-process queues or unix sockets
+//////////////////////////////////
+
+// Duplex link between the root (end 0) and a worker (end 1)
+class Link {
+public:
+    virtual ~Link() {}
+    virtual void send(int end, const char *buf, size_t n) = 0;
+    virtual size_t recv(int end, vector<char> &buf) = 0;
+};
+
+class InprocLink : public Link {
+    deque<vector<char>> queue[2];  // messages to each end
+    mutex mtx;
+    condition_variable cv;
+public:
+    void send(int end, const char *buf, size_t n) override {
+        {
+            lock_guard<mutex> lock(mtx);
+            queue[1 - end].emplace_back(buf, buf + n);
+        }
+        cv.notify_all();
+    }
+
+    size_t recv(int end, vector<char> &buf) override {
+        unique_lock<mutex> lock(mtx);
+        cv.wait(lock, [&] { return !queue[end].empty(); });
+        buf.swap(queue[end].front());
+        queue[end].pop_front();
+        return buf.size();
+    }
+};
+
+class UnixLink : public Link {
+    int fds[2];
+
+    static void io(int fd, char *buf, size_t n, bool writing) {
+        while (n > 0) {
+            ssize_t r = writing ? write(fd, buf, n) : read(fd, buf, n);
+            if (r <= 0) { perror("UnixLink"); exit(1); }
+            buf += r;
+            n -= r;
+        }
+    }
+public:
+    UnixLink() {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) { perror("socketpair"); exit(1); }
+    }
+    ~UnixLink() override { close(fds[0]); close(fds[1]); }
+
+    void send(int end, const char *buf, size_t n) override {
+        uint64_t len = n;
+        io(fds[end], (char *)&len, sizeof(len), true);
+        io(fds[end], (char *)buf, n, true);
+    }
+
+    size_t recv(int end, vector<char> &buf) override {
+        uint64_t len;
+        io(fds[end], (char *)&len, sizeof(len), false);
+        if (buf.size() < len) buf.resize(len);
+        io(fds[end], buf.data(), len, false);
+        return len;
+    }
+};
+
+model mlp() {
+    layer in = Input({784});
+    layer l = in;
+    l = ReLu(Dense(l, 1024));
+    l = ReLu(Dense(l, 1024));
+    l = ReLu(Dense(l, 1024));
+    layer out = Softmax(Dense(l, 10));
+    return Model({in}, {out});
+}
+
+model cnn() {
+    layer in = Input({3, 32, 32});
+    layer l = in;
+    for (int f : {64, 128, 256, 512}) {
+        l = ReLu(BatchNormalization(Conv(l, f, {3, 3})));
+        l = ReLu(BatchNormalization(Conv(l, f, {3, 3})));
+        l = MaxPool(l, {2, 2});
+    }
+    l = Reshape(l, {-1});
+    layer out = Softmax(Dense(l, 10));
+    return Model({in}, {out});
+}
+
+/*
+ * Star all-reduce of the gradients: every worker sends its message to the root (worker 0),
+ * that averages them into its own gradients and broadcasts the result with the same encoding.
+ */
+void bench_allreduce(BenchSuite &suite, const string &name, model (*arch)(), int workers, int encoding, float ratio, bool unix_sockets) {
+    string enc = (encoding == EXCHANGE_FP32) ? "fp32" : (encoding == EXCHANGE_FP16) ? "fp16" : "topk";
+    string full = "allreduce/" + name + "/" + enc + "/" + (unix_sockets ? "unix" : "inproc");
+    if (!suite.selected(full)) return;
+
+    vector<model> nets;
+    vector<ExchangeEncoder *> encoders;
+    vector<Link *> links;
+    for (int w = 0; w < workers; w++) {
+        model net = arch();
+        build(net, sgd(0.01f), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(), true);
+        for (auto g : exchange_tensors(net, EXCHANGE_GRADIENTS)) g->fill_rand_normal_(0.0f, 1.0f);
+        nets.push_back(net);
+        encoders.push_back(new ExchangeEncoder(net, EXCHANGE_GRADIENTS, encoding, ratio));
+        links.push_back((w == 0) ? nullptr : (unix_sockets ? (Link *)new UnixLink() : (Link *)new InprocLink()));
+    }
+    ExchangeEncoder bcast(nets[0], EXCHANGE_GRADIENTS, encoding, ratio);
+
+    vector<vector<char>> sendbuf(workers), recvbuf(workers);
+    vector<size_t> sent(workers, 0);
+    float scale = 1.0f / workers;
+
+    auto worker = [&](int w) {
+        sent[w] = encoders[w]->encode(sendbuf[w]);
+        links[w]->send(1, sendbuf[w].data(), sent[w]);
+        size_t n = links[w]->recv(1, recvbuf[w]);
+        decode_exchange(nets[w], recvbuf[w].data(), n, 1.0f, false);
+    };
+
+    auto allreduce = [&]() {
+        vector<thread> threads;
+        for (int w = 1; w < workers; w++) threads.emplace_back(worker, w);
+
+        sent[0] = encoders[0]->encode(sendbuf[0]);
+        decode_exchange(nets[0], sendbuf[0].data(), sent[0], scale, false);
+        for (int w = 1; w < workers; w++) {
+            size_t n = links[w]->recv(0, recvbuf[0]);
+            decode_exchange(nets[0], recvbuf[0].data(), n, scale, true);
+        }
+
+        size_t n = bcast.encode(sendbuf[0]);
+        for (int w = 1; w < workers; w++) links[w]->send(0, sendbuf[0].data(), n);
+        for (auto &t : threads) t.join();
+    };
+
+    double params = 0.0;
+    for (auto g : exchange_tensors(nets[0], EXCHANGE_GRADIENTS)) params += g->size;
+
+    allreduce();  // message sizes for the config
+    string config = "w" + to_string(workers) + "_" + to_string((long)(params * 4 / 1024)) + "KB_to_" + to_string((long)(sent[1] / 1024)) + "KB";
+    suite.run(full, "allreduce", config, 0.0, params, "params/s", allreduce);
+
+    for (int w = 0; w < workers; w++) {
+        delete encoders[w];
+        delete links[w];
+        delete nets[w];
+    }
+}
+
+
+int main(int argc, char **argv){
+    BenchSuite suite("exchange", argc, argv);
+
+    for (bool unix_sockets : {false, true}) {
+        for (int encoding : {EXCHANGE_FP32, EXCHANGE_FP16, EXCHANGE_TOPK}) {
+            bench_allreduce(suite, "mlp", mlp, 4, encoding, 0.01f, unix_sockets);
+            bench_allreduce(suite, "cnn", cnn, 4, encoding, 0.01f, unix_sockets);
+        }
+    }
+
+    return suite.finish();
+}
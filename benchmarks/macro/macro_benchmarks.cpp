@@ -0,0 +1,312 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "eddl/apis/eddl.h"
+#include "eddl/layers/conv/layer_conv.h"
+
+#include "../benchmark.h"
+
+using namespace eddl;
+
+//////////////////////////////////
+// macro_benchmarks.cpp:
+// Forward, backward and optimizer step of
+// full models on synthetic data (CPU)
+//////////////////////////////////
+
+layer VGGBlock(layer l, int filters, int nconv) {
+    for (int i = 0; i < nconv; i++)
+        l = ReLu(Conv(l, filters, {3, 3}));
+    return MaxPool(l, {2, 2});
+}
+
+layer ResBlock(layer l, int filters, int nconv, int half) {
+    layer in = l;
+
+    if (half)
+        l = ReLu(Conv(l, filters, {3, 3}, {2, 2}));
+    else
+        l = ReLu(Conv(l, filters, {3, 3}, {1, 1}));
+
+    for (int i = 0; i < nconv - 1; i++)
+        l = ReLu(Conv(l, filters, {3, 3}, {1, 1}));
+
+    if (half)
+        return Sum(Conv(in, filters, {1, 1}, {2, 2}), l);
+    else
+        return Sum(l, in);
+}
+
+model mlp() {
+    layer in = Input({784});
+    layer l = in;
+    l = ReLu(Dense(l, 1024));
+    l = ReLu(Dense(l, 1024));
+    l = ReLu(Dense(l, 1024));
+    layer out = Softmax(Dense(l, 10));
+    return Model({in}, {out});
+}
+
+model vgg16() {
+    layer in = Input({3, 32, 32});
+    layer l = in;
+    l = VGGBlock(l, 64, 2);
+    l = VGGBlock(l, 128, 2);
+    l = VGGBlock(l, 256, 3);
+    l = VGGBlock(l, 512, 3);
+    l = VGGBlock(l, 512, 3);
+    l = Reshape(l, {-1});
+    l = ReLu(Dense(l, 512));
+    layer out = Softmax(Dense(l, 10));
+    return Model({in}, {out});
+}
+
+model resnet18() {
+    layer in = Input({3, 32, 32});
+    layer l = in;
+    l = ReLu(Conv(l, 64, {3, 3}, {1, 1}));
+    l = ResBlock(l, 64, 2, 1);
+    l = ResBlock(l, 64, 2, 0);
+    l = ResBlock(l, 128, 2, 1);
+    l = ResBlock(l, 128, 2, 0);
+    l = ResBlock(l, 256, 2, 1);
+    l = ResBlock(l, 256, 2, 0);
+    l = ResBlock(l, 512, 2, 1);
+    l = ResBlock(l, 512, 2, 0);
+    l = Reshape(l, {-1});
+    layer out = Softmax(Dense(l, 10));
+    return Model({in}, {out});
+}
+
+// Every layer of a dense block sees the concatenation of all the previous ones
+layer DenseBlock(layer l, int layers, int growth) {
+    for (int i = 0; i < layers; i++) {
+        layer f = ReLu(BatchNormalization(l));
+        f = Conv(f, growth, {3, 3}, {1, 1});
+        l = Concat({l, f}, 1);
+    }
+    return l;
+}
+
+model densenet() {
+    layer in = Input({3, 32, 32});
+    layer l = Conv(in, 64, {3, 3}, {1, 1});
+    for (int b = 0; b < 3; b++) {
+        l = DenseBlock(l, 6, 32);
+        if (b < 2) l = AveragePool(Conv(ReLu(BatchNormalization(l)), 128, {1, 1}, {1, 1}), {2, 2});
+    }
+    l = Reshape(GlobalAveragePool(ReLu(BatchNormalization(l))), {-1});
+    layer out = Softmax(Dense(l, 10));
+    return Model({in}, {out});
+}
+
+model lstm(int features) {
+    layer in = Input({features});
+    layer l = LSTM(in, 128);
+    layer out = Sigmoid(Dense(l, 1));
+    return Model({in}, {out});
+}
+
+model gru(int features) {
+    layer in = Input({features});
+    layer l = GRU(in, 128);
+    layer out = Sigmoid(Dense(l, 1));
+    return Model({in}, {out});
+}
+
+// Same LSTM over the whole sequence at once
+model lstm_seq(int steps, int features, bool mask_zeros = false) {
+    layer in = Input({steps, features});
+    layer l = LSTMSequence(in, 128, 1, false, mask_zeros);
+    layer out = Sigmoid(Dense(l, 1));
+    return Model({in}, {out});
+}
+
+// Encoder-decoder as in the machine translation example
+model seq2seq(int invs, int outvs) {
+    layer in = Input({1});
+    layer enc = LSTM(Embedding(in, invs, 1, 64), 128);
+
+    layer ld = Input({outvs});
+    ld = Embedding(ReduceArgMax(ld, {0}), outvs, 1, 64);
+    layer l = Decoder(LSTM(ld, 128), enc);
+    layer out = Softmax(Dense(l, outvs));
+    return Model({in}, {out});
+}
+
+// Forward FLOPs: convolutions by output size, any other 2D param as a GEMM against the batch
+double forward_flops(model net, int batch, int steps) {
+    double flops = 0.0;
+    for (auto l : net->layers) {
+        auto *conv = dynamic_cast<LConv *>(l);
+        if (conv != nullptr) {
+            ConvolDescriptor *cd = conv->cd;
+            flops += 2.0 * batch * cd->r * cd->c * cd->nk * cd->kz * cd->kr * cd->kc;
+            continue;
+        }
+        double f = 0.0;
+        for (auto p : l->params)
+            if (p->ndim == 2) f += 2.0 * batch * p->size;
+        flops += (l->isrecurrent || dynamic_cast<LRecurrentSeq *>(l)) ? f * steps : f;
+    }
+    return flops;
+}
+
+void bench_model(BenchSuite &suite, const string &name, model net, const vector<int> &xshape, const vector<int> &yshape,
+                 const string &loss, int steps = 1, int checkpoint_every = -1) {
+    string prefix = name + "/";
+    if (!suite.selected(prefix + "forward") && !suite.selected(prefix + "backward") &&
+        !suite.selected(prefix + "step") && !suite.selected(prefix + "train_batch")) {
+        delete net;
+        return;
+    }
+
+    build(net, sgd(0.01f, 0.9f), {loss}, {"mse"}, CS_CPU(), true);
+    if (checkpoint_every >= 0) set_checkpointing(net, checkpoint_every);
+
+    int batch = xshape[0];
+    Tensor *x = Tensor::randn(xshape);
+    Tensor *y = Tensor::randu(yshape);
+
+    // Time each phase of the same training iteration
+    vector<double> total(4, 0.0), best(4, 1e30);
+    int iterations = 0;
+    for (int i = 0; i < suite.warmup || total[3] < suite.min_time * 1000.0 || iterations < 3; i++) {
+        auto t0 = chrono::high_resolution_clock::now();
+        zeroGrads(net);
+        forward(net, {x});
+        auto t1 = chrono::high_resolution_clock::now();
+        backward(net, {y});
+        auto t2 = chrono::high_resolution_clock::now();
+        update(net);
+        auto t3 = chrono::high_resolution_clock::now();
+
+        if (i < suite.warmup) continue;
+        double ms[4] = {chrono::duration<double, milli>(t1 - t0).count(),
+                        chrono::duration<double, milli>(t2 - t1).count(),
+                        chrono::duration<double, milli>(t3 - t2).count(),
+                        chrono::duration<double, milli>(t3 - t0).count()};
+        for (int k = 0; k < 4; k++) {
+            total[k] += ms[k];
+            best[k] = std::min(best[k], ms[k]);
+        }
+        iterations++;
+    }
+
+    // backward ~ 2x forward (input and weight gradients)
+    double fwd = forward_flops(net, batch, steps);
+    vector<string> phases = {"forward", "backward", "step", "train_batch"};
+    vector<double> flops = {fwd, 2.0 * fwd, 0.0, 3.0 * fwd};
+    string config = "b" + to_string(batch);
+    if (steps > 1) config += "_t" + to_string(steps);
+    for (int k = 0; k < 4; k++) {
+        if (!suite.selected(prefix + phases[k])) continue;
+        suite.record(prefix + phases[k], name, config, iterations, total[k] / iterations, best[k], flops[k], batch, "samples/s");
+    }
+
+    delete x;
+    delete y;
+    delete net;
+}
+
+// Step-wise decoding: latency of a decoder step (the encoder ran once), and full greedy and beam decodings
+void bench_decode(BenchSuite &suite, int batch, int length) {
+    string prefix = "decode/";
+    if (!suite.selected(prefix + "step") && !suite.selected(prefix + "greedy") && !suite.selected(prefix + "beam4")) return;
+
+    int invs = 687, outvs = 514;
+    model net = seq2seq(invs, outvs);
+    build(net, sgd(0.01f), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(), true);
+
+    Tensor *x = Tensor::randu({batch, length, 1});
+    x->mult_(invs - 1);
+    x->floor_();
+    string config = "b" + to_string(batch) + "_t" + to_string(length);
+
+    if (suite.selected(prefix + "step")) {
+        Tensor *tokens = Tensor::zeros({batch});
+        net->decode_start({x});
+        suite.run(prefix + "step", "decode", config, 0.0, batch, "tokens/s", [&]() {
+            vtensor out = net->decode_step(tokens);
+            tokens->ptr[0] = out[0]->ptr[0] > 0.5f;  // depends on the step
+        });
+        delete tokens;
+    }
+
+    suite.run(prefix + "greedy", "decode", config, 0.0, batch * length, "tokens/s", [&]() {
+        delete decode_greedy(net, {x}, length);
+    });
+    suite.run(prefix + "beam4", "decode", config, 0.0, batch * length, "tokens/s", [&]() {
+        delete decode_beam(net, {x}, length, 4);
+    });
+
+    delete x;
+    delete net;
+}
+
+// Training iterations over zero-padded sequences of skewed lengths, with and without packing
+void bench_packed(BenchSuite &suite, int batch, int steps, int features) {
+    string prefix = "lstm_packed/";
+    if (!suite.selected(prefix + "padded") && !suite.selected(prefix + "packed")) return;
+
+    // Most sequences are short: length ~ steps * u^3
+    Tensor *x = Tensor::randn({batch, steps, features});
+    Tensor *y = Tensor::randu({batch, 1});
+    int total = 0;
+    for (int b = 0; b < batch; b++) {
+        float u = (float)rand() / RAND_MAX;
+        int len = std::max(1, (int)(steps * u * u * u));
+        total += len;
+        std::fill(x->ptr + ((size_t)b * steps + len) * features, x->ptr + (size_t)(b + 1) * steps * features, 0.0f);
+    }
+    string config = "b" + to_string(batch) + "_t" + to_string(steps) + "_fill" + to_string(100 * total / (batch * steps));
+
+    for (bool packed : {false, true}) {
+        model net = lstm_seq(steps, features, packed);
+        build(net, sgd(0.01f, 0.9f), {"binary_cross_entropy"}, {"mse"}, CS_CPU(), true);
+        suite.run(prefix + (packed ? "packed" : "padded"), "lstm_packed", config, 0.0, batch, "samples/s", [&]() {
+            zeroGrads(net);
+            forward(net, {x});
+            backward(net, {y});
+            update(net);
+        });
+        delete net;
+    }
+
+    delete x;
+    delete y;
+}
+
+
+int main(int argc, char **argv){
+    BenchSuite suite("macro", argc, argv);
+
+    bench_model(suite, "mlp", mlp(), {128, 784}, {128, 10}, "softmax_cross_entropy");
+    bench_model(suite, "vgg16", vgg16(), {16, 3, 32, 32}, {16, 10}, "softmax_cross_entropy");
+    bench_model(suite, "resnet18", resnet18(), {16, 3, 32, 32}, {16, 10}, "softmax_cross_entropy");
+    // Activation checkpointing every sqrt(n) layers (run alone with --filter to compare peak_rss_kb)
+    bench_model(suite, "resnet18_checkpointing", resnet18(), {16, 3, 32, 32}, {16, 10}, "softmax_cross_entropy", 1, 0);
+    // Concat-heavy, also at batch 1 (where the parents of a concat can write in its output)
+    bench_model(suite, "densenet", densenet(), {16, 3, 32, 32}, {16, 10}, "softmax_cross_entropy");
+    bench_model(suite, "densenet_b1", densenet(), {1, 3, 32, 32}, {1, 10}, "softmax_cross_entropy");
+    bench_model(suite, "lstm", lstm(32), {32, 50, 32}, {32, 1}, "binary_cross_entropy", 50);
+    bench_model(suite, "lstm_seq", lstm_seq(50, 32), {32, 50, 32}, {32, 1}, "binary_cross_entropy", 50);
+    bench_model(suite, "gru", gru(32), {32, 50, 32}, {32, 1}, "binary_cross_entropy", 50);
+    bench_packed(suite, 32, 50, 32);
+    bench_decode(suite, 1, 30);
+    bench_decode(suite, 32, 30);
+
+    return suite.finish();
+}
@@ -0,0 +1,437 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "eddl/apis/eddl.h"
+#include "eddl/tensor/tensor.h"
+#include "eddl/tensor/nn/tensor_nn.h"
+#include "eddl/descriptors/descriptors.h"
+#include "eddl/layers/core/layer_core.h"
+
+#include "../benchmark.h"
+
+using namespace eddl;
+
+//////////////////////////////////
+// micro_benchmarks.cpp:
+// CPU kernel families on representative shapes
+// (synthetic data, one kernel call per iteration)
+//////////////////////////////////
+
+static string shape_str(const vector<int> &shape){
+    string s;
+    for (int i = 0; i < shape.size(); i++) s += (i ? "x" : "") + to_string(shape[i]);
+    return s;
+}
+
+
+// Conv2D / Conv2D_grad / Conv2D_back ****************************
+struct ConvCase { int b, c, h, w, filters, k, s; };
+
+static void bench_conv(BenchSuite &suite){
+    vector<ConvCase> cases = {
+            {32, 3, 32, 32, 32, 3, 1},     // CIFAR stem
+            {16, 64, 56, 56, 64, 3, 1},    // ResNet stage 1
+            {16, 256, 14, 14, 256, 3, 1},  // ResNet stage 3
+            {16, 256, 14, 14, 64, 1, 1},   // 1x1 bottleneck
+            {16, 64, 56, 56, 128, 3, 2},   // Strided downsampling
+            {16, 16, 4096, 1, 32, 3, 1},   // 1D sequence (direct kernel)
+    };
+
+    for (auto &cc : cases) {
+        string config = "b" + to_string(cc.b) + "_c" + to_string(cc.c) + "_" + to_string(cc.h) + "x" + to_string(cc.w) +
+                        "_f" + to_string(cc.filters) + "_k" + to_string(cc.k) + "_s" + to_string(cc.s);
+        if (!suite.selected("conv2D/" + config) && !suite.selected("conv2D_grad/" + config) && !suite.selected("conv2D_back/" + config)) continue;
+
+        Tensor *in = Tensor::randn({cc.b, cc.c, cc.h, cc.w});
+        int kc = (cc.w == 1) ? 1 : cc.k, sc = (cc.w == 1) ? 1 : cc.s;  // Sequences: {length, 1}
+        auto *cd = new ConvolDescriptor(cc.filters, {cc.k, kc}, {cc.s, sc}, "same", true);
+        cd->build(in);
+        cd->K->fill_rand_normal_(0.0f, 0.1f);
+        cd->bias->fill_(0.0f);
+        cd->gK->fill_(0.0f);
+        cd->gbias->fill_(0.0f);
+        cd->D = Tensor::randn(cd->O->shape);
+        cd->ID = Tensor::zeros(in->shape);
+
+        double flops = 2.0 * cc.b * cd->r * cd->c * cd->nk * cd->kz * cd->kr * cd->kc;
+        suite.run("conv2D/" + config, "conv2D", config, flops, cc.b, "samples/s", [&](){ tensorNN::Conv2D(cd); });
+        suite.run("conv2D_grad/" + config, "conv2D", config, flops, cc.b, "samples/s", [&](){ tensorNN::Conv2D_grad(cd); });
+        suite.run("conv2D_back/" + config, "conv2D", config, flops, cc.b, "samples/s", [&](){ tensorNN::Conv2D_back(cd); });
+
+        delete cd->O; delete cd->K; delete cd->bias; delete cd->gK; delete cd->gbias;
+        delete cd->D; delete cd->ID;
+        delete[] cd->ptrI;
+        delete cd;
+        delete in;
+    }
+}
+
+
+// MaxPool / AvgPool ****************************
+static void bench_pool(BenchSuite &suite){
+    vector<vector<int>> shapes = {{32, 32, 32, 32}, {16, 64, 112, 112}, {16, 256, 28, 28}};
+
+    for (auto &shape : shapes) {
+        string config = shape_str(shape) + "_k2_s2";
+        Tensor *in = Tensor::randn(shape);
+
+        // Max
+        if (suite.selected("mpool2D/" + config) || suite.selected("mpool2D_back/" + config)) {
+            auto *pd = new PoolDescriptor({2, 2}, {2, 2}, "none");
+            pd->build(in);
+            pd->indX = new Tensor(pd->O->getShape());
+            pd->indY = new Tensor(pd->O->getShape());
+            pd->D = Tensor::randn(pd->O->getShape());
+            pd->ID = Tensor::zeros(in->getShape());
+
+            suite.run("mpool2D/" + config, "pool", config, (double)in->size, shape[0], "samples/s", [&](){ tensorNN::MPool2D(pd); });
+            suite.run("mpool2D_back/" + config, "pool", config, (double)pd->O->size, shape[0], "samples/s", [&](){ tensorNN::MPool2D_back(pd); });
+
+            delete pd->O; delete pd->D; delete pd->ID;
+            delete pd;
+        }
+
+        // Average
+        if (suite.selected("avgpool2D/" + config) || suite.selected("avgpool2D_back/" + config)) {
+            auto *pd = new PoolDescriptor({2, 2}, {2, 2}, "none");
+            pd->build(in);
+            pd->indX = nullptr;
+            pd->indY = nullptr;
+            pd->D = Tensor::randn(pd->O->getShape());
+            pd->ID = Tensor::zeros(in->getShape());
+
+            suite.run("avgpool2D/" + config, "pool", config, (double)in->size, shape[0], "samples/s", [&](){ tensorNN::AvgPool2D(pd); });
+            suite.run("avgpool2D_back/" + config, "pool", config, (double)in->size, shape[0], "samples/s", [&](){ tensorNN::AvgPool2D_back(pd); });
+
+            delete pd->O; delete pd->D; delete pd->ID;
+            delete pd;
+        }
+
+        delete in;
+    }
+}
+
+
+// UpSampling (old repeat_nn kernel vs nearest/bilinear engine) ****************************
+static void bench_upsampling(BenchSuite &suite){
+    vector<vector<int>> shapes = {{16, 64, 56, 56}, {16, 256, 14, 14}};
+
+    for (auto &shape : shapes) {
+        string config = shape_str(shape) + "_x2";
+        Tensor *A = Tensor::randn(shape);
+        Tensor *gA = Tensor::zeros(shape);
+        Tensor *B = Tensor::empty({shape[0], shape[1], shape[2] * 2, shape[3] * 2});
+        Tensor *D = Tensor::randn(B->getShape());
+
+        suite.run("repeat_nn/" + config, "upsampling", config, 0, shape[0], "samples/s", [&](){ tensorNN::repeat_nn(A, B, {2, 2}); });
+        suite.run("d_repeat_nn/" + config, "upsampling", config, 0, shape[0], "samples/s", [&](){ tensorNN::d_repeat_nn(D, gA, {2, 2}); });
+
+        for (bool bilinear : {false, true}) {
+            string mode = bilinear ? "bilinear" : "nearest";
+            auto *ud = new UpSamplingDescriptor({2, 2}, bilinear, false, DEV_CPU);
+            ud->build(shape);
+            suite.run("upsampling_" + mode + "/" + config, "upsampling", config, 0, shape[0], "samples/s", [&](){ tensorNN::upsampling(A, B, ud); });
+            suite.run("d_upsampling_" + mode + "/" + config, "upsampling", config, 0, shape[0], "samples/s", [&](){ tensorNN::d_upsampling(D, gA, ud); });
+            delete ud;
+        }
+
+        delete A; delete gA; delete B; delete D;
+    }
+}
+
+
+// mult2D ****************************
+static void bench_mult2D(BenchSuite &suite){
+    vector<vector<int>> cases = {{128, 784, 512}, {256, 256, 256}, {1024, 1024, 1024}, {64, 4096, 4096}};  // MxKxN
+
+    for (auto &mkn : cases) {
+        string config = shape_str(mkn);
+        if (!suite.selected("mult2D/" + config) && !suite.selected("mult2D_tA/" + config)) continue;
+
+        Tensor *A = Tensor::randn({mkn[0], mkn[1]});
+        Tensor *At = Tensor::randn({mkn[1], mkn[0]});
+        Tensor *B = Tensor::randn({mkn[1], mkn[2]});
+        Tensor *C = Tensor::empty({mkn[0], mkn[2]});
+        double flops = 2.0 * mkn[0] * mkn[1] * mkn[2];
+
+        suite.run("mult2D/" + config, "mult2D", config, flops, 1, "calls/s", [&](){ Tensor::mult2D(A, 0, B, 0, C, 0); });
+        suite.run("mult2D_tA/" + config, "mult2D", config, flops, 1, "calls/s", [&](){ Tensor::mult2D(At, 1, B, 0, C, 0); });
+
+        delete A; delete At; delete B; delete C;
+    }
+}
+
+
+// Multi-head attention (the {b x heads x t x t} scores are never stored) ****************************
+static void bench_attention(BenchSuite &suite){
+    vector<vector<int>> cases = {{8, 256, 4, 64}, {1, 2048, 4, 64}};  // batch x time x heads x dim per head
+
+    for (auto &c : cases) {
+        string config = shape_str(c);
+        Tensor *Q = Tensor::randn({c[0], c[1], c[2] * c[3]});
+        Tensor *K = Tensor::randn(Q->shape);
+        Tensor *V = Tensor::randn(Q->shape);
+        Tensor *O = Tensor::empty(Q->shape);
+        Tensor *L = Tensor::empty({c[0], c[2], c[1]});
+        Tensor *dO = Tensor::randn(Q->shape);
+        Tensor *dQ = Tensor::zeros(Q->shape);
+        Tensor *dK = Tensor::zeros(Q->shape);
+        Tensor *dV = Tensor::zeros(Q->shape);
+        double flops = 4.0 * c[0] * c[2] * c[1] * c[1] * c[3];  // QK^T and PV
+
+        for (bool causal : {false, true}) {
+            string mode = causal ? "attention_causal" : "attention";
+            double f = causal ? flops / 2 : flops;
+            suite.run(mode + "/" + config, "attention", config, f, c[0], "samples/s", [&](){ tensorNN::MultiHeadAttention(Q, K, V, O, L, c[2], causal); });
+            tensorNN::MultiHeadAttention(Q, K, V, O, L, c[2], causal);
+            suite.run(mode + "_back/" + config, "attention", config, 2.5 * f, c[0], "samples/s", [&](){ tensorNN::D_MultiHeadAttention(Q, K, V, O, L, dO, dQ, dK, dV, c[2], causal); });
+        }
+
+        delete Q; delete K; delete V; delete O; delete L;
+        delete dO; delete dQ; delete dK; delete dV;
+    }
+}
+
+
+// Concat (DenseNet-like: growing feature maps plus a new block along the channels) ****************************
+static void bench_concat(BenchSuite &suite){
+    vector<vector<int>> shapes = {{16, 128, 28, 28}, {16, 512, 7, 7}, {1, 256, 56, 56}};  // first part; the second has 32 channels
+
+    for (auto &shape : shapes) {
+        string config = shape_str(shape) + "+32";
+        Tensor *A = Tensor::randn(shape);
+        Tensor *B = Tensor::randn({shape[0], 32, shape[2], shape[3]});
+        Tensor *C = Tensor::empty({shape[0], shape[1] + 32, shape[2], shape[3]});
+        double bytes = 2.0 * C->size * sizeof(float);
+
+        suite.run("concat/" + config, "concat", config, 0, bytes, "bytes/s", [&](){ Tensor::concat({A, B}, 1, C); });
+        suite.run("concat_back/" + config, "concat", config, 0, bytes, "bytes/s", [&](){ Tensor::concat_back(C, {A, B}, 1); });
+
+        delete A; delete B; delete C;
+    }
+}
+
+
+// Permute/select (as the layers run them: one descriptor per sample) ****************************
+static void bench_permute(BenchSuite &suite){
+    struct Case { string name; vector<int> shape; vector<int> dims; };
+    vector<Case> cases = {
+        {"nchw_nhwc", {16, 64, 56, 56}, {1, 2, 0}},
+        {"nhwc_nchw", {16, 56, 56, 64}, {2, 0, 1}},
+        {"transpose", {32, 512, 512}, {1, 0}},
+        {"swap_outer", {32, 64, 128, 64}, {1, 0, 2}},
+    };
+
+    for (auto &c : cases) {
+        string config = shape_str(c.shape);
+        if (!suite.selected("permute_" + c.name + "/" + config) && !suite.selected("permute_back_" + c.name + "/" + config)) continue;
+
+        vector<int> sample(c.shape.begin() + 1, c.shape.end());
+        auto *sd = new PermuteDescriptor(c.dims, DEV_CPU);
+        sd->build(sample);
+        vector<int> oshape = sd->oshape;
+        oshape.insert(oshape.begin(), c.shape[0]);
+
+        Tensor *A = Tensor::randn(c.shape);
+        Tensor *B = Tensor::empty(oshape);
+        double bytes = 2.0 * A->size * sizeof(float);
+        suite.run("permute_" + c.name + "/" + config, "permute", config, 0, bytes, "bytes/s", [&](){ tensorNN::select(A, B, sd); });
+        suite.run("permute_back_" + c.name + "/" + config, "permute", config, 0, bytes, "bytes/s", [&](){ tensorNN::select_back(B, A, sd); });
+
+        delete A; delete B; delete sd;
+    }
+
+    vector<pair<vector<int>, vector<string>>> selects = {{{64, 256, 28, 28}, {"64:192", ":", ":"}}, {{64, 64, 56, 56}, {":", "4:52", "4:52"}}};
+    for (auto &s : selects) {
+        string config = shape_str(s.first);
+        vector<int> sample(s.first.begin() + 1, s.first.end());
+        auto *sd = new SelDescriptor(s.second, DEV_CPU);
+        sd->build(sample);
+        vector<int> oshape = sd->oshape;
+        oshape.insert(oshape.begin(), s.first[0]);
+
+        Tensor *A = Tensor::randn(s.first);
+        Tensor *B = Tensor::empty(oshape);
+        double bytes = 2.0 * B->size * sizeof(float);
+        suite.run("select/" + config, "select", config, 0, bytes, "bytes/s", [&](){ tensorNN::select(A, B, sd); });
+        suite.run("select_back/" + config, "select", config, 0, bytes, "bytes/s", [&](){ tensorNN::select_back(B, A, sd); });
+        suite.run("select_resize/" + config, "select", config, 0, 1, "calls/s", [&](){ sd->resize(s.first[0]); });
+
+        delete A; delete B; delete sd;
+    }
+
+    // Whole tensors (Tensor::permute builds its descriptor on every call)
+    Tensor *T = Tensor::randn({16, 64, 56, 56});
+    suite.run("tensor_permute/16x64x56x56", "permute", "16x64x56x56", 0, 2.0 * T->size * sizeof(float), "bytes/s", [&](){ delete Tensor::permute(T, {0, 2, 3, 1}); });
+    delete T;
+
+    // Views: a batch of sequences sliced per timestep, and transposed
+    Tensor *X = Tensor::randn({64, 100, 256});
+    suite.run("timestep_select/64x100x256", "views", "64x100x256", 0, 1, "calls/s", [&](){ delete X->select({":", "50", ":"}); });
+    suite.run("timestep_view/64x100x256", "views", "64x100x256", 0, 1, "calls/s", [&](){ delete X->select_view({":", "50", ":"}); });
+    suite.run("batch_view/64x100x256", "views", "64x100x256", 0, 1, "calls/s", [&](){ delete X->select_view({"16:48"}); });
+    suite.run("time_major_view/64x100x256", "views", "64x100x256", 0, 2.0 * X->size * sizeof(float), "bytes/s", [&](){
+        Tensor *v = X->permute_view({1, 0, 2});
+        delete v->contiguous();
+        delete v;
+    });
+    delete X;
+}
+
+
+// Reductions ****************************
+static void bench_reductions(BenchSuite &suite){
+    vector<vector<int>> shapes = {{1024, 1024}, {64, 4096}, {32, 64, 32, 32}};
+
+    for (auto &shape : shapes) {
+        string config = shape_str(shape);
+        Tensor *A = Tensor::randn(shape);
+        double bytes = (double)A->size;
+
+        suite.run("sum_all/" + config, "reductions", config, bytes, bytes, "elements/s", [&](){ volatile float s = A->sum(); (void)s; });
+
+        for (int axis = 0; axis < 2; axis++) {
+            string name = "sum_axis" + to_string(axis) + "/" + config;
+            if (!suite.selected(name) && !suite.selected("max_axis" + to_string(axis) + "/" + config)) continue;
+
+            auto *rd = new ReduceDescriptor2({axis}, false, A->device);
+            rd->build(A->shape);
+            Tensor *B = Tensor::empty(rd->oshape);
+            suite.run(name, "reductions", config, bytes, bytes, "elements/s", [&](){ Tensor::sum(A, B, rd); });
+            suite.run("max_axis" + to_string(axis) + "/" + config, "reductions", config, bytes, bytes, "elements/s", [&](){ Tensor::max(A, B, rd); });
+            delete B;
+            delete rd;
+        }
+
+        if (shape.size() == 2) {
+            Tensor *B = Tensor::empty({shape[1]});
+            suite.run("reduce_sum2D/" + config, "reductions", config, bytes, bytes, "elements/s", [&](){ Tensor::reduce_sum2D(A, B, 0, 0); });
+            delete B;
+        }
+
+        delete A;
+    }
+}
+
+
+// Data augmentation ****************************
+static void bench_da(BenchSuite &suite){
+    vector<vector<int>> shapes = {{64, 3, 32, 32}, {16, 3, 224, 224}};
+
+    for (auto &shape : shapes) {
+        string config = shape_str(shape);
+        Tensor *A = Tensor::randu(shape);
+        Tensor *B = Tensor::empty(shape);
+        int items = shape[0];
+        int h = shape[2], w = shape[3];
+
+        suite.run("shift/" + config, "da", config, 0, items, "images/s", [&](){ Tensor::shift(A, B, {2, 3}); });
+        suite.run("rotate/" + config, "da", config, 0, items, "images/s", [&](){ Tensor::rotate(A, B, 15.0f); });
+        suite.run("flip/" + config, "da", config, 0, items, "images/s", [&](){ Tensor::flip(A, B, 1); });
+        suite.run("scale/" + config, "da", config, 0, items, "images/s", [&](){ Tensor::scale(A, B, {h, w}); });
+        suite.run("crop/" + config, "da", config, 0, items, "images/s", [&](){ Tensor::crop(A, B, {2, 2}, {h - 3, w - 3}); });
+        suite.run("shift_random/" + config, "da", config, 0, items, "images/s", [&](){ Tensor::shift_random(A, B, {-0.1f, 0.1f}, {-0.1f, 0.1f}); });
+        suite.run("rotate_random/" + config, "da", config, 0, items, "images/s", [&](){ Tensor::rotate_random(A, B, {-15.0f, 15.0f}); });
+
+        if (suite.selected("augment_random/" + config)) {
+            auto *ad = new AugmentDescriptor({-15.0f, 15.0f}, {0.1f, 0.1f}, {0.9f, 1.1f}, {}, 0.5f, 0.0f,
+                                             {0.8f, 1.2f}, {0.8f, 1.2f}, 0.0f, true, WrappingMode::Constant, 0.0f, DEV_CPU);
+            suite.run("augment_random/" + config, "da", config, 0, items, "images/s", [&](){ Tensor::augment_random(A, B, ad); });
+            delete ad;
+        }
+
+        delete A; delete B;
+    }
+}
+
+
+// Activations ****************************
+static void bench_activations(BenchSuite &suite){
+    vector<vector<int>> shapes = {{128, 1024}, {32, 64, 56, 56}};
+
+    for (auto &shape : shapes) {
+        string config = shape_str(shape);
+        Tensor *A = Tensor::randn(shape);
+        Tensor *B = Tensor::empty(shape);
+        Tensor *D = Tensor::randn(shape);
+        Tensor *PD = Tensor::zeros(shape);
+        double n = (double)A->size;
+
+        suite.run("relu/" + config, "activations", config, n, n, "elements/s", [&](){ tensorNN::ReLu(A, B); });
+        suite.run("d_relu/" + config, "activations", config, n, n, "elements/s", [&](){ tensorNN::D_ReLu(D, A, PD); });
+        suite.run("sigmoid/" + config, "activations", config, n, n, "elements/s", [&](){ tensorNN::Sigmoid(A, B); });
+        suite.run("d_sigmoid/" + config, "activations", config, n, n, "elements/s", [&](){ tensorNN::D_Sigmoid(D, B, PD); });
+        suite.run("tanh/" + config, "activations", config, n, n, "elements/s", [&](){ tensorNN::Tanh(A, B); });
+
+        if (shape.size() == 2) {
+            suite.run("softmax/" + config, "activations", config, n, n, "elements/s", [&](){ tensorNN::Softmax(A, B); });
+            suite.run("full_softmax/" + config, "activations", config, n, n, "elements/s", [&](){ tensorNN::FullSoftmax(A, B); });
+        }
+
+        delete A; delete B; delete D; delete PD;
+    }
+}
+
+
+// Optimizers (one step over the params of a Dense layer) ****************************
+static void bench_optimizers(BenchSuite &suite){
+    vector<string> names = {"sgd", "sgd_momentum", "adam", "rmsprop"};
+    vector<int> sizes = {256, 2048};
+
+    for (int units : sizes) {
+        for (auto &name : names) {
+            string config = to_string(units) + "x" + to_string(units);
+            string bname = name + "/" + config;
+            if (!suite.selected(bname)) continue;
+
+            optimizer opt;
+            if (name == "sgd") opt = sgd(0.01f);
+            else if (name == "sgd_momentum") opt = sgd(0.01f, 0.9f);
+            else if (name == "adam") opt = adam(0.001f);
+            else opt = rmsprop(0.001f);
+
+            layer in = Input({units});
+            layer out = Dense(in, units);
+            model net = Model({in}, {out});
+            build(net, opt, {"mse"}, {"mse"}, CS_CPU(), true);
+
+            for (auto &l : net->layers)
+                for (auto &g : l->gradients) g->fill_rand_normal_(0.0f, 0.01f);
+
+            double params = (double)units * units + units;
+            suite.run(bname, "optimizers", config, 0, params, "params/s", [&](){ net->optimizer->applygrads(1); });
+
+            delete net;
+        }
+    }
+}
+
+
+int main(int argc, char **argv){
+    BenchSuite suite("micro", argc, argv);
+
+    bench_conv(suite);
+    bench_pool(suite);
+    bench_upsampling(suite);
+    bench_mult2D(suite);
+    bench_attention(suite);
+    bench_concat(suite);
+    bench_permute(suite);
+    bench_reductions(suite);
+    bench_da(suite);
+    bench_activations(suite);
+    bench_optimizers(suite);
+
+    return suite.finish();
+}
@@ -107,6 +107,14 @@ int main(int argc, char **argv) {
       fit(net, {x_train}, {y_train}, batch_size, 1);
     }
 
+    // Translate some test sentences step by step (the encoder runs once)
+    Tensor *x_some=x_test->select({"0:8"});
+    Tensor *translations=decode_beam(net, {x_some}, olength, 4);
+    translations->print(0);
+
+    delete x_some;
+    delete translations;
+
    delete net;
 
 
@@ -268,6 +268,9 @@ namespace eddl {
     /**
       *  @brief  Load weights to reinstantiate your model.
       *
+      *  Weights containers (format "mmap") are detected and memory-mapped: the params point at the file and
+      *  its pages are only read when used, and copied only if written.
+      *
       *  @param m  Model
       *  @param fname  Where are the model weights
       *  @return     (void) Load the weights
@@ -278,9 +281,46 @@ namespace eddl {
       *
       *  @param m  Model
       *  @param fname  Where the model weights will be saved
+      *  @param format  "bin" or "mmap" (weights container with aligned params, see load)
       *  @return     (void) Save the weights
     */
     void save(model m, const string& fname, string format="bin");
+    /**
+      *  @brief  Convert the weights of a model saved with `save` to a weights container ("mmap").
+      *
+      *  @param m  Model the weights belong to
+      *  @param src  Weights file
+      *  @param dst  Weights container
+      *  @return     (void)
+    */
+    void convert_weights_to_mmap(model m, const string& src, const string& dst);
+    /**
+      *  @brief  Save a training checkpoint: the weights and the optimizer state (i.e. Adam moments).
+      *
+      *  The snapshot is taken on the calling thread and written from a background thread to fname.tmp,
+      *  which is renamed to fname once complete, so fname always holds a complete checkpoint.
+      *
+      *  @param m  Model
+      *  @param fname  Checkpoint file
+      *  @param async  If false, wait until the checkpoint is written
+      *  @return     (void)
+    */
+    void save_checkpoint(model m, const string& fname, bool async=true);
+    /**
+      *  @brief  Wait until the pending checkpoints of a model are written.
+      *
+      *  @param m  Model
+      *  @return     (void)
+    */
+    void wait_checkpoint(model m);
+    /**
+      *  @brief  Resume the training from a checkpoint (see save_checkpoint). The model must be built with the same layers and optimizer.
+      *
+      *  @param m  Model
+      *  @param fname  Checkpoint file
+      *  @return     (void)
+    */
+    void load_checkpoint(model m, const string& fname);
 
     // Optimizer
     /**
@@ -292,6 +332,65 @@ namespace eddl {
     */
     void setlr(model net,vector<float>p);
 
+    /**
+      *  @brief  Activation checkpointing: trades an extra forward for the memory of the activations during training.
+      *
+      *  @details
+      *   The forward pass (in training mode) splits the layers in segments closed by the checkpoints. The outputs of the layers inside each segment are freed once the segment is done,
+      *   and the backward recomputes them, one segment at a time, before going through it. Inputs, outputs, checkpoints and the layers whose forward cannot be repeated
+      *   (Dropout, BatchNorm, noise, random data augmentation) always keep their outputs. With a checkpoint every sqrt(n) layers, the activations take O(sqrt(n)) memory for about one extra forward.
+      *   While it is enabled, only the kept outputs can be read after a forward in training mode. Recurrent models are not supported.
+      *
+      *  @param net  Model (already built)
+      *  @param every  A checkpoint every `every` layers of the forward order (0: every sqrt(n) layers; -1: disables the checkpointing)
+      *  @return     (void)
+    */
+    void set_checkpointing(model net, int every=0);
+
+    /**
+      *  @brief  Activation checkpointing at the given layers (see set_checkpointing).
+      *
+      *  @param net  Model (already built)
+      *  @param checkpoints  Layers that keep their outputs. With no layers, the whole forward is a single segment
+      *  @return     (void)
+    */
+    void set_checkpointing(model net, const vector<layer> &checkpoints);
+
+    /**
+      *  @brief  Activation checkpointing with a memory budget per segment (see set_checkpointing).
+      *
+      *  @details
+      *   Checkpoints are placed along the forward so that the outputs recomputed for each segment take at most `megabytes` (at the current batch size).
+      *
+      *  @param net  Model (already built)
+      *  @param megabytes  Memory budget of the outputs of a segment
+      *  @return     (void)
+    */
+    void set_checkpointing_budget(model net, float megabytes);
+
+    /**
+      *  @brief  Post-training int8 quantization of the Dense and Conv layers of a built model (CPU inference only).
+      *
+      *  @details
+      *   The calibration samples are forwarded in fp32 to collect the range of the inputs of every Dense/Conv layer.
+      *   Then, in inference mode, these layers quantize their inputs (per-tensor) and weights (per output channel or per tensor) to int8 and accumulate in int32, dequantizing and adding the bias in the same pass.
+      *   The remaining layers run in fp32. The activation scales are stored by `save` and `save_net_to_onnx_file`, and restored by `load` and `import_net_from_onnx_file`.
+      *
+      *  @param net  Model
+      *  @param calibration  Input samples, one tensor per input layer
+      *  @param per_channel  One weight scale per output channel (true) or per layer (false)
+      *  @return     (void)
+    */
+    void quantize(model net, const vector<Tensor*>& calibration, bool per_channel=true);
+
+    /**
+      *  @brief  Removes the int8 quantization of a model, going back to fp32 inference.
+      *
+      *  @param net  Model
+      *  @return     (void)
+    */
+    void dequantize(model net);
+
 
     /**
       *  @brief Adadelta optimizer.
@@ -438,6 +537,38 @@ namespace eddl {
     */
     vector<Tensor *>  predict(model m, const vector<Tensor *> &in);
 
+    /**
+      *  @brief Performs a prediction with input data, in batches, into preallocated output tensors
+      *
+      *  @param m  Model
+      *  @param in  Input data (features)
+      *  @param out  Output tensors, with as many samples as the input
+      *  @param bs  Batch size (size [100])
+      *  @return    (void)
+    */
+    void predict(model m, const vector<Tensor *> &in, const vector<Tensor *> &out, int bs=100);
+
+    /**
+      *  @brief Decodes a recurrent decoder step by step: the encoder runs once, and the most likely token of every step is the input of the next one
+      *
+      *  @param m  Model with a decoder
+      *  @param in  Input data (features)
+      *  @param length  Number of decoded tokens
+      *  @return    Tensor of samples x length token indices
+    */
+    Tensor *decode_greedy(model m, const vector<Tensor *> &in, int length);
+
+    /**
+      *  @brief Decodes a recurrent decoder step by step with a beam search over the probabilities of its output
+      *
+      *  @param m  Model with a decoder
+      *  @param in  Input data (features)
+      *  @param length  Number of decoded tokens
+      *  @param beam  Hypotheses kept per sample
+      *  @return    Tensor of samples x length token indices, of the best hypothesis
+    */
+    Tensor *decode_beam(model m, const vector<Tensor *> &in, int length, int beam=4);
+
 
     // Finer methods
 
@@ -893,7 +1024,7 @@ namespace eddl {
    *  @param filters  Integer, the dimensionality of the output space (i.e. the number of output filters in the convolution)
    *  @param kernel_size  Vector of 1 integers, specifying the height and width of the 2D convolution window.
    *  @param strides  Vector of 1 integers, specifying the strides of the convolution along the height and width
-   *  @param padding  One of "none", "valid" or "same"
+   *  @param padding  One of "none", "valid", "same" or "causal" (output t only depends on inputs up to t)
    *  @param use_bias  Boolean, whether the layer uses a bias vector.
    *  @param groups  Number of blocked connections from input channels to output channels
    *  @param dilation_rate  Vector of 1 integers, specifying the dilation rate to use for dilated convolution
@@ -958,15 +1089,17 @@ namespace eddl {
       *  @brief Upsampling layer.
       *
       *  @details
-      *   Identical to the ``scale`` transformation, the only difference is that ``upsampling`` repeats its rows/columns *n* times, while scaling uses a proportion.
+      *   Upsamples the spatial axes of 1D ``{channels, length}``, 2D ``{channels, rows, cols}`` or 3D ``{channels, depth, rows, cols}`` inputs by integer factors.
+      *   ``nearest`` repeats every element *n* times; ``bilinear`` interpolates linearly along each axis (trilinear in 3D).
       *
       *  @param parent  Parent layer
-      *  @param size  Vector of 2 integers. The upsampling factors for rows and columns
+      *  @param size  Vector of 1, 2 or 3 integers. The upsampling factor of each spatial axis
       *  @param interpolation  A string, one of nearest or bilinear
       *  @param name  A name for the operation
+      *  @param align_corners  If true, the corner samples of the input and the output are aligned. Otherwise samples are taken at half-pixel centers
       *  @return     Output layer after upsampling operation
     */
-    layer UpSampling(layer parent, const vector<int> &size, string interpolation = "nearest", string name = "");
+    layer UpSampling(layer parent, const vector<int> &size, string interpolation = "nearest", string name = "", bool align_corners = false);
 
     /**
       *  @brief Reshapes an output to a certain shape.
@@ -1008,7 +1141,7 @@ namespace eddl {
     layer ConvT(layer parent, int filters, const vector<int> &kernel_size,
                 const vector<int> &output_padding, string padding = "same",
                 const vector<int> &dilation_rate = {1, 1},
-                const vector<int> &strides = {1, 1}, bool use_bias = true, string name = ""); //Todo: Implement
+                const vector<int> &strides = {1, 1}, bool use_bias = true, string name = "");
 
     /**
       *  @brief Turns positive integers (indexes) into dense vectors of fixed size. eg. [[4], [20]] -> [[0.25, 0.1], [0.6, -0.2]]
@@ -1213,7 +1346,33 @@ namespace eddl {
       *  @param name  A name for the operation
       *  @return     Output of affine transformation
     */
-    layer RandomAffine(layer parent, vector<float> angle, vector<float> translate, vector<float> scale, vector<float> shear, string name="");  // TODO: Implement
+    layer RandomAffine(layer parent, vector<float> angle, vector<float> translate, vector<float> scale, vector<float> shear, string name="");
+
+    /**
+      *  @brief Fused random augmentation: rotation, translation, scaling, shear and flips composed into a single affine map, plus brightness, contrast and grayscale, all applied in one resampling pass.
+      *
+      *  @details
+      *   Replaces chains such as RandomShift + RandomRotation + RandomScale + RandomFlip, which copy the image once per layer. Empty ranges (or zero probabilities) disable a transformation.
+      *
+      *  @param parent  Parent layer
+      *  @param angle  Rotation range in degrees `{min, max}`
+      *  @param translate  Maximum translation `{x, y}` as a fraction of the image size
+      *  @param scale  Scaling factor range `{min, max}`
+      *  @param shear  Shear range in degrees `{min, max}`
+      *  @param flip_h  Probability of a horizontal flip
+      *  @param flip_v  Probability of a vertical flip
+      *  @param brightness  Brightness factor range `{min, max}`
+      *  @param contrast  Contrast factor range `{min, max}`
+      *  @param grayscale  Probability of converting a (3-channel) image to grayscale
+      *  @param interpolation  One of "nearest", "bilinear"
+      *  @param da_mode  One of "constant", "nearest", "original"
+      *  @param constant  Fill value for area outside the transformed image
+      *  @param name  A name for the operation
+      *  @return     Output of the augmentation
+    */
+    layer RandomAugmentation(layer parent, vector<float> angle={}, vector<float> translate={}, vector<float> scale={}, vector<float> shear={},
+                             float flip_h=0.0f, float flip_v=0.0f, vector<float> brightness={}, vector<float> contrast={}, float grayscale=0.0f,
+                             string interpolation="bilinear", string da_mode="constant", float constant=0.0f, string name="");
 
     /**
       *  @brief Crop the given image at a random location with size `[height, width]`.
@@ -1360,6 +1519,20 @@ namespace eddl {
 
     layer MatMul(const vector<layer> &layers, string name = "");
 
+    /**
+      *  @brief Multi-head scaled dot-product attention, softmax(Q K^T / sqrt(dk)) V per head.
+      *
+      *  @details
+      *   Compute-only (the projections are done by the parents), on CPU. The scores are computed by tiles and never stored, so the memory is linear in the length of the sequences.
+      *
+      *  @param layers  {qkv} for self-attention, or {q, k, v}. Batch x time x dim outputs, the dims split in heads
+      *  @param heads  Number of heads
+      *  @param causal  Whether each query only attends to the keys up to its own timestep
+      *  @param name  A name for the operation
+      *  @return     Batch x time x dim(v) output
+    */
+    layer MultiHeadAttention(const vector<layer> &layers, int heads, bool causal=false, string name = "");
+
     /**
       *  @brief Layer that computes the maximum (element-wise) a list of inputs.
       *
@@ -1676,7 +1849,7 @@ namespace eddl {
       *  @param parent  Parent layer
       *  @param pool_size  Size of the max pooling windows
       *  @param strides  Factor by which to downscale. E.g. 2 will halve the input. If None, it will default to pool_size
-      *  @param padding  One of "none", "valid" or "same" (case-insensitive).
+      *  @param padding  One of "none", "valid", "same" or "causal" (case-insensitive).
       *  @param name  A name for the operation
       *  @return     The result after apply the max pooling operation over the parent layer
     */
@@ -1713,6 +1886,45 @@ namespace eddl {
     */
     layer LSTM(layer parent, int units, bool mask_zeros=false, bool bidirectional = false, string name = "");
 
+    /**
+      *  @brief Gated Recurrent Unit layer - Cho 2014 (reset gate applied after the recurrent product, as in cuDNN).
+      *
+      *  @param parent  Parent layer
+      *  @param units  dimensionality of the output space.
+      *  @param mask_zeros  Timesteps whose input is all zeros keep the previous state
+      *  @param bidirectional  Wether the RNN is bidirectional or not.
+      *  @param name  A name for the operation
+      *  @return     The GRU layer
+    */
+    layer GRU(layer parent, int units, bool mask_zeros=false, bool bidirectional = false, string name = "");
+
+    /**
+      *  @brief Sequence-level RNN: processes the whole batch x time x dim sequence without unrolling the net.
+      *
+      *  @param parent  Parent layer, with batch x time x dim outputs
+      *  @param units  dimensionality of the output space.
+      *  @param num_layers  Number of stacked RNN layers
+      *  @param activation  Activation of the cells
+      *  @param return_sequences  Whether to return the outputs of every timestep (batch x time x units) or only the last one
+      *  @param mask_zeros  Sequences padded with zeros at the end: the padded timesteps are skipped (and their outputs are zeros)
+      *  @param name  A name for the operation
+      *  @return     The RNN layer
+    */
+    layer RNNSequence(layer parent, int units, int num_layers=1, string activation="tanh", bool return_sequences=false, bool mask_zeros=false, string name = "");
+
+    /**
+      *  @brief Sequence-level LSTM: processes the whole batch x time x dim sequence without unrolling the net.
+      *
+      *  @param parent  Parent layer, with batch x time x dim outputs
+      *  @param units  dimensionality of the output space.
+      *  @param num_layers  Number of stacked LSTM layers
+      *  @param return_sequences  Whether to return the outputs of every timestep (batch x time x units) or only the last one
+      *  @param mask_zeros  Sequences padded with zeros at the end: the padded timesteps are skipped (and their outputs are zeros)
+      *  @param name  A name for the operation
+      *  @return     The LSTM layer
+    */
+    layer LSTMSequence(layer parent, int units, int num_layers=1, bool return_sequences=false, bool mask_zeros=false, string name = "");
+
     layer Decoder(layer l, layer ld, string op="concat");
 
     // Layers Methods
@@ -66,10 +66,12 @@ public:
     vector<int> ksize;
     vector<int> stride;
     vector<int> pad; // {rows-top, rows-bottom, cols-left, cols-right}
-    string padding; // valid/none, same/zeros, custom
+    vector<int> dilation; // {rows, cols}
+    string padding; // valid/none, same/zeros, causal, custom
 
     int nk, kr, kc, kz;
     int sr, sc;
+    int dr, dc;  // dilation: spacing between kernel elements
     int ir, ic, iz;
     int r, c, z;
     int padrt,padrb;
@@ -77,6 +79,9 @@ public:
     int size;  // Auxiliar var
     bool use_bias;
     int mem_level; // see CS
+    int groups;  // Channels are split in groups, each one convolved with its own filters (kz = iz/groups)
+    bool depthwise;  // groups == input channels: direct kernel, no lowering
+    bool direct;  // 1D (a single column) with few taps per filter: direct kernel, no lowering
 
     Tensor *I= nullptr; // Input map
     Tensor *ID= nullptr;// Delta input map
@@ -114,9 +119,9 @@ public:
 
     ConvolDescriptor();
 
-    ConvolDescriptor(int filters, const vector<int> &ks, const vector<int> &st, const string& p, bool use_bias, int mem=0);
+    ConvolDescriptor(int filters, const vector<int> &ks, const vector<int> &st, const string& p, bool use_bias, int mem=0, int groups=1, const vector<int> &dilation_rate={1, 1});
 
-    ConvolDescriptor(const vector<int> &ks, const vector<int> &st, const vector<int> &p, int mem=0);
+    ConvolDescriptor(const vector<int> &ks, const vector<int> &st, const vector<int> &p, int mem=0, int groups=1, const vector<int> &dilation_rate={1, 1});
 
     ~ConvolDescriptor();
 
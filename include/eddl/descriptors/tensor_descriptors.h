@@ -14,6 +14,7 @@
 #include <vector>
 #include <string>
 #include <mutex>
+#include <cstdint>
 
 #ifdef cFPGA
 #include "eddl/hardware/fpga/xcl2.hpp"
@@ -51,6 +52,10 @@ public:
     vector<int> oshape;
     vector<vector<int>> idxs_range;
 
+    // Strided view of the input (no address table on CPU): the element of the output at
+    // index (i0, i1, ...) is the input at offset + i0*strides[0] + i1*strides[1] + ...
+    int offset;
+    vector<int> strides;
 
     vector<string> indices;
 
@@ -103,5 +108,92 @@ public:
 
 };
 
+// Random geometric + photometric augmentation, applied in a single resampling pass
+class AugmentDescriptor : public TensorDescriptor {
+public:
+    // Geometric ranges (empty => disabled)
+    vector<float> angle;  // {min, max} degrees
+    vector<float> translate;  // {max_x, max_y} fraction of the image size
+    vector<float> scale;  // {min, max}
+    vector<float> shear;  // {min, max} degrees (x-axis)
+    float flip_h;  // probability of a horizontal flip
+    float flip_v;  // probability of a vertical flip
+
+    // Photometric ranges (empty => disabled)
+    vector<float> brightness;  // {min, max} factor
+    vector<float> contrast;  // {min, max} factor
+    float grayscale;  // probability
+
+    bool bilinear;  // false => nearest
+    int mode;  // WrappingMode
+    float cval;
+
+    // Per-sample parameters drawn by sample(): 2x3 inverse affine (output=>input) + photometric factors
+    vector<float> affine;
+    vector<float> photometric;  // {brightness, contrast, grayscale}
+
+    AugmentDescriptor(const vector<float>& angle, const vector<float>& translate, const vector<float>& scale,
+                      const vector<float>& shear, float flip_h, float flip_v,
+                      const vector<float>& brightness, const vector<float>& contrast, float grayscale,
+                      bool bilinear, int mode, float cval, int dev);
+
+    void sample(int batch, const vector<int>& ishape, const vector<int>& oshape);
+    bool has_photometric();
+};
+
+// Nearest/linear resampling of the spatial axes of {B, C, d1[, d2[, d3]]}, one separable pass per axis
+class UpSamplingDescriptor : public TensorDescriptor {
+public:
+    vector<int> size;  // integer factor per spatial axis
+    bool bilinear;  // false => nearest
+    bool align_corners;  // the corner samples of input and output are aligned (else half-pixel centers)
+    vector<int> ishape;
+    vector<int> oshape;
+
+    // Per spatial axis: output j = (1-w1[j])*input[i0[j]] + w1[j]*input[i1[j]]
+    vector<vector<int>> i0, i1;
+    vector<vector<float>> w1;
+
+    // Per spatial axis, the transposed tables (CSR): the delta of input i gathers
+    // bw[k]*delta[bidx[k]] for k in [bstart[i], bstart[i+1])
+    vector<vector<int>> bstart, bidx;
+    vector<vector<float>> bw;
+
+    vector<float> buffer[2];  // results between passes (scratch)
+
+    UpSamplingDescriptor(const vector<int>& size, bool bilinear, bool align_corners, int dev);
+
+    void build(const vector<int>& ishape);
+    void resize(int b) override;
+};
+
+class QuantDescriptor : public TensorDescriptor {
+public:
+    bool per_channel;  // one weight scale per output channel (else one per tensor)
+    bool calibrating;  // observe activations instead of running the int8 kernels
+    bool packed;  // qW is up to date with the fp32 weights
+
+    // Symmetric int8 activations: x ~ q*in_scale
+    float in_absmax;
+    float in_scale;
+
+    // Weights as [outs x ins] int8 rows: w ~ q*w_scale[out]
+    int ins, outs;
+    vector<int8_t> qW;
+    vector<float> w_scale;
+    vector<int32_t> w_sum;  // per row sum of qW (unsigned activation offset correction)
+
+    vector<int8_t> qI;  // quantized activations (scratch)
+
+    QuantDescriptor(bool per_channel, int dev);
+
+    void observe(const float *ptr, int size);
+    void calibrate();
+    bool ready();
+
+    void pack(const float *W, int ins, int outs, bool in_major);
+    void quantize(const float *ptr, int8_t *q, int size);
+};
+
 
 #endif //EDDL_TENSOR_DESCRIPTORS_H
@@ -148,8 +148,24 @@
 #define _CPU_REPEAT_NN             144
 #define _CPU_D_REPEAT_NN           145
 #define _CPU_FLIP                  146
+#define _CPU_DROPOUT               147
+#define _CPU_D_DROPOUT             148
+#define _CPU_AUGMENT_RANDOM        149
+#define _CPU_QDENSE                150
+#define _CPU_QCONV2D               151
+#define _CPU_EMBEDDING             152
+#define _CPU_EMBEDDING_BACK        153
+#define _CPU_SPARSE_UPDATE         154
+#define _CPU_UPSAMPLING            155
+#define _CPU_D_UPSAMPLING          156
+#define _CPU_LSTM_CELL             157
+#define _CPU_D_LSTM_CELL           158
+#define _CPU_GRU_CELL              159
+#define _CPU_D_GRU_CELL            160
+#define _CPU_ATTENTION             161
+#define _CPU_D_ATTENTION           162
 
-#define _NUM_CPU_FUNCS       147
+#define _NUM_CPU_FUNCS       163
 extern int num_instances[_NUM_CPU_FUNCS];
 void _profile(int f_id, int end);
 void _profile_add_tensor(unsigned long int size);
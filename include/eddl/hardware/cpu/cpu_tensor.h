@@ -10,6 +10,8 @@
 #ifndef EDDL_CPU_TENSOR_H
 #define EDDL_CPU_TENSOR_H
 
+#include <cstdint>
+
 #include "cpu_profile.h"
 
 #include "eddl/tensor/tensor.h"
@@ -31,6 +33,11 @@ void _cpu_sort(Tensor *A, Tensor *B, bool descending, bool stable);
 void cpu_sort(Tensor *A, Tensor *B, bool descending, bool stable);
 void cpu_argsort(Tensor *A, Tensor *B, bool descending, bool stable);
 
+// dense <-> strided view (see SelDescriptor): gather reads the view into dense
+void cpu_strided_copy(float *strided, float *dense, const vector<int> &shape, const vector<int> &strides, bool gather, bool accumulate);
+// B = A (or B += A) element by element in row-major order, when A or B is a strided view
+void cpu_copy_strided(Tensor *A, Tensor *B, bool accumulate);
+
 void cpu_select(Tensor *A, Tensor *B, SelDescriptor *sd);
 void cpu_select_back(Tensor *A, Tensor *B, SelDescriptor *sd);
 
@@ -54,6 +61,12 @@ void cpu_rand_signed_uniform(Tensor *A, float v);
 void cpu_rand_binary(Tensor *A, float v);
 void cpu_rand_normal(Tensor *A, float m, float s, bool fast_math);  // TODO: Don't like it
 
+// CPU: Precision
+uint16_t cpu_float_to_fp16(float v);
+float cpu_fp16_to_float(uint16_t v);
+void cpu_pack_fp16(const float *src, uint16_t *dst, int n);
+void cpu_unpack_fp16(const uint16_t *src, float *dst, int n);
+
 // CPU: Data transformations (2D Optimized) ********************************************
 // CPU: Data transformations (2D Optimized) ********************************************
 void cpu_shift(Tensor *A, Tensor *B, vector<int> shift, int mode, float constant);
@@ -71,6 +84,7 @@ void cpu_flip_random(Tensor *A, Tensor *B, int axis);
 void cpu_crop_random(Tensor *A, Tensor *B);
 void cpu_crop_scale_random(Tensor *A, Tensor *B, vector<float> factor, int mode, float constant);
 void cpu_cutout_random(Tensor *A, Tensor *B, vector<float> factor_x, vector<float> factor_y, float constant);
+void cpu_augment_random(Tensor *A, Tensor *B, AugmentDescriptor *ad);
 
 // CPU: Math (in-place)
 void cpu_abs(Tensor *A, Tensor *B);
@@ -11,6 +11,8 @@
 #ifndef EDDL_CPU_TENSOR_NN_H
 #define EDDL_CPU_TENSOR_NN_H
 
+#include <cstdint>
+
 #include "eddl/hardware/cpu/cpu_profile.h"
 
 #include "eddl/tensor/tensor.h"
@@ -19,6 +21,7 @@
 // Aux
 float get_pixel(int b,int px,int py,int pz,ConvolDescriptor *D,int isize,int irsize);
 void add_pixel(int b,int px,int py,int pz,ConvolDescriptor *D,int isize,int irsize,float val);
+void im2col(int b,ConvolDescriptor *D,float *ptrI,int col2im,int g=0);  // g: group of input channels
 
 // Activations
 void cpu_relu(Tensor *A, Tensor *B);
@@ -83,6 +86,8 @@ int cpu_bin_accuracy(Tensor *A, Tensor *B);
 void cpu_conv2D(ConvolDescriptor *D);
 void cpu_conv2D_grad(ConvolDescriptor *D);
 void cpu_conv2D_back(ConvolDescriptor *D);
+void cpu_conv2D_bias(Tensor *O, Tensor *bias);  // O[b,z] += bias[z]
+void cpu_conv2D_gbias(Tensor *D, Tensor *gbias);  // gbias[z] += sum(D[b,z])
 
 // MaxPool
 void cpu_mpool2D(PoolDescriptor*D);
@@ -92,10 +97,46 @@ void cpu_mpool2D_back(PoolDescriptor *D);
 void cpu_avgpool2D(PoolDescriptor*D);
 void cpu_avgpool2D_back(PoolDescriptor *D);
 
+// Quantized inference (int8 weights/activations, int32 accumulation)
+void cpu_qdense(Tensor *A, Tensor *B, Tensor *bias, QuantDescriptor *qd);
+void cpu_qconv2D(ConvolDescriptor *D, QuantDescriptor *qd);
+
+// Embeddings (ind receives the word of each position, returns the number of words out of vocabulary)
+int cpu_embedding(Tensor *E, Tensor *I, Tensor *O, int *ind, bool mask_zeros);
+void cpu_embedding_back(Tensor *D, Tensor *gE, const int *ind, int n, bool mask_zeros, vector<int> &rows);
+
+// Row-sparse updates (only the listed rows of the tensors are read or written)
+void cpu_zero_rows(Tensor *A, const vector<int> &rows);
+void cpu_clamp_rows(Tensor *A, const vector<int> &rows, float min, float max);
+void cpu_sgd_rows(Tensor *P, Tensor *G, Tensor *M, const vector<int> &rows, float lr, float mu);
+void cpu_adam_rows(Tensor *P, Tensor *G, Tensor *M, Tensor *V, const vector<int> &rows, float lr, float beta_1, float beta_2, float epsilon, int t);
+void cpu_rmsprop_rows(Tensor *P, Tensor *G, Tensor *G1, const vector<int> &rows, float lr, float rho, float epsilon);
+
+// Dropout (mask regenerated from the seed, never stored)
+void cpu_dropout(Tensor *A, Tensor *B, float keep, float scale, uint64_t seed);
+void cpu_d_dropout(Tensor *D, Tensor *PD, float keep, float scale, uint64_t seed);
+
+// LSTM cells of a timestep (gates packed per row: input, forget, output and cell)
+void cpu_lstm_cell(Tensor *G, Tensor *Cprev, Tensor *C, Tensor *H);
+void cpu_d_lstm_cell(Tensor *G, Tensor *Cprev, Tensor *C, Tensor *dH, Tensor *dC, Tensor *dG);
+
+// GRU cells of a timestep (gates packed per row: update, reset and candidate)
+void cpu_gru_cell(Tensor *GX, Tensor *GH, Tensor *Hprev, Tensor *H, Tensor *mask);
+void cpu_d_gru_cell(Tensor *GX, Tensor *GH, Tensor *Hprev, Tensor *dH, Tensor *dGX, Tensor *dGH, Tensor *dHprev, Tensor *mask);
+
+// Multi-head attention over tiles of queries and keys (the scores are never stored, L keeps
+// the log-sum-exp of each row for the backward)
+void cpu_attention(Tensor *Q, Tensor *K, Tensor *V, Tensor *O, Tensor *L, int heads, bool causal);
+void cpu_d_attention(Tensor *Q, Tensor *K, Tensor *V, Tensor *O, Tensor *L, Tensor *dO, Tensor *dQ, Tensor *dK, Tensor *dV, int heads, bool causal);
+
 // Tensor (special functions that deal with 4D tensors)
 void cpu_repeat_nn(Tensor *A, Tensor *B, vector<int> size);
 void cpu_d_repeat_nn(Tensor *D, Tensor *A, vector<int> size);
 
+// Upsampling of 1D/2D/3D spatial axes (nearest or linear), separable
+void cpu_upsampling(Tensor *A, Tensor *B, UpSamplingDescriptor *D);
+void cpu_d_upsampling(Tensor *D, Tensor *A, UpSamplingDescriptor *ud);
+
 void cpu_select_nn(Tensor *A, Tensor *B, SelDescriptor *sd);
 void cpu_select_back_nn(Tensor *A, Tensor *B, SelDescriptor *sd);
 void cpu_set_select_nn(Tensor *A, Tensor *B, SelDescriptor *sd);
@@ -30,6 +30,7 @@ public:
 	bool distributed_training;
 
     ConvolDescriptor *cd;
+    QuantDescriptor *qd;  // int8 inference (see Net::quantize)
 
     // constructors and clones
     LConv(Layer *parent, const vector<int> &ks, const vector<int> &st, const vector<int> &p, string name, int dev, int mem);
@@ -57,6 +58,8 @@ public:
 
     void resize(int batch) override;
 
+    bool strided_samples() override { return true; }
+
 	void update_weights(Tensor* w, Tensor* bias=nullptr) override;
 
 	void accumulate_accumulated_gradients(Tensor* gw, Tensor* gbias=nullptr) override;
@@ -130,49 +133,61 @@ public:
 class LConvT : public LinLayer {
 public:
     static int total_layers;
+    int filters;
+    bool use_bias;
+    vector<int> output_padding;
+
+    // Adjoint convolution: from the output space (filters channels) to the input space.
+    // Its filters {in_channels, filters, kr, kc} are the weights of this layer.
     ConvolDescriptor *cd;
 
+    Tensor *bias;
+    Tensor *gbias;
+
     // constructors and clones
     LConvT(Layer *parent, int filters, const vector<int> &kernel_size,
            const vector<int> &output_padding, string padding, const vector<int> &dilation_rate,
            const vector<int> &strides, bool use_bias, string name, int dev, int mem);
 
-    LConvT(Layer *parent, ConvolDescriptor *cd, string name, int dev, int mem);
+    // cd->ksize[0] is the number of output channels (filters)
+    LConvT(Layer *parent, ConvolDescriptor *cd, const vector<int> &output_padding, string name, int dev, int mem);
 
     // Destructor
     ~LConvT();
 
-//    Layer *share(int c, int bs, vector<Layer *> p) override;
-//
-//    Layer *clone(int c, int bs, vector<Layer *> p, int todev) override;
-//
-//    // Params are in ConvolDescriptor
-//
-//    // implementation
-//    void forward() override;
-//
-//    void backward() override;
-//
-//    string plot(int c) override;
+    Layer *share(int c, int bs, vector<Layer *> p) override;
+
+    Layer *clone(int c, int bs, vector<Layer *> p, int todev) override;
+
+    // implementation
+    void forward() override;
+
+    void backward() override;
+
+    void resize(int batch) override;
+
+    string plot(int c) override;
 
 };
 
-/// UpSampling2D Layer
+/// UpSampling Layer (1D, 2D or 3D)
 class LUpSampling : public LinLayer {
 public:
     vector<int> size;
-    string interpolation;
+    string interpolation;  // nearest, bilinear
+    bool align_corners;
+    UpSamplingDescriptor *ud;
     static int total_layers;
 
     // constructors and clones
-    LUpSampling(Layer *parent, const vector<int> &size, string interpolation, string name, int dev, int mem);
+    LUpSampling(Layer *parent, const vector<int> &size, string interpolation, bool align_corners, string name, int dev, int mem);
+
+    ~LUpSampling();
 
     Layer *share(int c, int bs, vector<Layer *> p) override;
 
     Layer *clone(int c, int bs, vector<Layer *> p, int todev) override;
 
-    // Params are in ConvolDescriptor
-
     // implementation
     void forward() override;
 
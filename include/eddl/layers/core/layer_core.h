@@ -89,12 +89,17 @@ public:
     Tensor *E;
     Tensor *gE;
     vector<int> sind;
+    vector<int> *grows;  // Rows of gE written since the last zeroGrads (shared with the unrolled copies)
     static int total_layers;
 
     LEmbedding(Layer *parent, int vocsize, int lenght, int dim, bool mask_zeros, string name, int dev, int mem);
 
     ~LEmbedding() override;
 
+    void zeroGrads() override;
+
+    vector<int> *sparse_grad_rows(int p) override;
+
     Layer *share(int c, int bs, vector<Layer *> p) override;
 
     Layer *clone(int c, int bs, vector<Layer *> p, int todev) override;
@@ -123,6 +128,9 @@ public:
 	Tensor *gbias;
 	Tensor *acc_gbias;
 
+	// int8 inference (see Net::quantize)
+	QuantDescriptor *qd;
+
     LDense(Layer *parent, int ndim, bool use_bias, string name, int dev, int mem);
 
     ~LDense() override;
@@ -244,7 +252,8 @@ public:
     Layer *clone(int c, int bs, vector<Layer *> p, int todev) override;
 
     float df;
-    Tensor *mask;
+    Tensor *mask;  // Only used on devices without seeded dropout (nullptr on CPU)
+    uint64_t seed;  // Seed of the current training mask, regenerated in backward
 
     // implementation
     void forward() override;
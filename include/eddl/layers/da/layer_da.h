@@ -330,4 +330,25 @@ public:
     string plot(int c) override;
 };
 
+/// Fused random augmentation Layer (affine + photometric, one resampling pass)
+class LAugmentRandom : public LDataAugmentation {
+public:
+    static int total_layers;
+    AugmentDescriptor *ad;
+
+    LAugmentRandom(Layer *parent, AugmentDescriptor *ad, string name, int dev, int mem);
+
+    ~LAugmentRandom() override;
+
+    Layer *share(int c, int bs, vector<Layer *> p) override;
+
+    Layer *clone(int c, int bs, vector<Layer *> p, int todev) override;
+
+    void forward() override;
+
+    void backward() override;
+
+    string plot(int c) override;
+};
+
 #endif //EDDL_LAYER_DA_H
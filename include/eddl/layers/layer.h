@@ -45,6 +45,7 @@ public:
     bool iscloned;
     bool isnorm;
     bool isdecoder;
+    bool carry_states;  // recurrent: the previous timestep is the layer itself (see Net::decode_step)
 
     vector<Tensor *> params;
     vector<Tensor *> gradients;
@@ -109,6 +110,11 @@ public:
     virtual void reset();
     virtual int get_trainable_params_count();
     virtual void zeroGrads();
+    // Rows of gradients[p] written since the last zeroGrads (nullptr => dense gradient)
+    virtual vector<int> *sparse_grad_rows(int p) { return nullptr; }
+    // Whether forward and backward take inputs, outputs and deltas with strided samples (e.g. the
+    // slice of a concat along the channels), so they can live in place inside the concat
+    virtual bool strided_samples() { return false; }
     virtual string plot(int c) { return ""; }
 
     virtual void addchild(Layer *l) {}
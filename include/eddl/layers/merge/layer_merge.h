@@ -82,6 +82,35 @@ public:
 
 };
 
+/// MultiHeadAttention Layer
+// Compute-only: the projections of the queries, keys and values are done by the parents
+class LMultiHeadAttention : public MLayer {
+public:
+    int heads;
+    bool causal;
+    static int total_layers;
+
+    Tensor *lse;  // {batch x heads x tq}: log-sum-exp of the scores of each query, for the backward
+
+    // parents: {qkv} (self-attention) or {q, k, v}, batch x time x dim
+    LMultiHeadAttention(vector<Layer *> in, int heads, bool causal, string name, int dev, int mem);
+
+    ~LMultiHeadAttention();
+
+    void resize(int batch) override;
+
+    Layer *share(int c, int bs, vector<Layer *> p) override;
+
+    Layer *clone(int c, int bs, vector<Layer *> p, int todev) override;
+
+    void forward() override;
+
+    void backward() override;
+
+    string plot(int c) override;
+
+};
+
 /// Average Layer
 class LAverage : public MLayer {
 public:
@@ -149,6 +178,14 @@ public:
     vector<int> index;
     static int total_layers;
 
+    // Parents whose output (and delta) can live in its slice of the concat, so they write there
+    // directly and the concat copies nothing. Set by Net::plan_concat_views. A slice is contiguous
+    // when every dim before the axis is 1, otherwise its samples are strided and only the parents
+    // in strided_views (the parent and its other children take strided samples) go in place
+    vector<bool> output_views;
+    vector<bool> delta_views;
+    vector<bool> strided_views;
+
     // constructors and clones
     LConcat(vector<Layer *> in, unsigned int axis, string name, int dev, int mem);
 
@@ -163,6 +200,14 @@ public:
 
     void backward() override;
 
+    void resize(int batch) override;
+
+    bool strided_samples() override { return true; }
+
+    void view_outputs();
+
+    void view_deltas();
+
     string plot(int c) override;
 
 };
@@ -139,4 +139,106 @@ public:
 };
 
 
+/// GRU Layer
+class LGRU : public MLayer {
+public:
+    int units;
+    bool bidirectional;
+    static int total_layers;
+    bool mask_zeros;
+
+    // Gates packed per row: update, reset and candidate
+    Tensor *Wx, *gWx;  // {in x 3*units}
+    Tensor *Wh, *gWh;  // {units x 3*units}
+    Tensor *bias, *gbias;  // {3*units}, added to the input projections
+    Tensor *rbias, *grbias;  // {3*units}, added to the recurrent projections (scaled by the reset gate in the candidate)
+
+    // Step buffers, kept between batches
+    Tensor *gx;  // activated gates
+    Tensor *gh;  // recurrent projections
+    Tensor *dgx, *dgh;
+    Tensor *mask;  // mask_zeros: {batch x 1}, 0 for the zero inputs
+
+    LGRU(vector<Layer *> in, int units, bool mask_zeros, bool bidirectional, string name, int dev, int mem);
+
+    ~LGRU();
+
+    Layer *share(int c, int bs, vector<Layer *> p) override;
+
+    Layer *clone(int c, int bs, vector<Layer *> p, int todev) override;
+
+    void resize(int batch) override;
+
+    void forward() override;
+
+    void backward() override;
+
+    string plot(int c) override;
+};
+
+
+/*
+ * Sequence-level RNN/LSTM: the whole batch x time x dim sequence is a single tensor, so the net
+ * is not unrolled. The input projections of all the timesteps are a single GEMM, the recurrence
+ * runs over time-major buffers that are kept between batches, and the weight gradients are single
+ * GEMMs over all the timesteps. num_layers cells are stacked inside the layer.
+ *
+ * With mask_zeros, the sequences are padded with zeros at the end: the batch is sorted by length
+ * and packed, so each timestep only processes the prefix of sequences that are still active and
+ * the padded timesteps cost nothing.
+ */
+class LRecurrentSeq : public MLayer {
+public:
+    string cell;  // "rnn" or "lstm"
+    int units;
+    int num_layers;
+    int gates;  // lstm: input, forget, output and cell, packed in this order
+    string activation;  // rnn
+    bool return_sequences;
+    bool mask_zeros;
+    static int total_layers;
+
+    // Packed layout of the last forward: the rows of timestep t are [offset[t], offset[t]+active[t]),
+    // sequences sorted by decreasing length
+    vector<int> active;
+    vector<int> offset;
+    vector<int> packed;  // batch-major row (b*steps+t) of each packed row
+    vector<int> last;  // packed row of the last timestep of each sequence
+    int npacked;
+
+    vector<Tensor *> Wx, Wh, bias;  // per stacked layer: {in x gates*units}, {units x gates*units}, {gates*units}
+    vector<Tensor *> gWx, gWh, gbias;
+
+    // Packed buffers of the last forward (batch*steps rows, npacked used), per stacked layer
+    Tensor *xt;  // input
+    vector<Tensor *> G;  // rnn: pre-activations, lstm: activated gates
+    vector<Tensor *> H;  // outputs
+    vector<Tensor *> C;  // lstm: cell states
+
+    // Backward buffers
+    Tensor *dxt;
+    Tensor *dG;
+    vector<Tensor *> dH;
+    Tensor *dC;
+
+    LRecurrentSeq(vector<Layer *> in, string cell, int units, int num_layers, string activation, bool return_sequences, bool mask_zeros, string name, int dev, int mem);
+
+    ~LRecurrentSeq();
+
+    Layer *share(int c, int bs, vector<Layer *> p) override;
+
+    Layer *clone(int c, int bs, vector<Layer *> p, int todev) override;
+
+    void forward() override;
+
+    void backward() override;
+
+    string plot(int c) override;
+
+private:
+    void reserve(int batch, int steps);
+    void pack(int batch, int steps);
+};
+
+
 #endif //EDDL_LAYER_RECURRENT_H
@@ -0,0 +1,66 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_CHECKPOINT_H
+#define EDDL_CHECKPOINT_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+#define CHECKPOINT_VERSION 1
+
+// Training state of a net: its params (fp32) followed by the state of its optimizer
+class CheckpointSnapshot {
+public:
+    string filename;
+    string optimizer;  // Optimizer::name
+    int step;  // Optimizer::get_step
+    int nparams;  // first shapes are params, the rest optimizer state
+    vector<vector<int>> shapes;
+    vector<float> data;
+
+    CheckpointSnapshot();
+
+    void write();  // <filename>.tmp, renamed to <filename> once complete
+    void read(const string &fname);
+};
+
+// Writes snapshots from a background thread. Two snapshots are kept so the training thread
+// can fill one while the other is written; it only blocks when both are still pending.
+class CheckpointWriter {
+public:
+    CheckpointWriter();
+    ~CheckpointWriter();
+
+    CheckpointSnapshot *acquire();
+    void submit(CheckpointSnapshot *s);
+    void wait();
+
+private:
+    CheckpointSnapshot buffers[2];
+    bool busy[2];
+    deque<int> queue;
+    string error;  // of the last failed write, raised by the next acquire/wait
+    bool stop;
+
+    thread worker;
+    mutex mtx;
+    condition_variable cv;
+
+    void run();
+    void raise();
+};
+
+#endif //EDDL_CHECKPOINT_H
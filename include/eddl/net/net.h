@@ -13,12 +13,14 @@
 
 #include <string>
 #include <vector>
+#include <map>
 
 #include "eddl/layers/layer.h"
 #include "eddl/optimizers/optim.h"
 #include "eddl/losses/loss.h"
 #include "eddl/metrics/metric.h"
 #include "eddl/net/compserv.h"
+#include "eddl/net/checkpoint.h"
 
 using namespace std;
 
@@ -35,6 +37,7 @@ typedef vector<Metric *> vmetrics;
 /////////////////////////////////////////
 int isIn(Layer *l, vlayer vl, int &ind);
 int isInorig(Layer *l, vlayer vl, int &ind);
+bool is_mmap_file(const string &fname);
 
 #define MAX_THREADS 1024
 
@@ -50,6 +53,7 @@ public:
     int batch_size;
     int tr_batches;
     int inferenced_samples;
+    int valid_samples;  // Samples of the batch that count in the loss, the rest is padding (-1: all)
     int trmode;
     int mem_level; // see Computing Service
     unsigned int verbosity_level = 0;
@@ -87,6 +91,21 @@ public:
     vtensor Xs[MAX_THREADS];
     vtensor Ys[MAX_THREADS];
 
+    // Activation checkpointing (see set_checkpointing)
+    bool checkpointing;
+    vector<string> checkpoints;  // layers that keep their outputs and split vfts in segments
+    vector<int> ck_segment;  // per layer of vfts: its segment
+    vector<bool> ck_free;  // per layer of vfts: output freed between the forward and the backward
+    vector<int> ck_end;  // per segment: position in vfts of its last layer
+    vector<int> ck_pending;  // per segment: layers that have not run the backward yet
+    map<Layer *, int> ck_pos;  // position in vfts
+
+    CheckpointWriter *ckwriter;  // background writer of save_checkpoint, created on first use
+
+    // Memory-mapped weights file the params point into (see load_mmap)
+    void *mmap_base;
+    size_t mmap_size;
+
     Net();
     Net(vlayer in, vlayer out);
     Net(vector <Net *> vnets);
@@ -99,6 +118,7 @@ public:
 
     void fts();
     void bts();
+    void plan_concat_views();
     void split(int c, int todev);
     Net *unroll(int inl, int outl);
     Net *unroll_enc(int inl, int outl);
@@ -130,6 +150,16 @@ public:
     void load(const string& filename, string format="");
     void setlogfile(string fname);
 
+    // Training checkpoints: params and optimizer state, written in the background
+    void save_checkpoint(const string& filename, bool async=true);
+    void wait_checkpoint();
+    void load_checkpoint(const string& filename);
+
+    // Weights container with aligned tensors, mapped by load without copies
+    void save_mmap(const string& filename);
+    void load_mmap(const string& filename);
+    void unmap_weights();
+
 
     //Func
     void do_initialize();
@@ -146,6 +176,28 @@ public:
 
     void sync_weights();
 
+    // int8 post-training quantization of Dense/Conv layers (inference only)
+    void quantize(vtensor tin, bool per_channel=true);
+    void dequantize();
+    bool is_quantized();
+    vlayer quantizable_layers();
+    QuantDescriptor *get_quantization(Layer *l);
+    void set_quantization(Layer *l, float in_scale, bool per_channel=true);
+
+    // Activation checkpointing (training only): the outputs between checkpoints are freed by the
+    // forward and recomputed segment by segment by the backward
+    void set_checkpoints(const vector<string> &names);
+    void set_checkpointing(int every);
+    void set_checkpointing_budget(long bytes);
+    void unset_checkpointing();
+    void plan_checkpoints();
+    bool checkpointing_active();
+    void forward_layer(int i);
+    void free_segment(int s);
+    void recompute_segment(int s);
+    void materialize(Layer *l);
+    long checkpointed_bytes();
+
     // API
     void run_snets(void *(*F)(void *t));
     void forward(vector<Layer *> in);
@@ -181,6 +233,16 @@ public:
     void evaluate_recurrent(vtensor tin, vtensor tout, int bs);
     vtensor predict_recurrent(vtensor tin);
     vtensor predict(vtensor tin);
+    void predict(vtensor tin, vtensor tout, int bs=100);
+
+    // Step-wise decoding of recurrent decoders: the encoder runs once, and then the decoder layers
+    // one timestep at a time from the states of the previous one, that are kept in place
+    vtensor decode_start(vtensor tin);
+    vtensor decode_step(Tensor *tokens);
+    void decode_reorder(const vector<int> &rows);
+    void do_decode_step();
+    Tensor *decode_greedy(vtensor tin, int length);
+    Tensor *decode_beam(vtensor tin, int length, int beam);
 
 
 };
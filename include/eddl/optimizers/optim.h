@@ -30,6 +30,7 @@ public:
     vlayer layers;
     bool isshared;
     float clip_val;
+    bool sparse_rows;  // Lazy updates of the row-sparse gradients (embeddings), off by default
     Optimizer *orig;
 
     Optimizer();
@@ -37,6 +38,10 @@ public:
     void set_clip_val(float v);
     void clip();
 
+    // Only the rows present in the batch are updated, with their optimizer state (lazy updates)
+    void set_sparse_rows(bool s);
+    vector<int> *lazy_rows(Layer *l, int p);
+
     virtual void setlayers(vlayer l) {}
 
     virtual void applygrads(int batch) {}
@@ -46,6 +51,11 @@ public:
 
     virtual void change(vector<float> &p) {}
 
+    // Persistent state for checkpoints: the moments, in setlayers order, and the step count
+    virtual vtensor get_state();
+    virtual int get_step() { return 0; }
+    virtual void set_step(int t) {}
+
 };
 
 class SGD : public Optimizer {
@@ -68,6 +78,7 @@ public:
     void applygrads(int batch) override;
 
     void change(vector<float> &p) override;
+    vtensor get_state() override;
 };
 
 // ---- Adam ----
@@ -97,6 +108,9 @@ public:
     void applygrads(int batch) override;
 
     void change(vector<float> &p) override;
+    vtensor get_state() override;
+    int get_step() override;
+    void set_step(int t) override;
 };
 
 
@@ -201,6 +215,10 @@ public:
     vtensor gT;
     vtensor gT1;
 
+    // Rows of gT1 written by the last lazy update; unknown (any row) until the first one
+    vector<vector<int>> g1rows;
+    vector<bool> g1known;
+
     explicit RMSProp(float lr=0.01f, float rho=0.9f, float epsilon=1e-8f, float weight_decay=0.0f);
 
     ~RMSProp();
@@ -211,8 +229,11 @@ public:
     void setlayers(vlayer l) override;
 
     void applygrads(int batch) override;
+    void zero_stale_rows(int p, vector<int> &rows);
 
     void change(vector<float> &p) override;
+    vtensor get_state() override;
+    void set_step(int t) override;
 };
 #endif
 
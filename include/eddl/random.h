@@ -10,6 +10,8 @@
 #ifndef EDDL_RANDOM_H
 #define EDDL_RANDOM_H
 
+#include <cstdint>
+
 float gaussgen();
 void build_randn_table();
 
@@ -19,5 +21,24 @@ float signed_uniform();
 float slow_randn(float mean, float sd);
 float fast_randn(float mean, float sd, int seed);
 
+// Counter-based generator: the n-th number of a stream is a pure function of (seed, n),
+// so a random mask can be regenerated instead of being stored
+uint64_t new_seed();
+
+inline uint32_t counter_rand(uint64_t seed, uint64_t counter) {
+    // SplitMix64 finalizer over the Weyl sequence
+    uint64_t z = seed + (counter + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (uint32_t)((z ^ (z >> 31)) >> 32);
+}
+
+// Integer threshold so that P(counter_rand(s, n) >> 8 < threshold) == p
+inline uint32_t counter_rand_threshold(float p) {
+    if (p <= 0.0f) return 0;
+    if (p >= 1.0f) return 1u << 24;
+    return (uint32_t)(p * 16777216.0f);
+}
+
 
 #endif //EDDL_RANDOM_H
@@ -0,0 +1,71 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_EDDL_EXCHANGE_H
+#define EDDL_EDDL_EXCHANGE_H
+
+#include <string>
+#include <vector>
+
+#include "eddl/net/net.h"
+
+using namespace std;
+
+#define EXCHANGE_VERSION 1
+
+enum ExchangeKind {
+    EXCHANGE_GRADIENTS = 0,
+    EXCHANGE_WEIGHTS = 1
+};
+
+enum ExchangeEncoding {
+    EXCHANGE_FP32 = 0,
+    EXCHANGE_FP16 = 1,
+    EXCHANGE_TOPK = 2  // largest magnitudes only (fp32), with error feedback
+};
+
+// Trainable params (or their gradients) of the first CS device, in the order used by the
+// messages: layers in order, and the trainable params of each layer in order
+vtensor exchange_tensors(Net *net, int kind);
+
+/*
+ * Flat binary messages for the exchanges of distributed training: a header and, per trainable
+ * param, {index, size, nnz} followed by its values. No names, no protobuf.
+ *
+ * EXCHANGE_TOPK sends the ratio of values with the largest magnitude. What is not sent is kept:
+ * gradients accumulate it in a residual that is added to the next ones, and weights are sent as
+ * the delta from what the receivers already have (the weights when the encoder was created, plus
+ * the deltas sent since then).
+ */
+class ExchangeEncoder {
+public:
+    Net *net;
+    int kind;
+    int encoding;
+    float ratio;
+    vector<vector<float>> feedback;  // EXCHANGE_TOPK: residuals (gradients) or receiver weights (weights)
+
+    ExchangeEncoder(Net *net, int kind=EXCHANGE_GRADIENTS, int encoding=EXCHANGE_FP32, float ratio=0.01f);
+
+    // Returns the size of the message, at the beginning of buf (which is reused, and may be larger)
+    size_t encode(vector<char> &buf);
+
+private:
+    vector<float> host;
+    vector<float> values;
+    vector<float> mags;
+    vector<unsigned int> indices;
+};
+
+// Decodes a message into the gradients or weights of every CS device: t = scale * msg, plus t
+// when accumulating (sparse messages leave the other values at 0, or untouched when accumulating).
+// Sparse weight messages are deltas, which are always accumulated.
+void decode_exchange(Net *net, const char *buf, size_t size, float scale=1.0f, bool accumulate=false);
+
+#endif //EDDL_EDDL_EXCHANGE_H
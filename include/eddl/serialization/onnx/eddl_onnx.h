@@ -38,6 +38,10 @@
 	
 	Net* import_net_from_onnx_string(std::string* model_string, int mem=0);
 
+	// Writes the weights of an ONNX model to a weights container (see Net::load_mmap), to be
+	// loaded by the nets imported from the same file
+	void convert_onnx_to_mmap(std::string path, std::string dst, int mem=0);
+
 //#if defined(cPROTO)
 //	Net* build_net_onnx(onnx::ModelProto model, int mem);
 //#endif
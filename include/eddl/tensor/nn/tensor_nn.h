@@ -10,6 +10,8 @@
 #ifndef EDDL_TENSOR_NN_H
 #define EDDL_TENSOR_NN_H
 
+#include <cstdint>
+
 #include "eddl/tensor/tensor.h"
 #include "eddl/descriptors/descriptors.h"
 
@@ -86,6 +88,23 @@ namespace tensorNN{
     void Conv2D(ConvolDescriptor *D);
     void Conv2D_grad(ConvolDescriptor *D);
     void Conv2D_back(ConvolDescriptor *D);
+    void Conv2D_bias(Tensor *O, Tensor *bias);
+    void Conv2D_gbias(Tensor *D, Tensor *gbias);
+
+// Quantized inference (weights packed in the QuantDescriptor)
+    void QDense(Tensor *A, Tensor *B, Tensor *bias, QuantDescriptor *qd);
+    void QConv2D(ConvolDescriptor *D, QuantDescriptor *qd);
+
+// Embeddings (ind receives the word of each position; returns the number of words out of vocabulary)
+    int Embedding(Tensor *E, Tensor *I, Tensor *O, vector<int> &ind, bool mask_zeros);
+    void Embedding_back(Tensor *D, Tensor *gE, vector<int> &ind, bool mask_zeros, vector<int> &rows);
+
+// Row-sparse optimizer updates (only the listed rows are touched)
+    void ZeroRows(Tensor *A, vector<int> &rows);
+    void ClampRows(Tensor *A, vector<int> &rows, float min, float max);
+    void SGD_rows(Tensor *P, Tensor *G, Tensor *M, vector<int> &rows, float lr, float mu);
+    void Adam_rows(Tensor *P, Tensor *G, Tensor *M, Tensor *V, vector<int> &rows, float lr, float beta_1, float beta_2, float epsilon, int t);
+    void RMSProp_rows(Tensor *P, Tensor *G, Tensor *G1, vector<int> &rows, float lr, float rho, float epsilon);
 
 // MaxPool
     void MPool2D(PoolDescriptor *D);
@@ -96,10 +115,39 @@ namespace tensorNN{
     void AvgPool2D(PoolDescriptor *D);
     void AvgPool2D_back(PoolDescriptor *D);
 
+// Dropout: B = A * mask * scale, with mask ~ Bernoulli(keep) generated from (seed, index)
+    void Dropout(Tensor *A, Tensor *B, float keep, float scale, uint64_t seed);
+    void D_Dropout(Tensor *D, Tensor *PD, float keep, float scale, uint64_t seed);
+
+// LSTM cells of a timestep: G has the pre-activations of the gates (input, forget, output and
+// cell, packed per row) and is activated in place. Cprev is nullptr at the first timestep.
+// D_LSTMCell receives in dC the delta of the cell state from the next timestep and leaves the
+// one of the previous.
+    void LSTMCell(Tensor *G, Tensor *Cprev, Tensor *C, Tensor *H);
+    void D_LSTMCell(Tensor *G, Tensor *Cprev, Tensor *C, Tensor *dH, Tensor *dC, Tensor *dG);
+
+// GRU cells of a timestep: GX has the input projections of the gates (update, reset and
+// candidate, packed per row) and is activated in place, GH the recurrent ones. The reset gate
+// scales the recurrent projection of the candidate. Hprev is nullptr at the first timestep, and
+// the rows where mask (nullptr or {n x 1}) is 0 keep the previous state. D_GRUCell adds the delta
+// of the previous state to dHprev, but not the one through the recurrent weights (dGH).
+    void GRUCell(Tensor *GX, Tensor *GH, Tensor *Hprev, Tensor *H, Tensor *mask);
+    void D_GRUCell(Tensor *GX, Tensor *GH, Tensor *Hprev, Tensor *dH, Tensor *dGX, Tensor *dGH, Tensor *dHprev, Tensor *mask);
+
+// Multi-head attention: softmax(Q K^T / sqrt(dk)) V per head, with Q {b x tq x heads*dk},
+// K {b x tk x heads*dk}, V {b x tk x heads*dv} and O {b x tq x heads*dv}. With causal, query i only
+// sees the keys up to i + tk - tq. L {b x heads x tq} receives the log-sum-exp of the scores of each
+// query, which is all D_MultiHeadAttention needs to recompute them. The deltas are added to dQ, dK and dV.
+    void MultiHeadAttention(Tensor *Q, Tensor *K, Tensor *V, Tensor *O, Tensor *L, int heads, bool causal);
+    void D_MultiHeadAttention(Tensor *Q, Tensor *K, Tensor *V, Tensor *O, Tensor *L, Tensor *dO, Tensor *dQ, Tensor *dK, Tensor *dV, int heads, bool causal);
+
 // ***** Tensor operations *****************************
     void repeat_nn(Tensor *A, Tensor *B, vector<int> size);
     void d_repeat_nn(Tensor *D, Tensor *P, vector<int> size);
 
+    void upsampling(Tensor *A, Tensor *B, UpSamplingDescriptor *D);
+    void d_upsampling(Tensor *D, Tensor *A, UpSamplingDescriptor *ud);
+
     void select(Tensor *A, Tensor* B, SelDescriptor *sd);
     void select_back(Tensor *A, Tensor* B, SelDescriptor *sd);
     void set_select(Tensor *A, Tensor *B, SelDescriptor *sd);
@@ -16,6 +16,7 @@
 #include <vector>
 #include <string>
 #include <mutex>
+#include <functional>
 
 #ifdef cFPGA
 #include "eddl/hardware/fpga/xcl2.hpp"
@@ -2293,6 +2294,15 @@ public:
     */
     static void cutout_random(Tensor *A, Tensor *B, vector<float> factor_x, vector<float> factor_y, float cval=0.0f);
 
+    /**
+    *   @brief Random geometric (rotation, translation, scale, shear, flips) and photometric (brightness, contrast, grayscale) augmentation.
+    *   All the sampled transforms of a sample are composed into one affine map, so each output pixel is resampled exactly once.
+    *   @param A Input tensor.
+    *   @param B Output tensor (its spatial size may differ from A).
+    *   @param ad Descriptor with the ranges of the transformations.
+    */
+    static void augment_random(Tensor *A, Tensor *B, AugmentDescriptor *ad);
+
 
     // Linear algebra *****************************
 
@@ -2878,6 +2888,58 @@ public:
     */
     Tensor* clone();
 
+    // Views ************************************
+    // A view shares the data of its tensor (no copy, O(1)): it points to its first element and
+    // its strides need not be row-major (e.g. a transpose). copy, clone, inc and select accept
+    // non-contiguous views; the other kernels need contiguous tensors (see contiguous()).
+    // The tensor must outlive its views.
+
+    /**
+      *  @brief Check if the elements are stored in row-major order, without gaps (dims of size 1 are ignored).
+      *
+      *  @return    bool
+    */
+    bool is_contiguous();
+
+    /**
+      *  @brief Check if every sample (first dim) is contiguous, while the samples themselves can be strided.
+      *
+      *  @return    bool
+    */
+    bool samples_contiguous();
+
+    /**
+      *  @brief View of the selected indices (same syntax as select). Contiguous when only the first
+      *  selected dimension is not complete, e.g. a range of samples: {"2:5"}
+      *
+      *  @param indices  Vector of strings representing the indices to be selected. Some examples: ``"0"`` , ``":5"`` , ``":"`` , ``"3:6"``.
+      *  @return    Tensor
+    */
+    Tensor* select_view(const vector<string>& indices);
+
+    /**
+      *  @brief View with the dimensions permuted (the data is not moved)
+      *
+      *  @param dims A vector containing the new order of the dimensions.
+      *  @return    Tensor
+    */
+    Tensor* permute_view(const vector<int>& dims);
+
+    /**
+      *  @brief View with a new shape if the tensor is contiguous, a reshaped copy otherwise
+      *
+      *  @param new_shape A vector containing the new shape (-1 is inferred).
+      *  @return    Tensor
+    */
+    Tensor* reshape_view(const vector<int>& new_shape);
+
+    /**
+      *  @brief View of the whole tensor if it is contiguous, a contiguous copy otherwise
+      *
+      *  @return    Tensor
+    */
+    Tensor* contiguous();
+
     /**
       *  @brief Reallocates a tensor into this one.
       *  Replaces the pointer of this tensor, with the pointer of a reference tensor.
@@ -3247,4 +3309,27 @@ void checkCompatibility(Tensor *A, Tensor *B, const string &title);
 */
 void checkCompatibility(Tensor *A, Tensor *B, Tensor *C, const string &title);
 
+/**
+    *   @brief Check that a tensor is contiguous (not a strided view), as needed by most kernels.
+    *   @param A Input tensor.
+    *   @param title A string identifier to append to the output.
+*/
+void checkContiguous(Tensor *A, const string &title);
+
+/**
+    *   @brief Check that the samples of a tensor are contiguous, as needed by kernels that take strided batches.
+    *   @param A Input tensor.
+    *   @param title A string identifier to append to the output.
+*/
+void checkSamplesContiguous(Tensor *A, const string &title);
+
+/**
+    *   @brief Run an operation over compact copies of the tensors when some of them are strided views.
+    *   @param ts Tensors of the operation (null tensors are skipped). The last nout of them are written back.
+    *   @param nout Number of output tensors.
+    *   @param op Operation, called with the compact tensors in the same order.
+    *   @return false (and op is not called) when all the tensors are contiguous.
+*/
+bool runContiguous(const vector<Tensor*> &ts, int nout, const std::function<void(const vector<Tensor*> &)> &op);
+
 #endif //EDDL_TENSOR_H
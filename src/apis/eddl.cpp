@@ -237,11 +237,50 @@ namespace eddl {
         m->save(fname,format);
     }
 
+    void convert_weights_to_mmap(model m, const string& src, const string& dst){
+        m->load(src, "bin");
+        m->save(dst, "mmap");
+    }
+
+    void save_checkpoint(model m, const string& fname, bool async){
+        m->save_checkpoint(fname, async);
+    }
+
+    void wait_checkpoint(model m){
+        m->wait_checkpoint();
+    }
+
+    void load_checkpoint(model m, const string& fname){
+        m->load_checkpoint(fname);
+    }
+
     // Optimizer
     void setlr(model net,vector<float>p)
     {
         net->setlr(p);
     }
+    void set_checkpointing(model net, int every)
+    {
+        net->set_checkpointing(every);
+    }
+    void set_checkpointing(model net, const vector<layer> &checkpoints)
+    {
+        vector<string> names;
+        for (auto l : checkpoints) names.push_back(l->name);
+        net->set_checkpoints(names);
+    }
+    void set_checkpointing_budget(model net, float megabytes)
+    {
+        net->set_checkpointing_budget((long)(megabytes * 1024 * 1024));
+    }
+    void quantize(model net, const vector<Tensor*>& calibration, bool per_channel)
+    {
+        net->quantize(calibration, per_channel);
+    }
+    void dequantize(model net)
+    {
+        net->dequantize();
+    }
     optimizer adadelta(float lr, float rho, float epsilon, float weight_decay){
         //Todo: Implement
         return new AdaDelta(lr, rho, epsilon, weight_decay);
@@ -288,6 +327,18 @@ namespace eddl {
     {
       return m->predict(in);
     }
+    void predict(model m, const vector<Tensor *> &in, const vector<Tensor *> &out, int bs)
+    {
+      m->predict(in, out, bs);
+    }
+    Tensor *decode_greedy(model m, const vector<Tensor *> &in, int length)
+    {
+      return m->decode_greedy(in, length);
+    }
+    Tensor *decode_beam(model m, const vector<Tensor *> &in, int length, int beam)
+    {
+      return m->decode_beam(in, length, beam);
+    }
 
     // Finer methods
     vector<int> random_indices(int batch_size, int num_samples){
@@ -609,6 +660,7 @@ namespace eddl {
                int groups, vector<int> dilation_rate,string name){
         kernel_size.push_back(1);
         strides.push_back(1);
+        dilation_rate.push_back(1);
         return new LConv1D(parent, filters, kernel_size, strides, padding, groups, dilation_rate, use_bias, name, DEV_CPU, 0);
     }
 
@@ -642,8 +694,8 @@ namespace eddl {
         return new LInput(new Tensor(s), name, DEV_CPU, 0);
     }
 
-    layer UpSampling(layer parent, const vector<int> &size, string interpolation, string name){
-        return new LUpSampling(parent, size, interpolation, name, DEV_CPU, 0);
+    layer UpSampling(layer parent, const vector<int> &size, string interpolation, string name, bool align_corners){
+        return new LUpSampling(parent, size, interpolation, align_corners, name, DEV_CPU, 0);
     }
 
     layer Reshape(layer parent, const vector<int> &shape, string name){
@@ -761,6 +813,19 @@ namespace eddl {
         return new LCutoutRandom(parent, factor_x, factor_y, constant, name, DEV_CPU, 0);
     }
 
+    layer RandomAffine(layer parent, vector<float> angle, vector<float> translate, vector<float> scale, vector<float> shear, string name){
+        return RandomAugmentation(parent, angle, translate, scale, shear, 0.0f, 0.0f, {}, {}, 0.0f, "bilinear", "constant", 0.0f, name);
+    }
+
+    layer RandomAugmentation(layer parent, vector<float> angle, vector<float> translate, vector<float> scale, vector<float> shear,
+                             float flip_h, float flip_v, vector<float> brightness, vector<float> contrast, float grayscale,
+                             string interpolation, string da_mode, float constant, string name){
+        if (interpolation != "nearest" && interpolation != "bilinear") msg("Unknown interpolation (" + interpolation + ")", "RandomAugmentation");
+        auto *ad = new AugmentDescriptor(angle, translate, scale, shear, flip_h, flip_v, brightness, contrast, grayscale,
+                                         interpolation == "bilinear", getWrappingMode(da_mode), constant, DEV_CPU);
+        return new LAugmentRandom(parent, ad, name, DEV_CPU, 0);
+    }
+
     // Merge Layers
     layer Add(const vector<layer> &layers, string name){
         return new LAdd(layers, name, DEV_CPU, 0);
@@ -779,6 +844,10 @@ namespace eddl {
         return new LMatMul(layers, name, DEV_CPU, 0);
     }
 
+    layer MultiHeadAttention(const vector<layer> &layers, int heads, bool causal, string name){
+        return new LMultiHeadAttention(layers, heads, causal, name, DEV_CPU, 0);
+    }
+
     layer Maximum(const vector<layer> &layers, string name){
         return new LMaximum(layers, name, DEV_CPU, 0);
     }
@@ -1029,6 +1098,18 @@ namespace eddl {
         return new LLSTM({parent}, units, mask_zeros, bidirectional, name, DEV_CPU, 0);
     }
 
+    layer GRU(layer parent, int units, bool mask_zeros, bool bidirectional, string name){
+        return new LGRU({parent}, units, mask_zeros, bidirectional, name, DEV_CPU, 0);
+    }
+
+    layer RNNSequence(layer parent, int units, int num_layers, string activation, bool return_sequences, bool mask_zeros, string name){
+        return new LRecurrentSeq({parent}, "rnn", units, num_layers, activation, return_sequences, mask_zeros, name, DEV_CPU, 0);
+    }
+
+    layer LSTMSequence(layer parent, int units, int num_layers, bool return_sequences, bool mask_zeros, string name){
+        return new LRecurrentSeq({parent}, "lstm", units, num_layers, "tanh", return_sequences, mask_zeros, name, DEV_CPU, 0);
+    }
+
     void setDecoder(layer l)
     {
        l->isdecoder=true;
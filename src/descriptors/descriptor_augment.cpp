@@ -0,0 +1,88 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cmath>
+
+#include "eddl/descriptors/tensor_descriptors.h"
+#include "eddl/random.h"
+#include "eddl/utils.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+AugmentDescriptor::AugmentDescriptor(const vector<float>& angle, const vector<float>& translate, const vector<float>& scale,
+                                     const vector<float>& shear, float flip_h, float flip_v,
+                                     const vector<float>& brightness, const vector<float>& contrast, float grayscale,
+                                     bool bilinear, int mode, float cval, int dev) : TensorDescriptor(dev) {
+    if (!angle.empty() && angle.size() != 2) msg("The angle range must be {min, max}", "AugmentDescriptor::AugmentDescriptor");
+    if (!translate.empty() && translate.size() != 2) msg("The translation must be {max_x, max_y}", "AugmentDescriptor::AugmentDescriptor");
+    if (!scale.empty() && (scale.size() != 2 || scale[0] <= 0.0f || scale[1] <= 0.0f)) msg("The scale range must be {min, max} with positive values", "AugmentDescriptor::AugmentDescriptor");
+    if (!shear.empty() && shear.size() != 2) msg("The shear range must be {min, max}", "AugmentDescriptor::AugmentDescriptor");
+    if (!brightness.empty() && brightness.size() != 2) msg("The brightness range must be {min, max}", "AugmentDescriptor::AugmentDescriptor");
+    if (!contrast.empty() && contrast.size() != 2) msg("The contrast range must be {min, max}", "AugmentDescriptor::AugmentDescriptor");
+
+    this->angle = angle;
+    this->translate = translate;
+    this->scale = scale;
+    this->shear = shear;
+    this->flip_h = flip_h;
+    this->flip_v = flip_v;
+    this->brightness = brightness;
+    this->contrast = contrast;
+    this->grayscale = grayscale;
+    this->bilinear = bilinear;
+    this->mode = mode;
+    this->cval = cval;
+}
+
+bool AugmentDescriptor::has_photometric(){
+    return !brightness.empty() || !contrast.empty() || grayscale > 0.0f;
+}
+
+void AugmentDescriptor::sample(int batch, const vector<int>& ishape, const vector<int>& oshape){
+    // Parameters are drawn serially (the generator is not thread-safe), the resampling runs in parallel
+    affine.resize(batch * 6);
+    photometric.resize(batch * 3);
+
+    float ih = (float)ishape[2], iw = (float)ishape[3];
+    float oh = (float)oshape[2], ow = (float)oshape[3];
+
+    for (int b = 0; b < batch; b++) {
+        float theta = angle.empty() ? 0.0f : uniform(angle[0], angle[1]) * (float)M_PI / 180.0f;
+        float s = scale.empty() ? 1.0f : uniform(scale[0], scale[1]);
+        float sh = shear.empty() ? 0.0f : ::tanf(uniform(shear[0], shear[1]) * (float)M_PI / 180.0f);
+        float tx = translate.empty() ? 0.0f : uniform(-translate[0], translate[0]) * iw;
+        float ty = translate.empty() ? 0.0f : uniform(-translate[1], translate[1]) * ih;
+        float fx = (flip_h > 0.0f && uniform() < flip_h) ? -1.0f : 1.0f;
+        float fy = (flip_v > 0.0f && uniform() < flip_v) ? -1.0f : 1.0f;
+
+        // Forward map (x, y): M = R(theta) * Shear * Scale * Flip
+        float c = ::cosf(theta), sn = ::sinf(theta);
+        float m00 = (c) * s * fx,  m01 = (c * sh - sn) * s * fy;
+        float m10 = (sn) * s * fx, m11 = (sn * sh + c) * s * fy;
+
+        // Inverse map: p_in = c_in + M^-1 * (p_out - c_out - t)
+        float det = m00 * m11 - m01 * m10;
+        float i00 = m11 / det, i01 = -m01 / det;
+        float i10 = -m10 / det, i11 = m00 / det;
+
+        float cx_in = (iw - 1.0f) / 2.0f, cy_in = (ih - 1.0f) / 2.0f;
+        float cx_out = (ow - 1.0f) / 2.0f + tx, cy_out = (oh - 1.0f) / 2.0f + ty;
+
+        float *a = &affine[b * 6];
+        a[0] = i00; a[1] = i01; a[2] = cx_in - i00 * cx_out - i01 * cy_out;  // x_in = a0*x + a1*y + a2
+        a[3] = i10; a[4] = i11; a[5] = cy_in - i10 * cx_out - i11 * cy_out;  // y_in = a3*x + a4*y + a5
+
+        float *p = &photometric[b * 3];
+        p[0] = brightness.empty() ? 1.0f : uniform(brightness[0], brightness[1]);
+        p[1] = contrast.empty() ? 1.0f : uniform(contrast[0], contrast[1]);
+        p[2] = (grayscale > 0.0f && uniform() < grayscale) ? 1.0f : 0.0f;
+    }
+}
@@ -14,6 +14,8 @@
 
 #include "eddl/hardware/cpu/cpu_profile.h"
 
+#define DIRECT_CONV1D_MAX_TAPS 64
+
 #ifdef cGPU
 #include "eddl/hardware/gpu/gpu_tensor.h"
 #include "eddl/hardware/gpu/gpu_hw.h"
@@ -23,32 +25,48 @@
 #include "eddl/hardware/fpga/fpga_hw.h"
 #endif
 
-ConvolDescriptor::ConvolDescriptor() {}
+ConvolDescriptor::ConvolDescriptor() {
+    groups = 1;
+    depthwise = false;
+    direct = false;
+    dilation = {1, 1};
+    dr = dc = 1;
+}
 
-ConvolDescriptor::ConvolDescriptor(const vector<int> &ks, const vector<int> &st, const vector<int> &p, int mem) {
+ConvolDescriptor::ConvolDescriptor(const vector<int> &ks, const vector<int> &st, const vector<int> &p, int mem, int groups, const vector<int> &dilation_rate) {
     ksize = vector<int>(ks.begin(), ks.end());
     stride = vector<int>(st.begin(), st.end());
     pad = vector<int>(p.begin(), p.end());
+    dilation = vector<int>(dilation_rate.begin(), dilation_rate.end());
     mem_level=mem;
+    this->groups=groups;
+    this->depthwise=false;
+    this->direct=false;
 
     this->padding = "custom";
 
     if (ksize.size() != 3) msg("Kernels must have 3 dimensions", "ConvolDescriptor::ConvolDescriptor");
     if (stride.size() != 2) msg("Strides must have 2 dimensions", "ConvolDescriptor::ConvolDescriptor");
+    if (dilation.size() != 2) msg("Dilations must have 2 dimensions", "ConvolDescriptor::ConvolDescriptor");
 }
 
-ConvolDescriptor::ConvolDescriptor(int filters, const vector<int> &ks, const vector<int> &st, const string& p, bool ub, int mem) {
+ConvolDescriptor::ConvolDescriptor(int filters, const vector<int> &ks, const vector<int> &st, const string& p, bool ub, int mem, int groups, const vector<int> &dilation_rate) {
     if (ks.size() != 2) { msg("Kernels must have 3 dimensions", "ConvolDescriptor::ConvolDescriptor"); }
     if (st.size() != 2) { msg("Strides must have 2 dimensions", "ConvolDescriptor::ConvolDescriptor"); }
+    if (dilation_rate.size() != 2) { msg("Dilations must have 2 dimensions", "ConvolDescriptor::ConvolDescriptor"); }
 
     // Add filters to kernel_size
     ksize = vector<int>(ks);
     ksize.insert(ksize.begin(), 1, filters);
     stride = vector<int>(st.begin(), st.end());
+    dilation = vector<int>(dilation_rate.begin(), dilation_rate.end());
     use_bias=ub;
     mem_level=mem;
+    this->groups=groups;
+    this->depthwise=false;
+    this->direct=false;
 
-    if (p=="same" || p =="none" || p =="valid" || p =="zeros" || p=="same,none" || p=="none,same") {
+    if (p=="same" || p =="none" || p =="valid" || p =="zeros" || p=="causal" || p=="same,none" || p=="none,same") {
         this->padding=p;
     }else{
         cout<<p<<endl;
@@ -67,14 +85,26 @@ void ConvolDescriptor::build(Tensor *A) {
 
     I = A;
 
+    if (groups < 1) msg("Groups must be greater than 0", "ConvolDescriptor::build");
+    if ((A->shape[1] % groups) || (ksize[0] % groups)) msg("Input channels and filters must be divisible by groups", "ConvolDescriptor::build");
+
     nk = ksize[0];
     kr = ksize[1];
     kc = ksize[2];
-    kz = A->shape[1];
+    kz = A->shape[1] / groups;  // Channels seen by each filter
+    depthwise = (groups > 1) && (kz == 1);
 
     sr = stride[0];
     sc = stride[1];
 
+    dr = dilation[0];
+    dc = dilation[1];
+    if ((dr < 1) || (dc < 1)) msg("Dilations must be greater than 0", "ConvolDescriptor::build");
+
+    // Extent of the dilated kernel
+    int kre = (kr - 1) * dr + 1;
+    int kce = (kc - 1) * dc + 1;
+
     iz = A->shape[1];
     ir = A->shape[2];
     ic = A->shape[3];
@@ -83,26 +113,26 @@ void ConvolDescriptor::build(Tensor *A) {
         // Compute output
         z = nk;
         vector<int>pr; pr.push_back(pad[0]);pr.push_back(pad[1]);
-        r = compute_output(pr, ir, kr, sr);
+        r = compute_output(pr, ir, kr, sr, dr);
 
         vector<int>pc; pc.push_back(pad[2]);pc.push_back(pad[3]);
-        c = compute_output(pc, ic, kc, sc);
+        c = compute_output(pc, ic, kc, sc, dc);
 
     }else{  // Common padding (same/zeros)
         // Compute output
         z = nk;
 
-        if (padding=="same,none") r = compute_output("same", ir, kr, sr);
-        else if (padding=="none,same")  r = compute_output("none", ir, kr, sr);
-        else r = compute_output(this->padding, ir, kr, sr);
+        if (padding=="same,none") r = compute_output("same", ir, kr, sr, dr);
+        else if (padding=="none,same")  r = compute_output("none", ir, kr, sr, dr);
+        else r = compute_output(this->padding, ir, kr, sr, dr);
 
-        if (padding=="same,none") c = compute_output("none", ic, kc, sc);
-        else if (padding=="none,same")  c = compute_output("same", ic, kc, sc);
-        else c = compute_output(this->padding, ic, kc, sc);
+        if (padding=="same,none") c = compute_output("none", ic, kc, sc, dc);
+        else if (padding=="none,same")  c = compute_output("same", ic, kc, sc, dc);
+        else c = compute_output(this->padding, ic, kc, sc, dc);
 
         // Compute padding
-        vector<int> padr = compute_padding(r, ir, kr, sr, this->padding,true);  // Order: [top, bottom]
-        vector<int> padc = compute_padding(c, ic, kc, sc, this->padding,false);  // Order: [left, right]
+        vector<int> padr = compute_padding(r, ir, kre, sr, this->padding,true);  // Order: [top, bottom]
+        vector<int> padc = compute_padding(c, ic, kce, sc, this->padding,false);  // Order: [left, right]
 
         // Set padding
         pad = {padr[0], padr[1], padc[0], padc[1]};  // top, bottom, left, right
@@ -116,6 +146,10 @@ void ConvolDescriptor::build(Tensor *A) {
         msg("Invalid output shape", "ConvolDescriptor::build");
     }
 
+    // Sequences ({batch, channels, length, 1}) with few taps per filter are cheaper
+    // to convolve directly than to lower (the lowered matrix has kz*kr copies of the input)
+    direct = !depthwise && (ic == 1) && (kc == 1) && (c == 1) && (kz * kr <= DIRECT_CONV1D_MAX_TAPS);
+
     O = new Tensor(vector<int>{A->shape[0], z, r, c}, A->device);
 //    if (!mem_level) { D = new Tensor(O->shape, A->device); }
 
@@ -127,10 +161,13 @@ void ConvolDescriptor::build(Tensor *A) {
     gbias = new Tensor(vector<int>{nk}, I->device);
 
     if (I->isCPU()) {
-        // mem for ptr, lowering im2col
-        ptrI=get_fmem(A->shape[0] * r * c * kr * kc * kz,"ConvolDescriptor::build");
-	 _profile_add_tensor(A->shape[0] * r * c * kr * kc * kz);
-	 matI=Eigen::Map<Eigen::MatrixXf>(ptrI, r*c,kz*kr*kc);
+        // mem for ptr, lowering im2col (one block per group, none for direct kernels)
+        if (depthwise || direct) ptrI=nullptr;
+        else {
+            ptrI=get_fmem(A->shape[0] * r * c * kr * kc * kz * groups,"ConvolDescriptor::build");
+	     _profile_add_tensor(A->shape[0] * r * c * kr * kc * kz * groups);
+	     matI=Eigen::Map<Eigen::MatrixXf>(ptrI, r*c,kz*kr*kc);
+        }
   	 //matK=Eigen::Map<Eigen::MatrixXf>(K->ptr, kr * kc * kz, nk);
          //matgK=Eigen::Map<Eigen::MatrixXf>(gK->ptr, kr * kc * kz, nk);
         // convolution: matC=matA*matK
@@ -190,12 +227,15 @@ void ConvolDescriptor::resize(int b)
 //    if (!mem_level) D->resize(b);
 
     // Prevent overflow. (512*512*512*3*3*3 = 3,623,878,656 > MAX_INT (2,147,483,647))
-    unsigned long int l_size =  (unsigned long)(b * r * c) * (unsigned long)(kr * kc * kz);
+    unsigned long int l_size =  (unsigned long)(b * r * c) * (unsigned long)(kr * kc * kz * groups);
 
     if (I->isCPU()) {
         delete[] ptrI;
-        ptrI=get_fmem(l_size, "ConvolDescriptor::build");
-	 _profile_add_tensor(l_size);
+        ptrI=nullptr;
+        if (!depthwise && !direct) {
+            ptrI=get_fmem(l_size, "ConvolDescriptor::build");
+	     _profile_add_tensor(l_size);
+        }
     }
 #ifdef cGPU
     else if (I->isGPU()) {
@@ -232,7 +272,7 @@ void ConvolDescriptor::enable_distributed() {
 }
 
 int ConvolDescriptor::compute_output(const string& padding, int input_size, int kerkel_size, int stride, int dilation_rate){
-    if (padding=="same" || padding =="zeros") {
+    if (padding=="same" || padding =="zeros" || padding=="causal") {
         return std::ceil((float)input_size/(float)stride);
 
     }else if(padding =="valid" || padding =="none"){
@@ -273,6 +313,10 @@ vector<int> ConvolDescriptor::compute_padding(int output_size, int input_size, i
 
     }else if(padding =="valid" || padding =="none"){
         return vector<int>({0, 0});
+
+    }else if(padding =="causal"){
+        // Every output only sees the current and previous inputs
+        return vector<int>({kerkel_size - 1, 0});
     }
     else{
         cout<<padding<<endl;
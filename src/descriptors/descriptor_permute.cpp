@@ -10,6 +10,7 @@
 
 
 #include "eddl/descriptors/tensor_descriptors.h"
+#include "eddl/tensor/tensor.h"
 #include "eddl/utils.h"
 
 PermuteDescriptor::PermuteDescriptor(const vector<int>& dims, int dev) : SelDescriptor(dev) {
@@ -22,6 +23,12 @@ void PermuteDescriptor::build(vector<int> ishape){
     this->ishape = ishape;
     this->oshape = permute_shape(ishape, this->dims);
 
+    // Output dim d walks the input dim dims[d]
+    vector<int> istride = shape2stride(ishape);
+    this->strides.clear();
+    for (int d : this->dims) this->strides.push_back(istride[d]);
+    this->offset = 0;
+
     // Build indices
     this->build_indices();
 }
@@ -39,6 +46,6 @@ void PermuteDescriptor::build_indices(){
     // Delete previous allocations
     this->free_memory();
 
-    // Compute index translation (output=>input)
-    this->cpu_addresses = permute_indices(this->ishape, this->dims);
+    // Compute index translation (output=>input), only needed by the GPU/FPGA kernels
+    if (this->device != DEV_CPU) this->cpu_addresses = permute_indices(this->ishape, this->dims);
 }
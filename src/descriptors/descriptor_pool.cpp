@@ -34,7 +34,7 @@ PoolDescriptor::PoolDescriptor(const vector<int> &ks, const vector<int> &st, con
     stride = st;
     mem_level=mem;
 
-    if (p=="same" || p =="none" || p =="valid" || p =="zeros") {
+    if (p=="same" || p =="none" || p =="valid" || p =="zeros" || p=="causal") {
         this->padding=p;
     }else{
         msg("Incorrect padding type", "PoolDescriptor::PoolDescriptor");
@@ -0,0 +1,92 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cmath>
+#include <algorithm>
+
+#include "eddl/descriptors/tensor_descriptors.h"
+#include "eddl/utils.h"
+
+
+QuantDescriptor::QuantDescriptor(bool per_channel, int dev) : TensorDescriptor(dev) {
+    this->per_channel = per_channel;
+    this->calibrating = false;
+    this->packed = false;
+    this->in_absmax = 0.0f;
+    this->in_scale = 0.0f;
+    this->ins = 0;
+    this->outs = 0;
+}
+
+void QuantDescriptor::observe(const float *ptr, int size){
+    float m = in_absmax;
+    #pragma omp parallel for reduction(max:m)
+    for (int i = 0; i < size; i++) {
+        float v = std::fabs(ptr[i]);
+        if (v > m) m = v;
+    }
+    in_absmax = m;
+}
+
+void QuantDescriptor::calibrate(){
+    // An all-zero calibration range still needs a valid scale
+    in_scale = (in_absmax > 0.0f) ? in_absmax / 127.0f : 1.0f;
+    calibrating = false;
+    packed = false;
+}
+
+bool QuantDescriptor::ready(){
+    return !calibrating && in_scale > 0.0f;
+}
+
+void QuantDescriptor::pack(const float *W, int ins, int outs, bool in_major){
+    // in_major: W is [ins x outs] (Dense), else [outs x ins] (Conv filters)
+    this->ins = ins;
+    this->outs = outs;
+    qW.resize((size_t)ins * outs);
+    w_scale.assign(outs, 0.0f);
+    w_sum.assign(outs, 0);
+
+    float tmax = 0.0f;
+    for (int n = 0; n < outs; n++) {
+        float m = 0.0f;
+        for (int k = 0; k < ins; k++) {
+            float v = std::fabs(in_major ? W[(size_t)k * outs + n] : W[(size_t)n * ins + k]);
+            if (v > m) m = v;
+        }
+        w_scale[n] = m;
+        tmax = std::max(tmax, m);
+    }
+    if (!per_channel) std::fill(w_scale.begin(), w_scale.end(), tmax);
+
+    #pragma omp parallel for
+    for (int n = 0; n < outs; n++) {
+        float s = (w_scale[n] > 0.0f) ? w_scale[n] / 127.0f : 1.0f;
+        float inv = 1.0f / s;
+        int32_t sum = 0;
+        for (int k = 0; k < ins; k++) {
+            float v = (in_major ? W[(size_t)k * outs + n] : W[(size_t)n * ins + k]) * inv;
+            v = std::min(127.0f, std::max(-127.0f, v));
+            int8_t q = (int8_t)std::lrintf(v);
+            qW[(size_t)n * ins + k] = q;
+            sum += q;
+        }
+        w_scale[n] = s;
+        w_sum[n] = sum;
+    }
+    packed = true;
+}
+
+void QuantDescriptor::quantize(const float *ptr, int8_t *q, int size){
+    float inv = 1.0f / in_scale;
+    for (int i = 0; i < size; i++) {
+        float v = std::min(127.0f, std::max(-127.0f, ptr[i] * inv));
+        q[i] = (int8_t)std::lrintf(v);
+    }
+}
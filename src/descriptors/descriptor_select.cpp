@@ -9,14 +9,16 @@
 
 
 #include "eddl/descriptors/tensor_descriptors.h"
+#include "eddl/tensor/tensor.h"
 #include "eddl/utils.h"
 
 SelDescriptor::SelDescriptor(int dev) : TensorDescriptor(dev) {
-
+    this->offset = 0;
 }
 
 SelDescriptor::SelDescriptor(const vector<string>& indices, int dev) : TensorDescriptor(dev) {
     this->indices = vector<string>(indices);
+    this->offset = 0;
 }
 
 void SelDescriptor::build(vector<int> ishape){
@@ -27,6 +29,12 @@ void SelDescriptor::build(vector<int> ishape){
     this->ishape = ishape;
     this->oshape = indices2shape(this->idxs_range);
 
+    // Each range starts at its first index and walks the input dim
+    vector<int> istride = shape2stride(ishape);
+    this->strides = istride;
+    this->offset = 0;
+    for (int d = 0; d < this->idxs_range.size(); d++) this->offset += this->idxs_range[d][0] * istride[d];
+
     // Build indices
     this->build_indices();
 }
@@ -49,6 +57,6 @@ void SelDescriptor::build_indices(){
     // Delete previous allocations
     this->free_memory();
 
-    // Compute index translation (output=>input)
-    this->cpu_addresses = ranges2indices(this->ishape, this->idxs_range);
+    // Compute index translation (output=>input), only needed by the GPU/FPGA kernels
+    if (this->device != DEV_CPU) this->cpu_addresses = ranges2indices(this->ishape, this->idxs_range);
 }
@@ -34,11 +34,13 @@ TensorDescriptor::~TensorDescriptor() {
 void TensorDescriptor::free_memory() {
     if (this->cpu_addresses != nullptr) {
         delete[] this->cpu_addresses;
+        this->cpu_addresses = nullptr;
     }
 
 #ifdef cGPU
     if (this->gpu_addresses != nullptr){
         gpu_delete_tensor_int(this->device, this->gpu_addresses);  // TODO: Ugly hotfix!
+        this->gpu_addresses = nullptr;
       }
 #endif
 
@@ -0,0 +1,89 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cmath>
+#include <algorithm>
+
+#include "eddl/descriptors/tensor_descriptors.h"
+#include "eddl/utils.h"
+
+
+UpSamplingDescriptor::UpSamplingDescriptor(const vector<int>& size, bool bilinear, bool align_corners, int dev) : TensorDescriptor(dev) {
+    if (size.empty() || size.size() > 3) msg("Only 1D, 2D and 3D upsampling are supported", "UpSamplingDescriptor::UpSamplingDescriptor");
+    for (int s : size)
+        if (s < 1) msg("Upsampling factors must be positive", "UpSamplingDescriptor::UpSamplingDescriptor");
+
+    this->size = size;
+    this->bilinear = bilinear;
+    this->align_corners = align_corners;
+}
+
+void UpSamplingDescriptor::build(const vector<int>& ishape){
+    int naxes = size.size();
+    if (ishape.size() != naxes + 2) msg("The input must have " + to_string(naxes + 2) + " dimensions (batch, channels, spatial)", "UpSamplingDescriptor::build");
+
+    this->ishape = ishape;
+    this->oshape = ishape;
+    for (int a = 0; a < naxes; a++) oshape[a + 2] = ishape[a + 2] * size[a];
+
+    i0.assign(naxes, vector<int>());
+    i1.assign(naxes, vector<int>());
+    w1.assign(naxes, vector<float>());
+    bstart.assign(naxes, vector<int>());
+    bidx.assign(naxes, vector<int>());
+    bw.assign(naxes, vector<float>());
+
+    for (int a = 0; a < naxes; a++) {
+        int in = ishape[a + 2], out = oshape[a + 2];
+        i0[a].resize(out);
+        i1[a].resize(out);
+        w1[a].resize(out);
+
+        for (int j = 0; j < out; j++) {
+            // Source coordinate of output j
+            float x;
+            if (align_corners) x = (out > 1) ? (float)j * (in - 1) / (out - 1) : 0.0f;
+            else if (bilinear) x = ((float)j + 0.5f) * in / out - 0.5f;
+            else x = (float)j * in / out;  // nearest: floor(j/size), the repeat of the old kernel
+
+            if (bilinear) {
+                x = std::min(std::max(x, 0.0f), (float)(in - 1));
+                int p = (int)x;
+                i0[a][j] = p;
+                i1[a][j] = std::min(p + 1, in - 1);
+                w1[a][j] = x - p;
+            } else {
+                int p = align_corners ? (int)std::floor(x + 0.5f) : (int)x;
+                i0[a][j] = i1[a][j] = std::min(p, in - 1);
+                w1[a][j] = 0.0f;
+            }
+        }
+
+        // Transpose the tables, so the backward gathers the deltas instead of scattering them
+        vector<vector<pair<int, float>>> rows(in);
+        for (int j = 0; j < out; j++) {
+            rows[i0[a][j]].emplace_back(j, 1.0f - w1[a][j]);
+            if (bilinear && (w1[a][j] != 0.0f)) rows[i1[a][j]].emplace_back(j, w1[a][j]);
+        }
+        bstart[a].push_back(0);
+        for (int i = 0; i < in; i++) {
+            for (auto &e : rows[i]) {
+                bidx[a].push_back(e.first);
+                bw[a].push_back(e.second);
+            }
+            bstart[a].push_back(bidx[a].size());
+        }
+    }
+}
+
+void UpSamplingDescriptor::resize(int b){
+    // The tables do not depend on the batch; the scratch buffers grow on demand
+    ishape[0] = b;
+    oshape[0] = b;
+}
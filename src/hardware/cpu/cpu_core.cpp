@@ -11,6 +11,7 @@
 #include "eddl/profiling.h"
 #include <algorithm>
 #include <numeric>
+#include <cstring>
 
 int num_instances[_NUM_CPU_FUNCS];
 float mb_memory_needed;
@@ -163,6 +164,22 @@ case _CPU_AVGPOOL2D              : strcpy(name, "avgpool2d"); break;
 case _CPU_AVGPOOL2D_BACK         : strcpy(name, "avgpool2d_back"); break;
 case _CPU_REPEAT_NN              : strcpy(name, "repeat_nn"); break;
 case _CPU_D_REPEAT_NN            : strcpy(name, "d_repeat_nn"); break;
+case _CPU_DROPOUT                : strcpy(name, "dropout"); break;
+case _CPU_D_DROPOUT              : strcpy(name, "d_dropout"); break;
+case _CPU_AUGMENT_RANDOM         : strcpy(name, "augment_random"); break;
+case _CPU_QDENSE                 : strcpy(name, "qdense"); break;
+case _CPU_QCONV2D                : strcpy(name, "qconv2D"); break;
+case _CPU_EMBEDDING              : strcpy(name, "embedding"); break;
+case _CPU_EMBEDDING_BACK         : strcpy(name, "embedding_back"); break;
+case _CPU_SPARSE_UPDATE          : strcpy(name, "sparse_update"); break;
+case _CPU_UPSAMPLING             : strcpy(name, "upsampling"); break;
+case _CPU_D_UPSAMPLING           : strcpy(name, "d_upsampling"); break;
+case _CPU_LSTM_CELL              : strcpy(name, "lstm_cell"); break;
+case _CPU_D_LSTM_CELL            : strcpy(name, "d_lstm_cell"); break;
+case _CPU_GRU_CELL               : strcpy(name, "gru_cell"); break;
+case _CPU_D_GRU_CELL             : strcpy(name, "d_gru_cell"); break;
+case _CPU_ATTENTION              : strcpy(name, "attention"); break;
+case _CPU_D_ATTENTION            : strcpy(name, "d_attention"); break;
 default                          : strcpy(name, "?????"); break;
 }
 }
@@ -216,10 +233,13 @@ void cpu_transpose(Tensor * A, Tensor * B) {
 
 void cpu_copy(Tensor * A, Tensor * B){
     _profile(_CPU_COPY, 0);
-    #pragma omp parallel for
-    for (int i = 0; i < A->size; i++){
-        B->ptr[i] = A->ptr[i];
+    if (A->is_contiguous() && B->is_contiguous()) {
+        #pragma omp parallel for
+        for (int i = 0; i < A->size; i++){
+            B->ptr[i] = A->ptr[i];
+        }
     }
+    else cpu_copy_strided(A, B, false);
     _profile(_CPU_COPY, 1);
 }
 
@@ -258,38 +278,138 @@ void cpu_fill(Tensor * A, int aini, int aend, Tensor * B, int bini, int bend, in
 }
 
 
-void cpu_select(Tensor *A, Tensor *B, SelDescriptor *sd){
-    _profile(_CPU_SELECT, 0);
+// Strided copies ****************************
+// dense (row-major over shape) <-> strided (the element at index (i0, i1, ...) is at
+// i0*strides[0] + i1*strides[1] + ...). Select and permute never map two elements to the
+// same strided position, so every part runs in parallel (also when accumulating)
+
+#define STRIDED_TILE 16
+
+template<bool gather, bool accumulate>
+static inline void strided_op(float *s, float *d) {
+    if (gather) { if (accumulate) *d += *s; else *d = *s; }
+    else { if (accumulate) *s += *d; else *s = *d; }
+}
+
+template<bool gather, bool accumulate>
+static void strided_copy(float *strided, float *dense, const vector<int> &sh, const vector<int> &st) {
+    int n = sh.size();
+    int cols = sh[n - 1];
+    long cstride = st[n - 1];
+
+    // The inner two dims are swapped (contiguous columns in the strided side): tiled transpose
+    if ((n >= 2) && (cstride != 1) && (st[n - 2] == 1)) {
+        int rows = sh[n - 2];
+        long outer = 1;
+        for (int d = 0; d < n - 2; d++) outer *= sh[d];
+        int rtiles = (rows + STRIDED_TILE - 1) / STRIDED_TILE;
+        int ctiles = (cols + STRIDED_TILE - 1) / STRIDED_TILE;
+        long ntiles = outer * rtiles * ctiles;
+
+        #pragma omp parallel for
+        for (long t = 0; t < ntiles; t++) {
+            long o = t / ((long)rtiles * ctiles);
+            int r0 = (int)((t / ctiles) % rtiles) * STRIDED_TILE;
+            int c0 = (int)(t % ctiles) * STRIDED_TILE;
+            int r1 = std::min(rows, r0 + STRIDED_TILE);
+            int c1 = std::min(cols, c0 + STRIDED_TILE);
+
+            long base = 0, rem = o;
+            for (int d = n - 3; d >= 0; d--) { base += (rem % sh[d]) * st[d]; rem /= sh[d]; }
+            float *s = strided + base;
+            float *dd = dense + o * rows * cols;
+
+            // Walk the side that is written contiguously
+            if (gather) {
+                for (int r = r0; r < r1; r++) {
+                    float *dr = dd + (long)r * cols;
+                    for (int c = c0; c < c1; c++) strided_op<gather, accumulate>(s + r + c * cstride, dr + c);
+                }
+            } else {
+                for (int c = c0; c < c1; c++) {
+                    float *sc = s + c * cstride;
+                    for (int r = r0; r < r1; r++) strided_op<gather, accumulate>(sc + r, dd + (long)r * cols + c);
+                }
+            }
+        }
+        return;
+    }
+
+    // Rows of the last dim: contiguous runs or a single stride
+    long nrows = 1;
+    for (int d = 0; d < n - 1; d++) nrows *= sh[d];
+
     #pragma omp parallel for
-    for (int i = 0; i < B->size; i++) {
-        B->ptr[i] = A->ptr[sd->cpu_addresses[i]];
+    for (long i = 0; i < nrows; i++) {
+        long base = 0, rem = i;
+        for (int d = n - 2; d >= 0; d--) { base += (rem % sh[d]) * st[d]; rem /= sh[d]; }
+        float *s = strided + base;
+        float *dd = dense + i * cols;
+
+        if ((cstride == 1) && !accumulate) {
+            if (gather) std::memcpy(dd, s, cols * sizeof(float));
+            else std::memcpy(s, dd, cols * sizeof(float));
+        } else if (cstride == 1) {
+            for (int k = 0; k < cols; k++) strided_op<gather, accumulate>(s + k, dd + k);
+        } else {
+            for (int k = 0; k < cols; k++) strided_op<gather, accumulate>(s + k * cstride, dd + k);
+        }
     }
+}
+
+void cpu_strided_copy(float *strided, float *dense, const vector<int> &shape, const vector<int> &strides, bool gather, bool accumulate){
+    // Drop the dims of size 1, and merge the dims that are also contiguous in the strided side
+    vector<int> sh, st;
+    for (int d = 0; d < shape.size(); d++) {
+        if (shape[d] == 0) return;
+        if (shape[d] == 1) continue;
+        if (!sh.empty() && (st.back() == strides[d] * shape[d])) {
+            sh.back() *= shape[d];
+            st.back() = strides[d];
+        } else {
+            sh.push_back(shape[d]);
+            st.push_back(strides[d]);
+        }
+    }
+    if (sh.empty()) { sh.push_back(1); st.push_back(1); }
+
+    if (gather && accumulate) strided_copy<true, true>(strided, dense, sh, st);
+    else if (gather) strided_copy<true, false>(strided, dense, sh, st);
+    else if (accumulate) strided_copy<false, true>(strided, dense, sh, st);
+    else strided_copy<false, false>(strided, dense, sh, st);
+}
+
+void cpu_copy_strided(Tensor *A, Tensor *B, bool accumulate){
+    if (B->is_contiguous()) cpu_strided_copy(A->ptr, B->ptr, A->shape, A->stride, true, accumulate);
+    else if (A->is_contiguous()) cpu_strided_copy(B->ptr, A->ptr, B->shape, B->stride, false, accumulate);
+    else {
+        // Both are views: through a dense copy of A
+        vector<float> dense(A->size);
+        cpu_strided_copy(A->ptr, dense.data(), A->shape, A->stride, true, false);
+        cpu_strided_copy(B->ptr, dense.data(), B->shape, B->stride, false, accumulate);
+    }
+}
+
+void cpu_select(Tensor *A, Tensor *B, SelDescriptor *sd){
+    _profile(_CPU_SELECT, 0);
+    cpu_strided_copy(A->ptr + sd->offset, B->ptr, B->shape, sd->strides, true, false);
     _profile(_CPU_SELECT, 1);
 }
 
 void cpu_select_back(Tensor *A, Tensor *B, SelDescriptor *sd){
     _profile(_CPU_SELECT_BACK, 0);
-    #pragma omp parallel for
-    for (int i = 0; i < A->size; i++) {  // walk stride
-        B->ptr[sd->cpu_addresses[i]] += A->ptr[i];  // delta_parent += delta
-    }
+    cpu_strided_copy(B->ptr + sd->offset, A->ptr, A->shape, sd->strides, false, true);  // delta_parent += delta
     _profile(_CPU_SELECT_BACK, 1);
 }
 
 void cpu_set_select(Tensor *A, Tensor *B, SelDescriptor *sd){
     _profile(_CPU_SET_SELECT, 0);
-    #pragma omp parallel for
-    for (int i = 0; i < B->size; i++) {
-        A->ptr[sd->cpu_addresses[i]] = B->ptr[i];
-    }
+    cpu_strided_copy(A->ptr + sd->offset, B->ptr, B->shape, sd->strides, false, false);
     _profile(_CPU_SET_SELECT, 1);
 }
 void cpu_set_select_back(Tensor *A, Tensor *B, SelDescriptor *sd){
     _profile(_CPU_SET_SELECT_BACK, 0);
-    #pragma omp parallel for
-    for (int i = 0; i < B->size; i++) {
-        B->ptr[i] += A->ptr[sd->cpu_addresses[i]];
-    }
+    cpu_strided_copy(A->ptr + sd->offset, B->ptr, B->shape, sd->strides, true, true);
     _profile(_CPU_SET_SELECT_BACK, 1);
 }
 
@@ -298,13 +418,13 @@ void cpu_select(Tensor * A, Tensor * B, vector<int> sind, int ini, int end,bool
     _profile(_CPU_SELECT2, 0);
     int s = A->size / A->shape[0];
 
+    // The samples of A are contiguous, but may be strided (see Tensor::select)
 #pragma omp parallel for
     for (int i = ini; i < end; i++) {
-        int p  = sind[i] * s;
+        long int p  = (long int)sind[i] * A->stride[0];
         int pb = (i - ini) * s;
-        for (int j = 0; j < s; j++, p++, pb++)
-            if ((mask_zeros)&&(sind[i]==0)) B->ptr[p]=0;
-            else B->ptr[pb] = A->ptr[p];
+        if ((mask_zeros)&&(sind[i]==0)) std::memset(B->ptr + pb, 0, s * sizeof(float));
+        else std::memcpy(B->ptr + pb, A->ptr + p, s * sizeof(float));
     }
     _profile(_CPU_SELECT2, 1);
 }
@@ -329,29 +449,63 @@ void cpu_deselect(Tensor * A, Tensor * B, vector<int> sind, int ini, int end,int
 
 void cpu_concat(Tensor *A, vector<Tensor*> t, unsigned int axis, bool derivative){
     _profile(_CPU_CONCAT, 0);
-  // Walk through all the tensors to concat one axis (once)
-    unsigned int offset = 0;
-    unsigned int src_stride = 0;
-    int steps = A->stride[axis] * A->shape[axis];  // Equivalent to A->stride[axis-1], but without the negative index problem
+    // Every tensor goes to its slice of A along the axis, which has the strides of A
+    bool contiguous = A->is_contiguous();
+    unsigned int offset = 0;  // along the axis
 
-    // Walk through each tensor
     for (unsigned int i = 0; i < t.size(); i++) {
-        offset += src_stride;
-        src_stride = t[i]->stride[axis] * t[i]->shape[axis];
-
-        // Copy n bytes from src to dest
-        float *dest = A->ptr + offset;
+        float *dest = A->ptr + (size_t)offset * A->stride[axis];
         float *src = t[i]->ptr;
-
-        // Walk tensor i
+        offset += t[i]->shape[axis];
+
+        // Already in place (a view of its slice)
+        bool in_place = (src == dest);
+        for (int d = 0; d < A->ndim; d++)
+            if ((t[i]->shape[d] != 1) && (t[i]->stride[d] != A->stride[d])) in_place = false;
+        if (in_place) continue;
+
+        if (contiguous && t[i]->is_contiguous()) {
+            // A sequence of contiguous blocks (one per index of the dims before the axis), each one
+            // copied to the same position of the corresponding block of A
+            int steps = A->stride[axis] * A->shape[axis];  // Equivalent to A->stride[axis-1], but without the negative index problem
+            int nblocks = A->size / steps;
+            int block = t[i]->size / nblocks;
+
+            if (nblocks == 1) {
+                if (derivative) {
 #pragma omp parallel for
-        for (int j = 0; j < t[i]->size; j++) {
-            unsigned int k = j % src_stride;  // Pos (index) in the stride (src)
-            unsigned int stride_idx = j / src_stride;  // Index of the stride (src/dst)
-            unsigned int dest_offset = stride_idx * steps;  // Offset in dest
+                    for (int k = 0; k < block; k++) src[k] += dest[k];
+                } else {
+                    std::memcpy(dest, src, block * sizeof(float));
+                }
+                continue;
+            }
 
-            if(derivative){ src[j] += dest[dest_offset + k]; }
-            else{ dest[dest_offset + k] = src[j]; }
+#pragma omp parallel for
+            for (int b = 0; b < nblocks; b++) {
+                float *d = dest + (size_t)b * steps;
+                float *s = src + (size_t)b * block;
+                if (derivative) {
+                    for (int k = 0; k < block; k++) s[k] += d[k];
+                } else {
+                    std::memcpy(d, s, block * sizeof(float));
+                }
+            }
+        }
+        else if (t[i]->is_contiguous()) {
+            // A is a strided view (e.g. a concat inside another one)
+            cpu_strided_copy(dest, src, t[i]->shape, A->stride, derivative, derivative);
+        }
+        else {
+            // A strided tensor out of place: through a dense copy
+            vector<float> dense(t[i]->size);
+            if (derivative) {
+                cpu_strided_copy(dest, dense.data(), t[i]->shape, A->stride, true, false);
+                cpu_strided_copy(src, dense.data(), t[i]->shape, t[i]->stride, false, true);
+            } else {
+                cpu_strided_copy(src, dense.data(), t[i]->shape, t[i]->stride, true, false);
+                cpu_strided_copy(dest, dense.data(), t[i]->shape, A->stride, false, false);
+            }
         }
     }
     _profile(_CPU_CONCAT, 1);
@@ -409,3 +409,128 @@ void cpu_cutout_random(Tensor *A, Tensor *B, vector<float> factor_x, vector<floa
     }
     _profile(_CPU_CUTOUT_RANDOM, 0);
 }
+
+
+// CPU: Fused augmentation (single resampling pass) ********************************************
+static inline float cpu_augment_fetch(const float *img, int h, int w, int y, int x, int mode, float constant, float original){
+    if (y >= 0 && y < h && x >= 0 && x < w) return img[y * w + x];
+    if (mode == WrappingMode::Nearest) {
+        y = y < 0 ? 0 : (y >= h ? h - 1 : y);
+        x = x < 0 ? 0 : (x >= w ? w - 1 : x);
+        return img[y * w + x];
+    } else if (mode == WrappingMode::Original) {
+        return original;
+    }
+    return constant;
+}
+
+void cpu_augment_random(Tensor *A, Tensor *B, AugmentDescriptor *ad){
+    _profile(_CPU_AUGMENT_RANDOM, 0);
+    const int channels = B->shape[1];
+    const int ih = A->shape[2], iw = A->shape[3];
+    const int oh = B->shape[2], ow = B->shape[3];
+    const bool same_size = (ih == oh && iw == ow);
+    const bool photometric = ad->has_photometric();
+
+    ad->sample(B->shape[0], A->shape, B->shape);
+
+#pragma omp parallel for
+    for(int b=0; b<B->shape[0]; b++) {
+        const float *a = &ad->affine[b * 6];
+        const float *p = &ad->photometric[b * 3];
+        const float *src = A->ptr + b * A->stride[0];
+        float *dst = B->ptr + b * B->stride[0];
+
+        // Contrast blends with the mean intensity of the (brightness-adjusted) sample
+        float mean = 0.0f;
+        if (p[1] != 1.0f) {
+            const int isize = ih * iw;
+            double acc = 0.0;
+            for (int i = 0; i < channels * isize; i++) acc += src[i];
+            mean = (float)(acc / (double)(channels * isize)) * p[0];
+        }
+
+        // One output row for all the channels, so photometric ops see every channel of a pixel at once
+        vector<float> row(channels * ow);
+
+        for (int Bi = 0; Bi < oh; Bi++) {
+            // Source coordinates are linear along the row: (x0 + a0*j, y0 + a3*j)
+            const float x0 = a[1] * Bi + a[2];
+            const float y0 = a[4] * Bi + a[5];
+
+            // The whole row reads inside the image => branch-free (vectorizable) inner loop
+            const float x_end = x0 + a[0] * (ow - 1), y_end = y0 + a[3] * (ow - 1);
+            const float lim = ad->bilinear ? 1.0f : 0.5f;
+            bool interior = ::fminf(x0, x_end) >= 0.0f && ::fmaxf(x0, x_end) < (float)iw - lim &&
+                            ::fminf(y0, y_end) >= 0.0f && ::fmaxf(y0, y_end) < (float)ih - lim;
+
+            for (int c = 0; c < channels; c++) {
+                const float *img = src + c * A->stride[1];
+                const float *orig = same_size ? img + Bi * iw : nullptr;
+                float *out = &row[c * ow];
+
+                if (interior) {
+                    if (ad->bilinear) {
+#pragma omp simd
+                        for (int Bj = 0; Bj < ow; Bj++) {
+                            float x = x0 + a[0] * Bj, y = y0 + a[3] * Bj;
+                            int xi = (int)x, yi = (int)y;
+                            float fx = x - (float)xi, fy = y - (float)yi;
+                            const float *q = img + yi * iw + xi;
+                            float top = q[0] + fx * (q[1] - q[0]);
+                            float bot = q[iw] + fx * (q[iw + 1] - q[iw]);
+                            out[Bj] = top + fy * (bot - top);
+                        }
+                    } else {
+#pragma omp simd
+                        for (int Bj = 0; Bj < ow; Bj++) {
+                            int xi = (int)(x0 + a[0] * Bj + 0.5f);
+                            int yi = (int)(y0 + a[3] * Bj + 0.5f);
+                            out[Bj] = img[yi * iw + xi];
+                        }
+                    }
+                } else {
+                    for (int Bj = 0; Bj < ow; Bj++) {
+                        float x = x0 + a[0] * Bj, y = y0 + a[3] * Bj;
+                        float o = orig != nullptr ? orig[Bj] : ad->cval;
+                        if (ad->bilinear) {
+                            int xi = (int)::floorf(x), yi = (int)::floorf(y);
+                            float fx = x - (float)xi, fy = y - (float)yi;
+                            float q00 = cpu_augment_fetch(img, ih, iw, yi, xi, ad->mode, ad->cval, o);
+                            float q01 = cpu_augment_fetch(img, ih, iw, yi, xi + 1, ad->mode, ad->cval, o);
+                            float q10 = cpu_augment_fetch(img, ih, iw, yi + 1, xi, ad->mode, ad->cval, o);
+                            float q11 = cpu_augment_fetch(img, ih, iw, yi + 1, xi + 1, ad->mode, ad->cval, o);
+                            float top = q00 + fx * (q01 - q00);
+                            float bot = q10 + fx * (q11 - q10);
+                            out[Bj] = top + fy * (bot - top);
+                        } else {
+                            int xi = (int)::floorf(x + 0.5f), yi = (int)::floorf(y + 0.5f);
+                            out[Bj] = cpu_augment_fetch(img, ih, iw, yi, xi, ad->mode, ad->cval, o);
+                        }
+                    }
+                }
+            }
+
+            // Photometric ops on the resampled row: grayscale -> brightness -> contrast
+            if (photometric) {
+                if (p[2] != 0.0f && channels == 3) {
+                    float *r = &row[0], *g = &row[ow], *bl = &row[2 * ow];
+#pragma omp simd
+                    for (int Bj = 0; Bj < ow; Bj++) {
+                        float v = 0.299f * r[Bj] + 0.587f * g[Bj] + 0.114f * bl[Bj];
+                        r[Bj] = v; g[Bj] = v; bl[Bj] = v;
+                    }
+                }
+                const float k = p[0] * p[1];
+                const float offset = (1.0f - p[1]) * mean;
+#pragma omp simd
+                for (int i = 0; i < channels * ow; i++) row[i] = row[i] * k + offset;
+            }
+
+            for (int c = 0; c < channels; c++) {
+                std::copy(row.begin() + c * ow, row.begin() + (c + 1) * ow, dst + c * B->stride[1] + Bi * ow);
+            }
+        }
+    }
+    _profile(_CPU_AUGMENT_RANDOM, 1);
+}
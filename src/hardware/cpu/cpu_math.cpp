@@ -230,7 +230,10 @@ void cpu_add(float scA, Tensor *A, float scB, Tensor *B, Tensor *C, int incC) {
 
 
 void cpu_inc(Tensor *A, Tensor *B) {
-
+    if (!A->is_contiguous() || !B->is_contiguous()) {
+        cpu_copy_strided(A, B, true);
+        return;
+    }
 
     #pragma omp parallel for
     for (int i = 0; i < A->size; i++){
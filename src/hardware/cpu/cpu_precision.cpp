@@ -0,0 +1,110 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstring>
+#include <cstdint>
+
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
+
+#include "eddl/hardware/cpu/cpu_tensor.h"
+
+// Bit-level helpers: the library is built with -ffast-math, so NaN/Inf checks
+// must not rely on floating point comparisons
+
+static inline uint32_t float_bits(float v){
+    uint32_t u;
+    std::memcpy(&u, &v, sizeof(u));
+    return u;
+}
+
+static inline float bits_float(uint32_t u){
+    float v;
+    std::memcpy(&v, &u, sizeof(v));
+    return v;
+}
+
+uint16_t cpu_float_to_fp16(float v){
+#ifdef __F16C__
+    return _cvtss_sh(v, 0);
+#else
+    uint32_t u = float_bits(v);
+    uint32_t sign = (u >> 16) & 0x8000u;
+    int32_t exp = (int32_t)((u >> 23) & 0xFF) - 127 + 15;
+    uint32_t mant = u & 0x7FFFFFu;
+
+    if (((u >> 23) & 0xFF) == 0xFF) {  // Inf/NaN
+        return (uint16_t)(sign | 0x7C00u | (mant ? 0x200u : 0u));
+    }
+    if (exp >= 31) {  // Overflow
+        return (uint16_t)(sign | 0x7C00u);
+    }
+    if (exp <= 0) {  // Subnormal or zero
+        if (exp < -10) return (uint16_t)sign;
+        mant |= 0x800000u;
+        uint32_t shift = (uint32_t)(14 - exp);
+        uint32_t half = mant >> shift;
+        uint32_t rem = mant & ((1u << shift) - 1u);
+        uint32_t mid = 1u << (shift - 1);
+        if (rem > mid || (rem == mid && (half & 1u))) half++;
+        return (uint16_t)(sign | half);
+    }
+    uint32_t half = sign | ((uint32_t)exp << 10) | (mant >> 13);
+    uint32_t rem = mant & 0x1FFFu;
+    if (rem > 0x1000u || (rem == 0x1000u && (half & 1u))) half++;  // May carry into the exponent (correct)
+    return (uint16_t)half;
+#endif
+}
+
+float cpu_fp16_to_float(uint16_t v){
+#ifdef __F16C__
+    return _cvtsh_ss(v);
+#else
+    uint32_t sign = ((uint32_t)v & 0x8000u) << 16;
+    uint32_t exp = ((uint32_t)v >> 10) & 0x1Fu;
+    uint32_t mant = (uint32_t)v & 0x3FFu;
+
+    if (exp == 0x1Fu) return bits_float(sign | 0x7F800000u | (mant << 13));
+    if (exp == 0) {
+        if (mant == 0) return bits_float(sign);
+        // Subnormal: normalize
+        exp = 1;
+        while ((mant & 0x400u) == 0) { mant <<= 1; exp--; }
+        mant &= 0x3FFu;
+    }
+    return bits_float(sign | ((exp + 127 - 15) << 23) | (mant << 13));
+#endif
+}
+
+void cpu_pack_fp16(const float *src, uint16_t *dst, int n){
+#ifdef __F16C__
+    int n8 = n - (n % 8);
+#pragma omp parallel for
+    for (int i = 0; i < n8; i += 8)
+        _mm_storeu_si128((__m128i *)(dst + i), _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+    for (int i = n8; i < n; i++) dst[i] = cpu_float_to_fp16(src[i]);
+#else
+#pragma omp parallel for
+    for (int i = 0; i < n; i++) dst[i] = cpu_float_to_fp16(src[i]);
+#endif
+}
+
+void cpu_unpack_fp16(const uint16_t *src, float *dst, int n){
+#ifdef __F16C__
+    int n8 = n - (n % 8);
+#pragma omp parallel for
+    for (int i = 0; i < n8; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)(src + i))));
+    for (int i = n8; i < n; i++) dst[i] = cpu_fp16_to_float(src[i]);
+#else
+#pragma omp parallel for
+    for (int i = 0; i < n; i++) dst[i] = cpu_fp16_to_float(src[i]);
+#endif
+}
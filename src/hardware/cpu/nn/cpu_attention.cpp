@@ -0,0 +1,182 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+
+// Queries are processed in tiles of ATT_TILE rows against tiles of ATT_TILE keys, with a running
+// max and sum per query (online softmax), so only a tile of scores is alive at any time. The
+// backward recomputes the scores of each tile from the log-sum-exp of its queries.
+
+#define ATT_TILE 64
+#define ATT_NO_MAX -1e30f  // finite, the build may assume no infinities
+
+// Rows of a head: row-major blocks with the stride of all the heads
+typedef Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+typedef Eigen::Map<RowMatrix, 0, Eigen::OuterStride<>> HeadRows;
+
+static inline HeadRows head_rows(float *ptr, int rows, int cols, int stride) {
+    return HeadRows(ptr, rows, cols, Eigen::OuterStride<>(stride));
+}
+
+// Keys visible by query i among the nj keys starting at j0
+static inline int visible_keys(int i, int j0, int nj, int tq, int tk, bool causal) {
+    if (!causal) return nj;
+    return std::max(0, std::min(nj, i + tk - tq + 1 - j0));
+}
+
+void cpu_attention(Tensor *Q, Tensor *K, Tensor *V, Tensor *O, Tensor *L, int heads, bool causal){
+    _profile(_CPU_ATTENTION, 0);
+    int batch = Q->shape[0];
+    int tq = Q->shape[1];
+    int tk = K->shape[1];
+    int qs = Q->shape[2];  // row strides: all the heads
+    int vs = V->shape[2];
+    int dk = qs / heads;
+    int dv = vs / heads;
+    float scale = 1.0f / ::sqrtf((float)dk);
+    int ntiles = (tq + ATT_TILE - 1) / ATT_TILE;
+    int tasks = batch * heads * ntiles;
+
+#pragma omp parallel
+    {
+        std::vector<float> S(ATT_TILE * ATT_TILE), m(ATT_TILE), l(ATT_TILE);
+
+#pragma omp for
+        for (int task = 0; task < tasks; task++) {
+            int b = task / (heads * ntiles);
+            int h = (task / ntiles) % heads;
+            int i0 = (task % ntiles) * ATT_TILE;
+            int ni = std::min(ATT_TILE, tq - i0);
+
+            HeadRows q = head_rows(Q->ptr + ((size_t)b * tq + i0) * qs + h * dk, ni, dk, qs);
+            HeadRows o = head_rows(O->ptr + ((size_t)b * tq + i0) * vs + h * dv, ni, dv, vs);
+            float *lse = L->ptr + ((size_t)b * heads + h) * tq + i0;
+
+            o.setZero();
+            std::fill(m.begin(), m.end(), ATT_NO_MAX);
+            std::fill(l.begin(), l.end(), 0.0f);
+
+            // Up to the keys visible by the last query of the tile
+            int kend = causal ? std::min(tk, i0 + ni + tk - tq) : tk;
+            for (int j0 = 0; j0 < kend; j0 += ATT_TILE) {
+                int nj = std::min(ATT_TILE, kend - j0);
+                HeadRows k = head_rows(K->ptr + ((size_t)b * tk + j0) * qs + h * dk, nj, dk, qs);
+                HeadRows v = head_rows(V->ptr + ((size_t)b * tk + j0) * vs + h * dv, nj, dv, vs);
+                HeadRows s = head_rows(S.data(), ni, nj, ATT_TILE);
+
+                s.noalias() = scale * q * k.transpose();
+
+                // Scores to probabilities (unnormalized, relative to the running max)
+                for (int i = 0; i < ni; i++) {
+                    float *si = S.data() + i * ATT_TILE;
+                    int nv = visible_keys(i0 + i, j0, nj, tq, tk, causal);
+                    if (nv == 0) {
+                        std::fill(si, si + nj, 0.0f);
+                        continue;
+                    }
+
+                    float mx = m[i];
+                    for (int j = 0; j < nv; j++) mx = std::max(mx, si[j]);
+                    float corr = ::expf(m[i] - mx);
+                    float sum = 0.0f;
+                    for (int j = 0; j < nv; j++) {
+                        si[j] = ::expf(si[j] - mx);
+                        sum += si[j];
+                    }
+                    std::fill(si + nv, si + nj, 0.0f);
+                    l[i] = l[i] * corr + sum;
+                    m[i] = mx;
+                    if (corr != 1.0f) o.row(i) *= corr;
+                }
+
+                o.noalias() += s * v;
+            }
+
+            for (int i = 0; i < ni; i++) {
+                o.row(i) *= 1.0f / l[i];
+                lse[i] = m[i] + ::logf(l[i]);
+            }
+        }
+    }
+    _profile(_CPU_ATTENTION, 1);
+}
+
+void cpu_d_attention(Tensor *Q, Tensor *K, Tensor *V, Tensor *O, Tensor *L, Tensor *dO, Tensor *dQ, Tensor *dK, Tensor *dV, int heads, bool causal){
+    _profile(_CPU_D_ATTENTION, 0);
+    int batch = Q->shape[0];
+    int tq = Q->shape[1];
+    int tk = K->shape[1];
+    int qs = Q->shape[2];
+    int vs = V->shape[2];
+    int dk = qs / heads;
+    int dv = vs / heads;
+    float scale = 1.0f / ::sqrtf((float)dk);
+
+    // A head of a sample per thread: it is the only one writing its columns of dQ, dK and dV
+    // (even if they are the same tensor)
+#pragma omp parallel
+    {
+        std::vector<float> P(ATT_TILE * ATT_TILE), dP(ATT_TILE * ATT_TILE), D(tq);
+
+#pragma omp for
+        for (int task = 0; task < batch * heads; task++) {
+            int b = task / heads;
+            int h = task % heads;
+            const float *lse = L->ptr + ((size_t)b * heads + h) * tq;
+
+            // D_i = dO_i . O_i = sum_j P_ij dP_ij
+            HeadRows o = head_rows(O->ptr + (size_t)b * tq * vs + h * dv, tq, dv, vs);
+            HeadRows dout = head_rows(dO->ptr + (size_t)b * tq * vs + h * dv, tq, dv, vs);
+            for (int i = 0; i < tq; i++) D[i] = o.row(i).dot(dout.row(i));
+
+            for (int j0 = 0; j0 < tk; j0 += ATT_TILE) {
+                int nj = std::min(ATT_TILE, tk - j0);
+                HeadRows k = head_rows(K->ptr + ((size_t)b * tk + j0) * qs + h * dk, nj, dk, qs);
+                HeadRows v = head_rows(V->ptr + ((size_t)b * tk + j0) * vs + h * dv, nj, dv, vs);
+                HeadRows gk = head_rows(dK->ptr + ((size_t)b * tk + j0) * qs + h * dk, nj, dk, qs);
+                HeadRows gv = head_rows(dV->ptr + ((size_t)b * tk + j0) * vs + h * dv, nj, dv, vs);
+
+                // From the first query that sees a key of the tile
+                int istart = causal ? std::max(0, j0 - (tk - tq)) : 0;
+                for (int i0 = istart; i0 < tq; i0 += ATT_TILE) {
+                    int ni = std::min(ATT_TILE, tq - i0);
+                    HeadRows q = head_rows(Q->ptr + ((size_t)b * tq + i0) * qs + h * dk, ni, dk, qs);
+                    HeadRows dq = head_rows(dQ->ptr + ((size_t)b * tq + i0) * qs + h * dk, ni, dk, qs);
+                    HeadRows doi = head_rows(dO->ptr + ((size_t)b * tq + i0) * vs + h * dv, ni, dv, vs);
+                    HeadRows p = head_rows(P.data(), ni, nj, ATT_TILE);
+                    HeadRows dp = head_rows(dP.data(), ni, nj, ATT_TILE);
+
+                    p.noalias() = scale * q * k.transpose();
+                    dp.noalias() = doi * v.transpose();
+                    for (int i = 0; i < ni; i++) {
+                        float *pi = P.data() + i * ATT_TILE;
+                        float *dpi = dP.data() + i * ATT_TILE;
+                        int nv = visible_keys(i0 + i, j0, nj, tq, tk, causal);
+                        float li = lse[i0 + i], di = D[i0 + i];
+                        for (int j = 0; j < nv; j++) {
+                            pi[j] = ::expf(pi[j] - li);
+                            dpi[j] = scale * pi[j] * (dpi[j] - di);  // dS
+                        }
+                        std::fill(pi + nv, pi + nj, 0.0f);
+                        std::fill(dpi + nv, dpi + nj, 0.0f);
+                    }
+
+                    gv.noalias() += p.transpose() * doi;
+                    dq.noalias() += dp * k;
+                    gk.noalias() += dp.transpose() * q;
+                }
+            }
+        }
+    }
+    _profile(_CPU_D_ATTENTION, 1);
+}
@@ -10,6 +10,7 @@
 #include <cstdio>      /* printf, scanf, NULL */
 #include <cstdlib>     /* malloc, free, rand */
 #include <iostream>
+#include <algorithm>
 
 #include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
 
@@ -39,34 +40,30 @@ void add_pixel(int b,int px,int py,int pz,ConvolDescriptor *D,int isize,int irsi
 }
 
 
-void im2col(int b,ConvolDescriptor *D,float *ptrI,int col2im)
+void im2col(int b,ConvolDescriptor *D,float *ptrI,int col2im,int g)
 {
   _profile(_CPU_IM2COL, 0);
   int i,j,k;
   int pz,py,px,y,x;
   int ksize=D->kr*D->kc;
-  int kr2=D->kr/2;
-  int kc2=D->kc/2;
-
-  if (kc2==0) kc2=-1;
 
   int orsize=D->r*D->c;
+  int cols=D->kz*ksize;
 
-  int isize=D->ir*D->ic*D->iz;
+  // Samples can be strided (e.g. the slice of a concat), the channels of a sample are not
+  int isize=col2im ? D->ID->stride[0] : D->I->stride[0];
   int irsize=D->ir*D->ic;
 
-  k=0;
-  py=-D->padrt;
-  px=-D->padcl;
-
-
-  for(j=0;j<D->matI.rows();j++) {
+  for(j=0;j<orsize;j++) {
     k=j;
+    // Top-left corner of the (dilated) window of output pixel j
+    py=(j/D->c)*D->sr-D->padrt;
+    px=(j%D->c)*D->sc-D->padcl;
 
-    for(i=0;i<D->matI.cols();i++,k+=orsize) {
-      pz=i/ksize;
-      y=py+(i%ksize)/D->kc;
-      x=px+(i%D->kc);
+    for(i=0;i<cols;i++,k+=orsize) {
+      pz=g*D->kz+i/ksize;
+      y=py+((i%ksize)/D->kc)*D->dr;
+      x=px+(i%D->kc)*D->dc;
 
       if(col2im)
       add_pixel(b,x,y,pz,D,isize,irsize,ptrI[k]);
@@ -74,48 +71,271 @@ void im2col(int b,ConvolDescriptor *D,float *ptrI,int col2im)
       ptrI[k]=get_pixel(b,x,y,pz,D,isize,irsize);
 
     }
-    px+=D->sc;
-    if (px>=D->ic+D->padcl-kc2-1) {
-      px=-D->padcl;
-      py+=D->sr;
-    }
   }
     _profile(_CPU_IM2COL, 1);
 }
 
 
-void cpu_conv2D(ConvolDescriptor *D)
+// Output columns [x0, x1) whose input column x*sc-padcl+kx*dc falls inside the image
+static inline void depthwise_cols(ConvolDescriptor *D, int kx, int &x0, int &x1)
 {
-  _profile(_CPU_CONV2D, 0);
-  int osize=D->z*D->r*D->c;
-  int isize=D->r*D->c*D->kc*D->kr*D->kz;//r*c,kr*kc*kz
+  int lo=D->padcl-kx*D->dc;
+  int hi=D->ic-1+D->padcl-kx*D->dc;
+  x0=(lo<=0) ? 0 : (lo+D->sc-1)/D->sc;
+  x1=(hi<0) ? 0 : std::min(D->c, hi/D->sc+1);
+}
+
+// Depthwise (kz=1) convolution, direct: every filter slides over a single input channel.
+// The inner loops run along the output row so they vectorize across spatial positions.
+static void cpu_depthwise_conv2D(ConvolDescriptor *D)
+{
+  int mult=D->nk/D->iz;  // channel multiplier
+  int isize=D->ir*D->ic;
+  int osize=D->r*D->c;
+  int ksize=D->kr*D->kc;
+  int batch=D->I->shape[0];
+
+  #pragma omp parallel for
+  for(int bo=0;bo<batch*D->nk;bo++){
+    int b=bo/D->nk, o=bo%D->nk;
+    const float *in=D->I->ptr+(size_t)b*D->I->stride[0]+(size_t)(o/mult)*isize;
+    const float *k=D->K->ptr+(size_t)o*ksize;
+    float *out=D->O->ptr+(size_t)b*D->O->stride[0]+(size_t)o*osize;
+
+    for(int i=0;i<osize;i++) out[i]=0.0f;
+
+    for(int y=0;y<D->r;y++) {
+      float *orow=out+y*D->c;
+      for(int ky=0;ky<D->kr;ky++) {
+        int iy=y*D->sr-D->padrt+ky*D->dr;
+        if (iy<0 || iy>=D->ir) continue;
+        for(int kx=0;kx<D->kc;kx++) {
+          int x0,x1;
+          depthwise_cols(D,kx,x0,x1);
+          const float *irow=in+iy*D->ic-D->padcl+kx*D->dc;
+          float w=k[ky*D->kc+kx];
+          if (D->sc==1) for(int x=x0;x<x1;x++) orow[x]+=w*irow[x];
+          else for(int x=x0;x<x1;x++) orow[x]+=w*irow[x*D->sc];
+        }
+      }
+    }
+  }
+}
 
-  float *ptrO=D->O->ptr;
-  float *ptrI=D->ptrI;
+static void cpu_depthwise_conv2D_grad(ConvolDescriptor *D)
+{
+  int mult=D->nk/D->iz;
+  int isize=D->ir*D->ic;
+  int osize=D->r*D->c;
+  int ksize=D->kr*D->kc;
+  int batch=D->I->shape[0];
 
+  // One filter per thread: no reduction across threads
+  #pragma omp parallel for
+  for(int o=0;o<D->nk;o++){
+    float *gk=D->gK->ptr+(size_t)o*ksize;
+    for(int b=0;b<batch;b++) {
+      const float *in=D->I->ptr+(size_t)b*D->I->stride[0]+(size_t)(o/mult)*isize;
+      const float *d=D->D->ptr+(size_t)b*D->D->stride[0]+(size_t)o*osize;
+      for(int y=0;y<D->r;y++) {
+        const float *drow=d+y*D->c;
+        for(int ky=0;ky<D->kr;ky++) {
+          int iy=y*D->sr-D->padrt+ky*D->dr;
+          if (iy<0 || iy>=D->ir) continue;
+          for(int kx=0;kx<D->kc;kx++) {
+            int x0,x1;
+            depthwise_cols(D,kx,x0,x1);
+            const float *irow=in+iy*D->ic-D->padcl+kx*D->dc;
+            float acc=0.0f;
+            if (D->sc==1) for(int x=x0;x<x1;x++) acc+=drow[x]*irow[x];
+            else for(int x=x0;x<x1;x++) acc+=drow[x]*irow[x*D->sc];
+            gk[ky*D->kc+kx]+=acc;
+          }
+        }
+      }
+    }
+  }
+}
 
-  // Map memory to Eigen
-  Eigen::Map<Eigen::MatrixXf> matK=Eigen::Map<Eigen::MatrixXf>(D->K->ptr, D->kr * D->kc * D->kz, D->nk);
+static void cpu_depthwise_conv2D_back(ConvolDescriptor *D)
+{
+  int mult=D->nk/D->iz;
+  int isize=D->ir*D->ic;
+  int osize=D->r*D->c;
+  int ksize=D->kr*D->kc;
+  int batch=D->I->shape[0];
 
+  // One input channel per thread: its filters are the only ones writing on it
   #pragma omp parallel for
-  for(int b=0;b<D->I->shape[0];b++){
+  for(int bz=0;bz<batch*D->iz;bz++){
+    int b=bz/D->iz, z=bz%D->iz;
+    float *id=D->ID->ptr+(size_t)b*D->ID->stride[0]+(size_t)z*isize;
+    for(int m=0;m<mult;m++) {
+      int o=z*mult+m;
+      const float *k=D->K->ptr+(size_t)o*ksize;
+      const float *d=D->D->ptr+(size_t)b*D->D->stride[0]+(size_t)o*osize;
+      for(int y=0;y<D->r;y++) {
+        const float *drow=d+y*D->c;
+        for(int ky=0;ky<D->kr;ky++) {
+          int iy=y*D->sr-D->padrt+ky*D->dr;
+          if (iy<0 || iy>=D->ir) continue;
+          for(int kx=0;kx<D->kc;kx++) {
+            int x0,x1;
+            depthwise_cols(D,kx,x0,x1);
+            float *irow=id+iy*D->ic-D->padcl+kx*D->dc;
+            float w=k[ky*D->kc+kx];
+            if (D->sc==1) for(int x=x0;x<x1;x++) irow[x]+=w*drow[x];
+            else for(int x=x0;x<x1;x++) irow[x*D->sc]+=w*drow[x];
+          }
+        }
+      }
+    }
+  }
+}
 
-    float *ptrO=D->O->ptr+(b*osize);
-    float *ptrI=D->ptrI+(b*isize);
 
-    Eigen::Map<Eigen::MatrixXf> matI=Eigen::Map<Eigen::MatrixXf>(ptrI,D->r*D->c,D->kz*D->kr*D->kc);
-    Eigen::Map<Eigen::MatrixXf> matO=Eigen::Map<Eigen::MatrixXf>(ptrO,D->r*D->c,D->z);
+// Output positions [t0, t1) whose input row t*sr-padrt+ky*dr falls inside the sequence
+static inline void direct_rows(ConvolDescriptor *D, int ky, int &t0, int &t1)
+{
+  int lo=D->padrt-ky*D->dr;
+  int hi=D->ir-1+D->padrt-ky*D->dr;
+  t0=(lo<=0) ? 0 : (lo+D->sr-1)/D->sr;
+  t1=(hi<0) ? 0 : std::min(D->r, hi/D->sr+1);
+}
+
+// 1D convolution over {batch, channels, length} (ic=kc=1), direct: every output row
+// accumulates kz*kr shifted input rows. The inner loops vectorize along the sequence.
+static void cpu_direct_conv1D(ConvolDescriptor *D)
+{
+  int nkg=D->nk/D->groups;
+  int ktaps=D->kz*D->kr;
+  int batch=D->I->shape[0];
+
+  #pragma omp parallel for
+  for(int bo=0;bo<batch*D->nk;bo++){
+    int b=bo/D->nk, o=bo%D->nk;
+    const float *in=D->I->ptr+(size_t)b*D->I->stride[0]+(size_t)(o/nkg)*D->kz*D->ir;
+    const float *k=D->K->ptr+(size_t)o*ktaps;
+    float *out=D->O->ptr+(size_t)b*D->O->stride[0]+(size_t)o*D->r;
+
+    for(int t=0;t<D->r;t++) out[t]=0.0f;
+
+    for(int z=0;z<D->kz;z++) {
+      for(int ky=0;ky<D->kr;ky++) {
+        int t0,t1;
+        direct_rows(D,ky,t0,t1);
+        const float *irow=in+z*D->ir-D->padrt+ky*D->dr;
+        float w=k[z*D->kr+ky];
+        if (D->sr==1) for(int t=t0;t<t1;t++) out[t]+=w*irow[t];
+        else for(int t=t0;t<t1;t++) out[t]+=w*irow[t*D->sr];
+      }
+    }
+  }
+}
 
-    im2col(b,D,ptrI,0);
+// Dot product of two rows (stride sr on x). Four interleaved partial sums: a single
+// running sum is bound by the latency of the adds, not by the loads.
+static inline float direct_dot(const float *d, const float *x, int t0, int t1, int sr)
+{
+  float a0=0.0f, a1=0.0f, a2=0.0f, a3=0.0f;
+  int n=(t1-t0)/4, t=t0;
+  if (sr==1) {
+    const float *d1=d+t0+n, *d2=d1+n, *d3=d2+n;
+    const float *x0=x+t0, *x1=x0+n, *x2=x1+n, *x3=x2+n;
+    for(int i=0;i<n;i++) {
+      a0+=d[t0+i]*x0[i]; a1+=d1[i]*x1[i]; a2+=d2[i]*x2[i]; a3+=d3[i]*x3[i];
+    }
+    t=t0+4*n;
+    for(;t<t1;t++) a0+=d[t]*x[t];
+  }
+  else for(;t<t1;t++) a0+=d[t]*x[t*sr];
+  return (a0+a1)+(a2+a3);
+}
 
-    matO=matI*matK;
-  }// batch
+static void cpu_direct_conv1D_grad(ConvolDescriptor *D)
+{
+  int nkg=D->nk/D->groups;
+  int ktaps=D->kz*D->kr;
+  int batch=D->I->shape[0];
+
+  // One filter per thread: no reduction across threads
+  #pragma omp parallel for
+  for(int o=0;o<D->nk;o++){
+    float *gk=D->gK->ptr+(size_t)o*ktaps;
+    for(int b=0;b<batch;b++) {
+      const float *in=D->I->ptr+(size_t)b*D->I->stride[0]+(size_t)(o/nkg)*D->kz*D->ir;
+      const float *d=D->D->ptr+(size_t)b*D->D->stride[0]+(size_t)o*D->r;
+      for(int z=0;z<D->kz;z++) {
+        for(int ky=0;ky<D->kr;ky++) {
+          int t0,t1;
+          direct_rows(D,ky,t0,t1);
+          gk[z*D->kr+ky]+=direct_dot(d,in+z*D->ir-D->padrt+ky*D->dr,t0,t1,D->sr);
+        }
+      }
+    }
+  }
+}
+
+static void cpu_direct_conv1D_back(ConvolDescriptor *D)
+{
+  int nkg=D->nk/D->groups;
+  int ktaps=D->kz*D->kr;
+  int batch=D->I->shape[0];
+
+  // One input channel per thread: the filters of its group are the only ones writing on it
+  #pragma omp parallel for
+  for(int bz=0;bz<batch*D->iz;bz++){
+    int b=bz/D->iz, g=(bz%D->iz)/D->kz, z=(bz%D->iz)%D->kz;
+    float *id=D->ID->ptr+(size_t)b*D->ID->stride[0]+(size_t)(bz%D->iz)*D->ir;
+    for(int o=g*nkg;o<(g+1)*nkg;o++) {
+      const float *k=D->K->ptr+(size_t)o*ktaps+z*D->kr;
+      const float *d=D->D->ptr+(size_t)b*D->D->stride[0]+(size_t)o*D->r;
+      for(int ky=0;ky<D->kr;ky++) {
+        int t0,t1;
+        direct_rows(D,ky,t0,t1);
+        float *irow=id-D->padrt+ky*D->dr;
+        float w=k[ky];
+        if (D->sr==1) for(int t=t0;t<t1;t++) irow[t]+=w*d[t];
+        else for(int t=t0;t<t1;t++) irow[t*D->sr]+=w*d[t];
+      }
+    }
+  }
+}
+
+
+void cpu_conv2D(ConvolDescriptor *D)
+{
+  _profile(_CPU_CONV2D, 0);
+  int gsize=D->r*D->c*D->kc*D->kr*D->kz;//r*c,kr*kc*kz (one group)
+  int isize=gsize*D->groups;
+  int nkg=D->nk/D->groups;  // filters per group
+
+  if (D->depthwise) cpu_depthwise_conv2D(D);
+  else if (D->direct) cpu_direct_conv1D(D);
+  else {
+    #pragma omp parallel for
+    for(int b=0;b<D->I->shape[0];b++){
+      for(int g=0;g<D->groups;g++) {
+        float *ptrO=D->O->ptr+((size_t)b*D->O->stride[0])+(g*nkg*D->r*D->c);
+        float *ptrI=D->ptrI+(b*isize)+(g*gsize);
+
+        // Map memory to Eigen
+        Eigen::Map<Eigen::MatrixXf> matK=Eigen::Map<Eigen::MatrixXf>(D->K->ptr+(g*nkg*D->kr*D->kc*D->kz), D->kr * D->kc * D->kz, nkg);
+        Eigen::Map<Eigen::MatrixXf> matI=Eigen::Map<Eigen::MatrixXf>(ptrI,D->r*D->c,D->kz*D->kr*D->kc);
+        Eigen::Map<Eigen::MatrixXf> matO=Eigen::Map<Eigen::MatrixXf>(ptrO,D->r*D->c,nkg);
+
+        im2col(b,D,ptrI,0,g);
+
+        matO=matI*matK;
+      }
+    }// batch
+  }
 
   //bias
   if (D->use_bias) {
     #pragma omp parallel for
     for(int b=0;b<D->O->shape[0];b++) {
-      float *ptrO=D->O->ptr+(b*osize);
+      float *ptrO=D->O->ptr+((size_t)b*D->O->stride[0]);
       for(int z=0;z<D->O->shape[1];z++)
       for(int r=0;r<D->O->shape[2];r++)
       for(int c=0;c<D->O->shape[3];c++,ptrO++)
@@ -130,31 +350,35 @@ void cpu_conv2D_grad(ConvolDescriptor *D)
 {
   _profile(_CPU_CONV2D_GRAD, 0);
   //return;
-  int osize=D->z*D->r*D->c;
-  int isize=D->r*D->c*D->kc*D->kr*D->kz;//r*c,kr*kc*kz
-
-
-  // Map memory to Eigen
-  Eigen::Map<Eigen::MatrixXf> matgK=Eigen::Map<Eigen::MatrixXf>(D->gK->ptr, D->kr * D->kc * D->kz, D->nk);
-
-  //#pragma omp parallel for
-  for(int b=0;b<D->I->shape[0];b++){
-
-    float *ptrD=D->D->ptr+(b*osize);
-    float *ptrI=D->ptrI+(b*isize);
-
-    Eigen::Map<Eigen::MatrixXf> matI=Eigen::Map<Eigen::MatrixXf>(ptrI,D->r*D->c,D->kz*D->kr*D->kc);
-    Eigen::Map<Eigen::MatrixXf> matD=Eigen::Map<Eigen::MatrixXf>(ptrD,D->r*D->c,D->z);
-
-    matgK+=matI.transpose()*matD;
-  }// batch
+  int gsize=D->r*D->c*D->kc*D->kr*D->kz;//r*c,kr*kc*kz (one group)
+  int isize=gsize*D->groups;
+  int nkg=D->nk/D->groups;
+
+  if (D->depthwise) cpu_depthwise_conv2D_grad(D);
+  else if (D->direct) cpu_direct_conv1D_grad(D);
+  else {
+    //#pragma omp parallel for
+    for(int b=0;b<D->I->shape[0];b++){
+      for(int g=0;g<D->groups;g++) {
+        float *ptrD=D->D->ptr+((size_t)b*D->D->stride[0])+(g*nkg*D->r*D->c);
+        float *ptrI=D->ptrI+(b*isize)+(g*gsize);
+
+        // Map memory to Eigen
+        Eigen::Map<Eigen::MatrixXf> matgK=Eigen::Map<Eigen::MatrixXf>(D->gK->ptr+(g*nkg*D->kr*D->kc*D->kz), D->kr * D->kc * D->kz, nkg);
+        Eigen::Map<Eigen::MatrixXf> matI=Eigen::Map<Eigen::MatrixXf>(ptrI,D->r*D->c,D->kz*D->kr*D->kc);
+        Eigen::Map<Eigen::MatrixXf> matD=Eigen::Map<Eigen::MatrixXf>(ptrD,D->r*D->c,nkg);
+
+        matgK+=matI.transpose()*matD;
+      }
+    }// batch
+  }
 
   //bias
 
   //#pragma omp parallel for
   if (D->use_bias) {
     for(int b=0;b<D->D->shape[0];b++) {
-      float *ptrD=D->D->ptr+(b*osize);
+      float *ptrD=D->D->ptr+((size_t)b*D->D->stride[0]);
       for(int z=0;z<D->D->shape[1];z++)
       for(int r=0;r<D->D->shape[2];r++)
       for(int c=0;c<D->D->shape[3];c++,ptrD++)
@@ -165,31 +389,57 @@ void cpu_conv2D_grad(ConvolDescriptor *D)
     _profile(_CPU_CONV2D_GRAD, 1);
 }
 
-void cpu_conv2D_back(ConvolDescriptor *D)
+void cpu_conv2D_bias(Tensor *O, Tensor *bias)
 {
-  _profile(_CPU_CONV2D_BACK, 0);
-  int osize=D->z*D->r*D->c;
-  int isize=D->r*D->c*D->kc*D->kr*D->kz;//r*c,kr*kc*kz
-
-  float *ptrD=D->D->ptr;
-  float *ptrI=D->ptrI;
-
-  // Map memory to Eigen
-  Eigen::Map<Eigen::MatrixXf> matK=Eigen::Map<Eigen::MatrixXf>(D->K->ptr, D->kr * D->kc * D->kz, D->nk);
+  int csize=O->shape[2]*O->shape[3];
+  #pragma omp parallel for
+  for(int p=0;p<O->shape[0]*O->shape[1];p++) {
+    float *ptrO=O->ptr+((size_t)(p/O->shape[1])*O->stride[0])+((size_t)(p%O->shape[1])*csize);
+    float v=bias->ptr[p%O->shape[1]];
+    for(int i=0;i<csize;i++) ptrO[i]+=v;
+  }
+}
 
+void cpu_conv2D_gbias(Tensor *D, Tensor *gbias)
+{
+  int csize=D->shape[2]*D->shape[3];
   #pragma omp parallel for
-  for(int b=0;b<D->I->shape[0];b++){
+  for(int z=0;z<D->shape[1];z++) {
+    float sum=0.0f;
+    for(int b=0;b<D->shape[0];b++) {
+      float *ptrD=D->ptr+((size_t)b*D->stride[0])+((size_t)z*csize);
+      for(int i=0;i<csize;i++) sum+=ptrD[i];
+    }
+    gbias->ptr[z]+=sum;
+  }
+}
 
-    float *ptrD=D->D->ptr+(b*osize);
-    float *ptrI=D->ptrI+(b*isize);
+void cpu_conv2D_back(ConvolDescriptor *D)
+{
+  _profile(_CPU_CONV2D_BACK, 0);
+  int gsize=D->r*D->c*D->kc*D->kr*D->kz;//r*c,kr*kc*kz (one group)
+  int isize=gsize*D->groups;
+  int nkg=D->nk/D->groups;
 
-    Eigen::Map<Eigen::MatrixXf> matI=Eigen::Map<Eigen::MatrixXf>(ptrI,D->r*D->c,D->kz*D->kr*D->kc);
-    Eigen::Map<Eigen::MatrixXf> matD=Eigen::Map<Eigen::MatrixXf>(ptrD,D->r*D->c,D->z);
+  if (D->depthwise) cpu_depthwise_conv2D_back(D);
+  else if (D->direct) cpu_direct_conv1D_back(D);
+  else {
+    #pragma omp parallel for
+    for(int b=0;b<D->I->shape[0];b++){
+      for(int g=0;g<D->groups;g++) {
+        float *ptrD=D->D->ptr+((size_t)b*D->D->stride[0])+(g*nkg*D->r*D->c);
+        float *ptrI=D->ptrI+(b*isize)+(g*gsize);
 
-    matI=matD*matK.transpose();
+        // Map memory to Eigen
+        Eigen::Map<Eigen::MatrixXf> matK=Eigen::Map<Eigen::MatrixXf>(D->K->ptr+(g*nkg*D->kr*D->kc*D->kz), D->kr * D->kc * D->kz, nkg);
+        Eigen::Map<Eigen::MatrixXf> matI=Eigen::Map<Eigen::MatrixXf>(ptrI,D->r*D->c,D->kz*D->kr*D->kc);
+        Eigen::Map<Eigen::MatrixXf> matD=Eigen::Map<Eigen::MatrixXf>(ptrD,D->r*D->c,nkg);
 
-    im2col(b,D,ptrI,1);
+        matI=matD*matK.transpose();
 
-  }// batch
+        im2col(b,D,ptrI,1,g);
+      }
+    }// batch
+  }
     _profile(_CPU_CONV2D_BACK, 1);
 }
@@ -0,0 +1,38 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include "eddl/random.h"
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+
+// The mask bit of element i is counter_rand(seed, i), so forward and backward
+// agree without keeping a mask tensor alive between them.
+
+void cpu_dropout(Tensor *A, Tensor *B, float keep, float scale, uint64_t seed){
+    _profile(_CPU_DROPOUT, 0);
+    const uint32_t th = counter_rand_threshold(keep);
+    const float *a = A->ptr;
+    float *b = B->ptr;
+#pragma omp parallel for
+    for (int i = 0; i < A->size; i++) {
+        b[i] = ((counter_rand(seed, i) >> 8) < th) ? a[i] * scale : 0.0f;
+    }
+    _profile(_CPU_DROPOUT, 1);
+}
+
+void cpu_d_dropout(Tensor *D, Tensor *PD, float keep, float scale, uint64_t seed){
+    _profile(_CPU_D_DROPOUT, 0);
+    const uint32_t th = counter_rand_threshold(keep);
+    const float *d = D->ptr;
+    float *pd = PD->ptr;
+#pragma omp parallel for
+    for (int i = 0; i < D->size; i++) {
+        if ((counter_rand(seed, i) >> 8) < th) pd[i] += d[i] * scale;
+    }
+    _profile(_CPU_D_DROPOUT, 1);
+}
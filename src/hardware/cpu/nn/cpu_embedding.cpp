@@ -0,0 +1,149 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+
+
+int cpu_embedding(Tensor *E, Tensor *I, Tensor *O, int *ind, bool mask_zeros){
+    _profile(_CPU_EMBEDDING, 0);
+    int vocsize = E->shape[0];
+    int dim = E->shape[1];
+    int n = I->size;
+    int oov = 0;
+
+    #pragma omp parallel for reduction(+:oov)
+    for (int i = 0; i < n; i++) {
+        int w = (int)I->ptr[i];
+        if ((w < 0) || (w >= vocsize)) { w = 0; oov++; }
+        ind[i] = w;
+
+        float *o = O->ptr + (size_t)i * dim;
+        if (mask_zeros && (w == 0)) std::memset(o, 0, dim * sizeof(float));
+        else std::memcpy(o, E->ptr + (size_t)w * dim, dim * sizeof(float));
+    }
+    _profile(_CPU_EMBEDDING, 1);
+    return oov;
+}
+
+void cpu_embedding_back(Tensor *D, Tensor *gE, const int *ind, int n, bool mask_zeros, vector<int> &rows){
+    _profile(_CPU_EMBEDDING_BACK, 0);
+    int dim = gE->shape[1];
+
+    // Group the positions by word so every row of gE is accumulated by a single thread
+    vector<pair<int, int>> order;
+    order.reserve(n);
+    for (int i = 0; i < n; i++)
+        if (!(mask_zeros && (ind[i] == 0))) order.emplace_back(ind[i], i);
+    std::sort(order.begin(), order.end());
+
+    vector<int> words, start;
+    for (int k = 0; k < order.size(); k++)
+        if ((k == 0) || (order[k].first != order[k - 1].first)) {
+            words.push_back(order[k].first);
+            start.push_back(k);
+        }
+    start.push_back(order.size());
+
+    #pragma omp parallel for
+    for (int u = 0; u < words.size(); u++) {
+        float *g = gE->ptr + (size_t)words[u] * dim;
+        for (int k = start[u]; k < start[u + 1]; k++) {
+            const float *d = D->ptr + (size_t)order[k].second * dim;
+            for (int j = 0; j < dim; j++) g[j] += d[j];
+        }
+    }
+
+    // rows is kept sorted and unique across several backward calls (i.e. unrolled nets)
+    vector<int> merged;
+    merged.reserve(rows.size() + words.size());
+    std::set_union(rows.begin(), rows.end(), words.begin(), words.end(), std::back_inserter(merged));
+    rows.swap(merged);
+    _profile(_CPU_EMBEDDING_BACK, 1);
+}
+
+
+void cpu_zero_rows(Tensor *A, const vector<int> &rows){
+    _profile(_CPU_SPARSE_UPDATE, 0);
+    int dim = A->size / A->shape[0];
+
+    #pragma omp parallel for
+    for (int r = 0; r < rows.size(); r++)
+        std::memset(A->ptr + (size_t)rows[r] * dim, 0, dim * sizeof(float));
+    _profile(_CPU_SPARSE_UPDATE, 1);
+}
+
+void cpu_clamp_rows(Tensor *A, const vector<int> &rows, float min, float max){
+    _profile(_CPU_SPARSE_UPDATE, 0);
+    int dim = A->size / A->shape[0];
+
+    #pragma omp parallel for
+    for (int r = 0; r < rows.size(); r++) {
+        float *a = A->ptr + (size_t)rows[r] * dim;
+        for (int j = 0; j < dim; j++) a[j] = std::min(max, std::max(min, a[j]));
+    }
+    _profile(_CPU_SPARSE_UPDATE, 1);
+}
+
+void cpu_sgd_rows(Tensor *P, Tensor *G, Tensor *M, const vector<int> &rows, float lr, float mu){
+    _profile(_CPU_SPARSE_UPDATE, 0);
+    int dim = P->size / P->shape[0];
+
+    #pragma omp parallel for
+    for (int r = 0; r < rows.size(); r++) {
+        size_t o = (size_t)rows[r] * dim;
+        float *p = P->ptr + o, *g = G->ptr + o, *m = M->ptr + o;
+        for (int j = 0; j < dim; j++) {
+            m[j] = lr * g[j] + mu * m[j];
+            p[j] -= m[j];
+        }
+    }
+    _profile(_CPU_SPARSE_UPDATE, 1);
+}
+
+void cpu_adam_rows(Tensor *P, Tensor *G, Tensor *M, Tensor *V, const vector<int> &rows, float lr, float beta_1, float beta_2, float epsilon, int t){
+    _profile(_CPU_SPARSE_UPDATE, 0);
+    int dim = P->size / P->shape[0];
+    float c1 = 1.0f / (1.0f - std::pow(beta_1, t));
+    float c2 = 1.0f / (1.0f - std::pow(beta_2, t));
+
+    #pragma omp parallel for
+    for (int r = 0; r < rows.size(); r++) {
+        size_t o = (size_t)rows[r] * dim;
+        float *p = P->ptr + o, *g = G->ptr + o, *m = M->ptr + o, *v = V->ptr + o;
+        for (int j = 0; j < dim; j++) {
+            m[j] = beta_1 * m[j] + (1.0f - beta_1) * g[j];
+            v[j] = beta_2 * v[j] + (1.0f - beta_2) * g[j] * g[j];
+            p[j] -= lr * (m[j] * c1) / std::sqrt(v[j] * c2 + epsilon);
+        }
+    }
+    _profile(_CPU_SPARSE_UPDATE, 1);
+}
+
+void cpu_rmsprop_rows(Tensor *P, Tensor *G, Tensor *G1, const vector<int> &rows, float lr, float rho, float epsilon){
+    _profile(_CPU_SPARSE_UPDATE, 0);
+    int dim = P->size / P->shape[0];
+
+    #pragma omp parallel for
+    for (int r = 0; r < rows.size(); r++) {
+        size_t o = (size_t)rows[r] * dim;
+        float *p = P->ptr + o, *g = G->ptr + o, *g1 = G1->ptr + o;
+        for (int j = 0; j < dim; j++) {
+            float acc = (1.0f - rho) * g[j] * g[j] + rho * g1[j] * g1[j];
+            p[j] -= lr * g[j] / std::sqrt(acc + epsilon);
+            g1[j] = g[j];
+        }
+    }
+    _profile(_CPU_SPARSE_UPDATE, 1);
+}
@@ -13,12 +13,101 @@
 #include <cstdlib>     /* malloc, free, rand */
 #include <iostream>
 #include <limits>       // std::numeric_limits
+#include <algorithm>
 
 #include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
 
 
+// Sequences {batch, channels, length, 1}: pooled along the rows without the 2D window walk
+static inline bool is_pool1D(PoolDescriptor *D){
+    return (D->ic==1) && (D->kc==1) && (D->padcl==0) && (D->padcr==0);
+}
+
+// Window of output t clipped to the sequence: padding never wins a max nor adds to an average
+static inline void pool1D_window(PoolDescriptor *D, int t, int &y0, int &y1){
+    int y=t*D->sr-D->padrt;
+    y0=std::max(y, 0);
+    y1=std::min(y+D->kr, D->ir);
+}
+
+static void cpu_mpool1D(PoolDescriptor *D){
+    int batch=D->I->shape[0];
+
+    #pragma omp parallel for
+    for(int bz=0; bz<batch*D->iz; bz++){
+        const float *in=D->I->ptr+(size_t)bz*D->ir;
+        float *out=D->O->ptr+(size_t)bz*D->r;
+        float *indY=D->indY->ptr+(size_t)bz*D->r;
+        float *indX=D->indX->ptr+(size_t)bz*D->r;
+
+        for(int t=0; t<D->r; t++){
+            int y0, y1;
+            pool1D_window(D, t, y0, y1);
+            int best=y0;
+            for(int y=y0+1; y<y1; y++) if (in[y]>in[best]) best=y;
+            out[t]=in[best];
+            indY[t]=best;
+            indX[t]=0;
+        }
+    }
+}
+
+static void cpu_mpool1D_back(PoolDescriptor *D){
+    int batch=D->I->shape[0];
+
+    #pragma omp parallel for
+    for(int bz=0; bz<batch*D->iz; bz++){
+        float *id=D->ID->ptr+(size_t)bz*D->ir;
+        const float *d=D->D->ptr+(size_t)bz*D->r;
+        const float *indY=D->indY->ptr+(size_t)bz*D->r;
+        for(int t=0; t<D->r; t++) id[(int)indY[t]]+=d[t];
+    }
+}
+
+static void cpu_avgpool1D(PoolDescriptor *D){
+    int batch=D->I->shape[0];
+    float scale=1.0f/(float)D->kr;  // Padding counts, as in the 2D kernel
+
+    #pragma omp parallel for
+    for(int bz=0; bz<batch*D->iz; bz++){
+        const float *in=D->I->ptr+(size_t)bz*D->ir;
+        float *out=D->O->ptr+(size_t)bz*D->r;
+        for(int t=0; t<D->r; t++){
+            int y0, y1;
+            pool1D_window(D, t, y0, y1);
+            float sum=0.0f;
+            for(int y=y0; y<y1; y++) sum+=in[y];
+            out[t]=sum*scale;
+        }
+    }
+}
+
+static void cpu_avgpool1D_back(PoolDescriptor *D){
+    int batch=D->I->shape[0];
+    float scale=1.0f/(float)D->kr;
+
+    #pragma omp parallel for
+    for(int bz=0; bz<batch*D->iz; bz++){
+        float *id=D->ID->ptr+(size_t)bz*D->ir;
+        const float *d=D->D->ptr+(size_t)bz*D->r;
+        for(int t=0; t<D->r; t++){
+            int y0, y1;
+            pool1D_window(D, t, y0, y1);
+            float v=d[t]*scale;
+            for(int y=y0; y<y1; y++) id[y]+=v;
+        }
+    }
+}
+
+
 void cpu_mpool2D(PoolDescriptor *D){
     _profile(_CPU_MPOOL2D, 0);
+    if (is_pool1D(D)) {
+        cpu_mpool1D(D);
+        _profile(_CPU_MPOOL2D, 1);
+        return;
+    }
+
     int isize = D->ir*D->ic*D->iz;
     int irsize = D->ir*D->ic;
 
@@ -58,6 +147,12 @@ void cpu_mpool2D(PoolDescriptor *D){
 
 void cpu_mpool2D_back(PoolDescriptor *D){
     _profile(_CPU_MPOOL2D_BACK, 0);
+    if (is_pool1D(D)) {
+        cpu_mpool1D_back(D);
+        _profile(_CPU_MPOOL2D_BACK, 1);
+        return;
+    }
+
     int isize = D->ir*D->ic*D->iz;
     int irsize = D->ir*D->ic;
 
@@ -82,6 +177,12 @@ void cpu_mpool2D_back(PoolDescriptor *D){
 
 void cpu_avgpool2D(PoolDescriptor *D){
     _profile(_CPU_AVGPOOL2D, 0);
+    if (is_pool1D(D)) {
+        cpu_avgpool1D(D);
+        _profile(_CPU_AVGPOOL2D, 1);
+        return;
+    }
+
     int isize = D->ir*D->ic*D->iz;
     int irsize = D->ir*D->ic;
     int ksize = D->kr*D->kc;
@@ -118,6 +219,12 @@ void cpu_avgpool2D(PoolDescriptor *D){
 
 void cpu_avgpool2D_back(PoolDescriptor *D){
     _profile(_CPU_AVGPOOL2D_BACK, 0);
+    if (is_pool1D(D)) {
+        cpu_avgpool1D_back(D);
+        _profile(_CPU_AVGPOOL2D_BACK, 1);
+        return;
+    }
+
     int isize = D->ir*D->ic*D->iz;
     int irsize = D->ir*D->ic;
     int ksize = D->kr*D->kc;
@@ -0,0 +1,127 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+
+#if defined(__AVXVNNI__)
+#define QDOT_VNNI(acc, a, b) _mm256_dpbusd_avx_epi32(acc, a, b)
+#elif defined(__AVX512VNNI__) && defined(__AVX512VL__)
+#define QDOT_VNNI(acc, a, b) _mm256_dpbusd_epi32(acc, a, b)
+#endif
+
+#if defined(__AVX2__)
+static inline int32_t hsum_epi32(__m256i v){
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_hadd_epi32(s, s);
+    s = _mm_hadd_epi32(s, s);
+    return _mm_cvtsi128_si32(s);
+}
+#endif
+
+// int8 x int8 dot product with int32 accumulation
+static inline int32_t qdot(const int8_t *a, const int8_t *w, int K, int32_t wsum){
+    int32_t acc = 0;
+    int k = 0;
+#if defined(QDOT_VNNI)
+    // VNNI multiplies u8 x s8: shift the activations to a+128 and remove 128*sum(w) at the end
+    const __m256i off = _mm256_set1_epi8((char)0x80);
+    __m256i vacc = _mm256_setzero_si256();
+    for (; k + 32 <= K; k += 32) {
+        __m256i va = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + k)), off);
+        __m256i vw = _mm256_loadu_si256((const __m256i*)(w + k));
+        vacc = QDOT_VNNI(vacc, va, vw);
+    }
+    acc = hsum_epi32(vacc);
+    for (; k < K; k++) acc += ((int32_t)a[k] + 128) * (int32_t)w[k];
+    return acc - 128 * wsum;
+#elif defined(__AVX2__)
+    __m256i vacc = _mm256_setzero_si256();
+    for (; k + 16 <= K; k += 16) {
+        __m256i va = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(a + k)));
+        __m256i vw = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(w + k)));
+        vacc = _mm256_add_epi32(vacc, _mm256_madd_epi16(va, vw));
+    }
+    acc = hsum_epi32(vacc);
+#endif
+    for (; k < K; k++) acc += (int32_t)a[k] * (int32_t)w[k];
+    return acc;
+}
+
+// C[m*ldm + n*ldn] = (A[m,:] . qW[n,:]) * in_scale * w_scale[n] + bias[n]
+static void qgemm(const int8_t *A, int M, QuantDescriptor *qd, const float *bias, float *C, int ldm, int ldn){
+    int K = qd->ins;
+    for (int m = 0; m < M; m++) {
+        const int8_t *a = A + (size_t)m * K;
+        for (int n = 0; n < qd->outs; n++) {
+            int32_t acc = qdot(a, qd->qW.data() + (size_t)n * K, K, qd->w_sum[n]);
+            float v = (float)acc * (qd->in_scale * qd->w_scale[n]);
+            if (bias != nullptr) v += bias[n];
+            C[(size_t)m * ldm + (size_t)n * ldn] = v;
+        }
+    }
+}
+
+
+void cpu_qdense(Tensor *A, Tensor *B, Tensor *bias, QuantDescriptor *qd){
+    _profile(_CPU_QDENSE, 0);
+    int batch = A->shape[0];
+    int K = qd->ins;
+    if (qd->qI.size() < (size_t)A->size) qd->qI.resize(A->size);
+
+    int8_t *qI = qd->qI.data();
+    const float *b = (bias != nullptr) ? bias->ptr : nullptr;
+
+    #pragma omp parallel for
+    for (int i = 0; i < batch; i++) {
+        qd->quantize(A->ptr + (size_t)i * K, qI + (size_t)i * K, K);
+        qgemm(qI + (size_t)i * K, 1, qd, b, B->ptr + (size_t)i * qd->outs, 0, 1);
+    }
+    _profile(_CPU_QDENSE, 1);
+}
+
+
+void cpu_qconv2D(ConvolDescriptor *D, QuantDescriptor *qd){
+    _profile(_CPU_QCONV2D, 0);
+    int rc = D->r * D->c;
+    int K = qd->ins;  // kz*kr*kc
+    int batch = D->I->shape[0];
+
+    if (qd->qI.size() < (size_t)batch * rc * K) qd->qI.resize((size_t)batch * rc * K);
+    const float *b = D->use_bias ? D->bias->ptr : nullptr;
+
+    #pragma omp parallel for
+    for (int i = 0; i < batch; i++) {
+        float *ptrI = D->ptrI + (size_t)i * rc * K;
+        int8_t *qI = qd->qI.data() + (size_t)i * rc * K;
+
+        im2col(i, D, ptrI, 0);
+
+        // im2col is column-major [rc x K]: quantize it into rows of K
+        float inv = 1.0f / qd->in_scale;
+        for (int k = 0; k < K; k++) {
+            const float *col = ptrI + (size_t)k * rc;
+            for (int m = 0; m < rc; m++) {
+                float v = std::min(127.0f, std::max(-127.0f, col[m] * inv));
+                qI[(size_t)m * K + k] = (int8_t)std::lrintf(v);
+            }
+        }
+
+        // Output is [z x rc] per sample
+        qgemm(qI, rc, qd, b, D->O->ptr + (size_t)i * D->O->stride[0], 1, rc);
+    }
+    _profile(_CPU_QCONV2D, 1);
+}
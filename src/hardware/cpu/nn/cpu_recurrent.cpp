@@ -0,0 +1,142 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cmath>
+
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+
+// The gates of each row are processed at once: the activations, the cell state and the output
+// (or their deltas) without intermediate tensors.
+
+static inline float sigmoid(float x) {
+    return 1.0f / (1.0f + ::expf(-x));
+}
+
+void cpu_lstm_cell(Tensor *G, Tensor *Cprev, Tensor *C, Tensor *H){
+    _profile(_CPU_LSTM_CELL, 0);
+    int n = C->shape[0];
+    int u = C->shape[1];
+#pragma omp parallel for
+    for (int b = 0; b < n; b++) {
+        float *g = G->ptr + (size_t)b * 4 * u;
+        const float *cp = (Cprev != nullptr) ? Cprev->ptr + (size_t)b * u : nullptr;
+        float *c = C->ptr + (size_t)b * u;
+        float *h = H->ptr + (size_t)b * u;
+        // Simple loops over contiguous gates, so the math functions are vectorized
+        for (int j = 0; j < 3 * u; j++) g[j] = sigmoid(g[j]);
+        for (int j = 3 * u; j < 4 * u; j++) g[j] = ::tanhf(g[j]);
+
+        for (int j = 0; j < u; j++) c[j] = g[j] * g[3 * u + j];
+        if (cp != nullptr)
+            for (int j = 0; j < u; j++) c[j] += g[u + j] * cp[j];
+        for (int j = 0; j < u; j++) h[j] = g[2 * u + j] * ::tanhf(c[j]);
+    }
+    _profile(_CPU_LSTM_CELL, 1);
+}
+
+void cpu_d_lstm_cell(Tensor *G, Tensor *Cprev, Tensor *C, Tensor *dH, Tensor *dC, Tensor *dG){
+    _profile(_CPU_D_LSTM_CELL, 0);
+    int n = C->shape[0];
+    int u = C->shape[1];
+#pragma omp parallel for
+    for (int b = 0; b < n; b++) {
+        const float *g = G->ptr + (size_t)b * 4 * u;
+        const float *cp = (Cprev != nullptr) ? Cprev->ptr + (size_t)b * u : nullptr;
+        const float *c = C->ptr + (size_t)b * u;
+        const float *dh = dH->ptr + (size_t)b * u;
+        float *dc = dC->ptr + (size_t)b * u;
+        float *dg = dG->ptr + (size_t)b * 4 * u;
+        // tanh(c) in the slot of the output gate, which is written last
+        for (int j = 0; j < u; j++) dg[2 * u + j] = ::tanhf(c[j]);
+        for (int j = 0; j < u; j++) {
+            float i = g[j];
+            float f = g[u + j];
+            float o = g[2 * u + j];
+            float z = g[3 * u + j];
+            float tc = dg[2 * u + j];
+
+            float d = dc[j] + dh[j] * o * (1.0f - tc * tc);
+            dg[j] = d * z * i * (1.0f - i);
+            dg[u + j] = (cp != nullptr) ? d * cp[j] * f * (1.0f - f) : 0.0f;
+            dg[2 * u + j] = dh[j] * tc * o * (1.0f - o);
+            dg[3 * u + j] = d * i * (1.0f - z * z);
+            dc[j] = d * f;
+        }
+    }
+    _profile(_CPU_D_LSTM_CELL, 1);
+}
+
+void cpu_gru_cell(Tensor *GX, Tensor *GH, Tensor *Hprev, Tensor *H, Tensor *mask){
+    _profile(_CPU_GRU_CELL, 0);
+    int n = H->shape[0];
+    int u = H->shape[1];
+#pragma omp parallel for
+    for (int b = 0; b < n; b++) {
+        float *gx = GX->ptr + (size_t)b * 3 * u;
+        const float *gh = GH->ptr + (size_t)b * 3 * u;
+        const float *hp = (Hprev != nullptr) ? Hprev->ptr + (size_t)b * u : nullptr;
+        float *h = H->ptr + (size_t)b * u;
+
+        // Hprev may be H (decoding step by step)
+        if ((mask != nullptr) && (mask->ptr[b] == 0.0f)) {
+            for (int j = 0; j < u; j++) h[j] = (hp != nullptr) ? hp[j] : 0.0f;
+            continue;
+        }
+
+        for (int j = 0; j < 2 * u; j++) gx[j] = sigmoid(gx[j] + gh[j]);
+        for (int j = 0; j < u; j++) gx[2 * u + j] = ::tanhf(gx[2 * u + j] + gx[u + j] * gh[2 * u + j]);
+
+        if (hp != nullptr)
+            for (int j = 0; j < u; j++) h[j] = gx[2 * u + j] + gx[j] * (hp[j] - gx[2 * u + j]);
+        else
+            for (int j = 0; j < u; j++) h[j] = (1.0f - gx[j]) * gx[2 * u + j];
+    }
+    _profile(_CPU_GRU_CELL, 1);
+}
+
+void cpu_d_gru_cell(Tensor *GX, Tensor *GH, Tensor *Hprev, Tensor *dH, Tensor *dGX, Tensor *dGH, Tensor *dHprev, Tensor *mask){
+    _profile(_CPU_D_GRU_CELL, 0);
+    int n = dH->shape[0];
+    int u = dH->shape[1];
+#pragma omp parallel for
+    for (int b = 0; b < n; b++) {
+        const float *g = GX->ptr + (size_t)b * 3 * u;
+        const float *gh = GH->ptr + (size_t)b * 3 * u;
+        const float *hp = (Hprev != nullptr) ? Hprev->ptr + (size_t)b * u : nullptr;
+        const float *dh = dH->ptr + (size_t)b * u;
+        float *dgx = dGX->ptr + (size_t)b * 3 * u;
+        float *dgh = dGH->ptr + (size_t)b * 3 * u;
+        float *dhp = (dHprev != nullptr) ? dHprev->ptr + (size_t)b * u : nullptr;
+
+        if ((mask != nullptr) && (mask->ptr[b] == 0.0f)) {
+            for (int j = 0; j < 3 * u; j++) dgx[j] = dgh[j] = 0.0f;
+            if (dhp != nullptr)
+                for (int j = 0; j < u; j++) dhp[j] += dh[j];
+            continue;
+        }
+
+        for (int j = 0; j < u; j++) {
+            float z = g[j];
+            float r = g[u + j];
+            float c = g[2 * u + j];
+            float p = (hp != nullptr) ? hp[j] : 0.0f;
+
+            float dc = dh[j] * (1.0f - z) * (1.0f - c * c);
+            float dz = dh[j] * (p - c) * z * (1.0f - z);
+            float dr = dc * gh[2 * u + j] * r * (1.0f - r);
+
+            dgx[j] = dgh[j] = dz;
+            dgx[u + j] = dgh[u + j] = dr;
+            dgx[2 * u + j] = dc;
+            dgh[2 * u + j] = dc * r;
+            if (dhp != nullptr) dhp[j] += dh[j] * z;
+        }
+    }
+    _profile(_CPU_D_GRU_CELL, 1);
+}
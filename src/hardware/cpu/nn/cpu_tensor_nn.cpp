@@ -7,7 +7,10 @@
 * All rights reserved
 */
 
+#include <cstring>
+
 #include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+#include "eddl/hardware/cpu/cpu_tensor.h"
 
 void cpu_repeat_nn(Tensor *A, Tensor *B, vector<int> size){
     _profile(_CPU_REPEAT_NN, 0);
@@ -52,38 +55,153 @@ void cpu_d_repeat_nn(Tensor *D, Tensor *A, vector<int> size){
 }
 
 
-void cpu_select_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
+// Resamples the middle axis of {outer, n_in, inner} into {outer, n_out, inner}
+static void upsampling_pass(const float *in, float *out, int outer, int n_in, int n_out, int inner,
+                            const int *i0, const int *i1, const float *w1, bool bilinear){
+    if (inner == 1) {
+        #pragma omp parallel for
+        for (int o = 0; o < outer; o++) {
+            const float *a = in + (size_t)o * n_in;
+            float *b = out + (size_t)o * n_out;
+            if (bilinear) for (int j = 0; j < n_out; j++) b[j] = a[i0[j]] + w1[j] * (a[i1[j]] - a[i0[j]]);
+            else for (int j = 0; j < n_out; j++) b[j] = a[i0[j]];
+        }
+        return;
+    }
+
+    // Whole rows of the inner axes: contiguous, vectorized
     #pragma omp parallel for
-    for (int b = 0; b < B->shape[0]; b++) {
-        for (int i = 0; i < B->stride[0]; i++) {
-            B->ptr[b*B->stride[0] + i] = A->ptr[b*A->stride[0] + sd->cpu_addresses[i]];
+    for (int oj = 0; oj < outer * n_out; oj++) {
+        int o = oj / n_out, j = oj % n_out;
+        const float *a0 = in + ((size_t)o * n_in + i0[j]) * inner;
+        const float *a1 = in + ((size_t)o * n_in + i1[j]) * inner;
+        float *b = out + (size_t)oj * inner;
+        float w = w1[j];
+        if (bilinear && (w != 0.0f)) {
+            #pragma omp simd
+            for (int k = 0; k < inner; k++) b[k] = a0[k] + w * (a1[k] - a0[k]);
         }
+        else std::memcpy(b, a0, inner * sizeof(float));
     }
 }
 
-void cpu_select_back_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
+// Transpose of upsampling_pass: {outer, n_out, inner} => {outer, n_in, inner}, gathering every
+// output that read each input (no scatter, so no races between threads)
+static void d_upsampling_pass(const float *d, float *out, int outer, int n_in, int n_out, int inner,
+                              const int *bstart, const int *bidx, const float *bw, bool acc){
+    if (inner == 1) {
+        #pragma omp parallel for
+        for (int o = 0; o < outer; o++) {
+            const float *dj = d + (size_t)o * n_out;
+            float *b = out + (size_t)o * n_in;
+            for (int i = 0; i < n_in; i++) {
+                float sum = acc ? b[i] : 0.0f;
+                for (int p = bstart[i]; p < bstart[i + 1]; p++) sum += bw[p] * dj[bidx[p]];
+                b[i] = sum;
+            }
+        }
+        return;
+    }
+
     #pragma omp parallel for
-    for (int b = 0; b < A->shape[0]; b++) {
-        for (int i = 0; i < A->stride[0]; i++) {  // walk stride
-            B->ptr[b*B->stride[0] + sd->cpu_addresses[i]] += A->ptr[b*A->stride[0] + i];  // delta_parent += delta
+    for (int oi = 0; oi < outer * n_in; oi++) {
+        int o = oi / n_in, i = oi % n_in;
+        float *b = out + (size_t)oi * inner;
+        if (!acc) std::memset(b, 0, inner * sizeof(float));
+        for (int p = bstart[i]; p < bstart[i + 1]; p++) {
+            const float *dj = d + ((size_t)o * n_out + bidx[p]) * inner;
+            float w = bw[p];
+            #pragma omp simd
+            for (int k = 0; k < inner; k++) b[k] += w * dj[k];
         }
     }
 }
 
-void cpu_set_select_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
-   #pragma omp parallel for
-    for (int b = 0; b < B->shape[0]; b++) {
-        for (int i = 0; i < B->stride[0]; i++) {
-            A->ptr[b*A->stride[0] + sd->cpu_addresses[i]] = B->ptr[b*B->stride[0] + i];
+// Spatial axes that are actually resampled (at least one, so the output is always written)
+static vector<int> upsampling_axes(UpSamplingDescriptor *D){
+    vector<int> axes;
+    for (int a = 0; a < D->size.size(); a++)
+        if (D->size[a] != 1) axes.push_back(a);
+    if (axes.empty()) axes.push_back(0);
+    return axes;
+}
+
+void cpu_upsampling(Tensor *A, Tensor *B, UpSamplingDescriptor *D){
+    _profile(_CPU_UPSAMPLING, 0);
+    vector<int> axes = upsampling_axes(D);
+
+    // One pass per axis, from the innermost one; the last pass writes B
+    vector<int> cur = A->shape;
+    const float *src = A->ptr;
+    for (int p = axes.size() - 1; p >= 0; p--) {
+        int a = axes[p], ax = a + 2;
+        int outer = 1, inner = 1;
+        for (int k = 0; k < ax; k++) outer *= cur[k];
+        for (int k = ax + 1; k < cur.size(); k++) inner *= cur[k];
+        cur[ax] = B->shape[ax];
+
+        float *dst = B->ptr;
+        if (p > 0) {
+            D->buffer[p % 2].resize((size_t)outer * cur[ax] * inner);
+            dst = D->buffer[p % 2].data();
         }
+
+        upsampling_pass(src, dst, outer, A->shape[ax], B->shape[ax], inner,
+                        D->i0[a].data(), D->i1[a].data(), D->w1[a].data(), D->bilinear);
+        src = dst;
     }
+    _profile(_CPU_UPSAMPLING, 1);
 }
 
-void cpu_set_select_back_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
-   #pragma omp parallel for
-    for (int b = 0; b < B->shape[0]; b++) {
-        for (int i = 0; i < B->stride[0]; i++) {
-            B->ptr[b*B->stride[0] + i] += A->ptr[b*A->stride[0] + sd->cpu_addresses[i]];
+void cpu_d_upsampling(Tensor *D, Tensor *A, UpSamplingDescriptor *ud){
+    _profile(_CPU_D_UPSAMPLING, 0);
+    vector<int> axes = upsampling_axes(ud);
+
+    // Transposed passes in reverse order (outermost axis first); the last one accumulates into A
+    vector<int> cur = D->shape;
+    const float *src = D->ptr;
+    for (int p = 0; p < axes.size(); p++) {
+        int a = axes[p], ax = a + 2;
+        int outer = 1, inner = 1;
+        for (int k = 0; k < ax; k++) outer *= cur[k];
+        for (int k = ax + 1; k < cur.size(); k++) inner *= cur[k];
+        cur[ax] = A->shape[ax];
+
+        bool last = (p == axes.size() - 1);
+        float *dst = A->ptr;
+        if (!last) {
+            ud->buffer[p % 2].resize((size_t)outer * cur[ax] * inner);
+            dst = ud->buffer[p % 2].data();
         }
+
+        d_upsampling_pass(src, dst, outer, A->shape[ax], D->shape[ax], inner,
+                          ud->bstart[a].data(), ud->bidx[a].data(), ud->bw[a].data(), last);
+        src = dst;
     }
+    _profile(_CPU_D_UPSAMPLING, 1);
+}
+
+
+// The descriptor is for one sample: the batch is an extra outer dim
+static vector<int> batch_shape(int batch, const vector<int> &shape) {
+    vector<int> s(shape);
+    s.insert(s.begin(), batch);
+    return s;
+}
+
+void cpu_select_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
+    cpu_strided_copy(A->ptr + sd->offset, B->ptr, batch_shape(B->shape[0], sd->oshape), batch_shape(A->stride[0], sd->strides), true, false);
+}
+
+void cpu_select_back_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
+    // delta_parent += delta
+    cpu_strided_copy(B->ptr + sd->offset, A->ptr, batch_shape(A->shape[0], sd->oshape), batch_shape(B->stride[0], sd->strides), false, true);
+}
+
+void cpu_set_select_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
+    cpu_strided_copy(A->ptr + sd->offset, B->ptr, batch_shape(B->shape[0], sd->oshape), batch_shape(A->stride[0], sd->strides), false, false);
+}
+
+void cpu_set_select_back_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
+    cpu_strided_copy(A->ptr + sd->offset, B->ptr, batch_shape(B->shape[0], sd->oshape), batch_shape(A->stride[0], sd->strides), true, true);
 }
\ No newline at end of file
@@ -25,9 +25,7 @@ LConv::LConv(Layer *parent, const vector<int> &ks, const vector<int> &st,
              const vector<int> &p, string name, int dev, int mem) : LConv(parent, new ConvolDescriptor(ks, st, p, mem), name, dev, mem) {}
 
 LConv::LConv(Layer *parent, int filters, const vector<int> &kernel_size, const vector<int> &strides, string padding,
-             int groups, const vector<int> &dilation_rate, bool use_bias, string name, int dev, int mem) : LConv(parent, new ConvolDescriptor(filters, kernel_size, strides, padding, use_bias, mem), name, dev, mem) {
-    // TODO: Implement (Fix initialization)
-};
+             int groups, const vector<int> &dilation_rate, bool use_bias, string name, int dev, int mem) : LConv(parent, new ConvolDescriptor(filters, kernel_size, strides, padding, use_bias, mem, groups, dilation_rate), name, dev, mem) {};
 
 LConv::LConv(Layer *parent, ConvolDescriptor *D, string name, int dev, int mem) : LinLayer(name, dev, mem) {
     if (parent->output->ndim != 4) msg("LConv only works over 4D tensors", "LConv::LConv");
@@ -56,6 +54,7 @@ LConv::LConv(Layer *parent, ConvolDescriptor *D, string name, int dev, int mem)
     distributed_training = false;
     cd->acc_gK = nullptr;
     cd->acc_gbias = nullptr;
+    qd = nullptr;
 
     parent->addchild(this);
     addparent(parent);
@@ -64,6 +63,7 @@ LConv::LConv(Layer *parent, ConvolDescriptor *D, string name, int dev, int mem)
 
 LConv::~LConv(){
 //    delete cd;  // Just in case
+    delete qd;
 }
 
 // virtual
@@ -88,10 +88,25 @@ void LConv::mem_delta(){
 }
 
 void LConv::forward() {
+    // Sample by sample: the input can be the strided slice of a concat
+    if (qd != nullptr && qd->calibrating) {
+        int ssize = input->size / input->shape[0];
+        for (int b = 0; b < input->shape[0]; b++) qd->observe(input->ptr + (size_t)b * input->stride[0], ssize);
+    }
+
+    if (qd != nullptr && qd->ready() && mode == TSMODE && input->isCPU()) {
+        if (!qd->packed) qd->pack(cd->K->ptr, cd->kz * cd->kr * cd->kc, cd->nk, false);
+        tensorNN::QConv2D(this->cd, qd);
+        return;
+    }
+
     tensorNN::Conv2D(this->cd);
 }
 
 void LConv::backward() {
+    // Weights are about to change: repack them on the next quantized forward
+    if (qd != nullptr) qd->packed = false;
+
     //get gradients with provided delta
     if (trainable) { tensorNN::Conv2D_grad(this->cd); }
 
@@ -128,7 +143,7 @@ void LConv::apply_accumulated_gradients() {
 }
 
 Layer *LConv::share(int c, int bs, vector<Layer *> p) {
-    LConv *n = new LConv(p[0], cd->ksize, cd->stride, cd->pad,  "share_"+name, dev,mem_level);
+    LConv *n = new LConv(p[0], new ConvolDescriptor(cd->ksize, cd->stride, cd->pad, mem_level, cd->groups, cd->dilation), "share_"+name, dev, mem_level);
     n->orig = this;
     n->isshared=true;
     n->trainable = trainable;
@@ -176,7 +191,7 @@ Layer *LConv::share(int c, int bs, vector<Layer *> p) {
 
 Layer *LConv::clone(int c, int bs, vector<Layer *> p, int todev) {
 
-    LConv *n = new LConv(p[0], cd->ksize, cd->stride, cd->pad,  name, todev, this->mem_level);
+    LConv *n = new LConv(p[0], new ConvolDescriptor(cd->ksize, cd->stride, cd->pad, this->mem_level, cd->groups, cd->dilation), name, todev, this->mem_level);
     n->trainable = trainable;
 
     n->orig = this;
@@ -25,9 +25,7 @@ LConv1D::LConv1D(Layer *parent, const vector<int> &ks, const vector<int> &st,
              const vector<int> &p, string name, int dev, int mem) : LConv1D(parent, new ConvolDescriptor(ks, st, p, mem), name, dev, mem) {}
 
 LConv1D::LConv1D(Layer *parent, int filters, const vector<int> &kernel_size, const vector<int> &strides, string padding,
-             int groups, const vector<int> &dilation_rate, bool use_bias, string name, int dev, int mem) : LConv1D(parent, new ConvolDescriptor(filters, kernel_size, strides, padding, use_bias, mem), name, dev, mem) {
-    // TODO: Implement (Fix initialization)
-};
+             int groups, const vector<int> &dilation_rate, bool use_bias, string name, int dev, int mem) : LConv1D(parent, new ConvolDescriptor(filters, kernel_size, strides, padding, use_bias, mem, groups, dilation_rate), name, dev, mem) {};
 
 LConv1D::LConv1D(Layer *parent, ConvolDescriptor *D, string name, int dev, int mem) : LinLayer(name, dev, mem) {
     if (parent->output->ndim != 3) msg("LConv only works over 3D tensors", "LConv1D::LConv1D");
@@ -143,7 +141,7 @@ void LConv1D::apply_accumulated_gradients() {
 }
 
 Layer *LConv1D::share(int c, int bs, vector<Layer *> p) {
-    LConv1D *n = new LConv1D(p[0], cd->ksize, cd->stride, cd->pad,  "share_"+name, dev,mem_level);
+    LConv1D *n = new LConv1D(p[0], new ConvolDescriptor(cd->ksize, cd->stride, cd->pad, mem_level, cd->groups, cd->dilation), "share_"+name, dev, mem_level);
     n->orig = this;
     n->isshared=true;
     n->trainable = trainable;
@@ -191,7 +189,7 @@ Layer *LConv1D::share(int c, int bs, vector<Layer *> p) {
 
 Layer *LConv1D::clone(int c, int bs, vector<Layer *> p, int todev) {
 
-    LConv1D *n = new LConv1D(p[0], cd->ksize, cd->stride, cd->pad,  name, todev, this->mem_level);
+    LConv1D *n = new LConv1D(p[0], new ConvolDescriptor(cd->ksize, cd->stride, cd->pad, this->mem_level, cd->groups, cd->dilation), name, todev, this->mem_level);
     n->trainable = trainable;
 
     n->orig = this;
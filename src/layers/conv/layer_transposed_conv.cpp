@@ -19,20 +19,179 @@ using namespace std;
 
 int LConvT::total_layers = 0;
 
+// Output size of the transposed convolution along one axis: the input size of the
+// convolution that would map an output of that size back to the input of this layer
+static int convt_output(string padding, const vector<int> &pad, int in, int k, int s, int d, int op, bool row) {
+    if (padding=="same,none") padding = row ? "same" : "none";
+    else if (padding=="none,same") padding = row ? "none" : "same";
+
+    if (padding=="same" || padding=="zeros") {
+        if (op != 0) msg("Output padding is not supported with \"same\" padding", "LConvT::LConvT");
+        return in * s;
+    } else if (padding=="valid" || padding=="none") {
+        return (in - 1) * s + (k - 1) * d + 1 + op;
+    } else {  // custom
+        int p = row ? pad[0] + pad[1] : pad[2] + pad[3];
+        return (in - 1) * s - p + (k - 1) * d + 1 + op;
+    }
+}
+
 // ---- TRANSPOSED CONVOLUTION ----
 LConvT::LConvT(Layer *parent, int filters, const vector<int> &kernel_size,
     const vector<int> &output_padding, string padding, const vector<int> &dilation_rate,
-    const vector<int> &strides, bool use_bias, string name, int dev, int mem) : LConvT(parent, new ConvolDescriptor(filters, kernel_size, strides, padding,mem), name, dev, mem) {
-    // TODO: Implement (Fix initialization)
-};
+    const vector<int> &strides, bool use_bias, string name, int dev, int mem) : LConvT(parent, new ConvolDescriptor(filters, kernel_size, strides, padding, use_bias, mem, 1, dilation_rate), output_padding, name, dev, mem) {};
 
-LConvT::LConvT(Layer *parent, ConvolDescriptor *cd, string name, int dev, int mem) : LinLayer(name, dev, mem) {
-    // TODO: Implement (Fix initialization)
+LConvT::LConvT(Layer *parent, ConvolDescriptor *cd, const vector<int> &output_padding, string name, int dev, int mem) : LinLayer(name, dev, mem) {
+    if (parent->output->ndim != 4) msg("LConvT only works over 4D tensors", "LConvT::LConvT");
+    if (output_padding.size() != 2) msg("Output padding must have 2 dimensions", "LConvT::LConvT");
+    if (cd->groups != 1) msg("Grouped transposed convolutions are not supported", "LConvT::LConvT");
+
+    // Set default name
     if(name.empty()) this->name = "convt" + to_string(++total_layers);
 
+    input = parent->output;
     this->cd = cd;
+    this->filters = cd->ksize[0];
+    this->use_bias = cd->use_bias;
+    this->output_padding = output_padding;
+
+    int ir = input->shape[2], ic = input->shape[3];
+    int r = convt_output(cd->padding, cd->pad, ir, cd->ksize[1], cd->stride[0], cd->dilation[0], output_padding[0], true);
+    int c = convt_output(cd->padding, cd->pad, ic, cd->ksize[2], cd->stride[1], cd->dilation[1], output_padding[1], false);
+    if ((r <= 0) || (c <= 0)) msg("Invalid output shape", "LConvT::LConvT");
+
+    output = new Tensor(vector<int>{input->shape[0], filters, r, c}, dev);
+
+    // The forward of this layer is the backward (data) pass of a convolution from the output
+    // space to the input space, and viceversa. Its filters {in_channels, filters, kr, kc}
+    // match the ONNX ConvTranspose layout.
+    cd->ksize[0] = input->shape[1];
+    cd->use_bias = false;
+    cd->build(output);
+    if ((cd->r != ir) || (cd->c != ic)) msg("Output padding must be lower than the stride", "LConvT::LConvT");
+
+    // Bias is added on the output channels, not on the ones of the descriptor
+    delete cd->bias;
+    delete cd->gbias;
+    cd->bias = cd->gbias = nullptr;
+
+    bias = new Tensor(vector<int>{filters}, dev);
+    gbias = new Tensor(vector<int>{filters}, dev);
+
+    cd->D = input;
+    cd->ID = output;
+
+    params.push_back(cd->K);
+    params.push_back(bias);
+
+    gradients.push_back(cd->gK);
+    gradients.push_back(gbias);
+
+    parent->addchild(this);
+    addparent(parent);
 }
 
 LConvT::~LConvT(){
-    delete cd;  // Just in case
-}
\ No newline at end of file
+    delete cd->O;  // Delta wrt the input (scratch)
+    delete cd;
+}
+
+void LConvT::resize(int batch){
+    output->resize(batch);
+    cd->resize(batch);
+}
+
+void LConvT::forward() {
+    // output = col2im(input * K)
+    cd->I = output;
+    cd->D = input;
+    cd->ID = output;
+    output->fill_(0.0);
+    tensorNN::Conv2D_back(this->cd);
+
+    if (use_bias) tensorNN::Conv2D_bias(output, bias);
+}
+
+void LConvT::backward() {
+    // Delta wrt the input: a regular convolution of the delta. It also leaves the
+    // lowered delta in the descriptor, which is reused for the gradient of the filters.
+    cd->I = delta;
+    tensorNN::Conv2D(this->cd);
+
+    if (trainable) {
+        cd->D = input;
+        tensorNN::Conv2D_grad(this->cd);
+
+        if (use_bias) tensorNN::Conv2D_gbias(delta, gbias);
+    }
+
+    // backprop delta
+    if (this->parent.size()) {
+        Tensor::inc(cd->O, parent[0]->delta);
+    }
+
+    // Regularizer
+    if (trainable) if(reg!= nullptr) {reg->apply(cd->K);}
+}
+
+Layer *LConvT::share(int c, int bs, vector<Layer *> p) {
+    auto *d = new ConvolDescriptor({filters, cd->kr, cd->kc}, cd->stride, cd->pad, mem_level, 1, cd->dilation);
+    d->padding = cd->padding;
+    d->use_bias = use_bias;
+
+    LConvT *n = new LConvT(p[0], d, output_padding, "share_"+name, dev, mem_level);
+    n->orig = this;
+    n->isshared=true;
+    n->trainable = trainable;
+
+    //share params
+    for (int i = 0; i < n->params.size(); i++) delete n->params[i];
+    n->params.clear();
+
+    n->cd->K = cd->K;
+    n->bias = bias;
+
+    n->params.push_back(n->cd->K);
+    n->params.push_back(n->bias);
+
+    //share gradients
+    for (int i = 0; i < n->gradients.size(); i++) delete n->gradients[i];
+    n->gradients.clear();
+
+    n->cd->gK = cd->gK;
+    n->gbias = gbias;
+
+    n->gradients.push_back(n->cd->gK);
+    n->gradients.push_back(n->gbias);
+
+    n->reg=reg;
+    n->init=init;
+
+    return n;
+}
+
+Layer *LConvT::clone(int c, int bs, vector<Layer *> p, int todev) {
+    auto *d = new ConvolDescriptor({filters, cd->kr, cd->kc}, cd->stride, cd->pad, mem_level, 1, cd->dilation);
+    d->padding = cd->padding;
+    d->use_bias = use_bias;
+
+    LConvT *n = new LConvT(p[0], d, output_padding, name, todev, mem_level);
+    n->trainable = trainable;
+
+    n->orig = this;
+
+    n->reg=reg;
+    n->init=init;
+
+    return n;
+}
+
+
+string LConvT::plot(int c) {
+    string s;
+
+    if (c) s = name + " [label=" + "\"" + name + "\",style=filled,fontsize=12,fillcolor=gray,shape=box]";
+    else s = name + " [label=" + "\"" + name + "\",style=filled,fontsize=12,fillcolor=White,shape=box]";
+
+    return s;
+}
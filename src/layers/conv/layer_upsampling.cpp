@@ -19,39 +19,46 @@ using namespace std;
 
 int LUpSampling::total_layers = 0;
 
-LUpSampling::LUpSampling(Layer *parent, const vector<int> &size, string interpolation, string name, int dev, int mem) : LinLayer(name, dev, mem) {
+LUpSampling::LUpSampling(Layer *parent, const vector<int> &size, string interpolation, bool align_corners, string name, int dev, int mem) : LinLayer(name, dev, mem) {
+    if (interpolation == "linear" || interpolation == "trilinear") interpolation = "bilinear";
+    if (interpolation != "nearest" && interpolation != "bilinear") msg("Unknown interpolation (" + interpolation + "). Use nearest or bilinear", "LUpSampling::LUpSampling");
+
     this->size = size;
     this->interpolation = interpolation;
+    this->align_corners = align_corners;
 
     if(name.empty()) this->name = "upsampling" + to_string(++total_layers);
 
     input = parent->output;
-    output = new Tensor(vector<int>{input->shape[0], input->shape[1], input->shape[2]*size[0], input->shape[3]*size[1]}, dev);
-//    delta = new Tensor(output->shape, dev);
+    ud = new UpSamplingDescriptor(size, interpolation == "bilinear", align_corners, dev);
+    ud->build(input->shape);
+    output = new Tensor(ud->oshape, dev);
 
     parent->addchild(this);
     addparent(parent);
 }
 
+LUpSampling::~LUpSampling(){
+    delete ud;
+}
 
 void LUpSampling::forward() {
-    //Repeats the rows and columns of the data by size[0] and size[1] respectively.
-    tensorNN::repeat_nn(this->input, this->output, this->size);
+    tensorNN::upsampling(this->input, this->output, this->ud);
 }
 
 void LUpSampling::backward() {
-    tensorNN::d_repeat_nn(delta, parent[0]->delta, this->size);
+    tensorNN::d_upsampling(delta, parent[0]->delta, this->ud);
 }
 
 Layer *LUpSampling::share(int c, int bs, vector<Layer *> p) {
-    LUpSampling *n = new LUpSampling(p[0], this->size, this->interpolation, "share_"+to_string(c)+this->name, this->dev, this->mem_level);
+    LUpSampling *n = new LUpSampling(p[0], this->size, this->interpolation, this->align_corners, "share_"+to_string(c)+this->name, this->dev, this->mem_level);
     n->orig = this;
 
     return n;
 }
 
 Layer *LUpSampling::clone(int c, int bs, vector<Layer *> p, int todev) {
-    LUpSampling *n = new LUpSampling(p[0], this->size, this->interpolation,  name, todev, this->mem_level);
+    LUpSampling *n = new LUpSampling(p[0], this->size, this->interpolation, this->align_corners, name, todev, this->mem_level);
     n->orig = this;
 
     return n;
@@ -42,6 +42,7 @@ LDense::LDense(Layer *parent, int ndim, bool use_bias, string name, int dev, int
     distributed_training = false;
     acc_gW = nullptr;
     acc_gbias = nullptr;
+    qd = nullptr;
 
     parent->addchild(this);
     addparent(parent);
@@ -49,14 +50,26 @@ LDense::LDense(Layer *parent, int ndim, bool use_bias, string name, int dev, int
 
 LDense::~LDense(){
     // input, output, delta, params[], and gradients[], acc_gradients[] => deleted in ~Layer()
+    delete qd;
 }
 
 void LDense::forward() {
+    if (qd != nullptr && qd->calibrating) qd->observe(input->ptr, input->size);
+
+    if (qd != nullptr && qd->ready() && mode == TSMODE && input->isCPU()) {
+        if (!qd->packed) qd->pack(W->ptr, W->shape[0], W->shape[1], true);
+        tensorNN::QDense(input, output, use_bias ? bias : nullptr, qd);
+        return;
+    }
+
     Tensor::mult2D(input, 0, W, 0, output, 0);
     if (use_bias) Tensor::sum2D_rowwise(output, bias, output);
 }
 
 void LDense::backward() {
+    // Weights are about to change: repack them on the next quantized forward
+    if (qd != nullptr) qd->packed = false;
+
     //get gradients with provided delta
     if (trainable) {
         Tensor::mult2D(input, 1, delta, 0, gW, 1);
@@ -13,6 +13,7 @@
 #include <iostream>
 
 #include "eddl/layers/core/layer_core.h"
+#include "eddl/random.h"
 
 using namespace std;
 
@@ -30,7 +31,10 @@ LDropout::LDropout(Layer *parent, float df, bool iw, string name, int dev, int m
     output = new Tensor(input->shape, dev);
     //    delta = new Tensor(output->shape, dev);
 
-    mask = new Tensor(input->shape, dev);
+    // On CPU the mask is a function of (seed, index) and is never materialized
+    mask = nullptr;
+    if (!output->isCPU()) mask = new Tensor(input->shape, dev);
+    seed = 0;
 
     parent->addchild(this);
     addparent(parent);
@@ -43,14 +47,21 @@ LDropout::~LDropout(){
 // virtual
 void LDropout::resize(int batch){
     Layer::resize(batch);
-    delete mask;
-    mask = new Tensor(input->shape, dev);
+    if (mask != nullptr) {
+        delete mask;
+        mask = new Tensor(input->shape, dev);
+    }
 }
 
 void LDropout::forward() {
     if (mode == TRMODE) {
-        mask->fill_rand_binary_(1.0 - df);
-        Tensor::el_mult(input, mask, output, 0);
+        if (mask == nullptr) {
+            seed = new_seed();
+            tensorNN::Dropout(input, output, 1.0 - df, 1.0, seed);
+        } else {
+            mask->fill_rand_binary_(1.0 - df);
+            Tensor::el_mult(input, mask, output, 0);
+        }
     } else {
         Tensor::copy(input, output);
         if (iw) output->mult_(1.0 - df);
@@ -59,7 +70,8 @@ void LDropout::forward() {
 }
 
 void LDropout::backward() {
-    Tensor::el_mult(delta, mask, parent[0]->delta, 1);
+    if (mask == nullptr) tensorNN::D_Dropout(delta, parent[0]->delta, 1.0 - df, 1.0, seed);
+    else Tensor::el_mult(delta, mask, parent[0]->delta, 1);
 }
 
 
@@ -13,6 +13,7 @@
 #include <iostream>
 
 #include "eddl/layers/core/layer_core.h"
+#include "eddl/tensor/nn/tensor_nn.h"
 
 using namespace std;
 
@@ -59,7 +60,9 @@ LEmbedding::LEmbedding(Layer *parent, int vocsize, int length, int dim, bool mas
     params.push_back(E);
 
     gE=new Tensor({vocsize,dim},dev);
+    gE->fill_(0.0);
     gradients.push_back(gE);
+    grows=new vector<int>();
 
 
     parent->addchild(this);
@@ -68,6 +71,7 @@ LEmbedding::LEmbedding(Layer *parent, int vocsize, int length, int dim, bool mas
 }
 
 LEmbedding::~LEmbedding(){
+    if (!isshared) delete grows;
 }
 
 void LEmbedding::forward()
@@ -76,14 +80,19 @@ void LEmbedding::forward()
   int b=input->shape[0];
   int indim=input->ndim;
 
-
+  if (input->isCPU()) {
+    // Read the words in place, no need to copy the input
+    int oov=tensorNN::Embedding(E, input, output, sind, mask_zeros);
+    if (oov>0) cout<<"\n Warning: "<<oov<<" words out of vocabulary\n";
+    return;
+  }
 
   input->reshape_({b*length});
 
   sind.clear();
 
-  Tensor *inputc=input->clone();
-  inputc->toCPU();
+  Tensor *inputc=new Tensor(input->shape,DEV_CPU);
+  Tensor::copy(input,inputc);
 
   for(int i=0;i<b*length;i++) {
       int val=(int)inputc->ptr[i*inputc->stride[0]];
@@ -113,18 +122,34 @@ void LEmbedding::forward()
 void LEmbedding::backward()
 {
    if (trainable) {
-     int b=output->shape[0];
-     delta->reshape_({b*length,dim});
+     if (delta->isCPU()) {
+       // Deduplicated scatter-add, only the rows present in the batch are written
+       tensorNN::Embedding_back(delta, gE, sind, mask_zeros, *grows);
+     }
+     else {
+       int b=output->shape[0];
+       delta->reshape_({b*length,dim});
 
-     Tensor::deselect(delta,gE, sind, 0,sind.size(),1, mask_zeros); //1=inc
+       Tensor::deselect(delta,gE, sind, 0,sind.size(),1, mask_zeros); //1=inc
 
-     delta->reshape_({b,length*dim});
+       delta->reshape_({b,length*dim});
+     }
 
      if(reg!= nullptr) {reg->apply(E);}
    }
 }
 
+void LEmbedding::zeroGrads() {
+    if (gE->isCPU()) {
+        tensorNN::ZeroRows(gE, *grows);
+        grows->clear();
+    }
+    else gE->fill_(0.0);
+}
 
+vector<int> *LEmbedding::sparse_grad_rows(int p) {
+    return gE->isCPU() ? grows : nullptr;
+}
 
 
 Layer *LEmbedding::share(int c, int bs, vector<Layer *> p) {
@@ -142,6 +167,8 @@ Layer *LEmbedding::share(int c, int bs, vector<Layer *> p) {
 
     n->E = E;
     n->gE = gE;
+    delete n->grows;
+    n->grows = grows;
 
     n->params.push_back(E);
     n->gradients.push_back(gE);
@@ -0,0 +1,78 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "eddl/layers/da/layer_da.h"
+
+
+using namespace std;
+
+int LAugmentRandom::total_layers = 0;
+
+LAugmentRandom::LAugmentRandom(Layer *parent, AugmentDescriptor *ad, string name, int dev, int mem) : LDataAugmentation(parent, name, dev, mem) {
+    if(name.empty()) this->name = "augment_random" + to_string(++total_layers);
+
+    output = new Tensor(input->shape, dev);
+
+    // Params
+    this->ad = ad;
+
+    parent->addchild(this);
+    addparent(parent);
+}
+
+LAugmentRandom::~LAugmentRandom(){
+    delete ad;
+}
+
+
+void LAugmentRandom::forward() {
+    if (mode == TRMODE) {
+        Tensor::augment_random(this->input, this->output, this->ad);
+    } else {
+        Tensor::copy(input, output);
+    }
+}
+
+void LAugmentRandom::backward() {
+
+}
+
+
+Layer *LAugmentRandom::share(int c, int bs, vector<Layer *> p) {
+    auto *nad = new AugmentDescriptor(ad->angle, ad->translate, ad->scale, ad->shear, ad->flip_h, ad->flip_v,
+                                      ad->brightness, ad->contrast, ad->grayscale, ad->bilinear, ad->mode, ad->cval, ad->device);
+    auto *n = new LAugmentRandom(p[0], nad, "share_"+to_string(c)+this->name, this->dev, this->mem_level);
+    n->orig = this;
+
+    return n;
+}
+
+Layer *LAugmentRandom::clone(int c, int bs, vector<Layer *> p, int todev) {
+    auto *nad = new AugmentDescriptor(ad->angle, ad->translate, ad->scale, ad->shear, ad->flip_h, ad->flip_v,
+                                      ad->brightness, ad->contrast, ad->grayscale, ad->bilinear, ad->mode, ad->cval, todev);
+    auto *n = new LAugmentRandom(p[0], nad, name, todev, this->mem_level);
+    n->orig = this;
+
+    return n;
+}
+
+
+string LAugmentRandom::plot(int c) {
+    string s;
+
+    if (c) s = name + " [label=" + "\"" + name + "\",style=filled,fontsize=12,fillcolor=bisque4,shape=box]";
+    else s = name + " [label=" + "\"" + name + "\",style=filled,fontsize=12,fillcolor=White,shape=box]";
+
+    return s;
+}
@@ -37,6 +37,7 @@ Layer::Layer(string name, int dev, int mem) {
     trainable=true;
     iscloned=false;
     isdecoder=false;
+    carry_states=false;
 
     orig=nullptr;
     net=nullptr;
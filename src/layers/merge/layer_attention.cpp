@@ -0,0 +1,99 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "eddl/layers/merge/layer_merge.h"
+
+
+using namespace std;
+
+int LMultiHeadAttention::total_layers = 0;
+
+LMultiHeadAttention::LMultiHeadAttention(vector<Layer *> parent, int heads, bool causal, string name, int dev, int mem) : MLayer(name, dev, mem) {
+    if ((parent.size() != 1) && (parent.size() != 3)) msg("Error: LMultiHeadAttention needs {qkv} or {q, k, v} layers");
+
+    Tensor *Q = parent[0]->output;
+    Tensor *K = parent[(parent.size() == 3) ? 1 : 0]->output;
+    Tensor *V = parent[(parent.size() == 3) ? 2 : 0]->output;
+    if ((Q->ndim != 3) || (K->ndim != 3) || (V->ndim != 3)) msg("Error: LMultiHeadAttention works over batch x time x dim tensors");
+    if ((Q->shape[2] != K->shape[2]) || (K->shape[1] != V->shape[1])) msg("Error: LMultiHeadAttention with incompatible queries, keys and values");
+    if ((heads < 1) || (Q->shape[2] % heads != 0) || (V->shape[2] % heads != 0)) msg("Error: LMultiHeadAttention dims are not divisible by the number of heads");
+    if (causal && (K->shape[1] < Q->shape[1])) msg("Error: causal LMultiHeadAttention needs at least as many keys as queries");
+
+    this->heads = heads;
+    this->causal = causal;
+
+    if(name.empty()) this->name = "attention" + to_string(++total_layers);
+
+    input = Q;
+
+    output = new Tensor({Q->shape[0], Q->shape[1], V->shape[2]}, dev);
+    lse = new Tensor({Q->shape[0], heads, Q->shape[1]}, dev);
+
+    for (int i = 0; i < parent.size(); ++i) {
+        parent[i]->addchild(this);
+        addparent(parent[i]);
+    }
+
+}
+
+LMultiHeadAttention::~LMultiHeadAttention(){
+    delete lse;
+}
+
+void LMultiHeadAttention::resize(int batch){
+    Layer::resize(batch);
+    lse->resize(batch);
+}
+
+
+// virtual
+
+string LMultiHeadAttention::plot(int c) {
+    string s;
+
+    s = name + " [label=" + "\"" + name + "\",style=filled,fontsize=12,fillcolor=lightblue3,shape=box]";
+
+    return s;
+}
+
+
+void LMultiHeadAttention::forward() {
+    Layer *k = parent[(parent.size() == 3) ? 1 : 0];
+    Layer *v = parent[(parent.size() == 3) ? 2 : 0];
+
+    tensorNN::MultiHeadAttention(parent[0]->output, k->output, v->output, output, lse, heads, causal);
+}
+
+void LMultiHeadAttention::backward() {
+    Layer *k = parent[(parent.size() == 3) ? 1 : 0];
+    Layer *v = parent[(parent.size() == 3) ? 2 : 0];
+
+    tensorNN::D_MultiHeadAttention(parent[0]->output, k->output, v->output, output, lse, delta,
+                                   parent[0]->delta, k->delta, v->delta, heads, causal);
+}
+
+Layer *LMultiHeadAttention::share(int c, int bs, vector<Layer *> p) {
+    LMultiHeadAttention *n = new LMultiHeadAttention(p, heads, causal, "share_"+to_string(c)+this->name, this->dev, this->mem_level);
+    n->orig = this;
+
+    return n;
+}
+
+
+Layer *LMultiHeadAttention::clone(int c, int bs, vector<Layer *> p, int todev) {
+    LMultiHeadAttention *n = new LMultiHeadAttention(p, heads, causal, name, todev, this->mem_level);
+    n->orig = this;
+
+    return n;
+}
@@ -73,6 +73,86 @@ LConcat::LConcat(vector<Layer *> parent, unsigned int axis, string name, int dev
 }
 
 
+// The parents fill the concat (they have been resized too)
+static bool resized(Tensor *t, vector<Layer *> &parent) {
+    long total = 0;
+    for (auto p : parent) total += p->output->size;
+    return total == t->size;
+}
+
+// Whether a slice with these strides is dense from dim `from` on (dims of size 1 are ignored):
+// from 0 it is contiguous, from 1 its samples are
+static bool dense_from(const vector<int> &shape, const vector<int> &strides, int from) {
+    unsigned long int s = 1;
+    for (int d = (int)shape.size() - 1; d >= from; d--) {
+        if ((shape[d] != 1) && (strides[d] != s)) return false;
+        s *= shape[d];
+    }
+    return true;
+}
+
+// Points a tensor at its slice, with the strides of the concat (the Eigen map of 2D tensors
+// is rebuilt by updateData, and dropped when the slice is strided)
+static void point_to(Tensor *t, float *ptr, const vector<int> &strides) {
+    if (!t->isshared) t->deleteData();
+    t->updateData(ptr, nullptr, true);
+    t->stride = strides;
+    if (!t->is_contiguous()) {
+        delete t->ptr2;
+        t->ptr2 = nullptr;
+    }
+}
+
+// A slice that is not contiguous only goes in place when its samples are, for a parent that takes them
+static bool in_place(Tensor *whole, Tensor *t, bool strided) {
+    if (dense_from(t->shape, whole->stride, 0)) return true;
+    return strided && dense_from(t->shape, whole->stride, 1);
+}
+
+void LConcat::view_outputs() {
+    if (output_views.empty() || !output->isCPU() || (output->ptr == nullptr) || !resized(output, parent)) return;
+
+    long int offset = 0;  // along the axis
+    for (int i = 0; i < parent.size(); i++) {
+        Tensor *o = parent[i]->output;
+        float *slice = output->ptr + offset * output->stride[axis];
+        offset += o->shape[axis];
+
+        if (output_views[i] && (o->ptr != slice) && in_place(output, o, strided_views[i])) {
+            point_to(o, slice, output->stride);
+            // A concat moved into another one takes its own parents along
+            auto *c = dynamic_cast<LConcat *>(parent[i]);
+            if (c != nullptr) c->view_outputs();
+        }
+    }
+}
+
+void LConcat::view_deltas() {
+    // With mem_level the delta of the concat is freed before the backward of its parents
+    if (mem_level || delta_views.empty() || (delta == nullptr) || !delta->isCPU() || !resized(delta, parent)) return;
+
+    long int offset = 0;
+    for (int i = 0; i < parent.size(); i++) {
+        Tensor *d = parent[i]->delta;
+        float *slice = delta->ptr + offset * delta->stride[axis];
+        offset += parent[i]->output->shape[axis];
+
+        if (delta_views[i] && (d != nullptr) && (d->ptr != slice) && (d->size == parent[i]->output->size)
+            && in_place(delta, d, strided_views[i])) {
+            point_to(d, slice, delta->stride);
+            auto *c = dynamic_cast<LConcat *>(parent[i]);
+            if (c != nullptr) c->view_deltas();
+        }
+    }
+}
+
+void LConcat::resize(int batch) {
+    Layer::resize(batch);
+
+    // Parents resized before were given new buffers
+    view_outputs();
+}
+
 void LConcat::forward() {
     // Get output tensors
     vector<Tensor*> outputs;
@@ -84,6 +164,9 @@ void LConcat::forward() {
 
 
 void LConcat::backward() {
+    // Parents whose delta is the slice get their gradient with no copy
+    view_deltas();
+
     // Get delta tensors
     vector<Tensor*> deltas;
     for (int i=0; i<this->parent.size(); i++) {
@@ -114,7 +114,10 @@ void LBatchNorm::forward() {
     if (input->ndim==2) {
         N=b=input->shape[0];
         M=d=input->shape[1];
-        in=input->clone();
+
+        // Normalized in place in the output (owned, so contiguous)
+        Tensor::copy(input,output);
+        in=output;
     }
     else {
         b=input->shape[0];
@@ -149,10 +152,8 @@ void LBatchNorm::forward() {
     if (input->ndim==4) {
         tensorNN::permute_channels_first(in,output);
     }
-    else Tensor::copy(in,output);
-
 
-    delete in;
+    if (in!=output) delete in;
 }
 
 void LBatchNorm::backward(){
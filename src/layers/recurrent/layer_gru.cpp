@@ -0,0 +1,190 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "eddl/layers/recurrent/layer_recurrent.h"
+
+
+using namespace std;
+
+// layer_lstm.cpp: {nxd} --> {nx1}
+void reduced_abs_sum(Tensor * input, Tensor *output);
+
+int LGRU::total_layers = 0;
+
+LGRU::LGRU(vector<Layer *> parent, int units, bool mask_zeros, bool bidirectional, string name, int dev, int mem) : MLayer(name, dev, mem) {
+
+    this->units = units;
+    this->bidirectional = bidirectional;
+    this->mask_zeros = mask_zeros;
+
+    isrecurrent=true;
+
+    if (parent[0]->output->ndim != 2) msg("LGRU only works over 2D tensors", "LGRU");
+
+    if(name.empty()) this->name = "GRU" + to_string(++total_layers);
+
+    input = parent[0]->output;
+    output = new Tensor(vector<int>{input->shape[0], units}, dev);
+
+    Wx = new Tensor(vector<int>{input->shape[1], 3 * units}, dev);
+    params.push_back(Wx);
+    gWx = new Tensor(vector<int>{input->shape[1], 3 * units}, dev);
+    gradients.push_back(gWx);
+
+    // From t-1 GRU
+    Wh = new Tensor(vector<int>{units, 3 * units}, dev);
+    params.push_back(Wh);
+    gWh = new Tensor(vector<int>{units, 3 * units}, dev);
+    gradients.push_back(gWh);
+
+    bias = new Tensor(vector<int>{3 * units}, dev);
+    params.push_back(bias);
+    gbias = new Tensor(vector<int>{3 * units}, dev);
+    gradients.push_back(gbias);
+
+    rbias = new Tensor(vector<int>{3 * units}, dev);
+    params.push_back(rbias);
+    grbias = new Tensor(vector<int>{3 * units}, dev);
+    gradients.push_back(grbias);
+
+    gx = new Tensor(vector<int>{input->shape[0], 3 * units}, dev);
+    gh = new Tensor(vector<int>{input->shape[0], 3 * units}, dev);
+    dgx = new Tensor(vector<int>{input->shape[0], 3 * units}, dev);
+    dgh = new Tensor(vector<int>{input->shape[0], 3 * units}, dev);
+    mask = mask_zeros ? new Tensor(vector<int>{input->shape[0], 1}, dev) : nullptr;
+
+    for (int i = 0; i < parent.size(); ++i) {
+        parent[i]->addchild(this);
+        addparent(parent[i]);
+    }
+
+}
+
+LGRU::~LGRU(){
+    delete gx;
+    delete gh;
+    delete dgx;
+    delete dgh;
+    delete mask;
+}
+
+void LGRU::resize(int batch){
+    if (output!=nullptr) {
+        output->resize(batch);
+        gx->resize(batch);
+        gh->resize(batch);
+        dgx->resize(batch);
+        dgh->resize(batch);
+        if (mask!=nullptr) mask->resize(batch);
+    }
+}
+
+// virtual
+void LGRU::forward() {
+    // Previous timestep: parent[1] when unrolled, or its own output when decoding step by step
+    Layer *prev = carry_states ? this : ((parent.size()>1) ? parent[1] : nullptr);
+
+    if (mask_zeros) reduced_abs_sum(input, mask);
+
+    Tensor::mult2D(parent[0]->output, 0, Wx, 0, gx, 0);
+    Tensor::sum2D_rowwise(gx, bias, gx);
+
+    if (prev!=nullptr) {
+        Tensor::mult2D(prev->output, 0, Wh, 0, gh, 0);
+        Tensor::sum2D_rowwise(gh, rbias, gh);
+    }
+    else {
+        gh->fill_(0.0);
+        Tensor::sum2D_rowwise(gh, rbias, gh);
+    }
+
+    tensorNN::GRUCell(gx, gh, (prev!=nullptr) ? prev->output : nullptr, output, mask);
+}
+
+void LGRU::backward() {
+    Layer *prev = (parent.size()>1) ? parent[1] : nullptr;
+
+    tensorNN::D_GRUCell(gx, gh, (prev!=nullptr) ? prev->output : nullptr, delta, dgx, dgh,
+                        (prev!=nullptr) ? prev->delta : nullptr, mask);
+
+    if (trainable) {
+        Tensor::mult2D(parent[0]->output, 1, dgx, 0, gWx, 1);
+        if (prev!=nullptr)
+            Tensor::mult2D(prev->output, 1, dgh, 0, gWh, 1);
+        Tensor::reduce_sum2D(dgx, gbias, 0, 1);
+        Tensor::reduce_sum2D(dgh, grbias, 0, 1);
+    }
+
+    Tensor::mult2D(dgx, 0, Wx, 1, parent[0]->delta, 1);
+    if (prev!=nullptr)
+        Tensor::mult2D(dgh, 0, Wh, 1, prev->delta, 1);
+
+    // Regularizer
+    if (trainable) if(reg != nullptr) {reg->apply(this->Wx);reg->apply(this->Wh);}
+}
+
+
+Layer *LGRU::share(int c, int bs, vector<Layer *> p) {
+    LGRU *n = new LGRU(p, units, mask_zeros, bidirectional, "share_"+to_string(c)+this->name, this->dev, this->mem_level);
+    n->orig = this;
+    n->isshared=true;
+
+    //share params
+    for (int i = 0; i < n->params.size(); i++) delete n->params[i];
+    n->params.clear();
+
+    n->Wx = Wx;
+    n->Wh = Wh;
+    n->bias = bias;
+    n->rbias = rbias;
+    n->params.push_back(Wx);
+    n->params.push_back(Wh);
+    n->params.push_back(bias);
+    n->params.push_back(rbias);
+
+    //share gradients
+    for (int i = 0; i < n->gradients.size(); i++) delete n->gradients[i];
+    n->gradients.clear();
+
+    n->gWx = gWx;
+    n->gWh = gWh;
+    n->gbias = gbias;
+    n->grbias = grbias;
+    n->gradients.push_back(gWx);
+    n->gradients.push_back(gWh);
+    n->gradients.push_back(gbias);
+    n->gradients.push_back(grbias);
+
+    n->reg=reg;
+    n->init=init;
+
+    return n;
+}
+
+Layer *LGRU::clone(int c, int bs, vector<Layer *> p, int todev) {
+    LGRU *n = new LGRU(p, units, mask_zeros, bidirectional, "clone_" + name, todev, this->mem_level);
+    n->orig = this;
+
+    return n;
+}
+
+
+string LGRU::plot(int c) {
+    string s;
+
+    if (c) s = name + " [label=" + "\"" + name + "\",style=filled,fontsize=12,fillcolor=bisque4,shape=box]";
+    else s = name + " [label=" + "\"" + name + "\",style=filled,fontsize=12,fillcolor=White,shape=box]";
+
+    return s;
+}
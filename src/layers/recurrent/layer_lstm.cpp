@@ -193,16 +193,19 @@ Tensor *replicate_tensor(Tensor *input,int d)
 
 // virtual
 void LLSTM::forward() {
+    // Previous timestep: parent[1] when unrolled, or its own states when decoding step by step
+    Layer *prev = carry_states ? this : ((parent.size()>1) ? parent[1] : nullptr);
+
     if (mask_zeros) {
         mask=new Tensor({input->shape[0],1},dev);
         reduced_abs_sum(input,mask);
 
         Tensor::logical_not(mask,mask);
-        if (parent.size()>1) {
+        if (prev!=nullptr) {
             Tensor *A=replicate_tensor(mask,units);
 
-            psh=parent[1]->states[0]->clone(); //prev state_h
-            psc=parent[1]->states[1]->clone(); //prev state_c
+            psh=prev->states[0]->clone(); //prev state_h
+            psc=prev->states[1]->clone(); //prev state_c
 
             Tensor::el_mult(A,psh,psh,0);
             Tensor::el_mult(A,psc,psc,0);
@@ -216,32 +219,32 @@ void LLSTM::forward() {
     in=new Tensor({input->shape[0], units}, dev);
 
     Tensor::mult2D(parent[0]->output, 0, Wix, 0, in, 0);
-    if (parent.size()>1) {
-        Tensor::mult2D(parent[1]->states[0], 0, Wih, 0, in, 1);
+    if (prev!=nullptr) {
+        Tensor::mult2D(prev->states[0], 0, Wih, 0, in, 1);
     }
     Tensor::sum2D_rowwise(in, inbias, in);
     tensorNN::Sigmoid(in, in);
 
     fn=new Tensor({input->shape[0], units}, dev);
     Tensor::mult2D(parent[0]->output, 0, Wfx, 0, fn, 0);
-    if (parent.size()>1) {
-        Tensor::mult2D(parent[1]->states[0], 0, Wfh, 0, fn, 1);
+    if (prev!=nullptr) {
+        Tensor::mult2D(prev->states[0], 0, Wfh, 0, fn, 1);
     }
     Tensor::sum2D_rowwise(fn, fnbias, fn);
     tensorNN::Sigmoid(fn, fn);
 
     on=new Tensor({input->shape[0], units}, dev);
     Tensor::mult2D(parent[0]->output, 0, Wox, 0, on, 0);
-    if (parent.size()>1) {
-        Tensor::mult2D(parent[1]->states[0], 0, Woh, 0, on, 1);
+    if (prev!=nullptr) {
+        Tensor::mult2D(prev->states[0], 0, Woh, 0, on, 1);
     }
     Tensor::sum2D_rowwise(on, onbias, on);
     tensorNN::Sigmoid(on, on);
 
     cn=new Tensor({input->shape[0], units}, dev);
     Tensor::mult2D(parent[0]->output, 0, Wcx, 0, cn, 0);
-    if (parent.size()>1) {
-        Tensor::mult2D(parent[1]->states[0], 0, Wch, 0, cn, 1);
+    if (prev!=nullptr) {
+        Tensor::mult2D(prev->states[0], 0, Wch, 0, cn, 1);
     }
     Tensor::sum2D_rowwise(cn, cnbias, cn);
     tensorNN::Tanh(cn,cn);
@@ -251,8 +254,8 @@ void LLSTM::forward() {
 
 
     cn1fn=new Tensor({input->shape[0], units}, dev);
-    if (parent.size()>1) {
-        Tensor::el_mult(parent[1]->states[1],fn,cn1fn,0);
+    if (prev!=nullptr) {
+        Tensor::el_mult(prev->states[1],fn,cn1fn,0);
     }
     else {
         cn1fn->fill_(0.0);
@@ -276,7 +279,7 @@ void LLSTM::forward() {
 
         delete A;
 
-        if (parent.size()>1) {
+        if (prev!=nullptr) {
             Tensor::inc(psh,state_h); //output=prev output when in=0
             Tensor::inc(psc,state_c);
 
@@ -462,11 +465,12 @@ Layer *LLSTM::share(int c, int bs, vector<Layer *> p) {
     n->params.push_back(onbias);
     n->params.push_back(cnbias);
 
+    // The first timestep has no recurrent params, but keeps them to carry its states
+    n->Woh = Woh;
+    n->Wih = Wih;
+    n->Wfh = Wfh;
+    n->Wch = Wch;
     if (n->parent.size()>1) {
-        n->Woh = Woh;
-        n->Wih = Wih;
-        n->Wfh = Wfh;
-        n->Wch = Wch;
         n->params.push_back(Wih);
         n->params.push_back(Wfh);
         n->params.push_back(Woh);
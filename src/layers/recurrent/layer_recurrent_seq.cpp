@@ -0,0 +1,359 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+
+#include "eddl/layers/recurrent/layer_recurrent.h"
+#include "eddl/tensor/nn/tensor_nn.h"
+
+
+using namespace std;
+
+int LRecurrentSeq::total_layers = 0;
+
+LRecurrentSeq::LRecurrentSeq(vector<Layer *> parent, string cell, int units, int num_layers, string activation, bool return_sequences, bool mask_zeros, string name, int dev, int mem) : MLayer(name, dev, mem) {
+    if ((cell != "rnn") && (cell != "lstm")) msg("Unknown recurrent cell " + cell, "LRecurrentSeq");
+    if (parent[0]->output->ndim != 3) msg("Expected batch x time x dim inputs", "LRecurrentSeq");
+    if (num_layers < 1) msg("Expected at least one layer", "LRecurrentSeq");
+    if ((cell == "rnn") && (activation != "relu") && (activation != "sigmoid") && (activation != "tanh") && (activation != "none"))
+        msg("Activation not supported for RNN", "LRecurrentSeq");
+
+    this->cell = cell;
+    this->units = units;
+    this->num_layers = num_layers;
+    this->gates = (cell == "lstm") ? 4 : 1;
+    this->activation = activation;
+    this->return_sequences = return_sequences;
+    this->mask_zeros = mask_zeros;
+    this->npacked = 0;
+
+    if(name.empty()) this->name = ((cell == "lstm") ? "LSTMSeq" : "RNNSeq") + to_string(++total_layers);
+
+    input = parent[0]->output;
+    int batch = input->shape[0];
+    int steps = input->shape[1];
+    if (return_sequences) output = new Tensor(vector<int>{batch, steps, units}, dev);
+    else output = new Tensor(vector<int>{batch, units}, dev);
+
+    for (int l = 0; l < num_layers; l++) {
+        int in = (l == 0) ? input->shape[2] : units;
+
+        Wx.push_back(new Tensor(vector<int>{in, gates * units}, dev));
+        Wh.push_back(new Tensor(vector<int>{units, gates * units}, dev));
+        bias.push_back(new Tensor(vector<int>{gates * units}, dev));
+        params.push_back(Wx[l]);
+        params.push_back(Wh[l]);
+        params.push_back(bias[l]);
+
+        gWx.push_back(new Tensor(vector<int>{in, gates * units}, dev));
+        gWh.push_back(new Tensor(vector<int>{units, gates * units}, dev));
+        gbias.push_back(new Tensor(vector<int>{gates * units}, dev));
+        gradients.push_back(gWx[l]);
+        gradients.push_back(gWh[l]);
+        gradients.push_back(gbias[l]);
+    }
+
+    xt = nullptr;
+    dxt = nullptr;
+    dG = nullptr;
+    dC = nullptr;
+    G.assign(num_layers, nullptr);
+    H.assign(num_layers, nullptr);
+    C.assign(num_layers, nullptr);
+    dH.assign(num_layers, nullptr);
+
+    for (int i = 0; i < parent.size(); ++i) {
+        parent[i]->addchild(this);
+        addparent(parent[i]);
+    }
+}
+
+LRecurrentSeq::~LRecurrentSeq(){
+    delete xt;
+    delete dxt;
+    delete dG;
+    delete dC;
+    for (int l = 0; l < num_layers; l++) {
+        delete G[l];
+        delete H[l];
+        delete C[l];
+        delete dH[l];
+    }
+}
+
+static void reserve_tensor(Tensor *&t, const vector<int> &shape, int dev) {
+    if ((t != nullptr) && (t->shape == shape)) return;
+    delete t;
+    t = new Tensor(shape, dev);
+}
+
+// Rows [start, start+n) of a 2D tensor
+static Tensor *rows(Tensor *t, int start, int n) {
+    return new Tensor({n, t->shape[1]}, t->ptr + (size_t)start * t->shape[1], t->device);
+}
+
+// The buffers only change with the batch size or the length of the sequences
+void LRecurrentSeq::reserve(int batch, int steps) {
+    int n = batch * steps;
+    reserve_tensor(xt, {n, input->shape[2]}, dev);
+    for (int l = 0; l < num_layers; l++) {
+        reserve_tensor(G[l], {n, gates * units}, dev);
+        reserve_tensor(H[l], {n, units}, dev);
+        if (cell == "lstm") reserve_tensor(C[l], {n, units}, dev);
+    }
+}
+
+// Lengths of the sequences (without the trailing zero timesteps when masking, but at least one
+// timestep) and the packed layout: sorted by decreasing length, timestep by timestep
+void LRecurrentSeq::pack(int batch, int steps) {
+    int dim = input->shape[2];
+    vector<int> length(batch, steps);
+    if (mask_zeros) {
+        for (int b = 0; b < batch; b++) {
+            int len = steps;
+            for (; len > 1; len--) {
+                const float *x = input->ptr + ((size_t)b * steps + len - 1) * dim;
+                if (std::any_of(x, x + dim, [](float v) { return v != 0.0f; })) break;
+            }
+            length[b] = len;
+        }
+    }
+
+    vector<int> order(batch);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int i, int j) { return length[i] > length[j]; });
+
+    active.assign(steps, 0);
+    offset.assign(steps, 0);
+    packed.clear();
+    last.assign(batch, 0);
+    for (int t = 0; t < steps; t++) {
+        offset[t] = packed.size();
+        for (int r = 0; (r < batch) && (length[order[r]] > t); r++) {
+            packed.push_back(order[r] * steps + t);
+            if (length[order[r]] == t + 1) last[order[r]] = offset[t] + r;
+        }
+        active[t] = packed.size() - offset[t];
+    }
+    npacked = packed.size();
+}
+
+void LRecurrentSeq::forward() {
+    if (!input->isCPU()) msg("Only available on CPU", "LRecurrentSeq::forward");
+
+    int batch = input->shape[0];
+    int steps = input->shape[1];
+    reserve(batch, steps);
+    pack(batch, steps);
+
+    // Packed copy of the input
+    Tensor *in2 = new Tensor({batch * steps, input->shape[2]}, input->ptr, dev);
+    Tensor *xs = rows(xt, 0, npacked);
+    Tensor::select(in2, xs, packed, 0, npacked);
+    delete in2;
+    delete xs;
+
+    for (int l = 0; l < num_layers; l++) {
+        Tensor *X = rows((l == 0) ? xt : H[l - 1], 0, npacked);
+        Tensor *Gs = rows(G[l], 0, npacked);
+
+        // Input projections of all the timesteps at once
+        Tensor::mult2D(X, 0, Wx[l], 0, Gs, 0);
+        Tensor::sum2D_rowwise(Gs, bias[l], Gs);
+        delete X;
+        delete Gs;
+
+        // The active sequences of a timestep are a prefix of the ones of the previous timestep
+        for (int t = 0; t < steps; t++) {
+            int a = active[t];
+            if (a == 0) break;
+            Tensor *g = rows(G[l], offset[t], a);
+            Tensor *h = rows(H[l], offset[t], a);
+            Tensor *hp = (t > 0) ? rows(H[l], offset[t - 1], a) : nullptr;
+            if (hp != nullptr) Tensor::mult2D(hp, 0, Wh[l], 0, g, 1);
+
+            if (cell == "lstm") {
+                Tensor *c = rows(C[l], offset[t], a);
+                Tensor *cp = (t > 0) ? rows(C[l], offset[t - 1], a) : nullptr;
+                tensorNN::LSTMCell(g, cp, c, h);
+                delete c;
+                delete cp;
+            }
+            else if (activation == "relu") tensorNN::ReLu(g, h);
+            else if (activation == "sigmoid") tensorNN::Sigmoid(g, h);
+            else if (activation == "tanh") tensorNN::Tanh(g, h);
+            else Tensor::copy(g, h);
+
+            delete g;
+            delete h;
+            delete hp;
+        }
+    }
+
+    // Batch-major outputs (zeros in the padding), or the last timestep of each sequence
+    Tensor *hs = rows(H[num_layers - 1], 0, npacked);
+    if (return_sequences) {
+        Tensor *out2 = new Tensor({batch * steps, units}, output->ptr, dev);
+        if (npacked < batch * steps) output->fill_(0.0);
+        Tensor::deselect(hs, out2, packed, 0, npacked);
+        delete out2;
+    }
+    else Tensor::select(hs, output, last, 0, batch);
+    delete hs;
+}
+
+void LRecurrentSeq::backward() {
+    int batch = input->shape[0];
+    int steps = input->shape[1];
+    int n = batch * steps;
+
+    reserve_tensor(dG, {n, gates * units}, dev);
+    for (int l = 0; l < num_layers; l++) reserve_tensor(dH[l], {n, units}, dev);
+    if (cell == "lstm") reserve_tensor(dC, {batch, units}, dev);
+
+    // Packed delta of the outputs of the last layer
+    Tensor *dlast = rows(dH[num_layers - 1], 0, npacked);
+    if (return_sequences) {
+        Tensor *d2 = new Tensor({batch * steps, units}, delta->ptr, dev);
+        Tensor::select(d2, dlast, packed, 0, npacked);
+        delete d2;
+    }
+    else {
+        dlast->fill_(0.0);
+        Tensor::deselect(delta, dlast, last, 0, batch);
+    }
+    delete dlast;
+
+    // Uniform lengths: the previous outputs of all the timesteps are a single block
+    bool uniform = (npacked == n);
+
+    for (int l = num_layers - 1; l >= 0; l--) {
+        Tensor *X = rows((l == 0) ? xt : H[l - 1], 0, npacked);
+        Tensor *dGs = rows(dG, 0, npacked);
+
+        dGs->fill_(0.0);
+        if (cell == "lstm") dC->fill_(0.0);
+
+        // Back through time: the recurrent deltas are added to the previous timestep
+        for (int t = steps - 1; t >= 0; t--) {
+            int a = active[t];
+            if (a == 0) continue;
+            Tensor *g = rows(G[l], offset[t], a);
+            Tensor *h = rows(H[l], offset[t], a);
+            Tensor *dg = rows(dG, offset[t], a);
+            Tensor *dh = rows(dH[l], offset[t], a);
+
+            if (cell == "lstm") {
+                Tensor *c = rows(C[l], offset[t], a);
+                Tensor *cp = (t > 0) ? rows(C[l], offset[t - 1], a) : nullptr;
+                Tensor *dc = rows(dC, 0, a);
+                tensorNN::D_LSTMCell(g, cp, c, dh, dc, dg);
+                delete c;
+                delete cp;
+                delete dc;
+            }
+            else if (activation == "relu") tensorNN::D_ReLu(dh, g, dg);
+            else if (activation == "sigmoid") tensorNN::D_Sigmoid(dh, h, dg);
+            else if (activation == "tanh") tensorNN::D_Tanh(dh, h, dg);
+            else Tensor::copy(dh, dg);
+
+            if (t > 0) {
+                Tensor *dhp = rows(dH[l], offset[t - 1], a);
+                Tensor::mult2D(dg, 0, Wh[l], 1, dhp, 1);
+                if (trainable && !uniform) {
+                    Tensor *hp = rows(H[l], offset[t - 1], a);
+                    Tensor::mult2D(hp, 1, dg, 0, gWh[l], 1);
+                    delete hp;
+                }
+                delete dhp;
+            }
+
+            delete g;
+            delete h;
+            delete dg;
+            delete dh;
+        }
+
+        // Weight gradients of all the timesteps at once
+        if (trainable) {
+            Tensor::mult2D(X, 1, dGs, 0, gWx[l], 1);
+            if (uniform && (steps > 1)) {
+                Tensor *hs = rows(H[l], 0, (steps - 1) * batch);
+                Tensor *dgs = rows(dG, batch, (steps - 1) * batch);
+                Tensor::mult2D(hs, 1, dgs, 0, gWh[l], 1);
+                delete hs;
+                delete dgs;
+            }
+            Tensor::reduce_sum2D(dGs, gbias[l], 0, 1);
+        }
+
+        // Delta of the inputs: the outputs of the layer below, or the parent
+        if (l > 0) {
+            Tensor *dx = rows(dH[l - 1], 0, npacked);
+            Tensor::mult2D(dGs, 0, Wx[l], 1, dx, 0);
+            delete dx;
+        }
+        else {
+            reserve_tensor(dxt, {n, input->shape[2]}, dev);
+            Tensor *dx = rows(dxt, 0, npacked);
+            Tensor *pd = new Tensor({batch * steps, input->shape[2]}, parent[0]->delta->ptr, dev);
+            Tensor::mult2D(dGs, 0, Wx[l], 1, dx, 0);
+            Tensor::deselect(dx, pd, packed, 0, npacked, 1);
+            delete dx;
+            delete pd;
+        }
+        delete X;
+        delete dGs;
+
+        // Regularizer
+        if (trainable) if(reg != nullptr) {reg->apply(Wx[l]); reg->apply(Wh[l]);}
+    }
+}
+
+
+Layer *LRecurrentSeq::share(int c, int bs, vector<Layer *> p) {
+    auto *n = new LRecurrentSeq(p, cell, units, num_layers, activation, return_sequences, mask_zeros, "share_"+to_string(c)+this->name, this->dev, this->mem_level);
+    n->orig = this;
+    n->isshared=true;
+
+    //share params and gradients
+    for (int i = 0; i < n->params.size(); i++) delete n->params[i];
+    for (int i = 0; i < n->gradients.size(); i++) delete n->gradients[i];
+    n->params = params;
+    n->gradients = gradients;
+    n->Wx = Wx; n->Wh = Wh; n->bias = bias;
+    n->gWx = gWx; n->gWh = gWh; n->gbias = gbias;
+
+    n->reg=reg;
+    n->init=init;
+
+    return n;
+}
+
+Layer *LRecurrentSeq::clone(int c, int bs, vector<Layer *> p, int todev) {
+    auto *n = new LRecurrentSeq(p, cell, units, num_layers, activation, return_sequences, mask_zeros, "clone_" + name, todev, this->mem_level);
+    n->orig = this;
+
+    return n;
+}
+
+
+string LRecurrentSeq::plot(int c) {
+    string s;
+
+    if (c) s = name + " [label=" + "\"" + name + "\",style=filled,fontsize=12,fillcolor=bisque4,shape=box]";
+    else s = name + " [label=" + "\"" + name + "\",style=filled,fontsize=12,fillcolor=White,shape=box]";
+
+    return s;
+}
@@ -75,9 +75,12 @@ void LRNN::forward() {
     if (preoutput->size!=output->size)
         preoutput->resize(output->shape[0]);
 
+    // Previous timestep: parent[1] when unrolled, or its own output when decoding step by step
+    Layer *prev = carry_states ? this : ((parent.size()>1) ? parent[1] : nullptr);
+
     Tensor::mult2D(parent[0]->output, 0, Wx, 0, preoutput, 0);
-    if (parent.size()>1)
-        Tensor::mult2D(parent[1]->output, 0, Wy, 0, preoutput, 1);
+    if (prev!=nullptr)
+        Tensor::mult2D(prev->output, 0, Wy, 0, preoutput, 1);
     if (use_bias) Tensor::sum2D_rowwise(preoutput, bias, preoutput);
 
     if (activation == "relu"){
@@ -0,0 +1,228 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "eddl/net/checkpoint.h"
+#include "eddl/utils.h"
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////
+///// CHECKPOINT FILES
+/////////////////////////////////////////////////////////////////
+// Single file, native byte order:
+//   "EDDLCKPT", int32 version, int32 step, int32 nparams, int32 ntensors,
+//   int32 len + optimizer name, per tensor {int32 ndim, int32 shape[ndim]},
+//   int64 nfloats, float data[nfloats], uint32 CRC-32 of all the previous bytes
+
+static const char CHECKPOINT_MAGIC[8] = {'E', 'D', 'D', 'L', 'C', 'K', 'P', 'T'};
+
+static uint32_t crc32_update(uint32_t crc, const void *buf, size_t n) {
+    static const vector<uint32_t> table = [] {
+        vector<uint32_t> t(256);
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    const auto *p = (const unsigned char *)buf;
+    crc = ~crc;
+    for (size_t i = 0; i < n; i++) crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+template<typename T>
+static void put(vector<char> &b, T v) {
+    const char *p = (const char *)&v;
+    b.insert(b.end(), p, p + sizeof(T));
+}
+
+template<typename T>
+static T get(const vector<char> &b, size_t &off) {
+    if (off + sizeof(T) > b.size()) msg("Truncated checkpoint", "CheckpointSnapshot::read");
+    T v;
+    memcpy(&v, b.data() + off, sizeof(T));
+    off += sizeof(T);
+    return v;
+}
+
+CheckpointSnapshot::CheckpointSnapshot() {
+    step = 0;
+    nparams = 0;
+}
+
+void CheckpointSnapshot::write() {
+    vector<char> header(CHECKPOINT_MAGIC, CHECKPOINT_MAGIC + 8);
+    put<int32_t>(header, CHECKPOINT_VERSION);
+    put<int32_t>(header, step);
+    put<int32_t>(header, nparams);
+    put<int32_t>(header, shapes.size());
+    put<int32_t>(header, optimizer.size());
+    header.insert(header.end(), optimizer.begin(), optimizer.end());
+    for (auto &sh : shapes) {
+        put<int32_t>(header, sh.size());
+        for (int d : sh) put<int32_t>(header, d);
+    }
+    put<int64_t>(header, data.size());
+
+    uint32_t crc = crc32_update(0, header.data(), header.size());
+    crc = crc32_update(crc, data.data(), data.size() * sizeof(float));
+
+    // A crash while writing leaves the previous checkpoint untouched
+    string tmp = filename + ".tmp";
+    FILE *f = fopen(tmp.c_str(), "wb");
+    if (f == nullptr) throw runtime_error("Cannot create " + tmp);
+
+    bool ok = (fwrite(header.data(), 1, header.size(), f) == header.size());
+    ok = ok && (fwrite(data.data(), sizeof(float), data.size(), f) == data.size());
+    ok = ok && (fwrite(&crc, sizeof(crc), 1, f) == 1);
+    ok = ok && (fflush(f) == 0) && (fsync(fileno(f)) == 0);
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) {
+        remove(tmp.c_str());
+        throw runtime_error("Error writing " + tmp);
+    }
+
+    if (rename(tmp.c_str(), filename.c_str()) != 0) throw runtime_error("Cannot rename " + tmp + " to " + filename);
+}
+
+void CheckpointSnapshot::read(const string &fname) {
+    FILE *f = fopen(fname.c_str(), "rb");
+    if (f == nullptr) msg("File not found: " + fname, "CheckpointSnapshot::read");
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    vector<char> b(n > 0 ? n : 0);
+    size_t nread = fread(b.data(), 1, b.size(), f);
+    fclose(f);
+
+    if ((nread != b.size()) || (b.size() < 8 + sizeof(uint32_t)) || (memcmp(b.data(), CHECKPOINT_MAGIC, 8) != 0))
+        msg("Not a checkpoint file: " + fname, "CheckpointSnapshot::read");
+
+    uint32_t crc;
+    memcpy(&crc, b.data() + b.size() - sizeof(crc), sizeof(crc));
+    b.resize(b.size() - sizeof(crc));
+    if (crc32_update(0, b.data(), b.size()) != crc) msg("Corrupted checkpoint (bad checksum): " + fname, "CheckpointSnapshot::read");
+
+    size_t off = 8;
+    int version = get<int32_t>(b, off);
+    if (version != CHECKPOINT_VERSION)
+        msg("Unsupported checkpoint version " + to_string(version), "CheckpointSnapshot::read");
+
+    filename = fname;
+    step = get<int32_t>(b, off);
+    nparams = get<int32_t>(b, off);
+    int ntensors = get<int32_t>(b, off);
+    int len = get<int32_t>(b, off);
+    if ((len < 0) || (off + len > b.size())) msg("Truncated checkpoint", "CheckpointSnapshot::read");
+    optimizer.assign(b.data() + off, len);
+    off += len;
+
+    shapes.assign(ntensors, {});
+    size_t total = 0;
+    for (auto &sh : shapes) {
+        sh.resize(get<int32_t>(b, off));
+        size_t size = 1;
+        for (auto &d : sh) { d = get<int32_t>(b, off); size *= d; }
+        total += size;
+    }
+
+    int64_t nfloats = get<int64_t>(b, off);
+    if ((nfloats != total) || (off + total * sizeof(float) != b.size()))
+        msg("Inconsistent checkpoint sizes", "CheckpointSnapshot::read");
+    data.resize(total);
+    memcpy(data.data(), b.data() + off, total * sizeof(float));
+}
+
+
+/////////////////////////////////////////////////////////////////
+///// BACKGROUND WRITER
+/////////////////////////////////////////////////////////////////
+
+CheckpointWriter::CheckpointWriter() {
+    busy[0] = busy[1] = false;
+    stop = false;
+    worker = thread(&CheckpointWriter::run, this);
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        unique_lock<mutex> lock(mtx);
+        cv.wait(lock, [this] { return queue.empty(); });
+        stop = true;
+    }
+    cv.notify_all();
+    worker.join();
+    if (!error.empty()) cerr << "Checkpoint lost: " << error << endl;
+}
+
+void CheckpointWriter::run() {
+    unique_lock<mutex> lock(mtx);
+    while (true) {
+        cv.wait(lock, [this] { return stop || !queue.empty(); });
+        if (queue.empty()) return;
+
+        // The snapshot stays in the queue while written, so wait() also waits for it
+        int i = queue.front();
+        lock.unlock();
+        string err;
+        try {
+            buffers[i].write();
+        } catch (std::exception &e) {
+            err = e.what();
+        }
+        lock.lock();
+
+        if (!err.empty()) error = err;
+        queue.pop_front();
+        busy[i] = false;
+        cv.notify_all();
+    }
+}
+
+void CheckpointWriter::raise() {
+    if (error.empty()) return;
+    string e = error;
+    error.clear();
+    msg(e, "CheckpointWriter");
+}
+
+CheckpointSnapshot *CheckpointWriter::acquire() {
+    unique_lock<mutex> lock(mtx);
+    cv.wait(lock, [this] { return !busy[0] || !busy[1]; });
+    raise();
+
+    int i = busy[0] ? 1 : 0;
+    busy[i] = true;
+    return &buffers[i];
+}
+
+void CheckpointWriter::submit(CheckpointSnapshot *s) {
+    {
+        lock_guard<mutex> lock(mtx);
+        queue.push_back(s == &buffers[0] ? 0 : 1);
+    }
+    cv.notify_all();
+}
+
+void CheckpointWriter::wait() {
+    unique_lock<mutex> lock(mtx);
+    cv.wait(lock, [this] { return queue.empty(); });
+    raise();
+}
@@ -15,6 +15,7 @@
 #include <fstream>
 #include <string>
 #include <chrono>
+#include <cstring>
 #include "eddl/net/net.h"
 #include "eddl/utils.h"
 #include "eddl/random.h"
@@ -64,6 +65,7 @@ int isInorig(Layer *l, vlayer vl, int &ind) {
 
 Net::Net() {
     batch_size=1;
+    valid_samples=-1;
     optimizer = nullptr;
     cs = nullptr;
     name="model";
@@ -76,6 +78,10 @@ Net::Net() {
     isencoder=false;
     isrecurrent=false;
     decsize=1;
+    checkpointing=false;
+    ckwriter=nullptr;
+    mmap_base=nullptr;
+    mmap_size=0;
 }
 
 Net::Net(vlayer in, vlayer out):Net() {
@@ -159,6 +165,8 @@ Net::Net(vector <Net *> vnets):Net()
 
 
 Net::~Net(){
+    // Pending checkpoints are finished
+    if (ckwriter != nullptr) { delete ckwriter; ckwriter = nullptr; }
 
     if (mnets.size()) return;
 
@@ -185,6 +193,9 @@ Net::~Net(){
     */
 
     if (rnet!=nullptr) {delete rnet; rnet = nullptr;}
+
+    // The params no longer point into the mapping
+    unmap_weights();
 }
 
 
@@ -324,6 +335,8 @@ void Net::setlogfile(string fname)
 
 
 void Net::save(const string& filename, string format){
+    if (format == "mmap") { save_mmap(filename); return; }
+
     // Open file stream
     std::ofstream ofs(filename, std::ios::out | std::ios::binary);
 
@@ -336,11 +349,31 @@ void Net::save(const string& filename, string format){
         layers[i]->save(ofs, format);
     }
 
+    // Quantized nets append one {in_scale, per_channel} row per Dense/Conv layer
+    if (is_quantized()) {
+        vlayer ql = quantizable_layers();
+        Tensor *table = Tensor::zeros({(int)ql.size(), 2});
+        for (int i = 0; i < ql.size(); i++) {
+            QuantDescriptor *qd = get_quantization(ql[i]);
+            if (qd == nullptr) continue;
+            table->ptr[i * 2] = qd->in_scale;
+            table->ptr[i * 2 + 1] = qd->per_channel ? 1.0f : 0.0f;
+        }
+        table->savefs(ofs, format);
+        delete table;
+    }
+
     // Close file stream
     ofs.close();
 }
 
 void Net::load(const string& filename, string format){
+    // Weights containers are mapped, whatever the format
+    if ((format == "mmap") || is_mmap_file(filename)) {
+        load_mmap(filename);
+        return;
+    }
+
     // Open file stream
     std::ifstream ifs(filename, std::ios::in | std::ios::binary);
     if (!ifs.good()){
@@ -351,6 +384,20 @@ void Net::load(const string& filename, string format){
         layers[i]->load(ifs, format);
     }
 
+    // Trailing quantization table (see save)
+    dequantize();
+    if (ifs.peek() != EOF) {
+        vlayer ql = quantizable_layers();
+        Tensor *table = Tensor::loadfs(ifs, format);
+        if (table->ndim != 2 || table->shape[0] != ql.size() || table->shape[1] != 2) {
+            msg("The quantization table does not match the net", "Net.load");
+        }
+        for (int i = 0; i < ql.size(); i++) {
+            set_quantization(ql[i], table->ptr[i * 2], table->ptr[i * 2 + 1] != 0.0f);
+        }
+        delete table;
+    }
+
 
     // Copy to CS devices layers
     if (snets[0]->dev!=DEV_CPU) {
@@ -363,6 +410,117 @@ void Net::load(const string& filename, string format){
     ifs.close();
 }
 
+// Params of a checkpoint: all the params of the layers
+static vtensor checkpoint_params(Net *net) {
+    vtensor params;
+    for (auto l : net->layers)
+        params.insert(params.end(), l->params.begin(), l->params.end());
+    return params;
+}
+
+static void copy_to_host(Tensor *t, float *dst) {
+    if (t->isCPU()) { memcpy(dst, t->ptr, t->size * sizeof(float)); return; }
+    auto *h = new Tensor(t->shape, dst, DEV_CPU);
+    Tensor::copy(t, h);
+    delete h;
+}
+
+static void copy_from_host(float *src, Tensor *t) {
+    if (t->isCPU()) { memcpy(t->ptr, src, t->size * sizeof(float)); return; }
+    auto *h = new Tensor(t->shape, src, DEV_CPU);
+    Tensor::copy(h, t);
+    delete h;
+}
+
+void Net::save_checkpoint(const string& filename, bool async){
+    if (!isbuild || (optimizer == nullptr)) msg("The model must be built before saving a checkpoint", "Net::save_checkpoint");
+
+    // Copy from CS devices to layers
+    if (snets[0]->dev!=DEV_CPU)
+        sync_weights();
+
+    Optimizer *opt = snets[0]->optimizer;
+    vtensor tensors = checkpoint_params(this);
+    int nparams = tensors.size();
+    vtensor state = opt->get_state();
+    tensors.insert(tensors.end(), state.begin(), state.end());
+
+    // The training thread only takes the snapshot, one copy per tensor, into a buffer
+    // that is reused between checkpoints; the file is written by the background writer
+    if (ckwriter == nullptr) ckwriter = new CheckpointWriter();
+    CheckpointSnapshot *s = ckwriter->acquire();
+    s->filename = filename;
+    s->optimizer = opt->name;
+    s->step = opt->get_step();
+    s->nparams = nparams;
+    s->shapes.clear();
+
+    size_t total = 0;
+    for (auto t : tensors) total += t->size;
+    s->data.resize(total);
+
+    size_t off = 0;
+    for (auto t : tensors) {
+        s->shapes.push_back(t->shape);
+        copy_to_host(t, s->data.data() + off);
+        off += t->size;
+    }
+
+    ckwriter->submit(s);
+    if (!async) ckwriter->wait();
+}
+
+void Net::wait_checkpoint(){
+    if (ckwriter != nullptr) ckwriter->wait();
+}
+
+void Net::load_checkpoint(const string& filename){
+    if (!isbuild || (optimizer == nullptr)) msg("The model must be built before loading a checkpoint", "Net::load_checkpoint");
+
+    // The file may still be being written by this net
+    wait_checkpoint();
+
+    CheckpointSnapshot s;
+    s.read(filename);
+
+    // Validate everything before touching the net
+    vtensor params = checkpoint_params(this);
+    Optimizer *opt = snets[0]->optimizer;
+    vtensor state = opt->get_state();
+
+    if (s.optimizer != opt->name)
+        msg("The checkpoint was saved with a different optimizer (" + s.optimizer + ")", "Net::load_checkpoint");
+    if ((s.nparams != params.size()) || (s.shapes.size() != params.size() + state.size()))
+        msg("The checkpoint does not match the net", "Net::load_checkpoint");
+    for (int i = 0; i < s.shapes.size(); i++) {
+        Tensor *t = (i < s.nparams) ? params[i] : state[i - s.nparams];
+        if (s.shapes[i] != t->shape) msg("The checkpoint does not match the net (tensor " + to_string(i) + ")", "Net::load_checkpoint");
+    }
+
+    size_t off = 0;
+    for (auto t : params) {
+        copy_from_host(s.data.data() + off, t);
+        off += t->size;
+    }
+
+    // Every CS device keeps its own optimizer
+    for (int i = 0; i < snets.size(); i++) {
+        size_t o = off;
+        for (auto t : snets[i]->optimizer->get_state()) {
+            copy_from_host(s.data.data() + o, t);
+            o += t->size;
+        }
+        snets[i]->optimizer->set_step(s.step);
+    }
+
+    // Copy to CS devices layers
+    if (snets[0]->dev!=DEV_CPU) {
+        for(int i=0; i!=snets.size(); i++)
+            for(int j=0;j<layers.size();j++)
+                layers[j]->copy(snets[i]->layers[j]);
+    }
+}
+
 void Net::reset_accumulated_gradients(){
     for(Layer* l : layers){
         l->reset_accumulated_gradients();
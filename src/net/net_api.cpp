@@ -15,7 +15,11 @@
 #include <string>
 #include <chrono>
 #include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <set>
 #include "eddl/layers/core/layer_core.h"
+#include "eddl/layers/recurrent/layer_recurrent.h"
 #include "eddl/net/net.h"
 #include "eddl/random.h"
 #include "eddl/system_info.h"
@@ -77,6 +81,16 @@ void *forward_t(void *t) {
   return nullptr;
 }
 
+void *decode_step_t(void *t) {
+  auto *targs = (tdata *) t;
+
+  Net *net = targs->net;
+
+  net->do_decode_step();
+
+  return nullptr;
+}
+
 /////////////////////////////////////////
 void *reset_t(void *t) {
   auto *targs = (tdata *) t;
@@ -313,6 +327,9 @@ void Net::forward_recurrent(vector<Tensor*> tin)
   else if (isdecoder)
     rnet->forward(tin);
 
+  for(i=0;i<tinr.size();i++) delete(tinr[i]);
+  for(i=0;i<toutr.size();i++) delete(toutr[i]);
+
   for(i=0;i<xt.size();i++)
     delete xt[i];
   xt.clear();
@@ -431,6 +448,9 @@ void Net::backward_recurrent(vector<Tensor *> target)
   else if (isdecoder)
     rnet->backward(toutr);
 
+  for(i=0;i<tinr.size();i++) delete(tinr[i]);
+  for(i=0;i<toutr.size();i++) delete(toutr[i]);
+
   for(i=0;i<xt.size();i++)
     delete xt[i];
   xt.clear();
@@ -525,7 +545,7 @@ void Net::compute_loss()
       }
     }
 
-    inferenced_samples+=batch_size;
+    inferenced_samples+=((valid_samples>=0)&&(valid_samples<batch_size)) ? valid_samples : batch_size;
   }
 }
 
@@ -859,6 +879,14 @@ void Net::fit(vtensor tin, vtensor tout, int batch, int epochs) {
 }
 
 
+// Samples of a timestep of batch x time x dim data (strided view)
+static Tensor *timestep_view(Tensor *t, int step)
+{
+  Tensor *v=t->select_view({":",to_string(step)});
+  v->squeeze_(1);
+  return v;
+}
+
 void Net::prepare_recurrent(vtensor tin, vtensor tout, int &inl, int &outl, vtensor &xt, vtensor &xtd,vtensor &yt,vtensor &tinr,vtensor &toutr, Tensor *Z)
 {
   int i, j, k, n;
@@ -879,12 +907,9 @@ void Net::prepare_recurrent(vtensor tin, vtensor tout, int &inl, int &outl, vten
 
   if (tin.size()) {
     if (isencoder) {
-      for(i=0;i<tin.size();i++)
-        xt.push_back(Tensor::permute(tin[i],{1,0,2})); // time x batch x dim
-
-      inl=xt[0]->shape[0];
-      for(i=0;i<xt.size();i++) {
-        if (xt[i]->shape[0]!=inl)
+      inl=tin[0]->shape[1];
+      for(i=0;i<tin.size();i++) {
+        if (tin[i]->shape[1]!=inl)
           msg("Input tensors with different time steps","fit_recurrent");
       }
     }
@@ -892,44 +917,25 @@ void Net::prepare_recurrent(vtensor tin, vtensor tout, int &inl, int &outl, vten
 
   if (tout.size()) {
     if (isdecoder) {
-      //set decoder input with outputs
-      for(i=0;i<tout.size();i++)
-        xtd.push_back(Tensor::permute(tout[i],{1,0,2})); // time x batch x dim
-
-      //prepare output
-      for(i=0;i<tout.size();i++)
-        yt.push_back(Tensor::permute(tout[i],{1,0,2})); // time x batch x dim
-
-      outl=yt[0]->shape[0];
-      for(i=0;i<yt.size();i++) {
-        if (yt[i]->shape[0]!=outl)
+      outl=tout[0]->shape[1];
+      for(i=0;i<tout.size();i++) {
+        if (tout[i]->shape[1]!=outl)
         msg("Output tensors with different time steps","fit_recurrent");
       }
     }
   }
 
-  // prepare data for unroll net
+  // prepare data for unroll net: the data stays batch x time x dim, and each timestep is a
+  // view of it (no time-major copies). The batches are gathered from the views by train_batch.
   if (isencoder) {
-    int offset;
-    for(i=0;i<xt.size();i++) {
-      offset=xt[i]->size/xt[i]->shape[0];
-      vector<int>shape;
-      for(j=1;j<xt[i]->ndim;j++)
-        shape.push_back(xt[i]->shape[j]);
+    for(i=0;i<tin.size();i++)
       for(j=0;j<inl;j++)
-        tinr.push_back(new Tensor(shape,xt[i]->ptr+(j*offset),xt[i]->device));
-    }
+        tinr.push_back(timestep_view(tin[i],j));
   }
 
   if (isdecoder) {
-    //increase input with delayed output in xtd
-    int offset;
-    for(i=0;i<xtd.size();i++) {
-      offset=xtd[i]->size/xtd[i]->shape[0];
-      vector<int>shape;
-      for(j=1;j<xtd[i]->ndim;j++)
-        shape.push_back(xtd[i]->shape[j]);
-
+    //increase input with delayed output
+    for(i=0;i<tout.size();i++) {
       vector<int>zero_shape;
       for(j=0;j<tout[i]->ndim;j++)
         if (j!=1) zero_shape.push_back(tout[i]->shape[j]);
@@ -937,19 +943,12 @@ void Net::prepare_recurrent(vtensor tin, vtensor tout, int &inl, int &outl, vten
       if (!isencoder) tinr.push_back(new Tensor(tin[0]->shape,tin[0]->ptr,tin[0]->device));
       tinr.push_back(Tensor::zeros(zero_shape,tout[i]->device));
       for(j=0;j<outl-1;j++)
-        tinr.push_back(new Tensor(shape,xtd[i]->ptr+(j*offset),xtd[i]->device));
+        tinr.push_back(timestep_view(tout[i],j));
     }
 
-    for(i=0;i<yt.size();i++) {
-      offset=yt[i]->size/yt[i]->shape[0];
-      vector<int>shape;
-      for(j=1;j<yt[i]->ndim;j++)
-        shape.push_back(yt[i]->shape[j]);
-
-      if (tout.size())
-        for(j=0;j<outl;j++)
-          toutr.push_back(new Tensor(shape,yt[i]->ptr+(j*offset),yt[i]->device));
-    }
+    for(i=0;i<tout.size();i++)
+      for(j=0;j<outl;j++)
+        toutr.push_back(timestep_view(tout[i],j));
   }
 
 }
@@ -1025,6 +1024,10 @@ void Net::train_batch(vtensor X, vtensor Y, vind sind, int eval) {
     int start = i * thread_batch_size;
     int end = start + Xs[i][0]->shape[0];
 
+    // Real samples of a padded batch that fall in this device
+    if (valid_samples >= 0) snets[i]->valid_samples = std::max(0, std::min(valid_samples, end) - start);
+    else snets[i]->valid_samples = -1;
+
     // Copy samples
     for (int j = 0; j < X.size(); j++) {
       Tensor::select(X[j], Xs[i][j], sind, start, end);
@@ -1123,12 +1126,16 @@ void Net::evaluate(vtensor tin, vtensor tout,int bs) {
     // Start eval
     setmode(TSMODE);
     reset_loss();
-    for (j = 0; j < n / batch_size; j++) {
-
+    int num_batches = (n + batch_size - 1) / batch_size;
+    for (j = 0; j < num_batches; j++) {
+      // The last batch is padded with its last sample (not counted), so the net is not resized
+      int m = std::min(batch_size, n - j * batch_size);
       for (k=0;k<batch_size;k++)
-        sind [k]=(j*batch_size)+k;
+        sind [k]=(j*batch_size)+std::min(k, m-1);
 
+      valid_samples = m;
       train_batch(tin, tout, sind, 1);
+      valid_samples = -1;
 
       print_loss(j+1);
       fprintf(stdout, "\r");
@@ -1209,6 +1216,7 @@ vtensor Net::predict_recurrent(vtensor tin) {
 
   out=rnet->predict(tinr);
 
+  for(int i=0;i<tinr.size();i++) delete(tinr[i]);
   for(int i=0;i<xt.size();i++)
     delete xt[i];
   xt.clear();
@@ -1225,17 +1233,341 @@ vtensor Net::predict(vtensor tin) {
   else {
     cout<<"Predict "<<tin[0]->shape[0]<<" samples\n";
 
-    setmode(TSMODE);
-
-    forward(tin);
+    // In batches of the current batch size (e.g. the one used by fit)
+    int n = tin[0]->shape[0];
+    int bs = (batch_size > 1) ? batch_size : 100;
+    if (bs > n) bs = std::max(n, (int)snets.size());
 
     for (int i = 0; i < lout.size(); i++) {
-      collectTensor(lout[i],"output");
-      out.push_back(lout[i]->output->clone());
+      vector<int> shape = lout[i]->output->shape;
+      shape[0] = n;
+      out.push_back(new Tensor(shape, DEV_CPU));
     }
+
+    predict(tin, out, bs);
     return out;
   }
 
 }
 
-//////
+/*
+ * Streams the inputs through the net in batches of bs samples: the net is only resized to bs
+ * (not to the number of samples), and the outputs of each batch are copied to their rows of tout.
+ * The samples of a batch are views of the input rows (no gather) and the last batch is padded
+ * with the previous one, which is not copied out.
+ */
+void Net::predict(vtensor tin, vtensor tout, int bs) {
+  if (isrecurrent) msg("Not supported by recurrent nets, use predict(tin)", "Net.predict");
+  if (tin.size() != lin.size())
+    msg("input tensor list does not match with defined input layers", "Net.predict");
+  if (tout.size() != lout.size())
+    msg("output tensor list does not match with defined output layers", "Net.predict");
+
+  int n = tin[0]->shape[0];
+  for (int i = 1; i < tin.size(); i++)
+    if (tin[i]->shape[0] != n)
+      msg("different number of samples in input tensor", "Net.predict");
+  for (int i = 0; i < tout.size(); i++)
+    if (tout[i]->shape[0] != n)
+      msg("the output tensors must have as many samples as the input", "Net.predict");
+
+  resize(bs);
+  setmode(TSMODE);
+
+  for (int start = 0; start < n; start += batch_size) {
+    int m = std::min(batch_size, n - start);
+    string rows = to_string(start) + ":" + to_string(start + m);
+    string first = "0:" + to_string(m);
+
+    reset();
+    for (int i = 0; i < tin.size(); i++) {
+      Tensor *src = tin[i]->select_view({rows});
+      Tensor *dst = lin[i]->output->select_view({first});
+      Tensor::copy(src, dst);
+      delete src;
+      delete dst;
+      distributeTensor(lin[i]);
+    }
+
+    run_snets(forward_t);
+
+    for (int i = 0; i < lout.size(); i++) {
+      collectTensor(lout[i], "output");
+      Tensor *src = lout[i]->output->select_view({first});
+      Tensor *dst = tout[i]->select_view({rows});
+      Tensor::copy(src, dst);
+      delete src;
+      delete dst;
+    }
+  }
+}
+
+
+///////////////////////////////////////////
+//// STEP-WISE DECODING
+///////////////////////////////////////////
+// The net is unrolled with a single decoder timestep: decode_start runs all of it (the encoder
+// and the first step, from zeros as in training) and every decode_step only runs the layers that
+// depend on the decoder inputs, with the recurrent ones carrying their own states.
+
+// Layers of vfts that depend on the decoder inputs
+static vector<bool> decoder_layers(Net *n)
+{
+  set<Layer *> dec(n->din.begin(), n->din.end());
+  vector<bool> mask(n->vfts.size(), false);
+
+  for (int i = 0; i < n->vfts.size(); i++) {
+    Layer *l = n->vfts[i];
+    if (dec.count(l)) continue;
+    for (auto p : l->parent)
+      if (dec.count(p)) {
+        mask[i] = true;
+        dec.insert(l);
+        break;
+      }
+  }
+  return mask;
+}
+
+// What a recurrent layer passes to its next timestep
+static vtensor recurrent_states(Layer *l)
+{
+  if (dynamic_cast<LLSTM *>(l) != nullptr) return l->states;
+  if ((dynamic_cast<LRNN *>(l) != nullptr) || (dynamic_cast<LGRU *>(l) != nullptr)) return {l->output};
+  return {};
+}
+
+// Decoder inputs of a step: the previous tokens, as indices ({batch x 1} inputs) or one-hot
+static void feed_decoder(Net *rn, Tensor *tokens)
+{
+  if (!tokens->isCPU()) msg("The tokens must be on CPU", "Net.decode_step");
+
+  for (auto l : rn->din) {
+    Tensor *t = l->output;
+    if (t->ndim != 2) msg("Only decoder inputs of batch x dim", "Net.decode_step");
+    int n = t->shape[0];
+    int d = t->shape[1];
+    if (tokens->size != n) msg("Expected a token per sample of the batch", "Net.decode_step");
+
+    Tensor *h = Tensor::zeros(t->shape, DEV_CPU);
+    for (int b = 0; b < n; b++) {
+      int w = (int)tokens->ptr[b];
+      if (d == 1) h->ptr[b] = w;
+      else if ((w < 0) || (w >= d)) msg("Token out of range", "Net.decode_step");
+      else h->ptr[b * d + w] = 1.0;
+    }
+    Tensor::copy(h, t);
+    delete h;
+
+    distributeTensor(l);
+  }
+}
+
+static vtensor step_outputs(Net *rn)
+{
+  vtensor out;
+  for (auto l : rn->lout) {
+    collectTensor(l, "output");
+    out.push_back(l->output);
+  }
+  return out;
+}
+
+// Runs the encoder and the first decoder step. The outputs of the step belong to the net.
+vtensor Net::decode_start(vtensor tin) {
+  if (!isrecurrent) msg("Only for recurrent nets with a decoder", "Net.decode_start");
+  if (tin.empty()) msg("Expected the input of the encoder", "Net.decode_start");
+
+  vtensor xt, xtd, yt, tinr, toutr, tout;
+  int inl, outl;
+  prepare_recurrent(tin, tout, inl, outl, xt, xtd, yt, tinr, toutr);
+  if (!isdecoder) {
+    for (auto t : tinr) delete t;
+    msg("Only for recurrent nets with a decoder", "Net.decode_start");
+  }
+
+  build_rnet(inl, 1);
+
+  // Encoder timesteps (or the inputs of a decoder without a recurrent encoder) and zeros
+  vtensor src = isencoder ? tinr : tin;
+  vtensor in, zeros;
+  int n = tin[0]->shape[0];
+  int k = 0;
+  for (auto l : rnet->lin) {
+    if (find(rnet->din.begin(), rnet->din.end(), l) != rnet->din.end()) {
+      vector<int> shape = l->output->shape;
+      shape[0] = n;
+      zeros.push_back(Tensor::zeros(shape, DEV_CPU));
+      in.push_back(zeros.back());
+    }
+    else if (k < src.size()) in.push_back(src[k++]);
+    else msg("input tensor list does not match with defined input layers", "Net.decode_start");
+  }
+
+  rnet->setmode(TSMODE);
+  rnet->forward(in);
+
+  for (auto t : tinr) delete t;
+  for (auto t : zeros) delete t;
+
+  return step_outputs(rnet);
+}
+
+// Next decoder step, with a token per sample as input. The outputs of the step belong to the net.
+vtensor Net::decode_step(Tensor *tokens) {
+  if ((rnet == nullptr) || rnet->din.empty() || (rnet->lout.size() != lout.size()))
+    msg("The decoding has not started, call decode_start", "Net.decode_step");
+
+  feed_decoder(rnet, tokens);
+  rnet->run_snets(decode_step_t);
+
+  return step_outputs(rnet);
+}
+
+void Net::do_decode_step() {
+  vector<bool> dec = decoder_layers(this);
+
+  for (int i = 0; i < vfts.size(); i++) {
+    if (!dec[i]) continue;
+    vfts[i]->carry_states = true;
+    forward_layer(i);
+    vfts[i]->carry_states = false;
+  }
+}
+
+// The states of row i become the ones of row rows[i] (e.g. the hypotheses kept by a beam search)
+void Net::decode_reorder(const vector<int> &rows) {
+  if ((rnet == nullptr) || rnet->din.empty())
+    msg("The decoding has not started, call decode_start", "Net.decode_reorder");
+  if (rows.size() != rnet->batch_size) msg("Expected a row per sample of the batch", "Net.decode_reorder");
+  if (rnet->snets.size() > 1) msg("Not supported with several computing devices", "Net.decode_reorder");
+
+  Net *sn = rnet->snets[0];
+  vector<bool> dec = decoder_layers(sn);
+  for (int i = 0; i < sn->vfts.size(); i++) {
+    if (!dec[i]) continue;
+    for (auto s : recurrent_states(sn->vfts[i])) {
+      Tensor *prev = s->clone();
+      Tensor::select(prev, s, rows, 0, rows.size());
+      delete prev;
+    }
+  }
+}
+
+// Most likely token of every step (from the first output of the net), fed to the next one
+Tensor *Net::decode_greedy(vtensor tin, int length) {
+  if (length < 1) msg("The length must be at least 1", "Net.decode_greedy");
+
+  vtensor out = decode_start(tin);
+  int n = out[0]->shape[0];
+  int v = out[0]->size / n;
+
+  auto *tokens = new Tensor({n}, DEV_CPU);
+  auto *result = new Tensor({n, length}, DEV_CPU);
+  for (int t = 0; t < length; t++) {
+    if (t > 0) out = decode_step(tokens);
+    for (int b = 0; b < n; b++) {
+      const float *p = out[0]->ptr + b * v;
+      int w = std::max_element(p, p + v) - p;
+      tokens->ptr[b] = w;
+      result->ptr[b * length + t] = w;
+    }
+  }
+
+  delete tokens;
+  return result;
+}
+
+/*
+ * Beam search over the probabilities of the first output of the net (e.g. a Softmax). The beams of
+ * all the samples are decoded as a single batch of samples x beam rows, and the states of the kept
+ * hypotheses are moved to their rows after every step. Returns the best hypothesis of each sample.
+ */
+Tensor *Net::decode_beam(vtensor tin, int length, int beam) {
+  if (length < 1) msg("The length must be at least 1", "Net.decode_beam");
+  if (beam < 1) msg("The beam must be at least 1", "Net.decode_beam");
+
+  int n = tin[0]->shape[0];
+  int rows = n * beam;
+
+  // The input of every sample, in its beam rows
+  vector<int> rep(rows);
+  for (int r = 0; r < rows; r++) rep[r] = r / beam;
+  vtensor tinb;
+  for (auto t : tin) {
+    vector<int> shape = t->shape;
+    shape[0] = rows;
+    tinb.push_back(new Tensor(shape, t->device));
+    Tensor::select(t, tinb.back(), rep, 0, rows);
+  }
+
+  vtensor out = decode_start(tinb);
+  for (auto t : tinb) delete t;
+  int v = out[0]->size / rows;
+
+  // Log-probability of the hypotheses, with a single one per sample at the first step. Rows
+  // without a hypothesis are flagged (-ffast-math does not allow testing for infinities).
+  vector<float> score(rows, 0.0f), next(rows);
+  vector<bool> alive(rows), next_alive(rows);
+  for (int r = 0; r < rows; r++) alive[r] = (r % beam) == 0;
+
+  vector<vector<int>> from(length, vector<int>(rows));
+  vector<vector<int>> word(length, vector<int>(rows));
+  vector<pair<float, int>> cand;
+  auto better = [](const pair<float, int> &a, const pair<float, int> &b) {
+    return (a.first > b.first) || ((a.first == b.first) && (a.second < b.second));
+  };
+
+  auto *tokens = new Tensor({rows}, DEV_CPU);
+  for (int t = 0; t < length; t++) {
+    if (t > 0) {
+      decode_reorder(from[t - 1]);
+      out = decode_step(tokens);
+    }
+
+    for (int s = 0; s < n; s++) {
+      cand.clear();
+      for (int j = 0; j < beam; j++) {
+        int r = s * beam + j;
+        if (!alive[r]) continue;
+        const float *p = out[0]->ptr + r * v;
+        for (int w = 0; w < v; w++)
+          cand.emplace_back(score[r] + std::log(std::max(p[w], 1e-30f)), j * v + w);
+      }
+
+      int k = std::min(beam, (int)cand.size());
+      std::partial_sort(cand.begin(), cand.begin() + k, cand.end(), better);
+      for (int j = 0; j < beam; j++) {
+        int r = s * beam + j;
+        if (j < k) {
+          from[t][r] = s * beam + cand[j].second / v;
+          word[t][r] = cand[j].second % v;
+          next[r] = cand[j].first;
+          next_alive[r] = true;
+        }
+        else {
+          from[t][r] = s * beam;
+          word[t][r] = 0;
+          next[r] = 0.0f;
+          next_alive[r] = false;
+        }
+      }
+    }
+
+    score.swap(next);
+    alive.swap(next_alive);
+    for (int r = 0; r < rows; r++) tokens->ptr[r] = word[t][r];
+  }
+  delete tokens;
+
+  // The hypotheses are sorted, the first one of every sample is followed back to the first step
+  auto *result = new Tensor({n, length}, DEV_CPU);
+  for (int s = 0; s < n; s++) {
+    int r = s * beam;
+    for (int t = length - 1; t >= 0; t--) {
+      result->ptr[s * length + t] = word[t][r];
+      r = from[t][r];
+    }
+  }
+  return result;
+}
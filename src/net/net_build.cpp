@@ -19,6 +19,7 @@
 #include "eddl/random.h"
 
 #include "eddl/layers/core/layer_core.h"
+#include "eddl/layers/merge/layer_merge.h"
 
 #ifdef cGPU
 #include "eddl/hardware/gpu/gpu_tensor.h"
@@ -261,10 +262,59 @@ void Net::build(Optimizer *opt, vloss lo, vmetrics me, bool initialize) {
 
     // backward sort
     bts();
+
+    plan_concat_views();
+
     // random params
     if(initialize) do_initialize();
 }
 
+// Parents of a concat that can write their output in its slice of the concat output (and
+// read their delta from its slice of the concat delta): not inputs, not views, and not viewed
+// by any other layer. Each layer lives in one concat at most. Slices with strided samples (a
+// concat along the channels of a batch) also need the parent and its other children to take them.
+void Net::plan_concat_views() {
+    int ind;
+    vlayer viewed;
+
+    // Outer concats first, so the inner ones are placed before their parents
+    vector<LConcat *> concats;
+    for (int i = vfts.size() - 1; i >= 0; i--) {
+        auto *c = dynamic_cast<LConcat *>(vfts[i]);
+        if (c != nullptr) concats.push_back(c);
+    }
+
+    for (auto c : concats) {
+        c->output_views.assign(c->parent.size(), false);
+        c->delta_views.assign(c->parent.size(), false);
+        c->strided_views.assign(c->parent.size(), false);
+        if (!c->output->isCPU()) continue;
+
+        for (int j = 0; j < c->parent.size(); j++) {
+            Layer *p = c->parent[j];
+            bool ok = !p->parent.empty() && !p->output->isshared && !isIn(p, viewed, ind);
+            for (int k = 0; k < c->parent.size(); k++)
+                if ((k != j) && (c->parent[k] == p)) ok = false;
+            for (auto ch : p->child)
+                if ((ch != c) && ch->output->isshared) ok = false;
+            if (!ok) continue;
+
+            c->output_views[j] = true;
+            viewed.push_back(p);
+
+            // The delta is the slice only if nothing else adds to it
+            c->delta_views[j] = (p->child.size() == 1) && !isIn(p, lout, ind);
+
+            bool strided = p->strided_samples() && !isIn(p, lout, ind);
+            for (auto ch : p->child)
+                if ((ch != c) && !ch->strided_samples()) strided = false;
+            c->strided_views[j] = strided;
+        }
+    }
+
+    for (auto c : concats) c->view_outputs();
+}
+
 void Net::set_compserv(CompServ *cs){
     int todev;
     this->cs=cs;
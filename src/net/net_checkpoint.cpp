@@ -0,0 +1,179 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include "eddl/net/net.h"
+#include "eddl/utils.h"
+#include "eddl/layers/core/layer_core.h"
+#include "eddl/layers/da/layer_da.h"
+#include "eddl/layers/generators/layer_generators.h"
+#include "eddl/layers/merge/layer_merge.h"
+#include "eddl/layers/noise/layer_noise.h"
+#include "eddl/layers/normalization/layer_normalization.h"
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////
+///// ACTIVATION CHECKPOINTING
+/////////////////////////////////////////////////////////////////
+
+// Layers whose output can never be freed: inputs, outputs, views (and the layers they may
+// view), and the layers whose forward cannot be replayed (random, or updating running stats)
+static bool keeps_output(Net *net, Layer *l) {
+    int ind;
+    if (l->parent.empty() || l->child.empty() || isIn(l, net->lout, ind)) return true;
+    if (l->output->isshared) return true;
+    for (auto c : l->child)
+        if (c->output->isshared) return true;
+
+    // Its parents write in its output
+    auto *concat = dynamic_cast<LConcat *>(l);
+    if ((concat != nullptr) && std::count(concat->output_views.begin(), concat->output_views.end(), true)) return true;
+
+    return (dynamic_cast<LDropout *>(l) != nullptr) || (dynamic_cast<LBatchNorm *>(l) != nullptr) ||
+           (dynamic_cast<LGaussianNoise *>(l) != nullptr) || (dynamic_cast<LDataAugmentation *>(l) != nullptr) ||
+           (dynamic_cast<GeneratorLayer *>(l) != nullptr);
+}
+
+void Net::set_checkpoints(const vector<string> &names) {
+    if (!isbuild) msg("The model must be built before setting the checkpoints", "Net::set_checkpoints");
+    if (isrecurrent) msg("Checkpointing is not available for recurrent nets", "Net::set_checkpoints");
+
+    // Outputs freed by a previous plan are allocated again by the next forward
+    checkpointing = true;
+    checkpoints = names;
+    ck_segment.clear();
+
+    for (int i = 0; i < snets.size(); i++)
+        if (snets[i] != this) snets[i]->set_checkpoints(names);
+}
+
+void Net::set_checkpointing(int every) {
+    if (every < 0) { unset_checkpointing(); return; }
+
+    // Default: sqrt(n) segments of sqrt(n) layers
+    int n = vfts.size();
+    if (every == 0) every = std::max(1, (int)std::ceil(std::sqrt((double)n)));
+
+    vector<string> names;
+    for (int i = every - 1; i < n; i += every) names.push_back(vfts[i]->name);
+    set_checkpoints(names);
+}
+
+void Net::set_checkpointing_budget(long bytes) {
+    if (bytes <= 0) msg("The memory budget must be positive", "Net::set_checkpointing_budget");
+
+    // A new segment starts whenever the outputs that it would free exceed the budget
+    vector<string> names;
+    long acc = 0;
+    for (auto l : vfts) {
+        if (keeps_output(this, l)) continue;
+        acc += (long)l->output->size * sizeof(float);
+        if (acc >= bytes) {
+            names.push_back(l->name);
+            acc = 0;
+        }
+    }
+    set_checkpoints(names);
+}
+
+void Net::unset_checkpointing() {
+    checkpointing = false;
+    checkpoints.clear();
+    ck_segment.clear();
+
+    for (int i = 0; i < snets.size(); i++)
+        if (snets[i] != this) snets[i]->unset_checkpointing();
+}
+
+void Net::plan_checkpoints() {
+    int n = vfts.size();
+    ck_pos.clear();
+    for (int i = 0; i < n; i++) ck_pos[vfts[i]] = i;
+
+    // Segments of vfts, closed by every checkpoint
+    ck_segment.assign(n, 0);
+    ck_end.clear();
+    for (int i = 0; i < n; i++) {
+        ck_segment[i] = ck_end.size();
+        bool cp = std::find(checkpoints.begin(), checkpoints.end(), vfts[i]->name) != checkpoints.end();
+        if (cp || (i == n - 1)) ck_end.push_back(i);
+    }
+
+    // Only outputs read within their own segment are freed, so recomputing a segment
+    // needs nothing but the outputs that were kept
+    ck_free.assign(n, false);
+    for (int i = 0; i < n; i++) {
+        Layer *l = vfts[i];
+        if (std::find(checkpoints.begin(), checkpoints.end(), l->name) != checkpoints.end()) continue;
+        if (keeps_output(this, l)) continue;
+
+        bool local = true;
+        for (auto c : l->child) {
+            auto it = ck_pos.find(c);
+            if ((it == ck_pos.end()) || (ck_segment[it->second] != ck_segment[i])) local = false;
+        }
+        ck_free[i] = local;
+    }
+    ck_pending.assign(ck_end.size(), 0);
+}
+
+bool Net::checkpointing_active() {
+    if (!checkpointing || vfts.empty() || (vfts[0]->mode != TRMODE)) return false;
+    if (ck_segment.size() != vfts.size()) plan_checkpoints();
+    return true;
+}
+
+void Net::forward_layer(int i) {
+    Layer *l = vfts[i];
+    if (l->output->ptr == nullptr) l->output->updateData(nullptr);  // Freed by the checkpointing
+
+    l->forward();
+}
+
+void Net::free_segment(int s) {
+    int start = (s > 0) ? ck_end[s - 1] + 1 : 0;
+    for (int p = start; p <= ck_end[s]; p++)
+        if (ck_free[p]) vfts[p]->output->deleteData();
+}
+
+void Net::recompute_segment(int s) {
+    if (this->verbosity_level >= 2) cout << "Recomputing segment " << s << endl;
+
+    int start = (s > 0) ? ck_end[s - 1] + 1 : 0;
+    for (int p = start; p <= ck_end[s]; p++)
+        if (ck_free[p] && (vfts[p]->output->ptr == nullptr)) forward_layer(p);
+}
+
+// The backward of a layer reads its output and the outputs of its parents
+void Net::materialize(Layer *l) {
+    vlayer needed = l->parent;
+    needed.push_back(l);
+    for (auto x : needed) {
+        auto it = ck_pos.find(x);
+        if ((it != ck_pos.end()) && ck_free[it->second] && (x->output->ptr == nullptr))
+            recompute_segment(ck_segment[it->second]);
+    }
+}
+
+long Net::checkpointed_bytes() {
+    if (!checkpointing) return 0;
+    if (ck_segment.size() != vfts.size()) plan_checkpoints();
+
+    long bytes = 0;
+    for (int i = 0; i < vfts.size(); i++)
+        if (ck_free[i]) bytes += (long)vfts[i]->output->size * sizeof(float);
+    return bytes;
+}
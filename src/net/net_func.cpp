@@ -50,6 +50,16 @@ void Net::do_forward() {
   if (VERBOSE) {
     cout<<"START FORWARD\n";
   }
+  bool ck = checkpointing_active();
+  if (ck) {
+    // Only the layers that will run the backward, which stops at the first frozen one
+    ck_pending.assign(ck_end.size(), 0);
+    for (auto l : vbts) {
+      if (!l->trainable) break;
+      ck_pending[ck_segment[ck_pos[l]]]++;
+    }
+  }
+
   for (int i = 0; i < vfts.size(); i++) {
     if (VERBOSE) {
       cout << vfts[i]->name << " Shape: ";
@@ -57,10 +67,14 @@ void Net::do_forward() {
       fprintf(stdout, "  %s In[%d,%s]:%f\n", vfts[i]->name.c_str(), j, vfts[i]->parent[j]->name.c_str(),vfts[i]->parent[j]->output->sum());
     }
 
-    vfts[i]->forward();
+    forward_layer(i);
+
     if (VERBOSE) {
       fprintf(stdout, "  %s Out:%f\n", vfts[i]->name.c_str(), vfts[i]->output->sum());
     }
+
+    // The last segment is the first one needed by the backward
+    if (ck && (i == ck_end[ck_segment[i]]) && (ck_segment[i] < ck_end.size() - 1)) free_segment(ck_segment[i]);
   }
   if (VERBOSE) {
     cout<<"END FORWARD\n";
@@ -72,10 +86,15 @@ void Net::do_backward() {
   if (VERBOSE) {
     cout<<"START BACKWARD\n";
   }
+  bool ck = checkpointing_active();
+
   for (int i = 0; i < vbts.size(); i++) {
 
     if (!vbts[i]->trainable) return;
 
+    // Recompute the outputs freed by the forward
+    if (ck) materialize(vbts[i]);
+
     if(this->verbosity_level >= 1){
       std::cout << vbts[i]->name << std::endl;
     }
@@ -93,6 +112,12 @@ void Net::do_backward() {
 
     // Delete this delta
     if(vbts[i]->mem_level) { vbts[i]->free_delta(); }
+
+    // Free the segment once all its layers are done
+    if (ck) {
+      int s = ck_segment[ck_pos[vbts[i]]];
+      if (--ck_pending[s] == 0) free_segment(s);
+    }
   }
   if (VERBOSE) {
     cout<<"END BACKWARD\n";
@@ -124,14 +149,34 @@ void Net::do_compute_loss() {
     getchar();
   }
 
+  // Padded batch (see evaluate): only its first samples count
+  int valid = ((valid_samples >= 0) && (valid_samples < batch_size)) ? valid_samples : -1;
+
   int p = 0;
   for (int i = 0; i < lout.size(); i++, p += 2) {
+    if (valid == 0) {
+      fiterr[p] = fiterr[p + 1] = 0.0;
+      continue;
+    }
+
+    Tensor *T = lout[i]->target;
+    Tensor *Y = lout[i]->output;
+    if (valid > 0) {
+      T = T->select_view({"0:" + to_string(valid)});
+      Y = Y->select_view({"0:" + to_string(valid)});
+    }
+
     // loss value
     if (losses.size()>=(i+1))
-    fiterr[p] = losses[i]->value(lout[i]->target, lout[i]->output);
+    fiterr[p] = losses[i]->value(T, Y);
     // metric value
     if (metrics.size()>=(i+1))
-    fiterr[p + 1] = metrics[i]->value(lout[i]->target, lout[i]->output);
+    fiterr[p + 1] = metrics[i]->value(T, Y);
+
+    if (valid > 0) {
+      delete T;
+      delete Y;
+    }
   }
 
   if (VERBOSE) {
@@ -0,0 +1,192 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "eddl/net/net.h"
+#include "eddl/utils.h"
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////
+///// MEMORY-MAPPED WEIGHTS
+/////////////////////////////////////////////////////////////////
+// Native byte order: a header, one entry per param of the layers (in order), and the
+// data of every param aligned to MMAP_ALIGN bytes, so the file can be mapped and the
+// params pointed at it without reading or copying anything
+
+#define MMAP_VERSION 1
+#define MMAP_ALIGN 64
+#define MMAP_MAX_DIMS 8
+
+static const char MMAP_MAGIC[8] = {'E', 'D', 'D', 'L', 'M', 'M', 'A', 'P'};
+
+struct MMapHeader {
+    char magic[8];
+    int32_t version;
+    int32_t ntensors;
+};
+
+struct MMapEntry {
+    int64_t offset;  // from the beginning of the file
+    int32_t layer;
+    int32_t param;
+    int32_t ndim;
+    int32_t shape[MMAP_MAX_DIMS];
+    int32_t reserved;
+};
+
+static_assert(sizeof(MMapHeader) == 16, "Unexpected padding in MMapHeader");
+static_assert(sizeof(MMapEntry) == 56, "Unexpected padding in MMapEntry");
+
+static size_t mmap_align(size_t n) {
+    return (n + MMAP_ALIGN - 1) / MMAP_ALIGN * MMAP_ALIGN;
+}
+
+bool is_mmap_file(const string &fname) {
+    FILE *f = fopen(fname.c_str(), "rb");
+    if (f == nullptr) return false;
+    char magic[8];
+    bool is = (fread(magic, 1, 8, f) == 8) && (memcmp(magic, MMAP_MAGIC, 8) == 0);
+    fclose(f);
+    return is;
+}
+
+void Net::save_mmap(const string& filename){
+    // Copy from CS devices to layers
+    if (!snets.empty() && (snets[0]->dev!=DEV_CPU))
+        sync_weights();
+
+    vector<MMapEntry> entries;
+    vtensor tensors;
+    for (int i = 0; i < layers.size(); i++)
+        for (int j = 0; j < layers[i]->params.size(); j++) {
+            Tensor *t = layers[i]->params[j];
+            if (t->ndim > MMAP_MAX_DIMS) msg("Params with more than " + to_string(MMAP_MAX_DIMS) + " dimensions", "Net::save_mmap");
+
+            MMapEntry e;
+            memset(&e, 0, sizeof(e));
+            e.layer = i;
+            e.param = j;
+            e.ndim = t->ndim;
+            for (int d = 0; d < t->ndim; d++) e.shape[d] = t->shape[d];
+            entries.push_back(e);
+            tensors.push_back(t);
+        }
+
+    size_t offset = mmap_align(sizeof(MMapHeader) + entries.size() * sizeof(MMapEntry));
+    for (int i = 0; i < entries.size(); i++) {
+        entries[i].offset = offset;
+        offset = mmap_align(offset + tensors[i]->size * sizeof(float));
+    }
+
+    MMapHeader h;
+    memcpy(h.magic, MMAP_MAGIC, 8);
+    h.version = MMAP_VERSION;
+    h.ntensors = entries.size();
+
+    FILE *f = fopen(filename.c_str(), "wb");
+    if (f == nullptr) msg("Cannot create " + filename, "Net::save_mmap");
+    bool ok = (fwrite(&h, sizeof(h), 1, f) == 1);
+    ok = ok && (fwrite(entries.data(), sizeof(MMapEntry), entries.size(), f) == entries.size());
+
+    char zeros[MMAP_ALIGN] = {0};
+    size_t pos = sizeof(h) + entries.size() * sizeof(MMapEntry);
+    for (int i = 0; ok && (i < tensors.size()); i++) {
+        ok = (fwrite(zeros, 1, entries[i].offset - pos, f) == entries[i].offset - pos);
+        ok = ok && (fwrite(tensors[i]->ptr, sizeof(float), tensors[i]->size, f) == tensors[i]->size);
+        pos = entries[i].offset + tensors[i]->size * sizeof(float);
+    }
+    ok = (fclose(f) == 0) && ok;
+
+    if (!ok) msg("Error writing " + filename, "Net::save_mmap");
+}
+
+// Points a param at the mapping (the Eigen map of 2D tensors is rebuilt by updateData)
+static void point_to(Tensor *t, float *ptr) {
+    if (!t->isshared) t->deleteData();
+    t->updateData(ptr, nullptr, true);
+}
+
+void Net::load_mmap(const string& filename){
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) msg("File not found: " + filename, "Net::load_mmap");
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(fd); msg("Cannot stat " + filename, "Net::load_mmap"); }
+    size_t size = st.st_size;
+
+    // Private mapping: the params are read in place, and a page is only copied if it is
+    // written (i.e. when training the loaded net)
+    void *base = (size > 0) ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (base == MAP_FAILED) msg("Cannot map " + filename, "Net::load_mmap");
+
+    auto fail = [&](const string &text) {
+        munmap(base, size);
+        msg(text, "Net::load_mmap");
+    };
+
+    const char *b = (const char *)base;
+    if (size < sizeof(MMapHeader)) fail("Not a weights container: " + filename);
+    auto *h = (const MMapHeader *)b;
+    if (memcmp(h->magic, MMAP_MAGIC, 8) != 0) fail("Not a weights container: " + filename);
+    if (h->version != MMAP_VERSION) fail("Unsupported weights container version " + to_string(h->version));
+    if ((h->ntensors < 0) || (sizeof(MMapHeader) + (size_t)h->ntensors * sizeof(MMapEntry) > size)) fail("Truncated weights container");
+    auto *entries = (const MMapEntry *)(b + sizeof(MMapHeader));
+
+    // Every entry must match the param of the net at the same position
+    vtensor tensors;
+    for (int i = 0; i < layers.size(); i++)
+        for (int j = 0; j < layers[i]->params.size(); j++) {
+            int k = tensors.size();
+            Tensor *t = layers[i]->params[j];
+            tensors.push_back(t);
+            if (k >= h->ntensors) fail("The weights container does not match the net (missing params)");
+
+            const MMapEntry &e = entries[k];
+            bool same = (e.layer == i) && (e.param == j) && (e.ndim == t->ndim);
+            for (int d = 0; same && (d < t->ndim); d++) same = (e.shape[d] == t->shape[d]);
+            if (!same) fail("The weights container does not match the net (" + layers[i]->name + ")");
+            if ((e.offset % MMAP_ALIGN != 0) || (e.offset + t->size * sizeof(float) > size)) fail("Truncated weights container");
+        }
+    if (tensors.size() != h->ntensors) fail("The weights container does not match the net (extra params)");
+
+    for (int k = 0; k < tensors.size(); k++)
+        point_to(tensors[k], (float *)(b + entries[k].offset));
+
+    // The previous mapping, if any, is no longer referenced
+    unmap_weights();
+    mmap_base = base;
+    mmap_size = size;
+
+    dequantize();
+
+    // Copy to CS devices layers
+    if (!snets.empty() && (snets[0]->dev!=DEV_CPU)) {
+        for(int i=0; i!=snets.size(); i++)
+            for(int j=0;j<layers.size();j++)
+                layers[j]->copy(snets[i]->layers[j]);
+    }
+}
+
+void Net::unmap_weights(){
+    if (mmap_base == nullptr) return;
+    munmap(mmap_base, mmap_size);
+    mmap_base = nullptr;
+    mmap_size = 0;
+}
@@ -0,0 +1,109 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include "eddl/net/net.h"
+#include "eddl/utils.h"
+#include "eddl/layers/core/layer_core.h"
+#include "eddl/layers/conv/layer_conv.h"
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////
+///// INT8 POST-TRAINING QUANTIZATION
+/////////////////////////////////////////////////////////////////
+
+// Address of the quantization slot of a layer (nullptr => runs in fp32)
+static QuantDescriptor **quant_slot(Layer *l) {
+    LDense *dense = dynamic_cast<LDense *>(l);
+    if (dense != nullptr) return &dense->qd;
+    LConv *conv = dynamic_cast<LConv *>(l);
+    if ((conv != nullptr) && (conv->cd->groups == 1) && !conv->cd->direct) return &conv->qd;  // Grouped and direct convolutions run in fp32
+    return nullptr;
+}
+
+vlayer Net::quantizable_layers() {
+    vlayer ql;
+    for (auto &l : layers)
+        if (quant_slot(l) != nullptr) ql.push_back(l);
+    return ql;
+}
+
+QuantDescriptor *Net::get_quantization(Layer *l) {
+    QuantDescriptor **slot = quant_slot(l);
+    return (slot == nullptr) ? nullptr : *slot;
+}
+
+void Net::set_quantization(Layer *l, float in_scale, bool per_channel) {
+    QuantDescriptor **slot = quant_slot(l);
+    if (slot == nullptr) msg("Layer " + l->name + " can not be quantized", "Net.set_quantization");
+
+    delete *slot;
+    *slot = nullptr;
+    if (in_scale <= 0.0f) return;  // fp32
+
+    *slot = new QuantDescriptor(per_channel, DEV_CPU);
+    (*slot)->in_scale = in_scale;
+}
+
+bool Net::is_quantized() {
+    for (auto &l : layers)
+        if (get_quantization(l) != nullptr) return true;
+    return false;
+}
+
+void Net::dequantize() {
+    for (auto &l : quantizable_layers()) set_quantization(l, 0.0f, false);
+}
+
+void Net::quantize(vtensor tin, bool per_channel) {
+    if (!isbuild) msg("The net must be built before quantizing it", "Net.quantize");
+    if (isrecurrent) msg("Recurrent nets can not be quantized", "Net.quantize");
+    if (snets[0]->dev != DEV_CPU) msg("Quantized inference is only available on CPU", "Net.quantize");
+    if (tin.size() != lin.size()) msg("input tensor list does not match with defined input layers", "Net.quantize");
+
+    int n = tin[0]->shape[0];
+    for (int i = 1; i < tin.size(); i++)
+        if (tin[i]->shape[0] != n) msg("different number of samples in input tensor", "Net.quantize");
+
+    // Calibrate: run the fp32 net observing the input range of Dense/Conv layers
+    vlayer ql = quantizable_layers();
+    for (auto &l : ql) {
+        set_quantization(l, 0.0f, per_channel);  // Drop previous calibrations
+        QuantDescriptor **slot = quant_slot(l);
+        *slot = new QuantDescriptor(per_channel, DEV_CPU);
+        (*slot)->calibrating = true;
+    }
+
+    int bs = batch_size;
+    setmode(TSMODE);
+    for (int i = 0; i < n; i += bs) {
+        int m = std::min(bs, n - i);
+        vtensor X;
+        for (int j = 0; j < tin.size(); j++)
+            X.push_back(tin[j]->select({to_string(i) + ":" + to_string(i + m)}));
+
+        forward(X);
+
+        for (int j = 0; j < X.size(); j++) delete X[j];
+    }
+    resize(bs);
+
+    // Weights are packed lazily on the first quantized forward
+    for (auto &l : ql) get_quantization(l)->calibrate();
+
+    if (verbosity_level > 0) {
+        cout << "Quantized " << ql.size() << " layers to int8 (" << (per_channel ? "per-channel" : "per-tensor") << " weights)\n";
+    }
+}
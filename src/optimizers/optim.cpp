@@ -12,6 +12,7 @@
 #include <iostream>
 
 #include "eddl/optimizers/optim.h"
+#include "eddl/tensor/nn/tensor_nn.h"
 
 using namespace std;
 
@@ -19,6 +20,7 @@ using namespace std;
 Optimizer::Optimizer() {
   isshared=false;
   clip_val=-1;
+  sparse_rows=false;
 }
 
 void Optimizer::set_clip_val(float v)
@@ -26,12 +28,32 @@ void Optimizer::set_clip_val(float v)
   clip_val=v;
 }
 
+void Optimizer::set_sparse_rows(bool s)
+{
+  sparse_rows=s;
+}
+
+vector<int> *Optimizer::lazy_rows(Layer *l, int p)
+{
+  return sparse_rows ? l->sparse_grad_rows(p) : nullptr;
+}
+
+vtensor Optimizer::get_state()
+{
+  // Saving or restoring only the weights would silently reset the training state
+  msg("The optimizer " + name + " does not support checkpoints", "Optimizer::get_state");
+  return {};
+}
+
 void Optimizer::clip()
 {
   if (clip_val<0) return;
 
   for (int i = 0; i < layers.size(); i++)
-    for (int j = 0; j < layers[i]->get_trainable_params_count(); j++)
-      layers[i]->gradients[j]->clamp_(-clip_val,clip_val);
+    for (int j = 0; j < layers[i]->get_trainable_params_count(); j++) {
+      vector<int> *rows = layers[i]->sparse_grad_rows(j);
+      if (rows != nullptr) tensorNN::ClampRows(layers[i]->gradients[j], *rows, -clip_val, clip_val);
+      else layers[i]->gradients[j]->clamp_(-clip_val,clip_val);
+    }
 
 }
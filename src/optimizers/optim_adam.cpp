@@ -12,11 +12,13 @@
 #include <iostream>
 
 #include "eddl/optimizers/optim.h"
+#include "eddl/tensor/nn/tensor_nn.h"
 
 using namespace std;
 
 
 Adam::Adam(float lr, float beta_1, float beta_2, float epsilon, float weight_decay, bool amsgrad) : Optimizer() {
+    this->name = "adam";
     this->lr = lr;
     this->beta_1 = beta_1;
     this->beta_2 = beta_2;
@@ -40,9 +42,21 @@ void Adam::change(vector<float> &p) {
   cout<<"Optimizer Adam set new lr="<<lr<<"\n";
 }
 
+// mCap and vCap are scratch
+vtensor Adam::get_state() {
+    vtensor state = mT;
+    state.insert(state.end(), vT.begin(), vT.end());
+    return state;
+}
+
+int Adam::get_step() { return t; }
+
+void Adam::set_step(int t) { this->t = t; }
+
 Optimizer *Adam::clone() {
     Adam *n=new Adam(lr, beta_1, beta_2, epsilon, weight_decay, amsgrad);
     n->clip_val=clip_val;
+    n->sparse_rows=sparse_rows;
     
     return n;
 }
@@ -51,6 +65,7 @@ Optimizer *Adam::share() {
     n->orig=this;
     n->isshared=true;
     n->clip_val=clip_val;
+    n->sparse_rows=sparse_rows;
     return n;
 }
 void Adam::setlayers(vlayer l) {
@@ -84,6 +99,12 @@ void Adam::applygrads(int batch) {
     for (int i = 0; i < layers.size(); i++)
       if (layers[i]->trainable) {
         for (int j = 0; j < layers[i]->get_trainable_params_count(); j++, p++) {
+            // Row-sparse gradients (embeddings): lazy update, the moments of absent rows are left untouched
+            vector<int> *rows = lazy_rows(layers[i], j);
+            if (rows != nullptr) {
+                tensorNN::Adam_rows(layers[i]->params[j], layers[i]->gradients[j], mT[p], vT[p], *rows, lr, beta_1, beta_2, epsilon, t);
+                continue;
+            }
             Tensor::add(beta_1,mT[p],(1-beta_1),layers[i]->gradients[j],mT[p],0);
             layers[i]->gradients[j]->sqr_();
             Tensor::add(beta_2,vT[p],(1-beta_2),layers[i]->gradients[j],vT[p],0);
@@ -10,13 +10,16 @@
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
+#include <unordered_set>
 
 #include "eddl/optimizers/optim.h"
+#include "eddl/tensor/nn/tensor_nn.h"
 
 using namespace std;
 
 
 RMSProp::RMSProp(float lr, float rho, float epsilon, float weight_decay) : Optimizer() {
+    this->name = "rmsprop";
     this->lr = lr;
     this->rho = rho;
     this->epsilon = epsilon;
@@ -35,9 +38,20 @@ void RMSProp::change(vector<float> &p) {
   cout<<"Optimizer RMSProp set new lr="<<lr<<" rho="<<rho<<"\n";
 }
 
+// gT is scratch
+vtensor RMSProp::get_state() {
+    return gT1;
+}
+
+// No step count, but the state has just been restored: any row of gT1 may be non zero
+void RMSProp::set_step(int t) {
+    for (int p = 0; p < g1known.size(); p++) g1known[p] = false;
+}
+
 Optimizer *RMSProp::clone() {
     RMSProp *n=new RMSProp(lr, rho, epsilon, weight_decay);
     n->clip_val=clip_val;
+    n->sparse_rows=sparse_rows;
 
     return n;
 }
@@ -47,6 +61,7 @@ Optimizer *RMSProp::share() {
     n->orig=this;
     n->isshared=true;
     n->clip_val=clip_val;
+    n->sparse_rows=sparse_rows;
     return n;
 }
 void RMSProp::setlayers(vlayer l) {
@@ -59,6 +74,8 @@ void RMSProp::setlayers(vlayer l) {
         for (int j = 0; j < layers[i]->get_trainable_params_count(); j++) {
             gT1.emplace_back(Tensor::zeros_like(layers[i]->gradients[j]));
             gT.emplace_back(Tensor::zeros_like(layers[i]->gradients[j]));
+            g1rows.emplace_back();
+            g1known.push_back(false);
         }
     }
 }
@@ -75,6 +92,14 @@ void RMSProp::applygrads(int batch) {
     for (int i = 0; i < layers.size(); i++)
       if (layers[i]->trainable) {
         for (int j = 0; j < layers[i]->get_trainable_params_count(); j++, p++) {
+            // Row-sparse gradients (embeddings): the absent rows have a zero gradient, so they are
+            // not moved and only their gT1 has to be cleared (same result as the dense update)
+            vector<int> *rows = lazy_rows(layers[i], j);
+            if (rows != nullptr) {
+                tensorNN::RMSProp_rows(layers[i]->params[j], layers[i]->gradients[j], gT1[p], *rows, lr, rho, epsilon);
+                zero_stale_rows(p, *rows);
+                continue;
+            }
             Tensor::copy(layers[i]->gradients[j],gT[p]);
             gT[p]->sqr_();
             gT[p]->mult_(1.0f-rho);
@@ -88,6 +113,7 @@ void RMSProp::applygrads(int batch) {
             Tensor::el_div(layers[i]->gradients[j],gT[p],gT[p],0);
 
             Tensor::copy(layers[i]->gradients[j],gT1[p]);
+            g1known[p] = false;
 
             Tensor::add(-lr, gT[p],1.0,layers[i]->params[j], layers[i]->params[j], 0);
 
@@ -101,3 +127,23 @@ void RMSProp::applygrads(int batch) {
   }
 
 }
+
+// gT1 holds the previous gradient, which the dense update leaves at zero for the rows absent
+// from this batch: clear the rows of the previous lazy update (all of them the first time)
+void RMSProp::zero_stale_rows(int p, vector<int> &rows) {
+    unordered_set<int> present(rows.begin(), rows.end());
+    vector<int> stale;
+
+    if (g1known[p]) {
+        for (int r : g1rows[p])
+            if (!present.count(r)) stale.push_back(r);
+    }
+    else {
+        for (int r = 0; r < gT1[p]->shape[0]; r++)
+            if (!present.count(r)) stale.push_back(r);
+    }
+
+    tensorNN::ZeroRows(gT1[p], stale);
+    g1rows[p] = rows;
+    g1known[p] = true;
+}
@@ -12,11 +12,13 @@
 #include <iostream>
 
 #include "eddl/optimizers/optim.h"
+#include "eddl/tensor/nn/tensor_nn.h"
 
 using namespace std;
 
 
 SGD::SGD(float lr, float momentum, float weight_decay, bool nesterov) : Optimizer() {
+    this->name = "sgd";
     this->lr = lr;
     this->mu = momentum;
     this->weight_decay = weight_decay;
@@ -33,9 +35,14 @@ void SGD::change(vector<float> &p) {
     if (p.size()>1) mu = p[1];
 }
 
+vtensor SGD::get_state() {
+    return mT;
+}
+
 Optimizer *SGD::clone() {
     SGD *n=new SGD(lr, mu, weight_decay, nesterov);
     n->clip_val=clip_val;
+    n->sparse_rows=sparse_rows;
 
     return n;
 }
@@ -45,6 +52,7 @@ Optimizer *SGD::share() {
     n->orig=this;
     n->isshared=true;
     n->clip_val=clip_val;
+    n->sparse_rows=sparse_rows;
     return n;
 }
 
@@ -73,6 +81,13 @@ void SGD::applygrads(int batch) {
       for (int i = 0; i < layers.size(); i++) {
         if (layers[i]->trainable) {
           for (int j = 0; j < layers[i]->get_trainable_params_count(); j++, p++) {
+            // Row-sparse gradients (embeddings): lazy update of the rows present, the absent ones
+            // keep their momentum without applying it
+            vector<int> *rows = lazy_rows(layers[i], j);
+            if (rows != nullptr) {
+              tensorNN::SGD_rows(layers[i]->params[j], layers[i]->gradients[j], mT[p], *rows, lr, mu);
+              continue;
+            }
             Tensor::add(lr , layers[i]->gradients[j], mu, mT[p], mT[p], 0);
             Tensor::add(1.0, layers[i]->params[j], -1.0, mT[p], layers[i]->params[j], 0);
           }
@@ -31,6 +31,10 @@ float uniform(float min, float max) {
     return distr(gen);
 }
 
+uint64_t new_seed() {
+    return ((uint64_t)gen() << 32) | (uint64_t)gen();
+}
+
 float signed_uniform() {
     return (2.0 * uniform()) - 1.0;
 }
@@ -0,0 +1,275 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#include "eddl/serialization/exchange/eddl_exchange.h"
+#include "eddl/hardware/cpu/cpu_tensor.h"
+#include "eddl/utils.h"
+
+using namespace std;
+
+// Native byte order. Every payload is padded to 4 bytes.
+static const char EXCHANGE_MAGIC[4] = {'E', 'D', 'G', 'X'};
+
+#define TOPK_SAMPLE 4096
+
+struct ExchangeHeader {
+    char magic[4];
+    uint8_t version;
+    uint8_t kind;
+    uint8_t encoding;
+    uint8_t reserved;
+    uint32_t nparams;
+};
+
+struct ExchangeEntry {
+    uint32_t index;
+    uint32_t size;
+    uint32_t nnz;  // values sent: size, or the selected ones by EXCHANGE_TOPK
+};
+
+static_assert(sizeof(ExchangeHeader) == 12, "Unexpected padding in ExchangeHeader");
+static_assert(sizeof(ExchangeEntry) == 12, "Unexpected padding in ExchangeEntry");
+
+static size_t payload_size(int encoding, size_t size, size_t nnz) {
+    if (encoding == EXCHANGE_FP16) return (size * sizeof(uint16_t) + 3) / 4 * 4;
+    if (encoding == EXCHANGE_TOPK) return nnz * (sizeof(uint32_t) + sizeof(float));
+    return size * sizeof(float);
+}
+
+static vtensor net_tensors(Net *n, int kind) {
+    vtensor ts;
+    for (auto l : n->layers)
+        for (int j = 0; j < l->get_trainable_params_count(); j++)
+            ts.push_back((kind == EXCHANGE_GRADIENTS) ? l->gradients[j] : l->params[j]);
+    return ts;
+}
+
+vtensor exchange_tensors(Net *net, int kind) {
+    if (net->snets.empty()) msg("The model must be built before exchanging its params", "exchange_tensors");
+    return net_tensors(net->snets[0], kind);
+}
+
+// Values of a tensor in host memory (its own buffer on CPU)
+static float *host_values(Tensor *t, vector<float> &host, bool read) {
+    if (t->isCPU()) return t->ptr;
+    host.resize(t->size);
+    if (read) {
+        auto *h = new Tensor(t->shape, host.data(), DEV_CPU);
+        Tensor::copy(t, h);
+        delete h;
+    }
+    return host.data();
+}
+
+static void host_writeback(Tensor *t, vector<float> &host) {
+    if (t->isCPU()) return;
+    auto *h = new Tensor(t->shape, host.data(), DEV_CPU);
+    Tensor::copy(h, t);
+    delete h;
+}
+
+
+ExchangeEncoder::ExchangeEncoder(Net *net, int kind, int encoding, float ratio) {
+    if ((kind != EXCHANGE_GRADIENTS) && (kind != EXCHANGE_WEIGHTS)) msg("Unknown kind of exchange", "ExchangeEncoder");
+    if ((encoding < EXCHANGE_FP32) || (encoding > EXCHANGE_TOPK)) msg("Unknown exchange encoding", "ExchangeEncoder");
+    if ((encoding == EXCHANGE_TOPK) && ((ratio <= 0.0f) || (ratio > 1.0f))) msg("The top-k ratio must be in (0, 1]", "ExchangeEncoder");
+
+    this->net = net;
+    this->kind = kind;
+    this->encoding = encoding;
+    this->ratio = ratio;
+
+    if (encoding != EXCHANGE_TOPK) return;
+    for (auto t : exchange_tensors(net, kind)) {
+        // Receivers are assumed to start from the current weights
+        feedback.emplace_back(t->size, 0.0f);
+        if (kind == EXCHANGE_WEIGHTS) memcpy(feedback.back().data(), host_values(t, host, true), t->size * sizeof(float));
+    }
+}
+
+size_t ExchangeEncoder::encode(vector<char> &buf) {
+    vtensor ts = exchange_tensors(net, kind);
+    if ((encoding == EXCHANGE_TOPK) && (ts.size() != feedback.size())) msg("The net has changed", "ExchangeEncoder::encode");
+
+    // Upper bound of the message, so buf is only allocated once
+    size_t bound = sizeof(ExchangeHeader);
+    for (auto t : ts) {
+        size_t k = (encoding == EXCHANGE_TOPK) ? std::min<size_t>(t->size, (size_t)std::ceil(ratio * t->size) + 1) : t->size;
+        bound += sizeof(ExchangeEntry) + payload_size(encoding, t->size, k);
+    }
+    if (buf.size() < bound) buf.resize(bound);
+    char *b = buf.data();
+
+    ExchangeHeader h;
+    memcpy(h.magic, EXCHANGE_MAGIC, 4);
+    h.version = EXCHANGE_VERSION;
+    h.kind = kind;
+    h.encoding = encoding;
+    h.reserved = 0;
+    h.nparams = ts.size();
+    memcpy(b, &h, sizeof(h));
+    size_t off = sizeof(h);
+
+    for (int p = 0; p < ts.size(); p++) {
+        Tensor *t = ts[p];
+        int n = t->size;
+        const float *v = host_values(t, host, true);
+        ExchangeEntry e = {(uint32_t)p, (uint32_t)n, (uint32_t)n};
+        char *payload = b + off + sizeof(e);
+
+        if (encoding == EXCHANGE_FP32) {
+            memcpy(payload, v, n * sizeof(float));
+        }
+        else if (encoding == EXCHANGE_FP16) {
+            auto *o = (uint16_t *)payload;
+            cpu_pack_fp16(v, o, n);
+            if (n % 2) o[n] = 0;
+        }
+        else {
+            // Gradients plus residual, or weights minus the weights of the receivers
+            float *f = feedback[p].data();
+            float sign = (kind == EXCHANGE_GRADIENTS) ? 1.0f : -1.0f;
+            values.resize(n);
+            for (int i = 0; i < n; i++) values[i] = v[i] + sign * f[i];
+
+            // Threshold of the k largest magnitudes, estimated on a sample of large tensors
+            int k = std::min(n, std::max(1, (int)std::ceil(ratio * n)));
+            int m = std::min(n, TOPK_SAMPLE);
+            int stride = n / m;
+            int km = std::min(m, std::max(1, (int)std::ceil(ratio * m)));
+            mags.resize(m);
+            for (int i = 0; i < m; i++) mags[i] = std::fabs(values[(size_t)i * stride]);
+            std::nth_element(mags.begin(), mags.begin() + (m - km), mags.end());
+            float thr = mags[m - km];
+
+            // Zeros are never sent
+            indices.clear();
+            for (int i = 0; i < n; i++) {
+                float a = std::fabs(values[i]);
+                if ((a > 0.0f) && (a >= thr)) indices.push_back(i);
+            }
+
+            // The estimate let too many values through: exact threshold among them (ties are cut at k)
+            if (indices.size() > k) {
+                mags.resize(indices.size());
+                for (int j = 0; j < indices.size(); j++) mags[j] = std::fabs(values[indices[j]]);
+                std::nth_element(mags.begin(), mags.begin() + (mags.size() - k), mags.end());
+                thr = mags[mags.size() - k];
+                int c = 0;
+                for (int j = 0; (j < indices.size()) && (c < k); j++)
+                    if (std::fabs(values[indices[j]]) >= thr) indices[c++] = indices[j];
+                indices.resize(c);
+            }
+            int nnz = indices.size();
+            e.nnz = nnz;
+
+            auto *oi = (uint32_t *)payload;
+            auto *ov = (float *)(payload + nnz * sizeof(uint32_t));
+            for (int j = 0; j < nnz; j++) {
+                oi[j] = indices[j];
+                ov[j] = values[indices[j]];
+            }
+
+            // Error feedback: what was not sent
+            if (kind == EXCHANGE_GRADIENTS) {
+                memcpy(f, values.data(), n * sizeof(float));
+                for (int j = 0; j < nnz; j++) f[indices[j]] = 0.0f;
+            } else {
+                for (int j = 0; j < nnz; j++) f[indices[j]] += values[indices[j]];
+            }
+        }
+
+        memcpy(b + off, &e, sizeof(e));
+        off += sizeof(e) + payload_size(encoding, n, e.nnz);
+    }
+
+    return off;
+}
+
+
+void decode_exchange(Net *net, const char *buf, size_t size, float scale, bool accumulate) {
+    if (net->snets.empty()) msg("The model must be built before exchanging its params", "decode_exchange");
+
+    ExchangeHeader h;
+    if (size < sizeof(h)) msg("Truncated message", "decode_exchange");
+    memcpy(&h, buf, sizeof(h));
+    if (memcmp(h.magic, EXCHANGE_MAGIC, 4) != 0) msg("Not an exchange message", "decode_exchange");
+    if (h.version != EXCHANGE_VERSION) msg("Unsupported exchange version " + to_string(h.version), "decode_exchange");
+    if ((h.kind != EXCHANGE_GRADIENTS) && (h.kind != EXCHANGE_WEIGHTS)) msg("Unknown kind of exchange", "decode_exchange");
+    if (h.encoding > EXCHANGE_TOPK) msg("Unknown exchange encoding", "decode_exchange");
+
+    bool sparse = (h.encoding == EXCHANGE_TOPK);
+    if (sparse && (h.kind == EXCHANGE_WEIGHTS)) accumulate = true;  // deltas
+
+    vector<vtensor> targets;
+    for (auto sn : net->snets) targets.push_back(net_tensors(sn, h.kind));
+
+    vector<float> host, values;
+    size_t off = sizeof(h);
+    for (int m = 0; m < h.nparams; m++) {
+        ExchangeEntry e;
+        if (off + sizeof(e) > size) msg("Truncated message", "decode_exchange");
+        memcpy(&e, buf + off, sizeof(e));
+        off += sizeof(e);
+
+        if ((e.index >= targets[0].size()) || (e.size != targets[0][e.index]->size) || (e.nnz > e.size))
+            msg("The message does not match the net (param " + to_string(e.index) + ")", "decode_exchange");
+        size_t bytes = payload_size(h.encoding, e.size, e.nnz);
+        if (off + bytes > size) msg("Truncated message", "decode_exchange");
+        const char *payload = buf + off;
+        off += bytes;
+
+        int n = e.size;
+        for (auto &ts : targets) {
+            Tensor *t = ts[e.index];
+            float *dst = host_values(t, host, accumulate);
+
+            if (h.encoding == EXCHANGE_FP32) {
+                const auto *v = (const float *)payload;
+                if (accumulate) {
+                    #pragma omp parallel for
+                    for (int i = 0; i < n; i++) dst[i] += scale * v[i];
+                } else {
+                    #pragma omp parallel for
+                    for (int i = 0; i < n; i++) dst[i] = scale * v[i];
+                }
+            }
+            else if (h.encoding == EXCHANGE_FP16) {
+                values.resize(n);
+                cpu_unpack_fp16((const uint16_t *)payload, values.data(), n);
+                const float *v = values.data();
+                if (accumulate) {
+                    #pragma omp parallel for
+                    for (int i = 0; i < n; i++) dst[i] += scale * v[i];
+                } else {
+                    #pragma omp parallel for
+                    for (int i = 0; i < n; i++) dst[i] = scale * v[i];
+                }
+            }
+            else {
+                const auto *vi = (const uint32_t *)payload;
+                const auto *vv = (const float *)(payload + e.nnz * sizeof(uint32_t));
+                if (!accumulate) std::fill(dst, dst + n, 0.0f);
+                for (int j = 0; j < e.nnz; j++) {
+                    if (vi[j] >= e.size) msg("Corrupted message (index out of range)", "decode_exchange");
+                    dst[vi[j]] += scale * vv[j];
+                }
+            }
+
+            host_writeback(t, host);
+        }
+    }
+}
@@ -26,6 +26,8 @@ using namespace std;
 
 	void build_conv1D_node( LConv1D *layer, onnx::GraphProto *graph, bool gradients );
 
+	void build_convT_node( LConvT *layer, onnx::GraphProto *graph );
+
 	void build_gemm_node( LDense *layer, onnx::GraphProto *graph, bool gradients );
 
 	void build_maxpool_node( LMaxPool *layer, onnx::GraphProto *graph );
@@ -85,6 +87,7 @@ using namespace std;
 	void build_upsample_node( LUpSampling *layer, onnx::GraphProto *graph );
 
     void build_lstm_node( LLSTM *layer, onnx::GraphProto *graph );
+    void build_gru_node( LGRU *layer, onnx::GraphProto *graph );
 #endif
 
 #ifdef cPROTO
@@ -148,6 +151,17 @@ using namespace std;
 		// Builds all the graph of the model
 		set_graph( &model, net, gradients );
 
+		// The fp32 weights are kept in the graph, the int8 activation scales travel as metadata
+		for( Layer* aux_layer : net->quantizable_layers() ) {
+			QuantDescriptor *qd = net->get_quantization( aux_layer );
+			if ( qd == nullptr ) continue;
+			char value[64];
+			snprintf( value, sizeof(value), "%.9g,%d", qd->in_scale, qd->per_channel ? 1 : 0 );
+			onnx::StringStringEntryProto* prop = model.add_metadata_props();
+			prop->set_key( "eddl.quantization." + aux_layer->name );
+			prop->set_value( value );
+		}
+
 		// Return the finished model
 		return model;
 	}
@@ -210,6 +224,10 @@ using namespace std;
 		else if ( LConv1D* t = dynamic_cast<LConv1D*>( layer ) ) 
 		{
 	    	build_conv1D_node( (LConv1D*)(LinLayer*)layer, graph, gradients );
+	    } 
+		else if ( LConvT* t = dynamic_cast<LConvT*>( layer ) ) 
+		{
+	    	build_convT_node( (LConvT*)(LinLayer*)layer, graph );
 	    } 
 		else if ( LDense *t = dynamic_cast<LDense*>( layer ) ) 
 		{
@@ -340,6 +358,10 @@ using namespace std;
 	    else if ( LLSTM *t = dynamic_cast<LLSTM*>( layer ) ) 
 		{
 	    	build_lstm_node( (LLSTM*)(MLayer*)layer, graph );
+	    } 
+	    else if ( LGRU *t = dynamic_cast<LGRU*>( layer ) ) 
+		{
+	    	build_gru_node( (LGRU*)(MLayer*)layer, graph );
 	    } 
 		else 
 		{
@@ -371,15 +393,14 @@ using namespace std;
 		onnx::AttributeProto* conv_dilations = node->add_attribute();
 		conv_dilations->set_name( "dilations" );
 		conv_dilations->set_type( onnx::AttributeProto::INTS );
-		vector<int> vdilations {1, 1}; // ?? Tenemos esto en EDDL
-		for ( int i : vdilations ) {
+		for ( int i : layer->cd->dilation ) {
 			conv_dilations->add_ints( i );
 		}
 		//Attr group
 		onnx::AttributeProto* conv_group = node->add_attribute();
 		conv_group->set_name( "group" );
 		conv_group->set_type( onnx::AttributeProto::INT );
-		conv_group->set_i( 1 ); // ????????????????????????????????????????????????????
+		conv_group->set_i( layer->cd->groups );
 		// Attr kernel_shape
 		onnx::AttributeProto* conv_kernel_shape = node->add_attribute();
 		conv_kernel_shape->set_name( "kernel_shape" );
@@ -435,6 +456,78 @@ using namespace std;
 		}
 	}
 
+	void build_convT_node( LConvT *layer, onnx::GraphProto *graph ) {
+		// Add an empty node to the graph
+		onnx::NodeProto* node = graph->add_node();
+		node->set_op_type( "ConvTranspose" );
+		node->set_name( layer->name );
+		// Set the inputs of the node from the parents of the layer
+		for ( Layer* parentl : layer->parent ) {
+			node->add_input( parentl->name );
+		}
+		// Set the input params names of the conv op
+		node->add_input( layer->name + "_W" );
+		if ( layer->use_bias ) node->add_input( layer->name + "_b" );
+		// Set the name of the output of the node to link with other nodes
+		node->add_output( layer->name );
+
+		////////////////////////// Attributes of the ConvTranspose operation //////////////////////////////////
+		// Attr dilations
+		onnx::AttributeProto* convt_dilations = node->add_attribute();
+		convt_dilations->set_name( "dilations" );
+		convt_dilations->set_type( onnx::AttributeProto::INTS );
+		for ( int i : layer->cd->dilation ) {
+			convt_dilations->add_ints( i );
+		}
+		//Attr group
+		onnx::AttributeProto* convt_group = node->add_attribute();
+		convt_group->set_name( "group" );
+		convt_group->set_type( onnx::AttributeProto::INT );
+		convt_group->set_i( 1 );
+		// Attr kernel_shape
+		onnx::AttributeProto* convt_kernel_shape = node->add_attribute();
+		convt_kernel_shape->set_name( "kernel_shape" );
+		convt_kernel_shape->set_type( onnx::AttributeProto::INTS );
+		convt_kernel_shape->add_ints( layer->cd->kr );
+		convt_kernel_shape->add_ints( layer->cd->kc );
+		// Attr output_padding
+		onnx::AttributeProto* convt_output_padding = node->add_attribute();
+		convt_output_padding->set_name( "output_padding" );
+		convt_output_padding->set_type( onnx::AttributeProto::INTS );
+		for ( int i : layer->output_padding ) {
+			convt_output_padding->add_ints( i );
+		}
+		// Attr pads (the ones of the adjoint convolution)
+		onnx::AttributeProto* convt_pads = node->add_attribute();
+		convt_pads->set_name( "pads" );
+		convt_pads->set_type( onnx::AttributeProto::INTS );
+		convt_pads->add_ints( layer->cd->padrt );
+		convt_pads->add_ints( layer->cd->padcl );
+		convt_pads->add_ints( layer->cd->padrb );
+		convt_pads->add_ints( layer->cd->padcr );
+		// Attr strides
+		onnx::AttributeProto* convt_strides = node->add_attribute();
+		convt_strides->set_name( "strides" );
+		convt_strides->set_type( onnx::AttributeProto::INTS );
+		convt_strides->add_ints( layer->cd->sr );
+		convt_strides->add_ints( layer->cd->sc );
+
+		// Weights input: {in_channels, filters, kr, kc}, as in ONNX
+		onnx::TensorProto* convt_w = graph->add_initializer();
+		convt_w->set_name( layer->name + "_W" );
+		convt_w->set_data_type( onnx::TensorProto::FLOAT );
+		convt_w->mutable_dims()->Add( layer->cd->K->shape.begin(), layer->cd->K->shape.end() ); // Set the shape of the weights
+		convt_w->mutable_float_data()->Add( layer->cd->K->ptr, layer->cd->K->ptr + layer->cd->K->size ); // Set the weights values
+		// Bias input
+		if ( layer->use_bias ) {
+			onnx::TensorProto* convt_b = graph->add_initializer();
+			convt_b->set_name( layer->name + "_b" );
+			convt_b->set_data_type( onnx::TensorProto::FLOAT );
+			convt_b->mutable_dims()->Add( layer->bias->shape.begin(), layer->bias->shape.end() ); // Set the shape of the bias
+			convt_b->mutable_float_data()->Add( layer->bias->ptr, layer->bias->ptr + layer->bias->size ); // Set the bias values
+		}
+	}
+
     void build_conv1D_node( LConv1D *layer, onnx::GraphProto *graph, bool gradients ) {
 		// Add an empty node to the graph
 		onnx::NodeProto* node = graph->add_node();
@@ -455,13 +548,13 @@ using namespace std;
 		onnx::AttributeProto* conv_dilations = node->add_attribute();
 		conv_dilations->set_name( "dilations" );
 		conv_dilations->set_type( onnx::AttributeProto::INTS );
-		conv_dilations->add_ints( 1 );
+		conv_dilations->add_ints( layer->cd->dilation[0] );
 
 		//Attr group
 		onnx::AttributeProto* conv_group = node->add_attribute();
 		conv_group->set_name( "group" );
 		conv_group->set_type( onnx::AttributeProto::INT );
-		conv_group->set_i( 1 );
+		conv_group->set_i( layer->cd->groups );
 
 		// Attr kernel_shape
 		onnx::AttributeProto* conv_kernel_shape = node->add_attribute();
@@ -1140,35 +1233,53 @@ using namespace std;
 	}
 
 	void build_upsample_node( LUpSampling *layer, onnx::GraphProto *graph ) {
-		// Add an empty node to the graph
+		// Add an empty node to the graph (Upsample is deprecated since opset 10)
 		onnx::NodeProto* node = graph->add_node();
-		node->set_op_type( "Upsample" );
+		node->set_op_type( "Resize" );
 		node->set_name( layer->name );
 		// Set the inputs of the node from the parents of the layer
 		for ( Layer* parentl : layer->parent ) {
 			node->add_input( parentl->name );
 		}
-		// Set the input with the scale values
-		node->add_input( layer->name + "_scales" );	
+		// Inputs: roi (not used), scales
+		node->add_input( "" );
+		node->add_input( layer->name + "_scales" );
 		// Set the name of the output of the node to link with other nodes
 		node->add_output( layer->name );
 
+		bool nearest = layer->interpolation == "nearest";
+
 		// Attr mode
 		onnx::AttributeProto* mode_attr = node->add_attribute();
 		mode_attr->set_name( "mode" );
 		mode_attr->set_type( onnx::AttributeProto::STRING );
-		mode_attr->set_s( layer->interpolation );
+		mode_attr->set_s( nearest ? "nearest" : "linear" );
+
+		// Attr coordinate_transformation_mode
+		onnx::AttributeProto* coord_attr = node->add_attribute();
+		coord_attr->set_name( "coordinate_transformation_mode" );
+		coord_attr->set_type( onnx::AttributeProto::STRING );
+		if ( layer->align_corners ) coord_attr->set_s( "align_corners" );
+		else coord_attr->set_s( nearest ? "asymmetric" : "half_pixel" );
+
+		// Attr nearest_mode
+		if ( nearest ) {
+			onnx::AttributeProto* nearest_attr = node->add_attribute();
+			nearest_attr->set_name( "nearest_mode" );
+			nearest_attr->set_type( onnx::AttributeProto::STRING );
+			nearest_attr->set_s( layer->align_corners ? "round_prefer_ceil" : "floor" );
+		}
 
 		// Scales input
 		onnx::TensorProto* scales = graph->add_initializer();
 		scales->set_name( layer->name + "_scales" );
-		scales->set_data_type( onnx::TensorProto::FLOAT );	
-		scales->add_dims( 2 + layer->size.size() ); // (batch_size, channels, height, width)
+		scales->set_data_type( onnx::TensorProto::FLOAT );
+		scales->add_dims( 2 + layer->size.size() ); // (batch_size, channels, spatial...)
 
 		// Add the scale factor for the first two dimensions
 		for( int i = 0; i < 2; ++i ) {
 			scales->add_float_data( 1 );
-		}	
+		}
 
 		for( int i = 0; i < layer->size.size(); ++i) {
 			scales->add_float_data( layer->size[i] );
@@ -1281,6 +1392,82 @@ using namespace std;
 		node->add_output( layer->name );
     }
 
+    void build_gru_node( LGRU *layer, onnx::GraphProto *graph ) {
+		// Add an empty node to the graph
+		onnx::NodeProto* node = graph->add_node();
+		node->set_op_type( "GRU" );
+		node->set_name( layer->name );
+		// Set the inputs of the node from the parents of the layer
+		for ( Layer* parentl : layer->parent ) {
+			node->add_input( parentl->name );
+		}
+		node->add_input( layer->name + "_W" );
+		node->add_input( layer->name + "_R" );
+		node->add_input( layer->name + "_B" );
+
+		// Attr activations
+		onnx::AttributeProto* activations_attr = node->add_attribute();
+		activations_attr->set_name( "activations" );
+		activations_attr->set_type( onnx::AttributeProto::STRINGS );
+	    activations_attr->add_strings( "Sigmoid" );  // For gates z, r
+	    activations_attr->add_strings( "Tanh" );     // For gate h
+
+		// Attr direction
+		onnx::AttributeProto* direction_attr = node->add_attribute();
+		direction_attr->set_name( "direction" );
+		direction_attr->set_type( onnx::AttributeProto::STRING );
+        direction_attr->set_s( "forward" );  // Current implementation of GRU
+
+		// Attr hidden size
+		onnx::AttributeProto* hidden_size_attr = node->add_attribute();
+		hidden_size_attr->set_name( "hidden_size" );
+		hidden_size_attr->set_type( onnx::AttributeProto::INT );
+        hidden_size_attr->set_i( layer->units );
+
+		// Attr linear before reset (the reset gate is applied after the recurrent product)
+		onnx::AttributeProto* linear_before_reset_attr = node->add_attribute();
+		linear_before_reset_attr->set_name( "linear_before_reset" );
+		linear_before_reset_attr->set_type( onnx::AttributeProto::INT );
+        linear_before_reset_attr->set_i( 1 );
+
+		// The gates are packed in the columns of Wx {in x 3u} and Wh {u x 3u} in the ONNX order (z, r, h),
+		// so W and R are their transposes
+		int in = layer->input->shape[1];
+		int g = 3 * layer->units;
+
+		// W input (weights for all the gates W[zrh])
+		onnx::TensorProto* w = graph->add_initializer();
+		w->set_name( layer->name + "_W" );
+		w->set_data_type( onnx::TensorProto::FLOAT );
+		vector<int> w_dims {1, g, in}; // shape[0] = 1 beacuse is only forward
+        w->mutable_dims()->Add( w_dims.begin(), w_dims.end() ); // Set the shape of the weights
+		for( int i = 0; i < g; ++i )
+			for( int j = 0; j < in; ++j )
+				w->add_float_data( layer->Wx->ptr[j * g + i] );
+
+		// R input (recurrent weights for all the gates R[zrh])
+		onnx::TensorProto* r = graph->add_initializer();
+		r->set_name( layer->name + "_R" );
+		r->set_data_type( onnx::TensorProto::FLOAT );
+		vector<int> r_dims {1, g, layer->units}; // shape[0] = 1 beacuse is only forward
+        r->mutable_dims()->Add( r_dims.begin(), r_dims.end() ); // Set the shape of the weights
+		for( int i = 0; i < g; ++i )
+			for( int j = 0; j < layer->units; ++j )
+				r->add_float_data( layer->Wh->ptr[j * g + i] );
+
+		// B input (input and recurrent biases)
+		onnx::TensorProto* b = graph->add_initializer();
+		b->set_name( layer->name + "_B" );
+		b->set_data_type( onnx::TensorProto::FLOAT );
+		vector<int> b_dims {1, 2*g}; // shape[0] = 1 beacuse is only forward
+        b->mutable_dims()->Add( b_dims.begin(), b_dims.end() ); // Set the shape of the weights
+        b->mutable_float_data()->Add( layer->bias->ptr, layer->bias->ptr + layer->bias->size ); // Wb[zrh]
+        b->mutable_float_data()->Add( layer->rbias->ptr, layer->rbias->ptr + layer->rbias->size ); // Rb[zrh]
+
+		// Set the name of the output of the node to link with other nodes
+		node->add_output( layer->name );
+    }
+
 	// End: Node builders
 	//----------------------------------------------------------------------------------------
 
@@ -47,8 +47,8 @@ using namespace std;
 		RESHAPE,            // implemented
 		FLATTEN,            // implemented
 		TRANSPOSE,          // implementing
-		TRANSPOSED_CONV,	// not implemented in eddl
-		UPSAMPLING,         // deprecated in ONNX, but works for EDDL
+		TRANSPOSED_CONV,	// implemented
+		UPSAMPLING,         // Upsample (deprecated in ONNX) and Resize
 		MAXPOOL,			// implemented
 		AVGPOOL,            // needs testing
 		GLOBAVGPOOL,        // implemented
@@ -77,6 +77,7 @@ using namespace std;
 		MIN,                // implemented
 		SUB,                // implemented
 		LSTM,               // implemented
+		GRU,                // implemented
 		IDENTITY            // implemented
 
 
@@ -162,6 +163,7 @@ using namespace std;
 		map_layers["Transpose"] = ONNX_LAYERS::TRANSPOSE;
 		map_layers["ConvTranspose"] = ONNX_LAYERS::TRANSPOSED_CONV;
 		map_layers["Upsample"] = ONNX_LAYERS::UPSAMPLING;
+		map_layers["Resize"] = ONNX_LAYERS::UPSAMPLING;
 		map_layers["Softmax"] = ONNX_LAYERS::SOFTMAX;
 		map_layers["MaxPool"] = ONNX_LAYERS::MAXPOOL;
 		map_layers["AveragePool"] = ONNX_LAYERS::AVGPOOL;
@@ -190,6 +192,7 @@ using namespace std;
 		map_layers["Max"] = ONNX_LAYERS::MAX;
 		map_layers["Min"] = ONNX_LAYERS::MIN;
 		map_layers["LSTM"] = ONNX_LAYERS::LSTM;
+		map_layers["GRU"] = ONNX_LAYERS::GRU;
 		map_layers["Identity"] = ONNX_LAYERS::IDENTITY;
 		
 
@@ -567,7 +570,7 @@ using namespace std;
 			bool avaliable = true;
 			for(int j = 0; j < node->input_size(); j++){
 				string input = node->input(j);
-				if(map_init_values.count(input)){
+				if(input.empty() || map_init_values.count(input)){ // empty: optional input not given
 					continue;
 				}
 				if(constant_node_map.count(input)){
@@ -596,7 +599,7 @@ using namespace std;
 
 			for(int i = 0; i < node->input_size(); i++){
 				string input = node->input(i);
-				if(map_init_values.count(input)){
+				if(input.empty() || map_init_values.count(input)){
 					continue;
 				}
 				if(output_node_map.count(input)){
@@ -705,6 +708,8 @@ using namespace std;
 						bool auto_pad = false;
 						vector<float> *bias;
                         bool conv1d = false;
+						int groups = 1;
+						vector<int> dilations;
 
 						for ( int j = 0; j < node->attribute_size(); j++ ) { //Set the attributes
 							onnx::AttributeProto attribute = node->attribute(j);
@@ -720,11 +725,13 @@ using namespace std;
 								else if(!attribute.s().compare("SAME_UPPER"))
 									auto_pad_option = "same";
 							}
-							else if (!attr_name.compare("dilations")) { //It isn't implemented in eddl
-
+							else if (!attr_name.compare("dilations")) {
+								for(int h = 0; h < attribute.ints_size(); h++){
+									dilations.push_back(attribute.ints(h));
+								}
 							}
-							else if (!attr_name.compare("group")) { //We don't know if this exists in eddl
-
+							else if (!attr_name.compare("group")) {
+								groups = attribute.i();
 							}
 							else if (!attr_name.compare("kernel_shape")) { //
 								for( int h = 0; h<attribute.ints_size(); h++){
@@ -777,16 +784,18 @@ using namespace std;
                             dims.push_back(1);
                             pads.push_back(0);
                             pads.push_back(0);
+							if(!dilations.empty()) dilations.push_back(1);
 						}
+						if(dilations.empty()) dilations = {1, 1};
 
 						filters = dims[0];
 						string name = node->name();
 						ConvolDescriptor* convol_descriptor;
 						if(!auto_pad){
 							kernel_shape.insert(kernel_shape.begin(), filters); //Add number of filters to kernel shape
-							convol_descriptor = new ConvolDescriptor(kernel_shape, strides, pads);
+							convol_descriptor = new ConvolDescriptor(kernel_shape, strides, pads, mem, groups, dilations);
 						}
-						else convol_descriptor = new ConvolDescriptor(filters, kernel_shape, strides, auto_pad_option, node->input_size() > 2, mem);
+						else convol_descriptor = new ConvolDescriptor(filters, kernel_shape, strides, auto_pad_option, node->input_size() > 2, mem, groups, dilations);
 
 						if(conv1d) actual_layer = new LConv1D(parent, convol_descriptor, name, dev, mem);
                         else actual_layer = new LConv(parent, convol_descriptor, name, dev, mem);
@@ -806,6 +815,94 @@ using namespace std;
 						delete weights_tensor;
 					}
 					break;
+				case ONNX_LAYERS::TRANSPOSED_CONV:
+					{
+						vector<int> kernel_shape;
+						vector<int> strides = {1, 1};
+						vector<int> pads = {0, 0, 0, 0};
+						vector<int> output_padding = {0, 0};
+						vector<int> dilations = {1, 1};
+						string auto_pad_option = "";
+						int groups = 1;
+
+						for ( int j = 0; j < node->attribute_size(); j++ ) { //Set the attributes
+							onnx::AttributeProto attribute = node->attribute(j);
+							string attr_name = attribute.name();
+							if (!attr_name.compare("auto_pad")) {
+								if(!attribute.s().compare("VALID"))
+									auto_pad_option = "none";
+								else if(!attribute.s().compare("SAME_UPPER"))
+									auto_pad_option = "same";
+								else if(attribute.s().compare("NOTSET"))
+									msg("Padding " + attribute.s() + " is not supported", "ONNX::ImportNet");
+							}
+							else if (!attr_name.compare("dilations")) {
+								dilations.clear();
+								for(int h = 0; h < attribute.ints_size(); h++) dilations.push_back(attribute.ints(h));
+							}
+							else if (!attr_name.compare("group")) {
+								groups = attribute.i();
+							}
+							else if (!attr_name.compare("kernel_shape")) {
+								for(int h = 0; h < attribute.ints_size(); h++) kernel_shape.push_back(attribute.ints(h));
+							}
+							else if (!attr_name.compare("output_padding")) {
+								output_padding.clear();
+								for(int h = 0; h < attribute.ints_size(); h++) output_padding.push_back(attribute.ints(h));
+							}
+							else if (!attr_name.compare("output_shape")) {
+								msg("ConvTranspose with an explicit output_shape is not supported", "ONNX::ImportNet");
+							}
+							else if (!attr_name.compare("pads")) {
+								pads.clear();
+								for(int h = 0; h < attribute.ints_size(); h++) pads.push_back(attribute.ints(h));
+								if(attribute.ints_size() == 4)
+									swap(pads[1], pads[2]);  // {top, left, bottom, right} -> {top, bottom, left, right}
+							}
+							else if (!attr_name.compare("strides")) {
+								strides.clear();
+								for(int h = 0; h < attribute.ints_size(); h++) strides.push_back(attribute.ints(h));
+							}
+						}
+
+						if (groups != 1) msg("Grouped ConvTranspose is not supported", "ONNX::ImportNet");
+
+						string parent_name = node->input(0); //Get parent
+						Layer* parent = output_node_map[parent_name];
+
+						string weights_name = node->input(1); //Get weights and dims: {in_channels, filters, kr, kc}
+						vector<float>* weights = &(map_init_values[weights_name]);
+						vector<int> dims = map_init_dims[weights_name];
+						if(kernel_shape.empty()) kernel_shape = {dims[2], dims[3]};
+
+						int filters = dims[1];
+						bool use_bias = node->input_size() > 2;
+						string name = node->name();
+						ConvolDescriptor* convol_descriptor;
+						if(auto_pad_option.empty()){
+							kernel_shape.insert(kernel_shape.begin(), filters);
+							convol_descriptor = new ConvolDescriptor(kernel_shape, strides, pads, mem, groups, dilations);
+							convol_descriptor->use_bias = use_bias;
+						}
+						else convol_descriptor = new ConvolDescriptor(filters, kernel_shape, strides, auto_pad_option, use_bias, mem, groups, dilations);
+
+						LConvT *convt = new LConvT(parent, convol_descriptor, output_padding, name, dev, mem);
+						actual_layer = convt;
+
+						if(use_bias){
+							string bias_name = node->input(2);
+							vector<float> *bias = &(map_init_values[bias_name]);
+							vector<int> bias_shape;
+							bias_shape.push_back(bias->size());
+							Tensor* bias_tensor = new Tensor(bias_shape, NEW_FROM_VECTOR_PTR(bias), dev);
+							Tensor::copy(bias_tensor, convt->bias);
+							delete bias_tensor;
+						}
+						Tensor* weights_tensor = new Tensor(dims, NEW_FROM_VECTOR_PTR(weights), dev);
+						Tensor::copy(weights_tensor, convol_descriptor->K);
+						delete weights_tensor;
+					}
+					break;
 				case ONNX_LAYERS::DENSE:
 					{
 						int ndim;
@@ -881,42 +978,58 @@ using namespace std;
 					}
 					break;
 					
-				case ONNX_LAYERS::UPSAMPLING:
+				case ONNX_LAYERS::UPSAMPLING:  // Upsample and Resize
 					{
-						string interpolation_mode;
-						float batch_scale;
-						float channel_scale;
-						float height_scale;
-						float width_scale;
+						string interpolation_mode = "nearest";
+						string coordinate_mode = "half_pixel";
+						vector<float> scales;
 						for ( int j = 0; j < node->attribute_size(); j++ ) { //Set the attributes
 							onnx::AttributeProto attribute = node->attribute(j);
 							string attr_name = attribute.name();
 							if(!attr_name.compare("mode")) interpolation_mode = attribute.s();
+							else if(!attr_name.compare("coordinate_transformation_mode")) coordinate_mode = attribute.s();
+							else if(!attr_name.compare("scales")) { // Upsample-7
+								for( int k = 0; k < attribute.floats_size(); k++ ) scales.push_back(attribute.floats(k));
+							}
 						}
-						
+
 						string parent_name = node->input(0); //Get parent
 						Layer* parent = output_node_map[parent_name];
 						vector<int> parent_shape = parent->output->shape;
-						
-						string scales_name = node->input(1); //Get scales and dims
-						vector<float>* scales = &(map_init_values[scales_name]);
-						vector<int> scales_dims = map_init_dims[scales_name];
-						
-						if(scales_dims[0] != 4){
-							cerr << "Dimensions of upsampling layer in onnx are wrong" << endl;
-						}
-						batch_scale = scales->at(0);
-						channel_scale = scales->at(1);
-						height_scale = scales->at(2);
-						width_scale = scales->at(3);
-						
-						string name = node->name();
 
+						// Upsample: (X, scales). Resize-10: (X, scales). Resize-11: (X, roi, scales, sizes)
+						vector<float> sizes;
+						int scales_input = (node->op_type() == "Resize" && node->input_size() > 2) ? 2 : 1;
+						if(node->input_size() > scales_input && !node->input(scales_input).empty())
+							scales = map_init_values[node->input(scales_input)];
+						if(node->input_size() > 3 && !node->input(3).empty())
+							sizes = map_init_values[node->input(3)];
 
 						vector<int> size_vector;
-						size_vector.push_back((int)height_scale);
-						size_vector.push_back((int)width_scale);
-						actual_layer = new LUpSampling(parent, size_vector, interpolation_mode, name, dev, mem);
+						for( int i = 2; i < parent_shape.size(); i++ ) {
+							float factor;
+							if(!scales.empty()) factor = scales[i];
+							else if(!sizes.empty()) factor = sizes[i] / parent_shape[i];
+							else msg("Resize node " + node->name() + " has neither scales nor sizes", "ONNX::ImportNet");
+							if(factor < 1 || factor != (int)factor)
+								msg("Only integer upsampling factors are supported (node " + node->name() + ")", "ONNX::ImportNet");
+							size_vector.push_back((int)factor);
+						}
+						if((!scales.empty() && (scales.size() != parent_shape.size() || scales[0] != 1 || scales[1] != 1)) ||
+						   (scales.empty() && sizes.size() != parent_shape.size()))
+							msg("Only the spatial axes can be resized (node " + node->name() + ")", "ONNX::ImportNet");
+
+						if(interpolation_mode == "linear") interpolation_mode = "bilinear";
+						else if(interpolation_mode != "nearest" && interpolation_mode != "bilinear")
+							msg("Interpolation mode " + interpolation_mode + " is not supported", "ONNX::ImportNet");
+
+						bool align_corners = coordinate_mode == "align_corners";
+						// With integer factors every mode but align_corners takes the nearest sample at floor(x/factor)
+						if(interpolation_mode == "bilinear" && coordinate_mode != "half_pixel" && coordinate_mode != "pytorch_half_pixel" && !align_corners)
+							msg("Coordinate transformation mode " + coordinate_mode + " is not supported for linear interpolation", "ONNX::ImportNet");
+
+						string name = node->name();
+						actual_layer = new LUpSampling(parent, size_vector, interpolation_mode, align_corners, name, dev, mem);
 					}
 					break;
 
@@ -1703,6 +1816,98 @@ using namespace std;
 					}
 					break;
 
+                case ONNX_LAYERS::GRU:
+					{
+						string direction = "forward";   //Forward, reverse or bidirectional
+						int hidden_size = -1;           //Number of neurons in the hidden layer
+						int linear_before_reset = 0;    //If 1, the reset gate is applied after the recurrent product
+
+						for ( int j = 0; j < node->attribute_size(); j++ ) { //Set the attributes
+							onnx::AttributeProto attribute = node->attribute(j);
+							string attr_name = attribute.name();
+							if (!attr_name.compare("activations")) { //We only support Sigmoid, Tanh
+								for( int h = 0; h<attribute.strings_size(); h++){
+									string act = attribute.strings(h);
+									if (act.compare((h % 2) ? "Tanh" : "Sigmoid"))
+										msg("GRU activation " + act + " is not supported", "ONNX::ImportNet");
+								}
+							}
+							else if (!attr_name.compare("clip")) {
+								msg("GRU with clip is not supported", "ONNX::ImportNet");
+							}
+							else if (!attr_name.compare("direction")) {
+								direction = attribute.s();
+							}
+							else if (!attr_name.compare("hidden_size")) {
+								hidden_size = attribute.i();
+							}
+							else if (!attr_name.compare("linear_before_reset")) {
+								linear_before_reset = attribute.i();
+							}
+						}
+
+						if (direction.compare("forward")) msg("GRU with direction " + direction + " is not supported", "ONNX::ImportNet");
+						if (linear_before_reset != 1) msg("GRU is only supported with linear_before_reset=1", "ONNX::ImportNet");
+						if (node->input_size() > 4 && !node->input(4).empty()) msg("GRU with sequence_lens is not supported", "ONNX::ImportNet");
+						if (node->input_size() > 5 && !node->input(5).empty()) msg("GRU with initial_h is not supported", "ONNX::ImportNet");
+
+						string parent_name = node->input(0); //Get parent
+						Layer* parent = output_node_map[parent_name];
+
+						string weights_name = node->input(1); //Get weights and dims
+						vector<float>* weights = &(map_init_values[weights_name]);
+						vector<int> dims_w = map_init_dims[weights_name];
+						if (hidden_size < 0) hidden_size = dims_w[1] / 3;
+						int g = 3 * hidden_size;
+						int input_size = dims_w[2];
+
+						string recurrence_name = node->input(2);
+						vector<float>* recurrence = &(map_init_values[recurrence_name]);
+
+						LGRU* gru = new LGRU({parent}, hidden_size, 0, 0, name, dev, mem);
+
+						// W {1 x 3u x in} and R {1 x 3u x u} are the transposes of Wx and Wh
+						vector<float>* wx = new vector<float>(input_size * g);
+						for( int i = 0; i < g; ++i )
+							for( int j = 0; j < input_size; ++j )
+								(*wx)[j * g + i] = (*weights)[i * input_size + j];
+						Tensor* wx_tensor = new Tensor({input_size, g}, NEW_FROM_VECTOR_PTR(wx), dev);
+						Tensor::copy(wx_tensor, gru->Wx );
+						delete wx_tensor;
+						delete wx;
+
+						vector<float>* wh = new vector<float>(hidden_size * g);
+						for( int i = 0; i < g; ++i )
+							for( int j = 0; j < hidden_size; ++j )
+								(*wh)[j * g + i] = (*recurrence)[i * hidden_size + j];
+						Tensor* wh_tensor = new Tensor({hidden_size, g}, NEW_FROM_VECTOR_PTR(wh), dev);
+						Tensor::copy(wh_tensor, gru->Wh );
+						delete wh_tensor;
+						delete wh;
+
+						// B is optional (zeros by default)
+						gru->bias->fill_(0.0);
+						gru->rbias->fill_(0.0);
+						if (node->input_size() > 3 && !node->input(3).empty()) {
+							vector<float>* biases = &(map_init_values[node->input(3)]);
+
+							vector<float>* bias = new vector<float>(biases->begin(), biases->begin() + g);
+							Tensor* bias_tensor = new Tensor({g}, NEW_FROM_VECTOR_PTR(bias), dev);
+							Tensor::copy(bias_tensor, gru->bias );
+							delete bias_tensor;
+							delete bias;
+
+							vector<float>* rbias = new vector<float>(biases->begin() + g, biases->begin() + 2 * g);
+							Tensor* rbias_tensor = new Tensor({g}, NEW_FROM_VECTOR_PTR(rbias), dev);
+							Tensor::copy(rbias_tensor, gru->rbias );
+							delete rbias_tensor;
+							delete rbias;
+						}
+
+						actual_layer = gru;
+					}
+					break;
+
 				case ONNX_LAYERS::IDENTITY:
 					{
 						log_string("Identity layer detected" , log_level, LOG_LEVEL::DEBUG);
@@ -1740,7 +1945,25 @@ using namespace std;
 		}
 		log_string("Finished importing net from ONNX" , log_level, LOG_LEVEL::DEBUG);
 		//cout << "Net imported from ONNX succesfully" << endl;
-		return new Net(input_layers, output_layers);
+		Net *net = new Net(input_layers, output_layers);
+
+		// int8 activation scales of quantized Dense/Conv layers (see build_onnx_model)
+		string quant_prefix = "eddl.quantization.";
+		map<string, Layer*> quantizable;
+		for( Layer* l : net->quantizable_layers() ) quantizable[l->name] = l;
+		for( int i = 0; i < model.metadata_props_size(); i++ ) {
+			const onnx::StringStringEntryProto &prop = model.metadata_props(i);
+			if ( prop.key().compare(0, quant_prefix.size(), quant_prefix) != 0 ) continue;
+			string layer_name = prop.key().substr(quant_prefix.size());
+			float in_scale = 0.0f;
+			int per_channel = 1;
+			if ( quantizable.count(layer_name) == 0 || sscanf(prop.value().c_str(), "%f,%d", &in_scale, &per_channel) != 2 ) {
+				log_string("Ignoring quantization of " + layer_name, log_level, LOG_LEVEL::WARN);
+				continue;
+			}
+			net->set_quantization( quantizable[layer_name], in_scale, per_channel != 0 );
+		}
+		return net;
 	}
 
 	//Sets the weights of a input Net to the ones stored in the onnx net inside the pointer
@@ -2020,6 +2243,12 @@ using namespace std;
 
 		return tensors;
 	}
+
+	void convert_onnx_to_mmap(std::string path, std::string dst, int mem){
+		Net *net = import_net_from_onnx_file(path, mem, LOG_LEVEL::NO_LOGS);
+		net->save_mmap(dst);
+		delete net;
+	}
 #else
 
 	Net* import_net_from_onnx_file(std::string path){
@@ -2037,5 +2266,8 @@ using namespace std;
 		return nullptr;
 	}
 
-#endif //cPROTO
+	void convert_onnx_to_mmap(std::string path, std::string dst, int mem){
+		cerr << "Not compiled for ONNX. Missing protobuf" << endl;
+	}
 
+#endif //cPROTO
@@ -49,6 +49,8 @@ namespace tensorNN {
 
 // ReLU
     void ReLu(Tensor *A, Tensor *B) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ ReLu(cs[0], cs[1]); })) return;
+
         if (A->device != B->device) msg("Tensors in different devices", "Tensor::ReLu");
         if (!Tensor::sameShape(A, B)) msg("Incompatible dims", "Tensor::ReLu");
 
@@ -77,6 +79,8 @@ namespace tensorNN {
 
 // RELU Derivative, always increment over parent delta
     void D_ReLu(Tensor *D, Tensor *I, Tensor *PD) {
+        if (runContiguous({D, I, PD}, 1, [&](const vector<Tensor*> &cs){ D_ReLu(cs[0], cs[1], cs[2]); })) return;
+
         if ((D->device != I->device) || (D->device != PD->device)) {
             msg("Tensors in different devices", "Tensor::D_ReLu");
         }
@@ -107,6 +111,8 @@ namespace tensorNN {
 
 // ThresholdedReLu
     void ThresholdedReLu(Tensor *A, Tensor *B, float param) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ ThresholdedReLu(cs[0], cs[1], param); })) return;
+
         if (A->device != B->device) msg("Tensors in different devices", "Tensor::ThresholdedReLu");
         if (!Tensor::sameShape(A, B)) msg("Incompatible dims", "Tensor::ThresholdedReLu");
 
@@ -135,6 +141,8 @@ namespace tensorNN {
 
 // ThresholdedReLu Derivative
     void D_ThresholdedReLu(Tensor *D, Tensor *I, Tensor *PD, float param) {
+        if (runContiguous({D, I, PD}, 1, [&](const vector<Tensor*> &cs){ D_ThresholdedReLu(cs[0], cs[1], cs[2], param); })) return;
+
         if ((D->device != I->device) || (D->device != PD->device))
             msg("Tensors in different devices", "Tensor::D_ThresholdedReLu");
         if ((!Tensor::sameShape(D, I)) || (!Tensor::sameShape(D, PD))) msg("Incompatible dims", "Tensor::D_ThresholdedReLu");
@@ -164,6 +172,8 @@ namespace tensorNN {
 
 // LeakyReLU
     void LeakyReLu(Tensor *A, Tensor *B, float param) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ LeakyReLu(cs[0], cs[1], param); })) return;
+
         if (A->device != B->device) msg("Tensors in different devices", "Tensor::LeakyReLu");
         if (!Tensor::sameShape(A, B)) msg("Incompatible dims", "Tensor::LeakyReLu");
 
@@ -192,6 +202,8 @@ namespace tensorNN {
 
 // RELU Derivative, always increment over parent delta
     void D_LeakyReLu(Tensor *D, Tensor *I, Tensor *PD, float param) {
+        if (runContiguous({D, I, PD}, 1, [&](const vector<Tensor*> &cs){ D_LeakyReLu(cs[0], cs[1], cs[2], param); })) return;
+
         if ((D->device != I->device) || (D->device != PD->device))
             msg("Tensors in different devices", "Tensor::D_ReLu");
         if ((!Tensor::sameShape(D, I)) || (!Tensor::sameShape(D, PD))) msg("Incompatible dims", "Tensor::D_ReLu");
@@ -222,6 +234,8 @@ namespace tensorNN {
 
 // ELU
     void ELu(Tensor *A, Tensor *B, float param) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ ELu(cs[0], cs[1], param); })) return;
+
         if (A->device != B->device) msg("Tensors in different devices", "Tensor::ELu");
         if (!Tensor::sameShape(A, B)) msg("Incompatible dims", "Tensor::ELu");
 
@@ -250,6 +264,8 @@ namespace tensorNN {
 
 // ELU Derivative
     void D_ELu(Tensor *D, Tensor *I, Tensor *PD, float param) {
+        if (runContiguous({D, I, PD}, 1, [&](const vector<Tensor*> &cs){ D_ELu(cs[0], cs[1], cs[2], param); })) return;
+
         if ((D->device != I->device) || (D->device != PD->device)) msg("Tensors in different devices", "Tensor::D_ELu");
         if ((!Tensor::sameShape(D, I)) || (!Tensor::sameShape(D, PD))) msg("Incompatible dims", "Tensor::D_ELu");
 
@@ -279,6 +295,8 @@ namespace tensorNN {
 
 // Softplus
     void Softplus(Tensor *A, Tensor *B) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Softplus(cs[0], cs[1]); })) return;
+
         if (A->device != B->device) msg("Tensors in different devices", "Tensor::Softplus");
         if (!Tensor::sameShape(A, B)) msg("Incompatible dims", "Tensor::Softplus");
 
@@ -307,6 +325,8 @@ namespace tensorNN {
 
 // Softplus Derivative
     void D_softplus(Tensor *D, Tensor *I, Tensor *PD) {
+        if (runContiguous({D, I, PD}, 1, [&](const vector<Tensor*> &cs){ D_softplus(cs[0], cs[1], cs[2]); })) return;
+
         if ((D->device != I->device) || (D->device != PD->device))
             msg("Tensors in different devices", "Tensor::D_softplus");
         if ((!Tensor::sameShape(D, I)) || (!Tensor::sameShape(D, PD))) msg("Incompatible dims", "Tensor::D_softplus");
@@ -337,6 +357,8 @@ namespace tensorNN {
 
 // Softsign
     void Softsign(Tensor *A, Tensor *B) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Softsign(cs[0], cs[1]); })) return;
+
         if (A->device != B->device) msg("Tensors in different devices", "Tensor::Softsign");
         if (!Tensor::sameShape(A, B)) msg("Incompatible dims", "Tensor::Softsign");
 
@@ -365,6 +387,8 @@ namespace tensorNN {
 
 // Softsign Derivative
     void D_softsign(Tensor *D, Tensor *I, Tensor *PD) {
+        if (runContiguous({D, I, PD}, 1, [&](const vector<Tensor*> &cs){ D_softsign(cs[0], cs[1], cs[2]); })) return;
+
         if ((D->device != I->device) || (D->device != PD->device))
             msg("Tensors in different devices", "Tensor::D_softsign");
         if ((!Tensor::sameShape(D, I)) || (!Tensor::sameShape(D, PD))) msg("Incompatible dims", "Tensor::D_softsign");
@@ -394,6 +418,8 @@ namespace tensorNN {
 
 // Linear
     void Linear(Tensor *A, Tensor *B, float param) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Linear(cs[0], cs[1], param); })) return;
+
         if (A->device != B->device) msg("Tensors in different devices", "Tensor::Linear");
         if (!Tensor::sameShape(A, B)) msg("Incompatible dims", "Tensor::Linear");
 
@@ -422,6 +448,8 @@ namespace tensorNN {
 
 // Linear Derivative
     void D_Linear(Tensor *D, Tensor *I, Tensor *PD, float param) {
+        if (runContiguous({D, I, PD}, 1, [&](const vector<Tensor*> &cs){ D_Linear(cs[0], cs[1], cs[2], param); })) return;
+
         if ((D->device != I->device) || (D->device != PD->device))
             msg("Tensors in different devices", "Tensor::D_Linear");
         if ((!Tensor::sameShape(D, I)) || (!Tensor::sameShape(D, PD))) msg("Incompatible dims", "Tensor::D_Linear");
@@ -452,6 +480,8 @@ namespace tensorNN {
 
 // Sigmoid
     void Sigmoid(Tensor *A, Tensor *B) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Sigmoid(cs[0], cs[1]); })) return;
+
         if (A->device != B->device) msg("Tensors in different devices", "Tensor::Sigmoid");
         if (!Tensor::sameShape(A, B)) msg("Incompatible dims", "Tensor::Sigmoid");
 
@@ -480,6 +510,8 @@ namespace tensorNN {
 
 // Sigmoid Derivative, always increment over parent delta
     void D_Sigmoid(Tensor *D, Tensor *I, Tensor *PD) {
+        if (runContiguous({D, I, PD}, 1, [&](const vector<Tensor*> &cs){ D_Sigmoid(cs[0], cs[1], cs[2]); })) return;
+
         if ((D->device != I->device) || (D->device != PD->device))
             msg("Tensors in different devices", "Tensor::D_Sigmoid");
         if ((!Tensor::sameShape(D, I)) || (!Tensor::sameShape(D, PD))) msg("Incompatible dims", "Tensor::D_Sigmoid");
@@ -509,6 +541,8 @@ namespace tensorNN {
 
 // Hard Sigmoid
     void HardSigmoid(Tensor *A, Tensor *B) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ HardSigmoid(cs[0], cs[1]); })) return;
+
         if (A->device != B->device) msg("Tensors in different devices", "Tensor::HardSigmoid");
         if (!Tensor::sameShape(A, B)) msg("Incompatible dims", "Tensor::HardSigmoid");
 
@@ -537,6 +571,8 @@ namespace tensorNN {
 
 // Hard Sigmoid Derivative
     void D_HardSigmoid(Tensor *D, Tensor *I, Tensor *PD) {
+        if (runContiguous({D, I, PD}, 1, [&](const vector<Tensor*> &cs){ D_HardSigmoid(cs[0], cs[1], cs[2]); })) return;
+
         if ((D->device != I->device) || (D->device != PD->device))
             msg("Tensors in different devices", "Tensor::D_HardSigmoid");
         if ((!Tensor::sameShape(D, I)) || (!Tensor::sameShape(D, PD))) msg("Incompatible dims", "Tensor::D_HardSigmoid");
@@ -566,6 +602,8 @@ namespace tensorNN {
 
 // Exponential
     void Exp(Tensor *A, Tensor *B) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Exp(cs[0], cs[1]); })) return;
+
         if (A->device != B->device) msg("Tensors in different devices", "Tensor::Exp");
         if (!Tensor::sameShape(A, B)) msg("Incompatible dims", "Tensor::Exp");
 
@@ -595,6 +633,8 @@ namespace tensorNN {
 
 // Exponential Derivative
     void D_Exp(Tensor *D, Tensor *I, Tensor *PD) {
+        if (runContiguous({D, I, PD}, 1, [&](const vector<Tensor*> &cs){ D_Exp(cs[0], cs[1], cs[2]); })) return;
+
         if ((D->device != I->device) || (D->device != PD->device)) msg("Tensors in different devices", "Tensor::D_Exp");
         if ((!Tensor::sameShape(D, I)) || (!Tensor::sameShape(D, PD))) msg("Incompatible dims", "Tensor::D_Exp");
 
@@ -622,6 +662,8 @@ namespace tensorNN {
 
 // Tanh
     void Tanh(Tensor *A, Tensor *B) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tanh(cs[0], cs[1]); })) return;
+
         if (A->device != B->device) msg("Tensors in different devices", "Tensor::Tanh");
         if (!Tensor::sameShape(A, B)) msg("Incompatible dims", "Tensor::Tanh");
 
@@ -650,6 +692,8 @@ namespace tensorNN {
 
 // Tanh Derivative
     void D_Tanh(Tensor *D, Tensor *I, Tensor *PD) {
+        if (runContiguous({D, I, PD}, 1, [&](const vector<Tensor*> &cs){ D_Tanh(cs[0], cs[1], cs[2]); })) return;
+
         if ((D->device != I->device) || (D->device != PD->device))
             msg("Tensors in different devices", "Tensor::D_Tanh");
         if ((!Tensor::sameShape(D, I)) || (!Tensor::sameShape(D, PD))) msg("Incompatible dims", "Tensor::D_Tanh");
@@ -680,6 +724,8 @@ namespace tensorNN {
 
 // SOFTMAX
     void Softmax(Tensor *A, Tensor *B) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Softmax(cs[0], cs[1]); })) return;
+
         if (A->device != B->device) msg("Tensors in different devices", "Tensor::Softmax");
         if (!Tensor::sameShape(A, B)) msg("Incompatible dims", "Tensor::Softmax");
         if (A->ndim != 2) msg("Softmax only over 2D Tensor (batch x logits)", "Tensor::Softmax");
@@ -710,6 +756,8 @@ namespace tensorNN {
 
 // SOFTMAX DERIVATIVE
     void D_Softmax(Tensor *D, Tensor *I, Tensor *PD) {
+        if (runContiguous({D, I, PD}, 1, [&](const vector<Tensor*> &cs){ D_Softmax(cs[0], cs[1], cs[2]); })) return;
+
         if ((D->device != I->device) || (D->device != PD->device))
             msg("Tensors in different devices", "Tensor::D_Softmax");
         if ((!Tensor::sameShape(D, I)) || (!Tensor::sameShape(D, PD))) msg("Incompatible dims", "Tensor::D_Softmax");
@@ -749,6 +797,8 @@ namespace tensorNN {
 
     // FULL SOFTMAX
     void FullSoftmax(Tensor *A, Tensor *B) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ FullSoftmax(cs[0], cs[1]); })) return;
+
         if (!Tensor::sameDevice(A, B)) msg("Tensors in different devices", "Tensor::FullSoftmax");
         if (!Tensor::sameShape(A, B)) msg("Incompatible dims", "Tensor::FullSoftmax");
 
@@ -774,6 +824,8 @@ namespace tensorNN {
 
     // FULL SOFTMAX DERIVATIVE
     void D_FullSoftmax(Tensor *D, Tensor *I, Tensor *PD) {
+        if (runContiguous({D, I, PD}, 1, [&](const vector<Tensor*> &cs){ D_FullSoftmax(cs[0], cs[1], cs[2]); })) return;
+
         if (!Tensor::sameDevice(D, I) || !Tensor::sameDevice(D, PD))
             msg("Tensors in different devices", "Tensor::D_FullSoftmax");
         if ((!Tensor::sameShape(D, I)) || (!Tensor::sameShape(D, PD))) msg("Incompatible dims", "Tensor::D_FullSoftmax");
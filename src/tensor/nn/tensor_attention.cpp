@@ -0,0 +1,66 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+#include "eddl/tensor/nn/tensor_nn.h"
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+#include "eddl/profiling.h"
+
+PROFILING_ENABLE_EXTERN(MultiHeadAttention);
+PROFILING_ENABLE_EXTERN(D_MultiHeadAttention);
+
+namespace tensorNN {
+
+    static void check_attention(Tensor *Q, Tensor *K, Tensor *V, Tensor *O, Tensor *L, int heads, bool causal, const string &title) {
+        if ((K->device != Q->device) || (V->device != Q->device) || (O->device != Q->device) || (L->device != Q->device))
+            msg("Tensors in different devices", title);
+        if ((Q->ndim != 3) || (K->ndim != 3) || (V->ndim != 3) || (O->ndim != 3)) msg("Tensors are not 3D", title);
+        if ((heads < 1) || (Q->shape[2] % heads != 0) || (V->shape[2] % heads != 0))
+            msg("The dims are not divisible by the number of heads", title);
+        if ((K->shape[0] != Q->shape[0]) || (V->shape[0] != Q->shape[0]) || (K->shape[2] != Q->shape[2]) || (V->shape[1] != K->shape[1]))
+            msg("Incompatible dims", title);
+        if ((O->shape[0] != Q->shape[0]) || (O->shape[1] != Q->shape[1]) || (O->shape[2] != V->shape[2]))
+            msg("Incompatible dims", title);
+        if (L->size != Q->shape[0] * heads * Q->shape[1]) msg("Incompatible dims", title);
+        if (causal && (K->shape[1] < Q->shape[1])) msg("Causal attention needs at least as many keys as queries", title);
+        for (auto t : {Q, K, V, O, L}) checkContiguous(t, title);
+    }
+
+    void MultiHeadAttention(Tensor *Q, Tensor *K, Tensor *V, Tensor *O, Tensor *L, int heads, bool causal) {
+        check_attention(Q, K, V, O, L, heads, causal, "Tensor::MultiHeadAttention");
+
+        PROFILING_HEADER(MultiHeadAttention);
+
+        if (Q->isCPU()) {
+            cpu_attention(Q, K, V, O, L, heads, causal);
+        }
+        else {
+            msg("Fused attention is only available on CPU", "Tensor::MultiHeadAttention");
+        }
+
+        PROFILING_FOOTER(MultiHeadAttention);
+    }
+
+    void D_MultiHeadAttention(Tensor *Q, Tensor *K, Tensor *V, Tensor *O, Tensor *L, Tensor *dO, Tensor *dQ, Tensor *dK, Tensor *dV, int heads, bool causal) {
+        check_attention(Q, K, V, O, L, heads, causal, "Tensor::D_MultiHeadAttention");
+        if (!Tensor::sameShape(O, dO) || !Tensor::sameShape(Q, dQ) || !Tensor::sameShape(K, dK) || !Tensor::sameShape(V, dV))
+            msg("Incompatible dims", "Tensor::D_MultiHeadAttention");
+        for (auto t : {dO, dQ, dK, dV}) checkContiguous(t, "Tensor::D_MultiHeadAttention");
+
+        PROFILING_HEADER(D_MultiHeadAttention);
+
+        if (Q->isCPU()) {
+            cpu_d_attention(Q, K, V, O, L, dO, dQ, dK, dV, heads, causal);
+        }
+        else {
+            msg("Fused attention is only available on CPU", "Tensor::D_MultiHeadAttention");
+        }
+
+        PROFILING_FOOTER(D_MultiHeadAttention);
+    }
+
+}
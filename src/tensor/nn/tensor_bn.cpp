@@ -30,6 +30,7 @@ namespace tensorNN {
 
 
     void permute_channels_last(Tensor *A, Tensor *B) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ permute_channels_last(cs[0], cs[1]); })) return;
 
         PROFILING_HEADER(permute_channels_last);
 
@@ -51,6 +52,7 @@ namespace tensorNN {
         }
 
     void permute_channels_first(Tensor *A, Tensor *B) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ permute_channels_first(cs[0], cs[1]); })) return;
 
         PROFILING_HEADER(permute_channels_first);
 
@@ -73,6 +75,7 @@ namespace tensorNN {
 
 
     void permute_batch_last(Tensor *A, Tensor *B) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ permute_batch_last(cs[0], cs[1]); })) return;
 
         PROFILING_HEADER(permute_batch_last);
 
@@ -94,6 +97,7 @@ namespace tensorNN {
     }
 
     void permute_batch_first(Tensor *A, Tensor *B) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ permute_batch_first(cs[0], cs[1]); })) return;
 
         PROFILING_HEADER(permute_batch_first);
 
@@ -27,6 +27,12 @@ PROFILING_ENABLE_EXTERN(Conv2D_back);
 
 namespace tensorNN{
 
+// The CPU kernels take strided samples (e.g. the slices of a concat), the rest need contiguous tensors
+static void checkConvTensor(Tensor *A, const string &title) {
+    if (A->isCPU()) checkSamplesContiguous(A, title);
+    else checkContiguous(A, title);
+}
+
 void Conv2D(ConvolDescriptor *D) {
     /////////////////////////////////////////////////////////////////////
     //// Conv2D
@@ -34,8 +40,13 @@ void Conv2D(ConvolDescriptor *D) {
     //// A is input 4D Tensor, Batch x Channels x Rows x Cols
     //// D is a ConvolDescriptor
     /////////////////////////////////////////////////////////////////////
+    checkConvTensor(D->I, "Tensor::Conv2D");
+    checkConvTensor(D->O, "Tensor::Conv2D");
+
     if ((D->I->ndim != 4)) msg("Tensors are not 4D", "Tensor::Conv2D");
 
+    if ((D->groups > 1 || D->dr > 1 || D->dc > 1) && !D->I->isCPU()) msg("Grouped and dilated convolutions are only available on CPU", "Tensor::Conv2D");
+
     PROFILING_HEADER(Conv2D);
 
 
@@ -66,8 +77,13 @@ void Conv2D_grad(ConvolDescriptor *D) {
     //// A is input 4D Tensor, Batch x Channels x Rows x Cols
     //// D is a ConvolDescriptor
     /////////////////////////////////////////////////////////////////////
+    checkConvTensor(D->I, "Tensor::Conv2D_grad");
+    checkConvTensor(D->D, "Tensor::Conv2D_grad");
+
     if ((D->I->ndim != 4)) msg("Tensors are not 4D", "Tensor::Conv2D");
 
+    if ((D->groups > 1 || D->dr > 1 || D->dc > 1) && !D->I->isCPU()) msg("Grouped and dilated convolutions are only available on CPU", "Tensor::Conv2D_grad");
+
     PROFILING_HEADER(Conv2D_grad);
 
 
@@ -97,8 +113,13 @@ void Conv2D_back(ConvolDescriptor *D) {
     //// A is input 4D Tensor, Batch x Channels x Rows x Cols
     //// D is a ConvolDescriptor
     /////////////////////////////////////////////////////////////////////
+    checkConvTensor(D->D, "Tensor::Conv2D_back");
+    checkConvTensor(D->ID, "Tensor::Conv2D_back");
+
     if ((D->I->ndim != 4)) msg("Tensors are not 4D", "Tensor::Conv2D");
 
+    if ((D->groups > 1 || D->dr > 1 || D->dc > 1) && !D->I->isCPU()) msg("Grouped and dilated convolutions are only available on CPU", "Tensor::Conv2D_back");
+
     PROFILING_HEADER(Conv2D_back);
 
 
@@ -121,4 +142,43 @@ void Conv2D_back(ConvolDescriptor *D) {
     PROFILING_FOOTER(Conv2D_back);
 }
 
+void Conv2D_bias(Tensor *O, Tensor *bias) {
+    if (runContiguous({bias, O}, 1, [&](const vector<Tensor*> &cs){ Conv2D_bias(cs[1], cs[0]); })) return;
+
+    // Adds bias[z] to every plane of channel z of a 4D tensor
+    if ((O->ndim != 4) || (bias->size != O->shape[1])) msg("Incompatible dims", "Tensor::Conv2D_bias");
+
+    if (O->isCPU()) {
+        cpu_conv2D_bias(O, bias);
+    }
+    else {
+        // One (channels x rows*cols) matrix per sample
+        int csize = O->shape[2] * O->shape[3];
+        for (int b = 0; b < O->shape[0]; b++) {
+            Tensor *ob = new Tensor({O->shape[1], csize}, O->ptr + (size_t)b * O->shape[1] * csize, O->device);
+            Tensor::sum2D_colwise(ob, bias, ob);
+            delete ob;
+        }
+    }
+}
+
+void Conv2D_gbias(Tensor *D, Tensor *gbias) {
+    if (runContiguous({D, gbias}, 1, [&](const vector<Tensor*> &cs){ Conv2D_gbias(cs[0], cs[1]); })) return;
+
+    // Accumulates the sum of every channel of a 4D delta in gbias
+    if ((D->ndim != 4) || (gbias->size != D->shape[1])) msg("Incompatible dims", "Tensor::Conv2D_gbias");
+
+    if (D->isCPU()) {
+        cpu_conv2D_gbias(D, gbias);
+    }
+    else {
+        int csize = D->shape[2] * D->shape[3];
+        for (int b = 0; b < D->shape[0]; b++) {
+            Tensor *db = new Tensor({D->shape[1], csize}, D->ptr + (size_t)b * D->shape[1] * csize, D->device);
+            Tensor::reduce_sum2D(db, gbias, 1, 1);
+            delete db;
+        }
+    }
+}
+
 }
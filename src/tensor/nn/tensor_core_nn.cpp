@@ -28,6 +28,8 @@ extern int next_fpga_tensor_id;
 
 PROFILING_ENABLE_EXTERN(repeat_nn);
 PROFILING_ENABLE_EXTERN(d_repeat_nn);
+PROFILING_ENABLE_EXTERN(upsampling);
+PROFILING_ENABLE_EXTERN(d_upsampling);
 PROFILING_ENABLE_EXTERN(select);
 PROFILING_ENABLE_EXTERN(select_back);
 PROFILING_ENABLE_EXTERN(set_select);
@@ -37,6 +39,8 @@ namespace tensorNN {
 
 
     void repeat_nn(Tensor *A, Tensor *B, vector<int> size) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ repeat_nn(cs[0], cs[1], size); })) return;
+
         // TODO: Should be for N dimensions, not 2 (...and generic, not just NN)
 
         if ((A->device != B->device)) msg("Tensors in different devices", "Tensor::Repeat_NN");
@@ -69,6 +73,8 @@ namespace tensorNN {
     }
 
     void d_repeat_nn(Tensor *D, Tensor *A, vector<int> size) {
+        if (runContiguous({D, A}, 1, [&](const vector<Tensor*> &cs){ d_repeat_nn(cs[0], cs[1], size); })) return;
+
         // TODO: Should be for N dimensions, not 2 (...and generic, not just NN)
         if ((D->device != A->device)) msg("Tensors in different devices", "Tensor::D_Repeat_NN");
 
@@ -91,8 +97,66 @@ namespace tensorNN {
         PROFILING_FOOTER(d_repeat_nn);
     }
 
+    void upsampling(Tensor *A, Tensor *B, UpSamplingDescriptor *D) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ upsampling(cs[0], cs[1], D); })) return;
+
+        if ((A->device != B->device)) msg("Tensors in different devices", "Tensor::UpSampling");
+        if ((A->ndim != D->ishape.size()) || (B->ndim != D->oshape.size()) || (A->shape[0] != B->shape[0])) msg("Incompatible dims", "Tensor::UpSampling");
+        for (int i = 1; i < A->ndim; i++)
+            if ((A->shape[i] != D->ishape[i]) || (B->shape[i] != D->oshape[i])) msg("Incompatible shapes", "Tensor::UpSampling");
+
+        PROFILING_HEADER(upsampling);
+
+        if (A->isCPU() && B->isCPU()) {
+            cpu_upsampling(A, B, D);
+        }
+#ifdef cGPU
+        else if (A->isGPU() && B->isGPU()) {
+            // Only nearest 2D upsampling is implemented on GPU
+            if (D->bilinear || D->align_corners || (A->ndim != 4)) msg("Only nearest 2D upsampling is available on GPU", "Tensor::UpSampling");
+            gpu_repeat_nn(A, B, D->size);
+        }
+#endif
+#ifdef cFPGA
+        else {
+            printf("upsampling not supported yet on FPGA\n");
+            exit(1);
+        }
+#endif
+        PROFILING_FOOTER(upsampling);
+    }
+
+    void d_upsampling(Tensor *D, Tensor *A, UpSamplingDescriptor *ud) {
+        if (runContiguous({D, A}, 1, [&](const vector<Tensor*> &cs){ d_upsampling(cs[0], cs[1], ud); })) return;
+
+        if ((D->device != A->device)) msg("Tensors in different devices", "Tensor::D_UpSampling");
+        if ((A->ndim != ud->ishape.size()) || (D->ndim != ud->oshape.size()) || (A->shape[0] != D->shape[0])) msg("Incompatible dims", "Tensor::D_UpSampling");
+        for (int i = 1; i < A->ndim; i++)
+            if ((A->shape[i] != ud->ishape[i]) || (D->shape[i] != ud->oshape[i])) msg("Incompatible shapes", "Tensor::D_UpSampling");
+
+        PROFILING_HEADER(d_upsampling);
+
+        if (D->isCPU() && A->isCPU()) {
+            cpu_d_upsampling(D, A, ud);
+        }
+#ifdef cGPU
+        else if (D->isGPU() && A->isGPU()) {
+            if (ud->bilinear || ud->align_corners || (A->ndim != 4)) msg("Only nearest 2D upsampling is available on GPU", "Tensor::D_UpSampling");
+            gpu_d_repeat_nn(D, A, ud->size);
+        }
+#endif
+#ifdef cFPGA
+        else {
+            printf("d_upsampling not implemented in FPGA yet\n");
+            exit(1);
+        }
+#endif
+        PROFILING_FOOTER(d_upsampling);
+    }
+
 
     void select(Tensor *A, Tensor* B, SelDescriptor *sd){
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ select(cs[0], cs[1], sd); })) return;
 
         PROFILING_HEADER(select);
 
@@ -115,6 +179,7 @@ namespace tensorNN {
     }
 
     void select_back(Tensor *A, Tensor* B, SelDescriptor *sd){
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ select_back(cs[0], cs[1], sd); })) return;
 
         PROFILING_HEADER(select_back);
 
@@ -137,6 +202,7 @@ namespace tensorNN {
     }
 
     void set_select(Tensor *A, Tensor *B, SelDescriptor *sd){
+        if (runContiguous({B, A}, 1, [&](const vector<Tensor*> &cs){ set_select(cs[1], cs[0], sd); })) return;
 
         PROFILING_HEADER(set_select);
 
@@ -160,6 +226,7 @@ namespace tensorNN {
 
 
     void set_select_back(Tensor *A, Tensor* B, SelDescriptor *sd){
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ set_select_back(cs[0], cs[1], sd); })) return;
 
         PROFILING_HEADER(set_select_back);
 
@@ -0,0 +1,54 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+#include "eddl/tensor/nn/tensor_nn.h"
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+#include "eddl/profiling.h"
+
+PROFILING_ENABLE_EXTERN(Dropout);
+PROFILING_ENABLE_EXTERN(D_Dropout);
+
+namespace tensorNN {
+
+    void Dropout(Tensor *A, Tensor *B, float keep, float scale, uint64_t seed) {
+        if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Dropout(cs[0], cs[1], keep, scale, seed); })) return;
+
+        if (A->device != B->device) msg("Tensors in different devices", "Tensor::Dropout");
+        if (!Tensor::sameSize(A, B)) msg("Incompatible sizes", "Tensor::Dropout");
+
+        PROFILING_HEADER(Dropout);
+
+        if (A->isCPU()) {
+            cpu_dropout(A, B, keep, scale, seed);
+        }
+        else {
+            msg("Seeded dropout is only available on CPU", "Tensor::Dropout");
+        }
+
+        PROFILING_FOOTER(Dropout);
+    }
+
+    void D_Dropout(Tensor *D, Tensor *PD, float keep, float scale, uint64_t seed) {
+        if (runContiguous({D, PD}, 1, [&](const vector<Tensor*> &cs){ D_Dropout(cs[0], cs[1], keep, scale, seed); })) return;
+
+        if (D->device != PD->device) msg("Tensors in different devices", "Tensor::D_Dropout");
+        if (!Tensor::sameSize(D, PD)) msg("Incompatible sizes", "Tensor::D_Dropout");
+
+        PROFILING_HEADER(D_Dropout);
+
+        if (D->isCPU()) {
+            cpu_d_dropout(D, PD, keep, scale, seed);
+        }
+        else {
+            msg("Seeded dropout is only available on CPU", "Tensor::D_Dropout");
+        }
+
+        PROFILING_FOOTER(D_Dropout);
+    }
+
+}
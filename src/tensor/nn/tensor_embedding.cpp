@@ -0,0 +1,154 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+#include "eddl/tensor/nn/tensor_nn.h"
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+#include "eddl/profiling.h"
+
+PROFILING_ENABLE_EXTERN(Embedding);
+PROFILING_ENABLE_EXTERN(Embedding_back);
+PROFILING_ENABLE_EXTERN(ZeroRows);
+PROFILING_ENABLE_EXTERN(ClampRows);
+PROFILING_ENABLE_EXTERN(SGD_rows);
+PROFILING_ENABLE_EXTERN(Adam_rows);
+PROFILING_ENABLE_EXTERN(RMSProp_rows);
+
+namespace tensorNN {
+
+    int Embedding(Tensor *E, Tensor *I, Tensor *O, vector<int> &ind, bool mask_zeros) {
+        checkContiguous(E, "Tensor::Embedding");
+        checkContiguous(I, "Tensor::Embedding");
+        checkContiguous(O, "Tensor::Embedding");
+
+        if ((E->device != I->device) || (E->device != O->device)) msg("Tensors in different devices", "Tensor::Embedding");
+        if (E->ndim != 2) msg("Embedding matrix must be 2D", "Tensor::Embedding");
+        if (O->size != I->size * E->shape[1]) msg("Incompatible output size", "Tensor::Embedding");
+
+        PROFILING_HEADER(Embedding);
+
+        int oov = 0;
+        if (E->isCPU()) {
+            ind.resize(I->size);
+            oov = cpu_embedding(E, I, O, ind.data(), mask_zeros);
+        }
+        else {
+            msg("Sparse embeddings are only available on CPU", "Tensor::Embedding");
+        }
+
+        PROFILING_FOOTER(Embedding);
+        return oov;
+    }
+
+    void Embedding_back(Tensor *D, Tensor *gE, vector<int> &ind, bool mask_zeros, vector<int> &rows) {
+        checkContiguous(D, "Tensor::Embedding_back");
+        checkContiguous(gE, "Tensor::Embedding_back");
+
+        if (D->device != gE->device) msg("Tensors in different devices", "Tensor::Embedding_back");
+        if (D->size != ind.size() * gE->shape[1]) msg("Incompatible delta size", "Tensor::Embedding_back");
+
+        PROFILING_HEADER(Embedding_back);
+
+        if (D->isCPU()) {
+            cpu_embedding_back(D, gE, ind.data(), ind.size(), mask_zeros, rows);
+        }
+        else {
+            msg("Sparse embeddings are only available on CPU", "Tensor::Embedding_back");
+        }
+
+        PROFILING_FOOTER(Embedding_back);
+    }
+
+    void ZeroRows(Tensor *A, vector<int> &rows) {
+        checkContiguous(A, "Tensor::ZeroRows");
+
+        PROFILING_HEADER(ZeroRows);
+
+        if (A->isCPU()) {
+            cpu_zero_rows(A, rows);
+        }
+        else {
+            msg("Row-sparse updates are only available on CPU", "Tensor::ZeroRows");
+        }
+
+        PROFILING_FOOTER(ZeroRows);
+    }
+
+    void ClampRows(Tensor *A, vector<int> &rows, float min, float max) {
+        checkContiguous(A, "Tensor::ClampRows");
+
+        PROFILING_HEADER(ClampRows);
+
+        if (A->isCPU()) {
+            cpu_clamp_rows(A, rows, min, max);
+        }
+        else {
+            msg("Row-sparse updates are only available on CPU", "Tensor::ClampRows");
+        }
+
+        PROFILING_FOOTER(ClampRows);
+    }
+
+    void SGD_rows(Tensor *P, Tensor *G, Tensor *M, vector<int> &rows, float lr, float mu) {
+        checkContiguous(P, "Tensor::SGD_rows");
+        checkContiguous(G, "Tensor::SGD_rows");
+        checkContiguous(M, "Tensor::SGD_rows");
+
+        if (!Tensor::sameShape(P, G) || !Tensor::sameShape(P, M)) msg("Incompatible shapes", "Tensor::SGD_rows");
+
+        PROFILING_HEADER(SGD_rows);
+
+        if (P->isCPU()) {
+            cpu_sgd_rows(P, G, M, rows, lr, mu);
+        }
+        else {
+            msg("Row-sparse updates are only available on CPU", "Tensor::SGD_rows");
+        }
+
+        PROFILING_FOOTER(SGD_rows);
+    }
+
+    void Adam_rows(Tensor *P, Tensor *G, Tensor *M, Tensor *V, vector<int> &rows, float lr, float beta_1, float beta_2, float epsilon, int t) {
+        checkContiguous(P, "Tensor::Adam_rows");
+        checkContiguous(G, "Tensor::Adam_rows");
+        checkContiguous(M, "Tensor::Adam_rows");
+        checkContiguous(V, "Tensor::Adam_rows");
+
+        if (!Tensor::sameShape(P, G) || !Tensor::sameShape(P, M) || !Tensor::sameShape(P, V)) msg("Incompatible shapes", "Tensor::Adam_rows");
+
+        PROFILING_HEADER(Adam_rows);
+
+        if (P->isCPU()) {
+            cpu_adam_rows(P, G, M, V, rows, lr, beta_1, beta_2, epsilon, t);
+        }
+        else {
+            msg("Row-sparse updates are only available on CPU", "Tensor::Adam_rows");
+        }
+
+        PROFILING_FOOTER(Adam_rows);
+    }
+
+    void RMSProp_rows(Tensor *P, Tensor *G, Tensor *G1, vector<int> &rows, float lr, float rho, float epsilon) {
+        checkContiguous(P, "Tensor::RMSProp_rows");
+        checkContiguous(G, "Tensor::RMSProp_rows");
+        checkContiguous(G1, "Tensor::RMSProp_rows");
+
+        if (!Tensor::sameShape(P, G) || !Tensor::sameShape(P, G1)) msg("Incompatible shapes", "Tensor::RMSProp_rows");
+
+        PROFILING_HEADER(RMSProp_rows);
+
+        if (P->isCPU()) {
+            cpu_rmsprop_rows(P, G, G1, rows, lr, rho, epsilon);
+        }
+        else {
+            msg("Row-sparse updates are only available on CPU", "Tensor::RMSProp_rows");
+        }
+
+        PROFILING_FOOTER(RMSProp_rows);
+    }
+
+}
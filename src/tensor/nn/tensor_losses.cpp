@@ -28,6 +28,8 @@ namespace tensorNN {
 
 // Cross-Entropy: C=-(A*log(B)+(1-A)*log_(1-B))
     void cent(Tensor *A, Tensor *B, Tensor *C) {
+        if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ cent(cs[0], cs[1], cs[2]); })) return;
+
         if (A->device != B->device) msg("Tensors in different devices", "Tensor::cross-entropy");
         if ((!Tensor::sameShape(A, B)) || (!Tensor::sameShape(A, C))) msg("Incompatible dims", "Tensor::cross-entropy");
 
@@ -56,6 +58,9 @@ namespace tensorNN {
 
 
     float categorical_cross_entropy(Tensor* y_true, Tensor* y_pred){
+        float r = 0.0f;
+        if (runContiguous({y_true, y_pred}, 0, [&](const vector<Tensor*> &cs){ r = categorical_cross_entropy(cs[0], cs[1]); })) return r;
+
         if (!Tensor::sameDevice(y_true, y_pred)) {
             msg("Tensors in different devices", "TensorNN::categorical_cross_entropy");
         }
@@ -80,6 +85,8 @@ namespace tensorNN {
     }
 
     void d_categorical_cross_entropy(Tensor* y_true, Tensor* y_pred, Tensor* delta){
+        if (runContiguous({y_true, y_pred, delta}, 1, [&](const vector<Tensor*> &cs){ d_categorical_cross_entropy(cs[0], cs[1], cs[2]); })) return;
+
         if (!Tensor::sameDevice(y_true, y_pred) || !Tensor::sameDevice(y_true, delta)) {
             msg("Tensors in different devices", "TensorNN::d_categorical_cross_entropy");
         }
@@ -104,6 +111,9 @@ namespace tensorNN {
     }
 
     float binary_cross_entropy(Tensor* y_true, Tensor* y_pred){
+        float r = 0.0f;
+        if (runContiguous({y_true, y_pred}, 0, [&](const vector<Tensor*> &cs){ r = binary_cross_entropy(cs[0], cs[1]); })) return r;
+
         if (!Tensor::sameDevice(y_true, y_pred)) {
             msg("Tensors in different devices", "TensorNN::binary_cross_entropy");
         }
@@ -128,6 +138,8 @@ namespace tensorNN {
     }
 
     void d_binary_cross_entropy(Tensor* y_true, Tensor* y_pred, Tensor* delta){
+        if (runContiguous({y_true, y_pred, delta}, 1, [&](const vector<Tensor*> &cs){ d_binary_cross_entropy(cs[0], cs[1], cs[2]); })) return;
+
         if (!Tensor::sameDevice(y_true, y_pred) || !Tensor::sameDevice(y_true, delta)) {
             msg("Tensors in different devices", "TensorNN::d_binary_cross_entropy");
         }
@@ -28,6 +28,9 @@ namespace tensorNN {
 
 
     int accuracy(Tensor *A, Tensor *B) {
+        int r = 0;
+        if (runContiguous({A, B}, 0, [&](const vector<Tensor*> &cs){ r = accuracy(cs[0], cs[1]); })) return r;
+
         if (A->device != B->device) msg("Tensors in different devices", "Tensor::accuracy");
         if (!Tensor::sameShape(A, B)) msg("Incompatible dims", "Tensor::accuracy");
         if (A->ndim != 2) msg("Accuracy only over 2D Tensor (batch x probs)", "Tensor::Accuracy");
@@ -60,6 +63,9 @@ namespace tensorNN {
     }
 
     int bin_accuracy(Tensor *A, Tensor *B) {
+        int r = 0;
+        if (runContiguous({A, B}, 0, [&](const vector<Tensor*> &cs){ r = bin_accuracy(cs[0], cs[1]); })) return r;
+
         if (A->device != B->device) msg("Tensors in different devices", "Tensor::accuracy");
         if (!Tensor::sameShape(A, B)) msg("Incompatible dims", "Tensor::accuracy");
         if (A->ndim != 2) msg("Accuracy only over 2D Tensor (batch x prob)", "Tensor::Bin_Accuracy");
@@ -36,6 +36,9 @@ namespace tensorNN {
         //// A is input 4D Tensor, Batch x Channels x Rows x Cols
         //// D is a PoolDescriptor
         /////////////////////////////////////////////////////////////////////
+        checkContiguous(D->I, "Tensor::MPool2D");
+        checkContiguous(D->O, "Tensor::MPool2D");
+
         if ((D->I->ndim != 4)) msg("Tensors are not 4D", "Tensor::MPool2D");
 
 	      PROFILING_HEADER(MPool2D);
@@ -68,6 +71,9 @@ namespace tensorNN {
         //// A is input 4D Tensor, Batch x Channels x Rows x Cols
         //// D is a PoolDescriptor
         /////////////////////////////////////////////////////////////////////
+        checkContiguous(D->D, "Tensor::MPool2D_back");
+        checkContiguous(D->ID, "Tensor::MPool2D_back");
+
         if ((D->I->ndim != 4)) msg("Tensors are not 4D", "Tensor::MPool2D_back");
 
         PROFILING_HEADER(MPool2D_back);
@@ -101,6 +107,9 @@ namespace tensorNN {
         //// A is input 4D Tensor, Batch x Channels x Rows x Cols
         //// D is a PoolDescriptor
         /////////////////////////////////////////////////////////////////////
+        checkContiguous(D->I, "Tensor::AvgPool2D");
+        checkContiguous(D->O, "Tensor::AvgPool2D");
+
         if ((D->I->ndim != 4)) msg("Tensors are not 4D", "Tensor::AvgPool2D");
 
         PROFILING_HEADER(AvgPool2D);
@@ -133,6 +142,9 @@ namespace tensorNN {
         //// A is input 4D Tensor, Batch x Channels x Rows x Cols
         //// D is a PoolDescriptor
         /////////////////////////////////////////////////////////////////////
+        checkContiguous(D->D, "Tensor::AvgPool2D_back");
+        checkContiguous(D->ID, "Tensor::AvgPool2D_back");
+
         if ((D->I->ndim != 4)) msg("Tensors are not 4D", "Tensor::AvgPool2D_back");
 
         PROFILING_HEADER(AvgPool2D_back);
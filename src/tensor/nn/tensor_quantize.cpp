@@ -0,0 +1,57 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+#include "eddl/tensor/nn/tensor_nn.h"
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+#include "eddl/profiling.h"
+
+PROFILING_ENABLE_EXTERN(QDense);
+PROFILING_ENABLE_EXTERN(QConv2D);
+
+namespace tensorNN {
+
+    void QDense(Tensor *A, Tensor *B, Tensor *bias, QuantDescriptor *qd) {
+        checkContiguous(A, "Tensor::QDense");
+        checkContiguous(B, "Tensor::QDense");
+
+        if (A->device != B->device) msg("Tensors in different devices", "Tensor::QDense");
+        if (A->ndim != 2 || B->ndim != 2) msg("Tensors are not 2D", "Tensor::QDense");
+        if (!qd->packed || A->shape[1] != qd->ins || B->shape[1] != qd->outs) msg("Weights not packed for these shapes", "Tensor::QDense");
+
+        PROFILING_HEADER(QDense);
+
+        if (A->isCPU()) {
+            cpu_qdense(A, B, bias, qd);
+        }
+        else {
+            msg("Quantized inference is only available on CPU", "Tensor::QDense");
+        }
+
+        PROFILING_FOOTER(QDense);
+    }
+
+    void QConv2D(ConvolDescriptor *D, QuantDescriptor *qd) {
+        checkSamplesContiguous(D->I, "Tensor::QConv2D");
+        checkSamplesContiguous(D->O, "Tensor::QConv2D");
+
+        if ((D->I->ndim != 4)) msg("Tensors are not 4D", "Tensor::QConv2D");
+        if (!qd->packed || qd->outs != D->nk || qd->ins != D->kz * D->kr * D->kc) msg("Weights not packed for this convolution", "Tensor::QConv2D");
+
+        PROFILING_HEADER(QConv2D);
+
+        if (D->I->isCPU()) {
+            cpu_qconv2D(D, qd);
+        }
+        else {
+            msg("Quantized inference is only available on CPU", "Tensor::QConv2D");
+        }
+
+        PROFILING_FOOTER(QConv2D);
+    }
+
+}
@@ -0,0 +1,105 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.8
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+#include "eddl/tensor/nn/tensor_nn.h"
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+#include "eddl/profiling.h"
+
+PROFILING_ENABLE_EXTERN(LSTMCell);
+PROFILING_ENABLE_EXTERN(D_LSTMCell);
+PROFILING_ENABLE_EXTERN(GRUCell);
+PROFILING_ENABLE_EXTERN(D_GRUCell);
+
+namespace tensorNN {
+
+    static void check_lstm_cell(Tensor *G, Tensor *Cprev, Tensor *C, Tensor *H, const string &title) {
+        if ((G->device != C->device) || (H->device != C->device)) msg("Tensors in different devices", title);
+        if ((C->ndim != 2) || (G->ndim != 2)) msg("Tensors are not 2D", title);
+        if (!Tensor::sameShape(C, H) || (G->shape[0] != C->shape[0]) || (G->shape[1] != 4 * C->shape[1]))
+            msg("Incompatible dims", title);
+        if ((Cprev != nullptr) && !Tensor::sameShape(C, Cprev)) msg("Incompatible dims", title);
+        for (auto t : {G, Cprev, C, H}) if (t != nullptr) checkContiguous(t, title);
+    }
+
+    void LSTMCell(Tensor *G, Tensor *Cprev, Tensor *C, Tensor *H) {
+        check_lstm_cell(G, Cprev, C, H, "Tensor::LSTMCell");
+
+        PROFILING_HEADER(LSTMCell);
+
+        if (C->isCPU()) {
+            cpu_lstm_cell(G, Cprev, C, H);
+        }
+        else {
+            msg("Fused LSTM cells are only available on CPU", "Tensor::LSTMCell");
+        }
+
+        PROFILING_FOOTER(LSTMCell);
+    }
+
+    void D_LSTMCell(Tensor *G, Tensor *Cprev, Tensor *C, Tensor *dH, Tensor *dC, Tensor *dG) {
+        check_lstm_cell(G, Cprev, C, dH, "Tensor::D_LSTMCell");
+        if (!Tensor::sameShape(G, dG) || !Tensor::sameShape(C, dC)) msg("Incompatible dims", "Tensor::D_LSTMCell");
+        checkContiguous(dC, "Tensor::D_LSTMCell");
+        checkContiguous(dG, "Tensor::D_LSTMCell");
+
+        PROFILING_HEADER(D_LSTMCell);
+
+        if (C->isCPU()) {
+            cpu_d_lstm_cell(G, Cprev, C, dH, dC, dG);
+        }
+        else {
+            msg("Fused LSTM cells are only available on CPU", "Tensor::D_LSTMCell");
+        }
+
+        PROFILING_FOOTER(D_LSTMCell);
+    }
+
+    static void check_gru_cell(Tensor *GX, Tensor *GH, Tensor *Hprev, Tensor *H, Tensor *mask, const string &title) {
+        if ((GX->device != H->device) || (GH->device != H->device)) msg("Tensors in different devices", title);
+        if ((H->ndim != 2) || (GX->ndim != 2)) msg("Tensors are not 2D", title);
+        if (!Tensor::sameShape(GX, GH) || (GX->shape[0] != H->shape[0]) || (GX->shape[1] != 3 * H->shape[1]))
+            msg("Incompatible dims", title);
+        if ((Hprev != nullptr) && !Tensor::sameShape(H, Hprev)) msg("Incompatible dims", title);
+        if ((mask != nullptr) && (mask->size != H->shape[0])) msg("Incompatible mask", title);
+        for (auto t : {GX, GH, Hprev, H, mask}) if (t != nullptr) checkContiguous(t, title);
+    }
+
+    void GRUCell(Tensor *GX, Tensor *GH, Tensor *Hprev, Tensor *H, Tensor *mask) {
+        check_gru_cell(GX, GH, Hprev, H, mask, "Tensor::GRUCell");
+
+        PROFILING_HEADER(GRUCell);
+
+        if (H->isCPU()) {
+            cpu_gru_cell(GX, GH, Hprev, H, mask);
+        }
+        else {
+            msg("Fused GRU cells are only available on CPU", "Tensor::GRUCell");
+        }
+
+        PROFILING_FOOTER(GRUCell);
+    }
+
+    void D_GRUCell(Tensor *GX, Tensor *GH, Tensor *Hprev, Tensor *dH, Tensor *dGX, Tensor *dGH, Tensor *dHprev, Tensor *mask) {
+        check_gru_cell(GX, GH, Hprev, dH, mask, "Tensor::D_GRUCell");
+        if (!Tensor::sameShape(GX, dGX) || !Tensor::sameShape(GH, dGH)) msg("Incompatible dims", "Tensor::D_GRUCell");
+        if ((dHprev != nullptr) && !Tensor::sameShape(dH, dHprev)) msg("Incompatible dims", "Tensor::D_GRUCell");
+        for (auto t : {dGX, dGH, dHprev}) if (t != nullptr) checkContiguous(t, "Tensor::D_GRUCell");
+
+        PROFILING_HEADER(D_GRUCell);
+
+        if (dH->isCPU()) {
+            cpu_d_gru_cell(GX, GH, Hprev, dH, dGX, dGH, dHprev, mask);
+        }
+        else {
+            msg("Fused GRU cells are only available on CPU", "Tensor::D_GRUCell");
+        }
+
+        PROFILING_FOOTER(D_GRUCell);
+    }
+
+}
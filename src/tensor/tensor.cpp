@@ -40,6 +40,9 @@ void checkCompatibility(Tensor *A, Tensor *B, const string &title){
     if (!Tensor::sameShape(A, B)){
         msg("Tensors with different shape", title);
     }
+
+    checkContiguous(A, title);
+    checkContiguous(B, title);
 }
 
 
@@ -48,6 +51,47 @@ void checkCompatibility(Tensor *A, Tensor *B, Tensor *C, const string &title){
     checkCompatibility(A, C, title);
 }
 
+void checkContiguous(Tensor *A, const string &title){
+    if (!A->is_contiguous()) {
+        msg("Non-contiguous view, use contiguous() or clone() first", title);
+    }
+}
+
+void checkSamplesContiguous(Tensor *A, const string &title){
+    if (!A->samples_contiguous()) {
+        msg("Non-contiguous samples, use contiguous() or clone() first", title);
+    }
+}
+
+bool runContiguous(const vector<Tensor*> &ts, int nout, const std::function<void(const vector<Tensor*> &)> &op){
+    bool views = false;
+    for (auto t : ts) views = views || ((t != nullptr) && !t->is_contiguous());
+    if (!views) return false;
+
+    // Compact copies of the views (a single one when a tensor is passed twice, e.g. in-place ops)
+    int n = ts.size();
+    vector<Tensor*> cs(n);
+    vector<bool> owned(n, false);
+    for (int i = 0; i < n; i++) {
+        cs[i] = ts[i];
+        if ((ts[i] == nullptr) || ts[i]->is_contiguous()) continue;
+        for (int j = 0; j < i; j++) if (ts[j] == ts[i]) cs[i] = cs[j];
+        if (cs[i] == ts[i]) { cs[i] = ts[i]->clone(); owned[i] = true; }
+    }
+
+    op(cs);
+
+    // Write the outputs back through their views
+    for (int i = n - nout; i < n; i++) {
+        if (cs[i] == ts[i]) continue;
+        bool done = false;
+        for (int j = n - nout; j < i; j++) done = done || (ts[j] == ts[i]);
+        if (!done) Tensor::copy(cs[i], ts[i]);
+    }
+    for (int i = 0; i < n; i++) if (owned[i]) delete cs[i];
+    return true;
+}
+
 
 
 
@@ -141,22 +185,19 @@ void Tensor::updateStrides() {
 }
 
 void Tensor::deleteData(){
+    // The Eigen map is always owned by the tensor, even when its data is shared
+    if (this->isCPU()) {
+        delete this->ptr2;
+        this->ptr2 = nullptr;
+    }
+
     // Carefpdal, you can't know is a pointer is allocated
     if (isshared) return;
 
     if(this->ptr != nullptr){
         if (this->isCPU()) {
-            // Delete eigen matrix
-            if (this->ndim == 2){
-                delete this->ptr2; //double free or corruption (out)
-                delete[] this->ptr;
-                this->ptr2 = nullptr;
-                this->ptr = nullptr;  // Redundant
-            }else{
-                delete[] this->ptr;
-                this->ptr = nullptr;  // Redundant
-            }
-
+            delete[] this->ptr;
+            this->ptr = nullptr;  // Redundant
         }
 #ifdef cGPU
         else if (this->isGPU())
@@ -182,6 +223,10 @@ void Tensor::updateData(float *fptr, void *fptr2,bool setshared){
     // Solved with setshared for reshape_
     isshared=false;
     if (this->isCPU()) {
+        // Map of the previous data, if any (e.g. reshapes and views pointed elsewhere)
+        delete this->ptr2;
+        this->ptr2 = nullptr;
+
         // If null => Reserve memory
         // else => point to data
         if (fptr==nullptr) { this->ptr = get_fmem(this->size,"Tensor::updateData"); }
@@ -431,6 +476,24 @@ int Tensor::isGPU() { return ((device >= DEV_GPU) && (device < DEV_FPGA)); }
 
 int Tensor::isFPGA() { return (device >= DEV_FPGA); }
 
+bool Tensor::is_contiguous() {
+    unsigned long int s = 1;
+    for (int i = (int)ndim - 1; i >= 0; i--) {
+        if ((shape[i] != 1) && (stride[i] != s)) return false;
+        s *= shape[i];
+    }
+    return true;
+}
+
+bool Tensor::samples_contiguous() {
+    unsigned long int s = 1;
+    for (int i = (int)ndim - 1; i > 0; i--) {
+        if ((shape[i] != 1) && (stride[i] != s)) return false;
+        s *= shape[i];
+    }
+    return true;
+}
+
 vector<int> Tensor::getShape() {
     return vector<int>(this->shape);
 }
@@ -467,9 +530,9 @@ void Tensor::print(int precision, bool raw) {
     int opened = 0;
     int closed = 0;
 
-    // Clone to CPU (if needed)
+    // Clone to CPU (if needed), compacting views
     Tensor *aux = nullptr;
-    if (this->isCPU()) {
+    if (this->isCPU() && this->is_contiguous()) {
         aux = this;
     }else{
         aux = new Tensor(this->shape, DEV_CPU);
@@ -484,7 +547,7 @@ void Tensor::print(int precision, bool raw) {
     int lines = 0;
     int max_lines = 100000;
     for (int i = 0; i < aux->size; ++i) {
-        if(i % this->stride[0]==0){lines++;}
+        if(i % aux->stride[0]==0){lines++;}
 
         if(raw){
             // Print number
@@ -543,7 +606,7 @@ void Tensor::print(int precision, bool raw) {
     }
 
     // Free memory
-    if (!this->isCPU()) {
+    if (aux != this) {
         delete aux;
     }
 }
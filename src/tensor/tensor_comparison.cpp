@@ -105,6 +105,8 @@ Tensor* Tensor::isclose(Tensor *A, float rtol, float atol, bool equal_nan){
 }
 
 bool Tensor::all(Tensor *A){
+    bool r = false;
+    if (runContiguous({A}, 0, [&](const vector<Tensor*> &cs){ r = Tensor::all(cs[0]); })) return r;
 
     PROFILING_HEADER(all);
 
@@ -131,6 +133,8 @@ bool Tensor::all(Tensor *A){
 }
 
 bool Tensor::any(Tensor *A){
+    bool r = false;
+    if (runContiguous({A}, 0, [&](const vector<Tensor*> &cs){ r = Tensor::any(cs[0]); })) return r;
 
     PROFILING_HEADER(any);
 
@@ -158,6 +162,8 @@ bool Tensor::any(Tensor *A){
 
 // Logic funcions: Logical ops
 void Tensor::isfinite(Tensor *A, Tensor* B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::isfinite(cs[0], cs[1]); })) return;
+
     checkCompatibility(A, B, "Tensor::isfinite");
 
     PROFILING_HEADER(isfinite);
@@ -180,6 +186,8 @@ void Tensor::isfinite(Tensor *A, Tensor* B){
 }
 
 void Tensor::isinf(Tensor *A, Tensor* B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::isinf(cs[0], cs[1]); })) return;
+
     checkCompatibility(A, B, "Tensor::isinf");
 
     PROFILING_HEADER(isinf);
@@ -202,6 +210,8 @@ void Tensor::isinf(Tensor *A, Tensor* B){
 }
 
 void Tensor::isnan(Tensor *A, Tensor* B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::isnan(cs[0], cs[1]); })) return;
+
     checkCompatibility(A, B, "Tensor::isnan");
 
     PROFILING_HEADER(isnan);
@@ -224,6 +234,8 @@ void Tensor::isnan(Tensor *A, Tensor* B){
 }
 
 void Tensor::isneginf(Tensor *A, Tensor* B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::isneginf(cs[0], cs[1]); })) return;
+
     checkCompatibility(A, B, "Tensor::isneginf");
 
     PROFILING_HEADER(isneginf);
@@ -246,6 +258,8 @@ void Tensor::isneginf(Tensor *A, Tensor* B){
 }
 
 void Tensor::isposinf(Tensor *A, Tensor* B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::isposinf(cs[0], cs[1]); })) return;
+
     checkCompatibility(A, B, "Tensor::isposinf");
 
     PROFILING_HEADER(isposinf);
@@ -271,6 +285,8 @@ void Tensor::isposinf(Tensor *A, Tensor* B){
 // Logic funcions: Logical ops
 
 void Tensor::logical_and(Tensor *A, Tensor *B, Tensor *C){
+    if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::logical_and(cs[0], cs[1], cs[2]); })) return;
+
     checkCompatibility(A, B, C, "Tensor::logical_and");
 
     PROFILING_HEADER(logical_and);
@@ -293,6 +309,8 @@ void Tensor::logical_and(Tensor *A, Tensor *B, Tensor *C){
 }
 
 void Tensor::logical_or(Tensor *A, Tensor *B, Tensor *C){
+    if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::logical_or(cs[0], cs[1], cs[2]); })) return;
+
     checkCompatibility(A, B, C, "Tensor::logical_or");
 
     PROFILING_HEADER(logical_or);
@@ -315,6 +333,8 @@ void Tensor::logical_or(Tensor *A, Tensor *B, Tensor *C){
 }
 
 void Tensor::logical_not(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::logical_not(cs[0], cs[1]); })) return;
+
     checkCompatibility(A, B, "Tensor::logical_not");
 
     PROFILING_HEADER(logical_not);
@@ -337,6 +357,8 @@ void Tensor::logical_not(Tensor *A, Tensor *B){
 }
 
 void Tensor::logical_xor(Tensor *A, Tensor *B, Tensor *C){
+    if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::logical_xor(cs[0], cs[1], cs[2]); })) return;
+
     checkCompatibility(A, B, C, "Tensor::logical_xor");
 
     PROFILING_HEADER(logical_xor);
@@ -361,6 +383,9 @@ void Tensor::logical_xor(Tensor *A, Tensor *B, Tensor *C){
 
 
 bool Tensor::allclose(Tensor *A, Tensor *B, float rtol, float atol, bool equal_nan){
+    bool r = false;
+    if (runContiguous({A, B}, 0, [&](const vector<Tensor*> &cs){ r = Tensor::allclose(cs[0], cs[1], rtol, atol, equal_nan); })) return r;
+
     checkCompatibility(A, B, "Tensor::allclose");
 
     PROFILING_HEADER(allclose);
@@ -386,6 +411,8 @@ bool Tensor::allclose(Tensor *A, Tensor *B, float rtol, float atol, bool equal_n
 
 
 void Tensor::isclose(Tensor *A, Tensor *B, Tensor *C, float rtol, float atol, bool equal_nan){
+    if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::isclose(cs[0], cs[1], cs[2], rtol, atol, equal_nan); })) return;
+
     checkCompatibility(A, B, C, "Tensor::isclose");
 
     PROFILING_HEADER(isclose);
@@ -418,6 +445,8 @@ Tensor* Tensor::greater(float v){
 }
 
 void Tensor::greater(Tensor *A, Tensor *B, float v){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::greater(cs[0], cs[1], v); })) return;
+
     checkCompatibility(A, B, "Tensor::greater");
 
     PROFILING_HEADER(greater);
@@ -448,6 +477,8 @@ Tensor* Tensor::greater(Tensor *A){
 }
 
 void Tensor::greater(Tensor *A, Tensor *B, Tensor *C){
+    if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::greater(cs[0], cs[1], cs[2]); })) return;
+
     checkCompatibility(A, B, C, "Tensor::greater");
 
     PROFILING_HEADER(greater);
@@ -482,6 +513,8 @@ Tensor* Tensor::greater_equal(float v){
 }
 
 void Tensor::greater_equal(Tensor *A, Tensor *B, float v){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::greater_equal(cs[0], cs[1], v); })) return;
+
     checkCompatibility(A, B, "Tensor::greater_equal");
 
     PROFILING_HEADER(greater_equal);
@@ -511,6 +544,8 @@ Tensor* Tensor::greater_equal(Tensor *A){
 }
 
 void Tensor::greater_equal(Tensor *A, Tensor *B, Tensor *C){
+    if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::greater_equal(cs[0], cs[1], cs[2]); })) return;
+
     checkCompatibility(A, B, C, "Tensor::greater_equal");
 
     PROFILING_HEADER(greater_equal);
@@ -546,6 +581,8 @@ Tensor* Tensor::less(float v){
 }
 
 void Tensor::less(Tensor *A, Tensor *B, float v){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::less(cs[0], cs[1], v); })) return;
+
     checkCompatibility(A, B, "Tensor::less");
 
     PROFILING_HEADER(less);
@@ -575,6 +612,8 @@ Tensor* Tensor::less(Tensor *A){
 }
 
 void Tensor::less(Tensor *A, Tensor *B, Tensor *C){
+    if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::less(cs[0], cs[1], cs[2]); })) return;
+
     checkCompatibility(A, B, C, "Tensor::less");
 
     PROFILING_HEADER(less);
@@ -609,6 +648,8 @@ Tensor* Tensor::less_equal(float v){
 }
 
 void Tensor::less_equal(Tensor *A, Tensor *B, float v){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::less_equal(cs[0], cs[1], v); })) return;
+
     checkCompatibility(A, B, "Tensor::less_equal");
 
     PROFILING_HEADER(less_equal);
@@ -640,6 +681,8 @@ Tensor* Tensor::less_equal(Tensor *A){
 }
 
 void Tensor::less_equal(Tensor *A, Tensor *B, Tensor *C){
+    if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::less_equal(cs[0], cs[1], cs[2]); })) return;
+
     checkCompatibility(A, B, C, "Tensor::less_equal");
 
     PROFILING_HEADER(less_equal);
@@ -673,6 +716,8 @@ Tensor* Tensor::equal(float v){
 }
 
 void Tensor::equal(Tensor *A, Tensor *B, float v){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::equal(cs[0], cs[1], v); })) return;
+
     checkCompatibility(A, B, "Tensor::equal");
 
     PROFILING_HEADER(equal);
@@ -703,6 +748,8 @@ Tensor* Tensor::equal(Tensor *A){
 }
 
 void Tensor::equal(Tensor *A, Tensor *B, Tensor *C){
+    if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::equal(cs[0], cs[1], cs[2]); })) return;
+
     checkCompatibility(A, B, C, "Tensor::equal");
 
     PROFILING_HEADER(equal);
@@ -736,6 +783,8 @@ Tensor* Tensor::not_equal(float v){
 }
 
 void Tensor::not_equal(Tensor *A, Tensor *B, float v){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::not_equal(cs[0], cs[1], v); })) return;
+
     checkCompatibility(A, B, "Tensor::not_equal");
 
     PROFILING_HEADER(not_equal);
@@ -766,6 +815,8 @@ Tensor* Tensor::not_equal(Tensor *A){
 }
 
 void Tensor::not_equal(Tensor *A, Tensor *B, Tensor *C){
+    if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::not_equal(cs[0], cs[1], cs[2]); })) return;
+
     checkCompatibility(A, B, C, "Tensor::not_equal");
 
     PROFILING_HEADER(not_equal);
@@ -812,8 +863,10 @@ int Tensor::sameShape(Tensor *A, Tensor *B) {
 }
 
 int Tensor::equivalent(Tensor *A, Tensor *B, float atol, float rtol, bool equal_nan) {
-
+    int r = 0;
     // Equal device
+    if (runContiguous({A, B}, 0, [&](const vector<Tensor*> &cs){ r = Tensor::equivalent(cs[0], cs[1], atol, rtol, equal_nan); })) return r;
+
     if (A->device != B->device) msg("Tensors in different devices", "Tensor::equivalent");
 
     // Equal ndims and shapes
@@ -35,6 +35,8 @@ Tensor* Tensor::fill(float v){
 }
 
 void Tensor::fill(Tensor* A, float v){
+    if (runContiguous({A}, 1, [&](const vector<Tensor*> &cs){ Tensor::fill(cs[0], v); })) return;
+
     if (A->isCPU()) {
         cpu_fill_(A, v);
     }
@@ -53,6 +55,7 @@ void Tensor::fill(Tensor* A, float v){
 
 
 void Tensor::permute_(const vector<int>& dims){
+    checkContiguous(this, "Tensor::permute_");
     Tensor* temp = Tensor::permute(this, dims);
 
     // Update attributes
@@ -87,6 +90,7 @@ Tensor* Tensor::permute(Tensor* A, const vector<int>& dims){
 
 
 void Tensor::moveaxis_(int source, int destination){
+    checkContiguous(this, "Tensor::moveaxis_");
     Tensor* temp = Tensor::moveaxis(this, source, destination);
 
     // Update attributes
@@ -129,6 +133,7 @@ Tensor* Tensor::moveaxis(Tensor* A, int source, int destination){
 
 
 void Tensor::swapaxis_(int axis1, int axis2){
+    checkContiguous(this, "Tensor::swapaxis_");
     Tensor* temp = Tensor::swapaxis(this, axis1, axis2);
 
     // Update attributes
@@ -165,6 +170,8 @@ Tensor* Tensor::swapaxis(Tensor* A, int axis1, int axis2){
 
 
 void Tensor::reshape_(const vector<int> &new_shape){
+    checkContiguous(this, "Tensor::reshape_");  // see reshape_view
+
     int new_size = 1;  // For checking
     vector<int> final_shape;
 
@@ -221,16 +228,25 @@ Tensor* Tensor::flatten(Tensor *A){
 
 void Tensor::squeeze_(int axis){
     // Remove single dimension entries from the array
-    vector<int> new_shape;
+    vector<int> new_shape, new_strides;
     for(int i=0; i<this->shape.size(); i++){
         int dim = this->shape[i];
 
         // If dimension is greater than 1
         if(dim>1 || (i!=axis && axis!=-1)){
             new_shape.push_back(dim);
+            new_strides.push_back(this->stride[i]);
         }
     }
-    this->reshape_(new_shape);
+
+    if (this->is_contiguous()) this->reshape_(new_shape);
+    else {
+        // Strided view: the other dims keep their strides
+        updateShape(new_shape);
+        updateSize();
+        this->stride = new_strides;
+        updateData(this->ptr, nullptr, isshared);
+    }
 }
 
 Tensor* Tensor::squeeze(int axis){
@@ -301,6 +317,7 @@ Tensor* Tensor::unsqueeze(Tensor *A, int axis){
 void Tensor::transpose(Tensor *A, Tensor *B, vector<int> dims) {
     // TODO: Deprecated.
     // Transpose
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::transpose(cs[0], cs[1], dims); })) return;
 
     if (A->size != B->size)
         msg("Tensors with different size", "Tensor::transpose");
@@ -344,6 +361,11 @@ void Tensor::copy(Tensor *A, Tensor *B) {
         msg("Tensors with different size", "Tensor::copy");
     }
 
+    // Strided views are only copied in CPU
+    if (!A->isCPU() || !B->isCPU()) {
+        checkContiguous(A, "Tensor::copy");
+        checkContiguous(B, "Tensor::copy");
+    }
 
     if ((A->isCPU()) && (B->isCPU())) {
         cpu_copy(A, B);
@@ -386,6 +408,8 @@ void Tensor::fill(Tensor *A, int aini, int aend, Tensor *B, int bini, int bend,
     ///////////////////////////////////////
     /// Partial copy ndim=1
     //////////////////////////////////////
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::fill(cs[0], aini, aend, cs[1], bini, bend, inc); })) return;
+
     if (A->ndim != B->ndim)
         msg("Tensors with different shape", "Tensor::fill");
 
@@ -416,6 +440,8 @@ Tensor* Tensor::sort(bool descending, bool stable){
 }
 
 void Tensor::sort(Tensor* A, Tensor* B, bool descending, bool stable){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::sort(cs[0], cs[1], descending, stable); })) return;
+
     if (A->isCPU() && B->isCPU()){
         cpu_sort(A, B, descending, stable);
     }
@@ -441,6 +467,8 @@ Tensor* Tensor::argsort(bool descending, bool stable){
 }
 
 void Tensor::argsort(Tensor* A, Tensor* B, bool descending, bool stable){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::argsort(cs[0], cs[1], descending, stable); })) return;
+
     if (A->isCPU() && B->isCPU()){
         cpu_argsort(A, B, descending, stable);
     }
@@ -660,7 +688,66 @@ Tensor* Tensor::select(const vector<string>& indices){
     return t;
 }
 
+// Tensor sharing the data of A from offset, with the given strides
+static Tensor* make_view(Tensor *A, const vector<int>& shape, const vector<int>& strides, long int offset){
+    if (A->isFPGA()) msg("Views are not supported in FPGA", "Tensor::view");
+
+    auto *t = new Tensor(shape, A->ptr + offset, A->device);
+    t->stride = strides;
+
+    // The Eigen map of 2D tensors assumes row-major data
+    if (!t->is_contiguous() && t->isCPU()) {
+        delete t->ptr2;
+        t->ptr2 = nullptr;
+    }
+    return t;
+}
+
+Tensor* Tensor::select_view(const vector<string>& indices){
+    vector<vector<int>> ranges = parse_indices(indices, this->shape);
+
+    long int offset = 0;
+    for (int d = 0; d < ranges.size(); d++) offset += (long int)ranges[d][0] * this->stride[d];
+
+    return make_view(this, indices2shape(ranges), this->stride, offset);
+}
+
+Tensor* Tensor::permute_view(const vector<int>& dims){
+    if (dims.size() != this->ndim) msg("The number of dimensions does not match", "Tensor::permute_view");
+
+    vector<bool> used(this->ndim, false);
+    vector<int> new_shape, new_strides;
+    for (auto d : dims) {
+        if ((d < 0) || (d >= this->ndim) || used[d]) msg("Invalid permutation", "Tensor::permute_view");
+        used[d] = true;
+        new_shape.push_back(this->shape[d]);
+        new_strides.push_back(this->stride[d]);
+    }
+
+    return make_view(this, new_shape, new_strides, 0);
+}
+
+Tensor* Tensor::reshape_view(const vector<int>& new_shape){
+    Tensor *t = this->contiguous();
+    t->reshape_(new_shape);
+    return t;
+}
+
+Tensor* Tensor::contiguous(){
+    if (this->is_contiguous()) return make_view(this, this->shape, this->stride, 0);
+    return this->clone();
+}
+
 void Tensor::select(Tensor *A, Tensor* B, SelDescriptor *sd){
+    // The descriptor assumes a row-major input
+    if (!A->is_contiguous()) {
+        Tensor *a = A->contiguous();
+        Tensor::select(a, B, sd);
+        delete a;
+        return;
+    }
+    checkContiguous(B, "Tensor::select");
+
     if (A->isCPU() && B->isCPU()) {
         cpu_select(A, B, sd);
     }
@@ -679,6 +766,8 @@ void Tensor::select(Tensor *A, Tensor* B, SelDescriptor *sd){
 }
 
 void Tensor::select_back(Tensor *A, Tensor* B, SelDescriptor *sd){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::select_back(cs[0], cs[1], sd); })) return;
+
     if (A->isCPU() && B->isCPU()) {
         cpu_select_back(A, B, sd);
     }
@@ -728,6 +817,8 @@ void Tensor::set_select(const vector<string>& indices, Tensor *A){
 }
 
 void Tensor::set_select(Tensor *A, Tensor *B, SelDescriptor *sd){
+    if (runContiguous({B, A}, 1, [&](const vector<Tensor*> &cs){ Tensor::set_select(cs[1], cs[0], sd); })) return;
+
     if (A->isCPU() && B->isCPU()) {
         cpu_set_select(A, B, sd);
     }
@@ -746,6 +837,8 @@ void Tensor::set_select(Tensor *A, Tensor *B, SelDescriptor *sd){
 
 
 void Tensor::set_select_back(Tensor *A, Tensor* B, SelDescriptor *sd){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::set_select_back(cs[0], cs[1], sd); })) return;
+
     if (A->isCPU() && B->isCPU()) {
         cpu_set_select_back(A, B, sd);
     }
@@ -768,6 +861,15 @@ void Tensor::select(Tensor *A, Tensor *B, vector<int> sind, int ini, int end, bo
     /// Select from A to B, A is bigger
     //////////////////////////////////////
 
+    // The samples of A can be strided (e.g. a timestep of batch-major sequences), not their elements
+    if (!A->samples_contiguous() || (!A->isCPU() && !A->is_contiguous())) {
+        Tensor *a = A->contiguous();
+        Tensor::select(a, B, sind, ini, end, mask_zeros);
+        delete a;
+        return;
+    }
+    checkContiguous(B, "Tensor::select");
+
     if ((A->size / A->shape[0]) != (B->size / B->shape[0])) {
         A->info();
         B->info();
@@ -838,6 +940,7 @@ void Tensor::deselect(Tensor *A, Tensor *B, vector<int> sind, int ini, int end,i
     ///////////////////////////////////////
     /// deSelect from A to B, B is bigger
     //////////////////////////////////////
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::deselect(cs[0], cs[1], sind, ini, end, inc, mask_zeros); })) return;
 
     if ((A->size / A->shape[0]) != (B->size / B->shape[0])) {
         A->info();
@@ -169,6 +169,8 @@ Tensor* Tensor::diag(int k){
 }
 
 void Tensor::diag(Tensor* A, Tensor* B, int k){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::diag(cs[0], cs[1], k); })) return;
+
     checkCompatibility(A, B, "Tensor::diag");
 
     if(!Tensor::isSquared(A) || A->ndim != 2){  // isSquares is for n dimensions, and here we need just two
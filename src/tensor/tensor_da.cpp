@@ -36,6 +36,8 @@ Tensor* Tensor::shift(vector<int> shift, WrappingMode mode, float cval){
 }
 
 void Tensor::shift(Tensor *A, Tensor *B, vector<int> shift, WrappingMode mode, float cval){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::shift(cs[0], cs[1], shift, mode, cval); })) return;
+
     // shift => {y, x}
     // Parameter check
     if(::abs(shift[0]) >= A->shape[2] || ::abs(shift[1]) >= A->shape[3]){
@@ -76,6 +78,8 @@ Tensor* Tensor::rotate(float angle, vector<int> offset_center, WrappingMode mode
 }
 
 void Tensor::rotate(Tensor *A, Tensor *B, float angle, vector<int> offset_center, WrappingMode mode, float cval) {
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::rotate(cs[0], cs[1], angle, offset_center, mode, cval); })) return;
+
     // Check dimensions
     if(A->shape!=B->shape){
         msg("Incompatible dimensions", "Tensor::rotate");
@@ -118,6 +122,8 @@ Tensor* Tensor::scale(vector<int> new_shape, WrappingMode mode, float cval, bool
 }
 
 void Tensor::scale(Tensor *A, Tensor *B, vector<int> new_shape, WrappingMode mode, float cval) {
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::scale(cs[0], cs[1], new_shape, mode, cval); })) return;
+
     // new_shape => {y, x}
     // Parameter check
     if(new_shape[0] <= 0 || new_shape[1] <= 0){
@@ -157,6 +163,8 @@ Tensor* Tensor::flip(int axis) {
 }
 
 void Tensor::flip(Tensor *A, Tensor *B, int axis) {
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::flip(cs[0], cs[1], axis); })) return;
+
     // Parameter check
     if(axis != 0 && axis != 1){
         msg("Axis must be either 0 (vertical axis) or 1 (horizontal axis)", "Tensor::flip");
@@ -203,6 +211,8 @@ Tensor* Tensor::crop(vector<int> coords_from, vector<int> coords_to, float cval,
 }
 
 void Tensor::crop(Tensor *A, Tensor *B, vector<int> coords_from, vector<int> coords_to, float cval) {
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::crop(cs[0], cs[1], coords_from, coords_to, cval); })) return;
+
     // coords => {y, x}
     // Parameter check
     if(coords_from[0] < 0.0f || coords_from[0]>= A->shape[2] ||
@@ -244,6 +254,8 @@ Tensor* Tensor::crop_scale(vector<int> coords_from, vector<int> coords_to, Wrapp
 }
 
 void Tensor::crop_scale(Tensor *A, Tensor *B, vector<int> coords_from, vector<int> coords_to, WrappingMode mode, float cval) {
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::crop_scale(cs[0], cs[1], coords_from, coords_to, mode, cval); })) return;
+
     // coords => {y, x}
     // Parameter check
     if(coords_from[0] < 0.0f || coords_from[0]>= A->shape[2] ||
@@ -286,6 +298,8 @@ Tensor* Tensor::cutout(vector<int> coords_from, vector<int> coords_to, float cva
 }
 
 void Tensor::cutout(Tensor *A, Tensor *B, vector<int> coords_from, vector<int> coords_to, float cval) {
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::cutout(cs[0], cs[1], coords_from, coords_to, cval); })) return;
+
     // coords => {y, x}
     // Parameter check
     if(coords_from[0] < 0.0f || coords_from[0]>= A->shape[2] ||
@@ -332,6 +346,8 @@ Tensor* Tensor::shift_random(vector<float> factor_x, vector<float> factor_y, Wra
 
 
 void Tensor::shift_random(Tensor *A, Tensor *B, vector<float> factor_x, vector<float> factor_y, WrappingMode mode, float cval){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::shift_random(cs[0], cs[1], factor_x, factor_y, mode, cval); })) return;
+
     // Parameter check
     if(factor_x[0] < -1.0f || factor_x[0] > 1.0f ||
        factor_x[1] < -1.0f || factor_x[1] > 1.0f ||
@@ -375,6 +391,8 @@ Tensor* Tensor::rotate_random(vector<float> factor, vector<int> offset_center, W
 }
 
 void Tensor::rotate_random(Tensor *A, Tensor *B, vector<float> factor, vector<int> offset_center, WrappingMode mode, float cval) {
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::rotate_random(cs[0], cs[1], factor, offset_center, mode, cval); })) return;
+
     // Check dimensions
     if(A->shape!=B->shape){
         msg("Incompatible dimensions", "Tensor::rotate_random");
@@ -411,6 +429,8 @@ Tensor* Tensor::scale_random(vector<float> factor, WrappingMode mode, float cval
 }
 
 void Tensor::scale_random(Tensor *A, Tensor *B, vector<float> factor, WrappingMode mode, float cval) {
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::scale_random(cs[0], cs[1], factor, mode, cval); })) return;
+
     // Parameter check
     if(factor[0] < 0.0f || factor[1] < 0.0f){
         msg("The scaling factor must be a positive number", "Tensor::scale_random");
@@ -449,6 +469,8 @@ Tensor* Tensor::flip_random(int axis){
 }
 
 void Tensor::flip_random(Tensor *A, Tensor *B, int axis) {
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::flip_random(cs[0], cs[1], axis); })) return;
+
     // Parameter check
     if(axis != 0 && axis != 1){
         msg("The axis must be either 0 (vertical axis) or 1 (horizontal axis)", "Tensor::flip_random");
@@ -504,6 +526,8 @@ Tensor* Tensor::crop_random(int height, int width, float cval, bool keep_size){
 }
 
 void Tensor::crop_random(Tensor *A, Tensor *B) {
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::crop_random(cs[0], cs[1]); })) return;
+
     // Check dimensions
     if (A->ndim != 4 || B->ndim != 4){
         msg("This method requires two 4D tensors", "Tensor::crop_random");
@@ -536,6 +560,8 @@ Tensor* Tensor::crop_scale_random(vector<float> factor, WrappingMode mode, float
 }
 
 void Tensor::crop_scale_random(Tensor *A, Tensor *B, vector<float> factor, WrappingMode mode, float cval) {
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::crop_scale_random(cs[0], cs[1], factor, mode, cval); })) return;
+
     // Parameter check
     if(factor[0] < 0.0f || factor[0] > 1.0f ||
        factor[1] < 0.0f || factor[1] > 1.0f){
@@ -574,6 +600,8 @@ Tensor* Tensor::cutout_random(vector<float> factor_x, vector<float> factor_y, fl
 }
 
 void Tensor::cutout_random(Tensor *A, Tensor *B, vector<float> factor_x, vector<float> factor_y, float cval) {
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::cutout_random(cs[0], cs[1], factor_x, factor_y, cval); })) return;
+
     // Parameter check
     if(factor_x[0] < 0.0f || factor_x[0] > 1.0f ||
        factor_x[1] < 0.0f || factor_x[1] > 1.0f ||
@@ -608,3 +636,25 @@ void Tensor::cutout_random(Tensor *A, Tensor *B, vector<float> factor_x, vector<
 
   PROFILING_FOOTER(cutout_random);
 }
+
+void Tensor::augment_random(Tensor *A, Tensor *B, AugmentDescriptor *ad) {
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::augment_random(cs[0], cs[1], ad); })) return;
+
+    // Check dimensions
+    if (A->ndim != 4 || B->ndim != 4){
+        msg("This method requires two 4D tensors", "Tensor::augment_random");
+    } else if (A->shape[0] != B->shape[0] || A->shape[1] != B->shape[1]){
+        msg("Incompatible dimensions", "Tensor::augment_random");
+    }
+
+    PROFILING_HEADER_EXTERN(augment_random);
+
+    if (A->isCPU()) {
+        cpu_augment_random(A, B, ad);
+    }
+    else {
+        msg("Fused augmentation is only available on CPU", "Tensor::augment_random");
+    }
+
+    PROFILING_FOOTER(augment_random);
+}
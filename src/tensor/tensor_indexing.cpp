@@ -73,6 +73,8 @@ Tensor* Tensor::where(Tensor *condition, Tensor *A, Tensor *B){ // where(x > 0,
 }
 
 void Tensor::where(Tensor *condition, Tensor *A, Tensor *B, Tensor *C){
+    if (runContiguous({condition, A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::where(cs[0], cs[1], cs[2], cs[3]); })) return;
+
     checkCompatibility(A, B, C, "Tensor::where");
 
     if (condition->isCPU() && A->isCPU() && B->isCPU()) {
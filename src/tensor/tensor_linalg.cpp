@@ -35,6 +35,9 @@ float Tensor::norm(string ord){
 }
 
 float Tensor::norm(Tensor *A, string ord){
+    float r = 0.0f;
+    if (runContiguous({A}, 0, [&](const vector<Tensor*> &cs){ r = Tensor::norm(cs[0], ord); })) return r;
+
     if (A->isCPU()) {
         return cpu_norm(A, ord);
     }
@@ -67,6 +70,8 @@ Tensor* Tensor::norm(vector<int> axis, bool keepdims, string ord){
 }
 
 void Tensor::norm(Tensor* A, Tensor *B, ReduceDescriptor2 *rd, string ord){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::norm(cs[0], cs[1], rd, ord); })) return;
+
     if (A->isCPU() && B->isCPU()) {
         cpu_norm(A, B, rd, ord);
     }
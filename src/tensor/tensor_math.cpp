@@ -41,6 +41,7 @@ Tensor* Tensor::maximum(Tensor* A, float v){
 }
 
 void Tensor::maximum(Tensor* A, Tensor* B, float v){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::maximum(cs[0], cs[1], v); })) return;
 
     PROFILING_HEADER_EXTERN(maximum);
 
@@ -69,6 +70,7 @@ Tensor* Tensor::maximum(Tensor* A, Tensor* B){
 }
 
 void Tensor::maximum(Tensor* A, Tensor* B, Tensor* C){
+    if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::maximum(cs[0], cs[1], cs[2]); })) return;
 
     PROFILING_HEADER_EXTERN(maximum);
 
@@ -103,6 +105,7 @@ Tensor* Tensor::minimum(Tensor* A, float v){
 }
 
 void Tensor::minimum(Tensor* A, Tensor* B, float v){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::minimum(cs[0], cs[1], v); })) return;
 
     PROFILING_HEADER_EXTERN(minimum);
 
@@ -131,6 +134,7 @@ Tensor* Tensor::minimum(Tensor* A, Tensor* B){
 }
 
 void Tensor::minimum(Tensor* A, Tensor* B, Tensor* C){
+    if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::minimum(cs[0], cs[1], cs[2]); })) return;
 
     PROFILING_HEADER_EXTERN(minimum);
 
@@ -162,6 +166,8 @@ float Tensor::max(){
 
 
 float Tensor::max(Tensor* A){
+    float r = 0.0f;
+    if (runContiguous({A}, 0, [&](const vector<Tensor*> &cs){ r = Tensor::max(cs[0]); })) return r;
 
     PROFILING_HEADER_EXTERN(max);
 
@@ -200,6 +206,7 @@ Tensor* Tensor::max(vector<int> axis, bool keepdims){
 }
 
 void Tensor::max(Tensor* A, Tensor *B, ReduceDescriptor2 *rd){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::max(cs[0], cs[1], rd); })) return;
 
     PROFILING_HEADER_EXTERN(max);
 
@@ -229,6 +236,8 @@ int Tensor::argmax(){
 
 
 int Tensor::argmax(Tensor* A){
+    int r = 0;
+    if (runContiguous({A}, 0, [&](const vector<Tensor*> &cs){ r = Tensor::argmax(cs[0]); })) return r;
 
     PROFILING_HEADER_EXTERN(argmax);
 
@@ -270,6 +279,7 @@ Tensor* Tensor::argmax(vector<int> axis, bool keepdims){
 }
 
 void Tensor::argmax(Tensor* A, Tensor *B, ReduceDescriptor2 *rd){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::argmax(cs[0], cs[1], rd); })) return;
 
     PROFILING_HEADER_EXTERN(argmax);
 
@@ -292,6 +302,7 @@ void Tensor::argmax(Tensor* A, Tensor *B, ReduceDescriptor2 *rd){
 }
 
 void Tensor::argmax_d(Tensor *D, Tensor *O, Tensor *PD){
+    if (runContiguous({D, O, PD}, 1, [&](const vector<Tensor*> &cs){ Tensor::argmax_d(cs[0], cs[1], cs[2]); })) return;
 
     PROFILING_HEADER_EXTERN(argmax_d);
 
@@ -319,6 +330,8 @@ float Tensor::min(){
 
 
 float Tensor::min(Tensor* A){
+    float r = 0.0f;
+    if (runContiguous({A}, 0, [&](const vector<Tensor*> &cs){ r = Tensor::min(cs[0]); })) return r;
 
     PROFILING_HEADER_EXTERN(min);
 
@@ -360,6 +373,7 @@ Tensor* Tensor::min(vector<int> axis, bool keepdims){
 }
 
 void Tensor::min(Tensor* A, Tensor *B, ReduceDescriptor2 *rd){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::min(cs[0], cs[1], rd); })) return;
 
     PROFILING_HEADER_EXTERN(min);
 
@@ -388,6 +402,8 @@ int Tensor::argmin(){
 
 
 int Tensor::argmin(Tensor* A){
+    int r = 0;
+    if (runContiguous({A}, 0, [&](const vector<Tensor*> &cs){ r = Tensor::argmin(cs[0]); })) return r;
 
     PROFILING_HEADER_EXTERN(argmin);
 
@@ -429,6 +445,7 @@ Tensor* Tensor::argmin(vector<int> axis, bool keepdims){
 }
 
 void Tensor::argmin(Tensor* A, Tensor *B, ReduceDescriptor2 *rd){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::argmin(cs[0], cs[1], rd); })) return;
 
     PROFILING_HEADER_EXTERN(argmin);
 
@@ -458,6 +475,8 @@ float Tensor::sum(){
 
 
 float Tensor::sum(Tensor* A){
+    float r = 0.0f;
+    if (runContiguous({A}, 0, [&](const vector<Tensor*> &cs){ r = Tensor::sum(cs[0]); })) return r;
 
     PROFILING_HEADER_EXTERN(sum);
 
@@ -501,6 +520,7 @@ Tensor* Tensor::sum(vector<int> axis, bool keepdims){
 }
 
 void Tensor::sum(Tensor* A, Tensor *B, ReduceDescriptor2 *rd){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::sum(cs[0], cs[1], rd); })) return;
 
     PROFILING_HEADER_EXTERN(sum);
 
@@ -528,6 +548,8 @@ float Tensor::sum_abs(){
 
 
 float Tensor::sum_abs(Tensor* A){
+    float r = 0.0f;
+    if (runContiguous({A}, 0, [&](const vector<Tensor*> &cs){ r = Tensor::sum_abs(cs[0]); })) return r;
 
     PROFILING_HEADER_EXTERN(sum_abs);
 
@@ -571,6 +593,7 @@ Tensor* Tensor::sum_abs(vector<int> axis, bool keepdims){
 }
 
 void Tensor::sum_abs(Tensor* A, Tensor *B, ReduceDescriptor2 *rd){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::sum_abs(cs[0], cs[1], rd); })) return;
 
     PROFILING_HEADER_EXTERN(sum_abs);
 
@@ -598,6 +621,8 @@ float Tensor::prod(){
 
 
 float Tensor::prod(Tensor* A){  // AKA factorial
+    float r = 0.0f;
+    if (runContiguous({A}, 0, [&](const vector<Tensor*> &cs){ r = Tensor::prod(cs[0]); })) return r;
 
     PROFILING_HEADER_EXTERN(prod);
 
@@ -640,6 +665,7 @@ Tensor* Tensor::prod(vector<int> axis, bool keepdims){
 }
 
 void Tensor::prod(Tensor* A, Tensor *B, ReduceDescriptor2 *rd){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::prod(cs[0], cs[1], rd); })) return;
 
     PROFILING_HEADER_EXTERN(prod);
 
@@ -685,6 +711,7 @@ Tensor* Tensor::mean(vector<int> axis, bool keepdims){
 }
 
 void Tensor::mean(Tensor* A, Tensor *B, ReduceDescriptor2 *rd){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::mean(cs[0], cs[1], rd); })) return;
 
     PROFILING_HEADER_EXTERN(mean);
 
@@ -714,6 +741,8 @@ float Tensor::median(){
 
 
 float Tensor::median(Tensor* A){
+    float r = 0.0f;
+    if (runContiguous({A}, 0, [&](const vector<Tensor*> &cs){ r = Tensor::median(cs[0]); })) return r;
 
     PROFILING_HEADER_EXTERN(median);
 
@@ -757,6 +786,7 @@ Tensor* Tensor::median(vector<int> axis, bool keepdims){
 }
 
 void Tensor::median(Tensor* A, Tensor *B, ReduceDescriptor2 *rd){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::median(cs[0], cs[1], rd); })) return;
 
     PROFILING_HEADER_EXTERN(median);
 
@@ -784,6 +814,8 @@ float Tensor::std(bool unbiased){
 
 
 float Tensor::std(Tensor* A, bool unbiased){
+    float r = 0.0f;
+    if (runContiguous({A}, 0, [&](const vector<Tensor*> &cs){ r = Tensor::std(cs[0], unbiased); })) return r;
 
     PROFILING_HEADER_EXTERN(std);
 
@@ -826,6 +858,7 @@ Tensor* Tensor::std(vector<int> axis, bool keepdims, bool unbiased){
 }
 
 void Tensor::std(Tensor* A, Tensor *B, ReduceDescriptor2 *rd, bool unbiased){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::std(cs[0], cs[1], rd, unbiased); })) return;
 
     PROFILING_HEADER_EXTERN(std);
 
@@ -854,6 +887,8 @@ float Tensor::var(bool unbiased){
 
 
 float Tensor::var(Tensor* A, bool unbiased){
+    float r = 0.0f;
+    if (runContiguous({A}, 0, [&](const vector<Tensor*> &cs){ r = Tensor::var(cs[0], unbiased); })) return r;
 
     PROFILING_HEADER_EXTERN(var);
 
@@ -900,6 +935,7 @@ Tensor* Tensor::var(vector<int> axis, bool keepdims, bool unbiased){
 }
 
 void Tensor::var(Tensor* A, Tensor *B, ReduceDescriptor2 *rd, bool unbiased){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::var(cs[0], cs[1], rd, unbiased); })) return;
 
     PROFILING_HEADER_EXTERN(var);
 
@@ -929,6 +965,8 @@ int Tensor::mode(){
 
 
 int Tensor::mode(Tensor* A){
+    int r = 0;
+    if (runContiguous({A}, 0, [&](const vector<Tensor*> &cs){ r = Tensor::mode(cs[0]); })) return r;
 
     PROFILING_HEADER_EXTERN(mode);
 
@@ -972,6 +1010,7 @@ Tensor* Tensor::mode(vector<int> axis, bool keepdims){
 }
 
 void Tensor::mode(Tensor* A, Tensor *B, ReduceDescriptor2 *rd){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::mode(cs[0], cs[1], rd); })) return;
 
     PROFILING_HEADER_EXTERN(mode);
 
@@ -1006,6 +1045,7 @@ Tensor* Tensor::abs(){
 }
 
 void Tensor::abs(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::abs(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(abs);
 
@@ -1040,6 +1080,7 @@ Tensor* Tensor::acos(){
 }
 
 void Tensor::acos(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::acos(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(acos);
 
@@ -1084,6 +1125,8 @@ Tensor* Tensor::add(Tensor* A){
 }
 
 void Tensor::add(Tensor *A, Tensor *B, float v){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::add(cs[0], cs[1], v); })) return;
+
     PROFILING_HEADER_EXTERN(add);
 
     if (A->isCPU() && B->isCPU()) {
@@ -1118,6 +1161,7 @@ Tensor* Tensor::asin(){
 }
 
 void Tensor::asin(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::asin(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(asin);
 
@@ -1154,6 +1198,7 @@ Tensor* Tensor::atan(){
 
 
 void Tensor::atan(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::atan(cs[0], cs[1]); })) return;
     
     PROFILING_HEADER_EXTERN(atan);    
 
@@ -1190,6 +1235,7 @@ Tensor* Tensor::ceil(){
 
 
 void Tensor::ceil(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::ceil(cs[0], cs[1]); })) return;
     
     PROFILING_HEADER_EXTERN(ceil);
     
@@ -1226,6 +1272,7 @@ Tensor* Tensor::clamp(float min, float max){
 
 
 void Tensor::clamp(Tensor *A, Tensor *B, float min, float max){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::clamp(cs[0], cs[1], min, max); })) return;
 
     PROFILING_HEADER_EXTERN(clamp);
 
@@ -1295,6 +1342,7 @@ Tensor* Tensor::cos(){
 
 
 void Tensor::cos(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::cos(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(cos);
 
@@ -1330,6 +1378,7 @@ Tensor* Tensor::cosh(){
 }
 
 void Tensor::cosh(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::cosh(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(cosh);
 
@@ -1395,6 +1444,7 @@ Tensor* Tensor::exp(){
 
 
 void Tensor::exp(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::exp(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(exp);
     
@@ -1431,6 +1481,7 @@ Tensor* Tensor::floor(){
 
 
 void Tensor::floor(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::floor(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(floor);
     
@@ -1467,6 +1518,7 @@ Tensor* Tensor::inv(float v){
 
 
 void Tensor::inv(Tensor *A, Tensor *B, float v){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::inv(cs[0], cs[1], v); })) return;
 
     PROFILING_HEADER_EXTERN(inv);
     
@@ -1503,6 +1555,7 @@ Tensor* Tensor::log(){
 
 
 void Tensor::log(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::log(cs[0], cs[1]); })) return;
     
     PROFILING_HEADER_EXTERN(log);
     
@@ -1539,6 +1592,7 @@ Tensor* Tensor::log2(){
 
 
 void Tensor::log2(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::log2(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(log2);
     
@@ -1575,6 +1629,7 @@ Tensor* Tensor::log10(){
 
 
 void Tensor::log10(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::log10(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(log10);
     
@@ -1611,6 +1666,7 @@ Tensor* Tensor::logn(float n){
 
 
 void Tensor::logn(Tensor *A, Tensor *B, float n){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::logn(cs[0], cs[1], n); })) return;
     
     PROFILING_HEADER_EXTERN(logn);
     
@@ -1647,6 +1703,7 @@ Tensor* Tensor::mod(float v){
 
 
 void Tensor::mod(Tensor *A, Tensor *B, float v){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::mod(cs[0], cs[1], v); })) return;
 
     PROFILING_HEADER_EXTERN(mod);
     
@@ -1695,6 +1752,7 @@ Tensor* Tensor::mult(Tensor* A){
 
 
 void Tensor::mult(Tensor *A, Tensor *B, float v){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::mult(cs[0], cs[1], v); })) return;
 
     PROFILING_HEADER_EXTERN(mult);
     
@@ -1748,6 +1806,7 @@ Tensor* Tensor::normalize(float min, float max){
 
 
 void Tensor::normalize(Tensor *A, Tensor *B, float min, float max){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::normalize(cs[0], cs[1], min, max); })) return;
 
     PROFILING_HEADER_EXTERN(normalize);
     
@@ -1784,6 +1843,7 @@ Tensor* Tensor::pow(float exp){
 
 
 void Tensor::pow(Tensor *A, Tensor *B, float exp){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::pow(cs[0], cs[1], exp); })) return;
     
     PROFILING_HEADER_EXTERN(pow);
     
@@ -1820,6 +1880,7 @@ Tensor* Tensor::powb(float base){
 
 
 void Tensor::powb(Tensor *A, Tensor *B, float base){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::powb(cs[0], cs[1], base); })) return;
 
     PROFILING_HEADER_EXTERN(powb);
     
@@ -1873,6 +1934,7 @@ Tensor* Tensor::remainder(float v){
 
 
 void Tensor::remainder(Tensor *A, Tensor *B, float v){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::remainder(cs[0], cs[1], v); })) return;
 
     PROFILING_HEADER_EXTERN(remainder);
     
@@ -1910,6 +1972,7 @@ Tensor* Tensor::round(){
 
 
 void Tensor::round(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::round(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(round);
 
@@ -1946,6 +2009,7 @@ Tensor* Tensor::rsqrt(){
 
 
 void Tensor::rsqrt(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::rsqrt(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(rsqrt);
     
@@ -1982,6 +2046,7 @@ Tensor* Tensor::sigmoid(){
 
 
 void Tensor::sigmoid(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::sigmoid(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(sigmoid);
     
@@ -2018,6 +2083,7 @@ Tensor* Tensor::sign(float zero_sign){
 
 
 void Tensor::sign(Tensor *A, Tensor *B, float zero_sign) {
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::sign(cs[0], cs[1], zero_sign); })) return;
 
     PROFILING_HEADER_EXTERN(sign);
     
@@ -2054,6 +2120,7 @@ Tensor* Tensor::sin(){
 
 
 void Tensor::sin(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::sin(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(sin);
     
@@ -2090,6 +2157,7 @@ Tensor* Tensor::sinh(){
 
 
 void Tensor::sinh(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::sinh(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(sinh);
     
@@ -2126,6 +2194,7 @@ Tensor* Tensor::sqr(){
 
 
 void Tensor::sqr(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::sqr(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(sqr);
     
@@ -2162,6 +2231,7 @@ Tensor* Tensor::sqrt(){
 
 
 void Tensor::sqrt(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::sqrt(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(sqrt);
     
@@ -2227,6 +2297,7 @@ Tensor* Tensor::tan(){
 
 
 void Tensor::tan(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::tan(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(tan);
     
@@ -2263,6 +2334,7 @@ Tensor* Tensor::tanh(){
 
 
 void Tensor::tanh(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::tanh(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(tanh);
     
@@ -2299,6 +2371,7 @@ Tensor* Tensor::trunc(){
 
 
 void Tensor::trunc(Tensor *A, Tensor *B){
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::trunc(cs[0], cs[1]); })) return;
 
     PROFILING_HEADER_EXTERN(trunc);
     
@@ -2510,6 +2583,8 @@ void Tensor::add(float scA, Tensor *A, float scB, Tensor *B, Tensor *C, int incC
     //// or C+=(sca*A)+(scb*B) if incC is 1
     //// Dimensions and types must be compatible
     ///////////////////////////////////////
+    if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::add(scA, cs[0], scB, cs[1], cs[2], incC); })) return;
+
     int aux = 0;
 
     PROFILING_HEADER_EXTERN(add);
@@ -2589,6 +2664,7 @@ void Tensor::el_div(Tensor *A, Tensor *B, Tensor *C, int incC) {
     //// incC 1 means C+=A./B (increment over C)
     //// Dimensions must be compatible
     ///////////////////////////////////////
+    if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::el_div(cs[0], cs[1], cs[2], incC); })) return;
 
     if ((A->device != B->device) || (A->device != C->device)) msg("Tensors in different devices", "Tensor::el_div");
     if ((!sameShape(A, B)) || (!sameShape(A, C))) msg("Incompatible dims", "Tensor::el_div");
@@ -2626,6 +2702,7 @@ void Tensor::mult2D(Tensor *A, int tA, Tensor *B, int tB, Tensor *C, int incC) {
     //// Dimensions and types must be compatible
     //// Only for 2D Tensors
     ///////////////////////////////////////
+    if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::mult2D(cs[0], tA, cs[1], tB, cs[2], incC); })) return;
    
     PROFILING_HEADER_EXTERN(mult2D);
 
@@ -2676,6 +2753,7 @@ void Tensor::el_mult(Tensor *A, Tensor *B, Tensor *C, int incC) {
     //// incC 1 means C+=A.*B (increment over C)
     //// Dimensions must be compatible
     ///////////////////////////////////////
+    if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::el_mult(cs[0], cs[1], cs[2], incC); })) return;
 
     PROFILING_HEADER_EXTERN(el_mult);
 
@@ -2716,6 +2794,8 @@ void Tensor::sum2D_rowwise(Tensor *A, Tensor *B, Tensor *C) {
     //// A is 2D Tensor
     //// B is 1D Tensor
     ///////////////////////////////////////
+    if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::sum2D_rowwise(cs[0], cs[1], cs[2]); })) return;
+
     if ((A->device != B->device) || (A->device != C->device))
         msg("Tensors in different devices", "Tensor::sum2D_rowwise");
     if ((A->ndim != 2) || (B->ndim != 1) || (C->ndim != 2)) msg("sum2D_rowwise dims");
@@ -2753,6 +2833,8 @@ void Tensor::reduce_sum2D(Tensor *A, Tensor *B, int axis, int incB) {
     //// B is 1D Tensor
     //// axis is the dimension to be sumed
     ///////////////////////////////////////
+    if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ Tensor::reduce_sum2D(cs[0], cs[1], axis, incB); })) return;
+
     if (A->device != B->device) msg("Tensors in different devices", "Tensor::reduce_sum2D");
     if ((A->ndim - 1) != B->ndim) msg("Incorrect dims", "Tensor::reduce_sum2D");
     if ((A->shape[1 - axis] != B->shape[0])) msg("Incompatible dims", "Tensor::reduce_sum2D");
@@ -2787,6 +2869,8 @@ void Tensor::sum2D_colwise(Tensor *A, Tensor *B, Tensor *C) {
     //// A is 2D Tensor
     //// B is 1D Tensor
     ///////////////////////////////////////
+    if (runContiguous({A, B, C}, 1, [&](const vector<Tensor*> &cs){ Tensor::sum2D_colwise(cs[0], cs[1], cs[2]); })) return;
+
     if ((A->device != B->device) || (A->device != C->device))
         msg("Tensors in different devices", "Tensor::sum2D_colwise");
     if ((A->ndim != 2) || (B->ndim != 1) || (C->ndim != 2)) msg("sum2D_colwise dims");
@@ -87,6 +87,8 @@ int * get_reduction_map(Tensor *A, vector<int> axis)
 
 void reduce(Tensor *A, Tensor *B,string mode,vector<int> axis,int* map)
 {
+  if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ reduce(cs[0], cs[1], mode, axis, map); })) return;
+
   int i,j;
 
 
@@ -145,6 +147,7 @@ void reduce_min(Tensor *A, Tensor *B,vector<int> axis,int* map)
 
 void reduce(Tensor *A, Tensor *B,string mode,MapReduceDescriptor *MD)
 {
+  if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ reduce(cs[0], cs[1], mode, MD); })) return;
 
   PROFILING_HEADER_EXTERN(reduce);
 
@@ -187,6 +190,8 @@ void reduce_min(Tensor *A, Tensor *B,MapReduceDescriptor *MD)
 ////////////////////////////////////////////////////////
 void reduce_op(Tensor *A, Tensor *B,string op,vector<int> axis,int* map)
 {
+  if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ reduce_op(cs[0], cs[1], op, axis, map); })) return;
+
   int i,j;
 
   PROFILING_HEADER_EXTERN(reduce_op);
@@ -242,6 +247,7 @@ void reduce_div(Tensor *A, Tensor *B,vector<int> axis,int* map)
 
  void reduce_op(Tensor *A, Tensor *B,string op, MapReduceDescriptor *MD)
 {
+  if (runContiguous({A, B}, 1, [&](const vector<Tensor*> &cs){ reduce_op(cs[0], cs[1], op, MD); })) return;
 
   PROFILING_HEADER_EXTERN(reduce_op);
 
@@ -280,6 +286,8 @@ void reduce_div(Tensor *A, Tensor *B,vector<int> axis,int* map)
 
 ////////////
 void reduction(ReduceDescriptor *RD){
+    checkContiguous(RD->I, "reduction");
+    checkContiguous(RD->O, "reduction");
 
     PROFILING_HEADER_EXTERN(reduction);
 
@@ -304,6 +312,8 @@ void reduction(ReduceDescriptor *RD){
 
 void reduction_back(ReduceDescriptor *RD)
 {
+  checkContiguous(RD->D, "reduction_back");
+  checkContiguous(RD->ID, "reduction_back");
 
   PROFILING_HEADER_EXTERN(reduction_back);
 
@@ -509,6 +509,7 @@ PROFILING_ENABLE(flip_random);
 PROFILING_ENABLE(crop_random);
 PROFILING_ENABLE(crop_scale_random);
 PROFILING_ENABLE(cutout_random);
+PROFILING_ENABLE(augment_random);
 // reduction
 PROFILING_ENABLE(reduce);
 PROFILING_ENABLE(reduce_op);
@@ -580,6 +581,8 @@ PROFILING_ENABLE(permute_batch_first);
 // core_nn
 PROFILING_ENABLE(repeat_nn);
 PROFILING_ENABLE(d_repeat_nn);
+PROFILING_ENABLE(upsampling);
+PROFILING_ENABLE(d_upsampling);
 PROFILING_ENABLE(select);
 PROFILING_ENABLE(select_back);
 PROFILING_ENABLE(set_select);
@@ -592,6 +595,25 @@ PROFILING_ENABLE(MPool2D);
 PROFILING_ENABLE(MPool2D_back);
 PROFILING_ENABLE(AvgPool2D);
 PROFILING_ENABLE(AvgPool2D_back);
+// dropout
+PROFILING_ENABLE(Dropout);
+PROFILING_ENABLE(D_Dropout);
+PROFILING_ENABLE(QDense);
+PROFILING_ENABLE(QConv2D);
+PROFILING_ENABLE(LSTMCell);
+PROFILING_ENABLE(D_LSTMCell);
+PROFILING_ENABLE(GRUCell);
+PROFILING_ENABLE(D_GRUCell);
+PROFILING_ENABLE(MultiHeadAttention);
+PROFILING_ENABLE(D_MultiHeadAttention);
+// embeddings and sparse updates
+PROFILING_ENABLE(Embedding);
+PROFILING_ENABLE(Embedding_back);
+PROFILING_ENABLE(ZeroRows);
+PROFILING_ENABLE(ClampRows);
+PROFILING_ENABLE(SGD_rows);
+PROFILING_ENABLE(Adam_rows);
+PROFILING_ENABLE(RMSProp_rows);
 
 void __show_profile() {
 
@@ -673,6 +695,7 @@ void __show_profile() {
   PROFILING_PRINTF(crop_random);
   PROFILING_PRINTF(crop_scale_random);
   PROFILING_PRINTF(cutout_random);
+  PROFILING_PRINTF(augment_random);
   //reduction
   PROFILING_PRINTF(reduce);
   PROFILING_PRINTF(reduce_op);
@@ -744,6 +767,8 @@ void __show_profile() {
   // core_nn
   PROFILING_PRINTF(repeat_nn);
   PROFILING_PRINTF(d_repeat_nn);
+  PROFILING_PRINTF(upsampling);
+  PROFILING_PRINTF(d_upsampling);
   PROFILING_PRINTF(select);
   PROFILING_PRINTF(select_back);
   PROFILING_PRINTF(set_select);
@@ -756,5 +781,24 @@ void __show_profile() {
   PROFILING_PRINTF(MPool2D_back);
   PROFILING_PRINTF(AvgPool2D);
   PROFILING_PRINTF(AvgPool2D_back);
+  // dropout
+  PROFILING_PRINTF(Dropout);
+  PROFILING_PRINTF(D_Dropout);
+  PROFILING_PRINTF(QDense);
+  PROFILING_PRINTF(QConv2D);
+  PROFILING_PRINTF(LSTMCell);
+  PROFILING_PRINTF(D_LSTMCell);
+  PROFILING_PRINTF(GRUCell);
+  PROFILING_PRINTF(D_GRUCell);
+  PROFILING_PRINTF(MultiHeadAttention);
+  PROFILING_PRINTF(D_MultiHeadAttention);
+  // embeddings and sparse updates
+  PROFILING_PRINTF(Embedding);
+  PROFILING_PRINTF(Embedding_back);
+  PROFILING_PRINTF(ZeroRows);
+  PROFILING_PRINTF(ClampRows);
+  PROFILING_PRINTF(SGD_rows);
+  PROFILING_PRINTF(Adam_rows);
+  PROFILING_PRINTF(RMSProp_rows);
 
 }
\ No newline at end of file
@@ -1,7 +1,12 @@
 #include <gtest/gtest.h>
 #include <string>
+#include <algorithm>
 
 #include "eddl/descriptors/descriptors.h"
+#include "eddl/layers/core/layer_core.h"
+#include "eddl/layers/conv/layer_conv.h"
+#include "eddl/tensor/tensor.h"
+#include "eddl/tensor/nn/tensor_nn.h"
 
 
 using namespace std;
@@ -43,3 +48,263 @@ TEST(Convol2DTestSuite, output_size)
         }
     }
 }
+
+
+// The layer owns what build() allocates, a bare descriptor has to free it
+static void delete_descriptor(ConvolDescriptor *cd){
+    delete cd->O; delete cd->K; delete cd->bias; delete cd->gK; delete cd->gbias;
+    delete[] cd->ptrI;
+    delete cd;
+}
+
+// Copies n channels of a 4D tensor, starting at channel a of A and channel b of B
+static void copy_channels(Tensor *A, int a, Tensor *B, int b, int n){
+    int plane = A->shape[2] * A->shape[3];
+    for (int i = 0; i < A->shape[0]; i++)
+        for (int z = 0; z < n; z++)
+            for (int j = 0; j < plane; j++)
+                B->ptr[((i * B->shape[1]) + b + z) * plane + j] = A->ptr[((i * A->shape[1]) + a + z) * plane + j];
+}
+
+TEST(Convol2DTestSuite, grouped_and_depthwise)
+{
+    int batch = 2, iz = 4, nk = 8;
+
+    // groups=2 => lowering per group, groups=4 => depthwise kernel (channel multiplier 2)
+    for (int groups : {2, 4}) {
+        for (int st : {1, 2}) {
+            int izg = iz / groups, nkg = nk / groups;
+
+            Tensor *I = Tensor::randn({batch, iz, 7, 7});
+            auto *cd = new ConvolDescriptor(nk, {3, 3}, {st, st}, "same", true, 0, groups);
+            cd->build(I);
+            ASSERT_EQ(cd->depthwise, groups == iz);
+            ASSERT_EQ(cd->K->shape[1], izg);
+
+            cd->K->fill_rand_normal_(0.0f, 1.0f);
+            cd->bias->fill_rand_normal_(0.0f, 1.0f);
+            cd->gK->fill_(0.0f); cd->gbias->fill_(0.0f);
+            cd->D = Tensor::randn(cd->O->shape);
+            cd->ID = Tensor::zeros(I->shape);
+
+            tensorNN::Conv2D(cd);
+            tensorNN::Conv2D_grad(cd);
+            tensorNN::Conv2D_back(cd);
+
+            // Reference: an independent (groups=1) convolution for each group
+            for (int g = 0; g < groups; g++) {
+                Tensor *Ig = Tensor::zeros({batch, izg, 7, 7});
+                copy_channels(I, g * izg, Ig, 0, izg);
+                auto *rd = new ConvolDescriptor(nkg, {3, 3}, {st, st}, "same", true, 0);
+                rd->build(Ig);
+                std::copy(cd->K->ptr + g * rd->K->size, cd->K->ptr + (g + 1) * rd->K->size, rd->K->ptr);
+                std::copy(cd->bias->ptr + g * nkg, cd->bias->ptr + (g + 1) * nkg, rd->bias->ptr);
+                rd->gK->fill_(0.0f); rd->gbias->fill_(0.0f);
+                rd->D = Tensor::zeros(rd->O->shape);
+                copy_channels(cd->D, g * nkg, rd->D, 0, nkg);
+                rd->ID = Tensor::zeros(Ig->shape);
+
+                tensorNN::Conv2D(rd);
+                tensorNN::Conv2D_grad(rd);
+                tensorNN::Conv2D_back(rd);
+
+                Tensor *O = Tensor::zeros(rd->O->shape);
+                copy_channels(cd->O, g * nkg, O, 0, nkg);
+                ASSERT_TRUE(Tensor::allclose(O, rd->O, 1e-4, 1e-4));
+
+                Tensor *ID = Tensor::zeros(Ig->shape);
+                copy_channels(cd->ID, g * izg, ID, 0, izg);
+                ASSERT_TRUE(Tensor::allclose(ID, rd->ID, 1e-4, 1e-4));
+
+                for (int k = 0; k < rd->gK->size; k++)
+                    ASSERT_NEAR(cd->gK->ptr[g * rd->gK->size + k], rd->gK->ptr[k], 1e-3);
+
+                delete O; delete ID; delete rd->D; delete rd->ID; delete Ig;
+                delete_descriptor(rd);
+            }
+            delete cd->D; delete cd->ID; delete I;
+            delete_descriptor(cd);
+        }
+    }
+}
+
+
+TEST(Convol2DTestSuite, dilated)
+{
+    // A 3x3 kernel with dilation 2 is a 5x5 kernel with zeros in between
+    int batch = 2, iz = 3, nk = 3;
+    for (int groups : {1, 3}) {  // lowering and depthwise
+        for (string padding : {"same", "valid"}) {
+            Tensor *I = Tensor::randn({batch, iz, 9, 8});
+
+            auto *cd = new ConvolDescriptor(nk, {3, 3}, {1, 1}, padding, false, 0, groups, {2, 2});
+            cd->build(I);
+            auto *rd = new ConvolDescriptor(nk, {5, 5}, {1, 1}, padding, false, 0, groups);
+            rd->build(I);
+            ASSERT_EQ(cd->O->shape, rd->O->shape);
+
+            cd->K->fill_rand_normal_(0.0f, 1.0f);
+            rd->K->fill_(0.0f);
+            int kz = cd->K->shape[1];
+            for (int o = 0; o < nk * kz; o++)
+                for (int ky = 0; ky < 3; ky++)
+                    for (int kx = 0; kx < 3; kx++)
+                        rd->K->ptr[o * 25 + (2 * ky) * 5 + (2 * kx)] = cd->K->ptr[o * 9 + ky * 3 + kx];
+
+            Tensor *D = Tensor::randn(cd->O->shape);
+            cd->D = rd->D = D;
+            cd->ID = Tensor::zeros(I->shape);
+            rd->ID = Tensor::zeros(I->shape);
+            cd->gK->fill_(0.0f);
+            rd->gK->fill_(0.0f);
+
+            for (auto d : {cd, rd}) {
+                tensorNN::Conv2D(d);
+                tensorNN::Conv2D_grad(d);
+                tensorNN::Conv2D_back(d);
+            }
+
+            ASSERT_TRUE(Tensor::allclose(cd->O, rd->O, 1e-4, 1e-4));
+            ASSERT_TRUE(Tensor::allclose(cd->ID, rd->ID, 1e-4, 1e-4));
+            for (int o = 0; o < nk * kz; o++)
+                for (int ky = 0; ky < 3; ky++)
+                    for (int kx = 0; kx < 3; kx++)
+                        ASSERT_NEAR(cd->gK->ptr[o * 9 + ky * 3 + kx], rd->gK->ptr[o * 25 + (2 * ky) * 5 + (2 * kx)], 1e-3);
+
+            delete D; delete cd->ID; delete rd->ID; delete I;
+            delete_descriptor(cd); delete_descriptor(rd);
+        }
+    }
+}
+
+
+TEST(Convol2DTestSuite, transposed)
+{
+    // Against a direct scatter of every input pixel over the output
+    struct Config { string padding; vector<int> stride, dilation, output_padding; vector<int> shape; };
+    vector<Config> configs = {
+            {"valid", {2, 2}, {1, 1}, {1, 0}, {2, 3, 4, 5, 4, 5}},
+            {"same", {2, 2}, {1, 1}, {0, 0}, {2, 3, 4, 5, 8, 10}},
+            {"valid", {1, 2}, {2, 1}, {0, 1}, {2, 3, 4, 5, 8, 12}},
+    };
+    int nk = 4;
+    for (auto &cfg : configs) {
+        int batch = cfg.shape[0], iz = cfg.shape[1], ir = cfg.shape[2], ic = cfg.shape[3];
+        auto *in = new LInput(new Tensor({batch, iz, ir, ic}), "in", DEV_CPU, 0);
+        auto *l = new LConvT(in, nk, {3, 3}, cfg.output_padding, cfg.padding, cfg.dilation, cfg.stride, true, "", DEV_CPU, 0);
+        ConvolDescriptor *cd = l->cd;
+        int r = l->output->shape[2], c = l->output->shape[3];
+        if (cfg.padding == "valid") {
+            ASSERT_EQ(r, (ir - 1) * cfg.stride[0] + 2 * cfg.dilation[0] + 1 + cfg.output_padding[0]);
+            ASSERT_EQ(c, (ic - 1) * cfg.stride[1] + 2 * cfg.dilation[1] + 1 + cfg.output_padding[1]);
+        } else {
+            ASSERT_EQ(r, ir * cfg.stride[0]);
+            ASSERT_EQ(c, ic * cfg.stride[1]);
+        }
+
+        in->output->fill_rand_normal_(0.0f, 1.0f);
+        cd->K->fill_rand_normal_(0.0f, 1.0f);
+        l->bias->fill_rand_normal_(0.0f, 1.0f);
+        l->forward();
+
+        l->delta = Tensor::randn(l->output->shape);
+        in->delta = Tensor::zeros(in->output->shape);
+        cd->gK->fill_(0.0f);
+        l->gbias->fill_(0.0f);
+        l->backward();
+
+        Tensor *X = in->output, *dY = l->delta;
+        Tensor *Y = Tensor::zeros(l->output->shape);
+        Tensor *dX = Tensor::zeros(X->shape);
+        Tensor *gK = Tensor::zeros(cd->K->shape);
+        Tensor *gb = Tensor::zeros({nk});
+        for (int b = 0; b < batch; b++)
+            for (int o = 0; o < nk; o++)
+                for (int p = 0; p < r * c; p++) {
+                    Y->ptr[(b * nk + o) * r * c + p] = l->bias->ptr[o];
+                    gb->ptr[o] += dY->ptr[(b * nk + o) * r * c + p];
+                }
+        for (int b = 0; b < batch; b++)
+            for (int z = 0; z < iz; z++)
+                for (int i = 0; i < ir; i++)
+                    for (int j = 0; j < ic; j++)
+                        for (int o = 0; o < nk; o++)
+                            for (int ky = 0; ky < 3; ky++)
+                                for (int kx = 0; kx < 3; kx++) {
+                                    int y = i * cfg.stride[0] - cd->padrt + ky * cfg.dilation[0];
+                                    int x = j * cfg.stride[1] - cd->padcl + kx * cfg.dilation[1];
+                                    if (y < 0 || y >= r || x < 0 || x >= c) continue;
+                                    int xi = ((b * iz + z) * ir + i) * ic + j;
+                                    int yi = ((b * nk + o) * r + y) * c + x;
+                                    int ki = ((z * nk + o) * 3 + ky) * 3 + kx;
+                                    Y->ptr[yi] += X->ptr[xi] * cd->K->ptr[ki];
+                                    dX->ptr[xi] += dY->ptr[yi] * cd->K->ptr[ki];
+                                    gK->ptr[ki] += dY->ptr[yi] * X->ptr[xi];
+                                }
+
+        ASSERT_TRUE(Tensor::allclose(l->output, Y, 1e-4, 1e-4));
+        ASSERT_TRUE(Tensor::allclose(in->delta, dX, 1e-4, 1e-4));
+        ASSERT_TRUE(Tensor::allclose(cd->gK, gK, 1e-3, 1e-3));
+        ASSERT_TRUE(Tensor::allclose(l->gbias, gb, 1e-3, 1e-3));
+
+        delete Y; delete dX; delete gK; delete gb;
+        delete l; delete in;
+    }
+}
+
+
+TEST(Convol2DTestSuite, direct_conv1D)
+{
+    // {batch, channels, length, 1} runs the direct kernel; the same data laid out as
+    // {batch, channels, 1, length} is lowered. The filters have the same memory layout.
+    int batch = 2, iz = 4, len = 13, nk = 6;
+    for (int groups : {1, 2}) {
+        for (string padding : {"causal", "same", "valid"}) {
+            for (int s : {1, 2}) {
+                Tensor *I = Tensor::randn({batch, iz, len, 1});
+                Tensor *IT = new Tensor({batch, iz, 1, len}, I->ptr, DEV_CPU);
+
+                auto *cd = new ConvolDescriptor(nk, {3, 1}, {s, 1}, padding, true, 0, groups, {2, 1});
+                cd->build(I);
+                auto *rd = new ConvolDescriptor(nk, {1, 3}, {1, s}, padding, true, 0, groups, {1, 2});
+                rd->build(IT);
+                ASSERT_TRUE(cd->direct);
+                ASSERT_FALSE(rd->direct);
+                ASSERT_EQ(cd->O->size, rd->O->size);
+
+                cd->K->fill_rand_normal_(0.0f, 1.0f);
+                cd->bias->fill_rand_normal_(0.0f, 1.0f);
+                Tensor::copy(cd->bias, rd->bias);
+                std::copy(cd->K->ptr, cd->K->ptr + cd->K->size, rd->K->ptr);
+
+                Tensor *D = Tensor::randn(cd->O->shape);
+                cd->D = D;
+                rd->D = new Tensor(rd->O->shape, D->ptr, DEV_CPU);
+                cd->ID = Tensor::zeros(I->shape);
+                rd->ID = Tensor::zeros(IT->shape);
+                for (auto d : {cd, rd}) {
+                    d->gK->fill_(0.0f);
+                    d->gbias->fill_(0.0f);
+                    tensorNN::Conv2D(d);
+                    tensorNN::Conv2D_grad(d);
+                    tensorNN::Conv2D_back(d);
+                }
+
+                for (int i = 0; i < cd->O->size; i++) ASSERT_NEAR(cd->O->ptr[i], rd->O->ptr[i], 1e-4);
+                for (int i = 0; i < I->size; i++) ASSERT_NEAR(cd->ID->ptr[i], rd->ID->ptr[i], 1e-4);
+                for (int i = 0; i < cd->gK->size; i++) ASSERT_NEAR(cd->gK->ptr[i], rd->gK->ptr[i], 1e-3);
+                ASSERT_TRUE(Tensor::allclose(cd->gbias, rd->gbias, 1e-4, 1e-4));
+
+                // Causal: all the padding goes before the sequence
+                if (padding == "causal") {
+                    ASSERT_EQ(cd->O->shape[2], (len + s - 1) / s);
+                    ASSERT_EQ(cd->padrt, 4);
+                    ASSERT_EQ(cd->padrb, 0);
+                }
+
+                delete rd->D; delete cd->ID; delete rd->ID; delete D; delete IT; delete I;
+                delete_descriptor(cd); delete_descriptor(rd);
+            }
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "eddl/apis/eddl.h"
+
+#include "eddl/tensor/tensor.h"
+#include "eddl/tensor/nn/tensor_nn.h"
+
+
+using namespace eddl;
+
+TEST(AttentionTestSuite, self_attention){
+    int n = 3, steps = 10, dim = 8, heads = 2;
+    layer in = Input({steps, dim});
+    layer l = MultiHeadAttention({in}, heads, true);
+    model net = Model({in}, {Reshape(l, {-1})});
+    build(net, sgd(0.1f), {"mse"}, {"mse"}, CS_CPU());
+
+    Tensor* x = Tensor::randn({n, steps, dim});
+    Tensor* y = Tensor::randn({n, steps * dim});
+    forward(net, {x});
+    Tensor* o = Tensor::empty({n, steps, dim});
+    Tensor* lse = Tensor::empty({n, heads, steps});
+    tensorNN::MultiHeadAttention(x, x, x, o, lse, heads, true);
+    ASSERT_TRUE(Tensor::equivalent(o, l->output, 1e-6f, 1e-5f));
+
+    // The same parent receives the deltas of the queries, keys and values
+    backward(net, {y});
+    Tensor* dx = Tensor::zeros(x->shape);
+    tensorNN::D_MultiHeadAttention(x, x, x, o, lse, l->delta, dx, dx, dx, heads, true);
+    ASSERT_TRUE(Tensor::equivalent(dx, in->delta, 1e-6f, 1e-5f));
+
+    delete x; delete y; delete o; delete lse; delete dx;
+    delete net;
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "eddl/apis/eddl.h"
+
+#include "eddl/tensor/tensor.h"
+
+
+using namespace eddl;
+
+TEST(ConcatTestSuite, concat_views){
+    auto densenet = [] {
+        layer in = Input({3, 8, 8});
+        layer a = ReLu(Conv(in, 4, {3, 3}), "a");
+        layer b = Conv(a, 4, {3, 3}, {1, 1}, "same", true, 1, {1, 1}, "b");
+        layer c1 = Concat({a, b}, 1, "c1");
+        layer d = Conv(c1, 4, {3, 3}, {1, 1}, "same", true, 1, {1, 1}, "d");
+        layer c2 = Concat({c1, d}, 1, "c2");
+        layer out = Softmax(Dense(Reshape(c2, {-1}), 10));
+        return Model({in}, {out});
+    };
+    model net = densenet();
+    model net2 = densenet();
+    build(net, sgd(0.01f), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU());
+    build(net2, sgd(0.01f), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU());
+    set_parameters(net2, get_parameters(net));
+
+    // Batch 1 writes in place. With batch 2 (the same sample twice) the slices are strided: the
+    // convolutions and c1 still write in place, the ReLu is copied
+    Tensor* x = Tensor::randn({1, 3, 8, 8});
+    Tensor* y = Tensor::zeros({1, 10});
+    y->ptr[3] = 1.0f;
+    Tensor* x2 = Tensor::concat({x, x});
+    Tensor* y2 = Tensor::concat({y, y});
+
+    zeroGrads(net);
+    forward(net, {x});
+    backward(net, {y});
+    zeroGrads(net2);
+    forward(net2, {x2});
+    backward(net2, {y2});
+
+    Layer *a = net->getLayer("a"), *b = net->getLayer("b"), *c1 = net->getLayer("c1"), *c2 = net->getLayer("c2");
+    ASSERT_EQ(c1->output->ptr, c2->output->ptr);
+    ASSERT_EQ(a->output->ptr, c1->output->ptr);
+    ASSERT_EQ(b->output->ptr, c1->output->ptr + a->output->size);
+    ASSERT_EQ(b->delta->ptr, c1->delta->ptr + a->output->size);
+    ASSERT_NE(a->delta->ptr, c1->delta->ptr);  // two children
+    Layer *a2 = net2->getLayer("a"), *b2 = net2->getLayer("b"), *c12 = net2->getLayer("c1"), *c22 = net2->getLayer("c2");
+    Layer *d2 = net2->getLayer("d");
+    int plane = 8 * 8;
+    ASSERT_EQ(c12->output->ptr, c22->output->ptr);
+    ASSERT_NE(a2->output->ptr, c12->output->ptr);
+    ASSERT_EQ(b2->output->ptr, c12->output->ptr + 4 * plane);
+    ASSERT_EQ(b2->output->stride[0], 12 * plane);
+    ASSERT_EQ(b2->delta->ptr, c12->delta->ptr + 4 * plane);
+    ASSERT_EQ(d2->output->ptr, c22->output->ptr + 8 * plane);
+    ASSERT_EQ(d2->delta->ptr, c22->delta->ptr + 8 * plane);
+
+    Tensor *o2 = net2->lout[0]->output->select({"0"});
+    ASSERT_TRUE(Tensor::equivalent(net->lout[0]->output, o2, 1e-5f));
+    // The loss adds the gradients of both copies
+    for (int i = 0; i < net->layers.size(); i++)
+        for (int j = 0; j < net->layers[i]->gradients.size(); j++) {
+            Tensor *g = net->layers[i]->gradients[j]->clone();
+            g->mult_(2.0f);
+            ASSERT_TRUE(Tensor::equivalent(g, net2->layers[i]->gradients[j], 1e-4f));
+            delete g;
+        }
+
+    delete o2;
+    delete x; delete y; delete x2; delete y2;
+    delete net; delete net2;
+}
@@ -306,4 +306,35 @@ TEST(MaxPoolTestSuite, mpool_k2x2_s2x2_pad_valid_gpu)
     Tensor *pd_gpu_ID = pd_gpu->ID->clone(); pd_gpu_ID->toCPU(); // Tensor::equivalent is only for CPU (at the moment)
     ASSERT_TRUE((bool) Tensor::equivalent(pd_cpu->ID, pd_gpu_ID, 10e-5f));
 }
-#endif
\ No newline at end of file
+#endif
+
+TEST(MaxPoolTestSuite, mpool1D_k3_s1_pad_causal)
+{
+    // Sequence {batch, channels, length, 1}
+    auto *ptr_seq = new float[6]{1, -3, 2, 5, -1, 0};
+    auto* t_seq = new Tensor({1, 1, 6, 1}, ptr_seq, DEV_CPU);
+
+    // Forward: every output only sees the current and the two previous elements
+    auto *ptr_fwrd = new float[6]{1, 1, 2, 5, 5, 5};
+    auto* t_fwrd = new Tensor({1, 1, 6, 1}, ptr_fwrd, DEV_CPU);
+
+    // backward
+    auto *ptr_bwrd = new float[6]{2, 0, 1, 3, 0, 0};
+    auto* t_bwrd = new Tensor({1, 1, 6, 1}, ptr_bwrd, DEV_CPU);
+
+    // Operation
+    auto *pd = new PoolDescriptor({3, 1}, {1, 1}, "causal");
+    pd->build(t_seq);
+    pd->ID = Tensor::zeros(pd->I->getShape());
+    pd->D = Tensor::ones(pd->O->getShape());
+    pd->indX = new Tensor(pd->O->getShape());
+    pd->indY = new Tensor(pd->O->getShape());
+
+    // Forward
+    tensorNN::MPool2D(pd);
+    ASSERT_TRUE((bool) Tensor::equivalent(t_fwrd, pd->O, 10e-5f));
+
+    // Backward
+    tensorNN::MPool2D_back(pd);
+    ASSERT_TRUE((bool) Tensor::equivalent(t_bwrd, pd->ID, 10e-5f));
+}
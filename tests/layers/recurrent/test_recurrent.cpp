@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <cmath>
+
+#include "eddl/apis/eddl.h"
+
+#include "eddl/tensor/tensor.h"
+
+
+using namespace eddl;
+
+// Packs the gate weights of an unrolled LSTM as the columns of a sequence-level one
+static void pack_lstm_gates(vector<Tensor*> gates, Tensor* packed){
+    int u = gates[0]->shape[gates[0]->ndim - 1];
+    int r = gates[0]->size / u;
+    for (int g = 0; g < 4; g++)
+        for (int i = 0; i < r; i++)
+            for (int j = 0; j < u; j++) packed->ptr[i * 4 * u + g * u + j] = gates[g]->ptr[i * u + j];
+}
+
+TEST(RecurrentTestSuite, lstm_sequence){
+    int n = 6, steps = 5, dim = 4, units = 8;
+
+    layer in1 = Input({dim});
+    layer l1 = LSTM(in1, units);
+    layer out1 = Dense(l1, 3);
+    model unrolled = Model({in1}, {out1});
+    build(unrolled, sgd(0.1f), {"mse"}, {"mse"}, CS_CPU());
+
+    layer in2 = Input({steps, dim});
+    layer l2 = LSTMSequence(in2, units);
+    layer out2 = Dense(l2, 3);
+    model seq = Model({in2}, {out2});
+    build(seq, sgd(0.1f), {"mse"}, {"mse"}, CS_CPU());
+
+    // Same weights
+    auto* a = (LLSTM*)l1;
+    auto* b = (LRecurrentSeq*)l2;
+    pack_lstm_gates({a->Wix, a->Wfx, a->Wox, a->Wcx}, b->Wx[0]);
+    pack_lstm_gates({a->Wih, a->Wfh, a->Woh, a->Wch}, b->Wh[0]);
+    pack_lstm_gates({a->inbias, a->fnbias, a->onbias, a->cnbias}, b->bias[0]);
+    for (int i = 0; i < out1->params.size(); i++) Tensor::copy(out1->params[i], out2->params[i]);
+
+    Tensor* x = Tensor::randn({n, steps, dim});
+    Tensor* y = Tensor::randn({n, 3});
+    evaluate(unrolled, {x}, {y}, n);
+    evaluate(seq, {x}, {y}, n);
+    ASSERT_TRUE(Tensor::equivalent(unrolled->rnet->lout[0]->output, out2->output, 1e-5f, 1e-4f));
+
+    // Same update (and the same random batch): the gradients of all the timesteps
+    srand(1);
+    fit(unrolled, {x}, {y}, n, 1);
+    srand(1);
+    fit(seq, {x}, {y}, n, 1);
+    Tensor* w = Tensor::empty(b->Wx[0]->shape);
+    pack_lstm_gates({a->Wix, a->Wfx, a->Wox, a->Wcx}, w);
+    ASSERT_TRUE(Tensor::equivalent(w, b->Wx[0], 1e-5f, 1e-4f));
+    delete w;
+    w = Tensor::empty(b->Wh[0]->shape);
+    pack_lstm_gates({a->Wih, a->Wfh, a->Woh, a->Wch}, w);
+    ASSERT_TRUE(Tensor::equivalent(w, b->Wh[0], 1e-5f, 1e-4f));
+    delete w;
+
+    // Stacked layers with the outputs of every timestep
+    layer in3 = Input({steps, dim});
+    layer l3 = RNNSequence(LSTMSequence(in3, units, 2, true), units, 1, "tanh", true);
+    model stacked = Model({in3}, {Reshape(l3, {-1})});
+    build(stacked, sgd(0.1f), {"mse"}, {"mse"}, CS_CPU());
+    ASSERT_EQ(l3->output->shape, vector<int>({1, steps, units}));
+    Tensor* z = Tensor::randn({n, steps * units});
+    fit(stacked, {x}, {z}, 3, 2);
+    ASSERT_TRUE(std::isfinite(get_losses(stacked)[0]));
+
+    delete x; delete y; delete z;
+    delete unrolled; delete seq; delete stacked;
+}
+
+TEST(RecurrentTestSuite, lstm_sequence_packed){
+    int n = 6, steps = 5, dim = 4, units = 8;
+    vector<int> lengths = {5, 2, 4, 1, 3, 5};
+
+    layer in1 = Input({dim});
+    layer l1 = LSTM(in1, units, true);
+    layer out1 = Dense(l1, 3);
+    model unrolled = Model({in1}, {out1});
+    build(unrolled, sgd(0.1f), {"mse"}, {"mse"}, CS_CPU());
+
+    layer in2 = Input({steps, dim});
+    layer l2 = LSTMSequence(in2, units, 1, false, true);
+    layer out2 = Dense(l2, 3);
+    model seq = Model({in2}, {out2});
+    build(seq, sgd(0.1f), {"mse"}, {"mse"}, CS_CPU());
+
+    auto* a = (LLSTM*)l1;
+    auto* b = (LRecurrentSeq*)l2;
+    pack_lstm_gates({a->Wix, a->Wfx, a->Wox, a->Wcx}, b->Wx[0]);
+    pack_lstm_gates({a->Wih, a->Wfh, a->Woh, a->Wch}, b->Wh[0]);
+    pack_lstm_gates({a->inbias, a->fnbias, a->onbias, a->cnbias}, b->bias[0]);
+    for (int i = 0; i < out1->params.size(); i++) Tensor::copy(out1->params[i], out2->params[i]);
+
+    // Padded with zeros at the end
+    Tensor* x = Tensor::randn({n, steps, dim});
+    for (int s = 0; s < n; s++)
+        for (int t = lengths[s]; t < steps; t++)
+            for (int d = 0; d < dim; d++) x->ptr[(s * steps + t) * dim + d] = 0.0f;
+    Tensor* y = Tensor::randn({n, 3});
+
+    // The masked timesteps keep the state of the last timestep of each sequence
+    evaluate(unrolled, {x}, {y}, n);
+    evaluate(seq, {x}, {y}, n);
+    ASSERT_EQ(b->npacked, 20);
+    ASSERT_EQ(b->active, vector<int>({6, 5, 4, 3, 2}));
+    ASSERT_TRUE(Tensor::equivalent(unrolled->rnet->lout[0]->output, out2->output, 1e-5f, 1e-4f));
+
+    // Same gradients as each sequence alone, without its padding
+    zeroGrads(seq);
+    forward(seq, {x});
+    backward(seq, {y});
+    vector<Tensor*> expected;
+    for (auto g : l2->gradients) expected.push_back(Tensor::zeros(g->shape));
+    for (int s = 0; s < n; s++) {
+        layer ins = Input({lengths[s], dim});
+        layer ls = LSTMSequence(ins, units);
+        model one = Model({ins}, {Dense(ls, 3)});
+        build(one, sgd(0.1f), {"mse"}, {"mse"}, CS_CPU());
+        for (int i = 0; i < one->layers.size(); i++)
+            for (int j = 0; j < one->layers[i]->params.size(); j++) Tensor::copy(seq->layers[i]->params[j], one->layers[i]->params[j]);
+
+        Tensor* xs = Tensor::zeros({1, lengths[s], dim});
+        Tensor* ys = Tensor::zeros({1, 3});
+        std::copy(x->ptr + s * steps * dim, x->ptr + (s * steps + lengths[s]) * dim, xs->ptr);
+        std::copy(y->ptr + s * 3, y->ptr + (s + 1) * 3, ys->ptr);
+        zeroGrads(one);
+        forward(one, {xs});
+        backward(one, {ys});
+        for (int i = 0; i < expected.size(); i++) Tensor::add(1.0f, expected[i], 1.0f / n, ls->gradients[i], expected[i], 0);
+
+        delete xs; delete ys;
+        delete one;
+    }
+    for (int i = 0; i < expected.size(); i++) {
+        ASSERT_TRUE(Tensor::equivalent(expected[i], l2->gradients[i], 1e-5f, 1e-4f));
+        delete expected[i];
+    }
+
+    // Outputs of every timestep: zeros in the padding
+    layer in3 = Input({steps, dim});
+    layer l3 = RNNSequence(in3, units, 2, "tanh", true, true);
+    model all = Model({in3}, {Reshape(l3, {-1})});
+    build(all, sgd(0.1f), {"mse"}, {"mse"}, CS_CPU());
+    Tensor* z = Tensor::randn({n, steps * units});
+    fit(all, {x}, {z}, n, 2);
+    forward(all, {x});
+    for (int s = 0; s < n; s++)
+        for (int t = 0; t < steps; t++) {
+            float sum = 0.0f;
+            for (int u = 0; u < units; u++) sum += std::fabs(l3->output->ptr[(s * steps + t) * units + u]);
+            ASSERT_EQ(sum == 0.0f, t >= lengths[s]);
+        }
+
+    delete x; delete y; delete z;
+    delete unrolled; delete seq; delete all;
+}
+
+TEST(RecurrentTestSuite, gru_gradients){
+    int n = 5, steps = 4, dim = 3, units = 4, outs = 2;
+    vector<int> lengths = {4, 1, 3, 4, 2};
+
+    layer in = Input({dim});
+    layer l = GRU(in, units, true);
+    layer out = Dense(l, outs);
+    model net = Model({in}, {out});
+    build(net, sgd(0.1f), {"mse"}, {"mse"}, CS_CPU());
+    auto* g = (LGRU*)l;
+    auto* d = (LDense*)out;
+    g->bias->fill_rand_normal_(0.0f, 0.5f);
+    g->rbias->fill_rand_normal_(0.0f, 0.5f);
+
+    // Padded with zeros at the end
+    Tensor* x = Tensor::randn({n, steps, dim});
+    for (int s = 0; s < n; s++)
+        for (int t = lengths[s]; t < steps; t++)
+            for (int k = 0; k < dim; k++) x->ptr[(s * steps + t) * dim + k] = 0.0f;
+    Tensor* y = Tensor::randn({n, outs});
+
+    // Reference: each sequence without its padding, z r h gates with the reset after the recurrent product
+    vector<Tensor*> ps = {g->Wx, g->Wh, g->bias, g->rbias, d->W, d->bias};
+    vector<vector<double>> p;
+    for (auto t : ps) p.emplace_back(t->ptr, t->ptr + t->size);
+    auto sig = [](double v) { return 1.0 / (1.0 + std::exp(-v)); };
+    vector<double> o(n * outs);
+    auto reference = [&]() {
+        double loss = 0.0;
+        for (int s = 0; s < n; s++) {
+            vector<double> h(units, 0.0), gx(3 * units), gh(3 * units);
+            for (int t = 0; t < lengths[s]; t++) {
+                for (int j = 0; j < 3 * units; j++) {
+                    gx[j] = p[2][j];
+                    gh[j] = p[3][j];
+                    for (int k = 0; k < dim; k++) gx[j] += x->ptr[(s * steps + t) * dim + k] * p[0][k * 3 * units + j];
+                    for (int k = 0; k < units; k++) gh[j] += h[k] * p[1][k * 3 * units + j];
+                }
+                for (int j = 0; j < units; j++) {
+                    double z = sig(gx[j] + gh[j]);
+                    double r = sig(gx[units + j] + gh[units + j]);
+                    double c = std::tanh(gx[2 * units + j] + r * gh[2 * units + j]);
+                    h[j] = (1.0 - z) * c + z * h[j];
+                }
+            }
+            for (int j = 0; j < outs; j++) {
+                o[s * outs + j] = p[5][j];
+                for (int k = 0; k < units; k++) o[s * outs + j] += h[k] * p[4][k * outs + j];
+                double e = o[s * outs + j] - y->ptr[s * outs + j];
+                loss += e * e / (2 * n);  // the mse delta is (y - t) / batch
+            }
+        }
+        return loss;
+    };
+
+    net->forward_recurrent({x});
+    reference();
+    Tensor* expected = new Tensor({n, outs});
+    for (int i = 0; i < o.size(); i++) expected->ptr[i] = (float)o[i];
+    ASSERT_TRUE(Tensor::equivalent(expected, net->rnet->lout[0]->output, 1e-5f, 1e-4f));
+
+    net->reset_grads();
+    net->backward_recurrent({y});
+    vector<Tensor*> gs = {g->gWx, g->gWh, g->gbias, g->grbias};
+    for (int i = 0; i < gs.size(); i++)
+        for (int j = 0; j < gs[i]->size; j++) {
+            double v = p[i][j], eps = 1e-5;
+            p[i][j] = v + eps;
+            double lp = reference();
+            p[i][j] = v - eps;
+            double lm = reference();
+            p[i][j] = v;
+            ASSERT_NEAR(gs[i]->ptr[j], (lp - lm) / (2 * eps), 1e-4);
+        }
+
+    delete x; delete y; delete expected;
+    delete net;
+}
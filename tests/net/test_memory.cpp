@@ -4,6 +4,9 @@
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 #include "eddl/apis/eddl.h"
 
@@ -28,6 +31,102 @@ TEST(NetTestSuite, memory_leaks_select){
     ASSERT_TRUE(true);
 }
 
+#ifdef __GLIBC__
+// Bytes allocated with malloc/new and not freed yet
+static long heap_in_use(){
+    return (long)mallinfo2().uordblks;
+}
+
+TEST(NetTestSuite, memory_leaks_shared_views){
+    Tensor* A = Tensor::zeros({64, 32});
+    long before = heap_in_use();
+    for (int i = 0; i < 10000; i++) {
+        // 2D views own an Eigen map of their data
+        auto* v = new Tensor({32, 32}, A->ptr + (i % 32) * 32, DEV_CPU);
+        v->reshape_({32 * 32});
+        v->reshape_({16, 64});
+        delete v;
+    }
+    ASSERT_LT(heap_in_use() - before, 4096);
+    delete A;
+}
+
+// Heap growth of n more runs of f, after a first one
+template<typename F>
+static long heap_growth(int n, F f){
+    f();
+    long before = heap_in_use();
+    for (int i = 0; i < n; i++) f();
+    return heap_in_use() - before;
+}
+
+TEST(NetTestSuite, memory_leaks_recurrent_seq){
+    Tensor* x = Tensor::randn({8, 20, 8});
+    Tensor* y = Tensor::randn({8, 4});
+    for (int s = 0; s < 8; s++)  // padded with zeros at the end
+        for (int t = 20 - 2 * s; t < 20; t++)
+            for (int d = 0; d < 8; d++) x->ptr[(s * 20 + t) * 8 + d] = 0.0f;
+
+    for (bool mask_zeros : {false, true}) {
+        layer in = Input({20, 8});
+        layer l = LSTMSequence(in, 16, 2, false, mask_zeros);
+        model net = Model({in}, {Dense(l, 4)});
+        build(net, sgd(0.01f), {"mse"}, {"mse"}, CS_CPU());
+
+        // Per-timestep views of the layer buffers, and the packing ones
+        ASSERT_LT(heap_growth(20, [&](){ forward(net, {x}); backward(net, {y}); }), 4096);
+        delete net;
+    }
+
+    delete x; delete y;
+}
+
+TEST(NetTestSuite, memory_leaks_batchnorm){
+    layer in = Input({32});
+    layer l = BatchNormalization(Dense(in, 16));
+    model net = Model({in}, {Dense(l, 4)});
+    build(net, sgd(0.01f), {"mse"}, {"mse"}, CS_CPU());
+    Tensor* x = Tensor::randn({8, 32});
+    Tensor* y = Tensor::randn({8, 4});
+
+    ASSERT_LT(heap_growth(20, [&](){ forward(net, {x}); backward(net, {y}); }), 4096);
+
+    delete x; delete y;
+    delete net;
+}
+
+TEST(NetTestSuite, memory_leaks_predict_evaluate){
+    layer in = Input({16});
+    model net = Model({in}, {Softmax(Dense(in, 4))});
+    build(net, sgd(0.01f), {"mse"}, {"categorical_accuracy"}, CS_CPU());
+    Tensor* x = Tensor::randn({51, 16});
+    Tensor* y = Tensor::zeros({51, 4});
+    Tensor* out = Tensor::empty({51, 4});
+
+    // Views of the batch rows, and of the valid samples of the padded last batch
+    ASSERT_LT(heap_growth(20, [&](){ predict(net, {x}, {out}, 2); }), 1024);
+    ASSERT_LT(heap_growth(50, [&](){ evaluate(net, {x}, {y}, 16); }), 1024);
+
+    delete x; delete y; delete out;
+    delete net;
+}
+
+TEST(NetTestSuite, memory_leaks_recurrent_timesteps){
+    layer in = Input({8});
+    layer l = LSTM(in, 16);
+    model net = Model({in}, {Dense(l, 4)});
+    build(net, sgd(0.01f), {"mse"}, {"mse"}, CS_CPU());
+    Tensor* x = Tensor::randn({20, 6, 8});
+    Tensor* y = Tensor::randn({20, 4});
+
+    // Timestep views of the data, made again on each call
+    ASSERT_LT(heap_growth(5, [&](){ evaluate(net, {x}, {y}, 8); }), 4096);
+
+    delete x; delete y;
+    delete net;
+}
+#endif
+
 TEST(NetTestSuite, net_delete_mnist_mlp){
     int num_classes = 10;
 
@@ -55,7 +154,6 @@ TEST(NetTestSuite, net_delete_mnist_mlp){
     ASSERT_TRUE(true);
 }
 
-
 TEST(NetTestSuite, net_delete_mnist_initializers){
     int num_classes = 10;
 
@@ -83,8 +181,6 @@ TEST(NetTestSuite, net_delete_mnist_initializers){
     ASSERT_TRUE(true);
 }
 
-
-
 TEST(NetTestSuite, net_delete_mnist_regularizers){
     int num_classes = 10;
 
@@ -181,7 +277,6 @@ TEST(NetTestSuite, net_delete_mnist_conv){
     ASSERT_TRUE(true);
 }
 
-
 TEST(NetTestSuite, net_delete_mnist_rnn){
     int num_classes = 10;
 
@@ -319,7 +414,6 @@ TEST(NetTestSuite, net_delete_mnist_siamese){
     ASSERT_TRUE(true);
 }
 
-
 // Auxiliary function for: net_delete_cifar_resnet50_da_bg
 layer BN(layer l){
     return BatchNormalization(l);
@@ -486,7 +580,6 @@ TEST(NetTestSuite, net_delete_drive_seg_concat) {
     delete segnet;
 }
 
-
 //TEST(NetTestSuite, net_delete_drive_seg_sum){
 //
 //    // Build SegNet
@@ -503,8 +596,6 @@ TEST(NetTestSuite, net_delete_drive_seg_concat) {
 //    delete segnet;
 //}
 
-
-
 TEST(NetTestSuite, net_delete_nlp_sentiment_rnn){
     // ERROR => malloc_consolidate(): invalid chunk size
     int embdim=32;
@@ -536,7 +627,6 @@ TEST(NetTestSuite, net_delete_nlp_sentiment_rnn){
     delete net;
 }
 
-
 TEST(NetTestSuite, net_delete_nlp_sentiment_lstm){
     // ERROR => malloc_consolidate(): invalid chunk size
     int embdim=32;
@@ -567,7 +657,6 @@ TEST(NetTestSuite, net_delete_nlp_sentiment_lstm){
     delete net;
 }
 
-
 TEST(NetTestSuite, net_delete_nlp_machine_translation){
     // ERROR => malloc_consolidate(): invalid chunk size
     int invs=687;
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "eddl/apis/eddl.h"
+
+#include "eddl/tensor/tensor.h"
+
+
+using namespace eddl;
+
+static model checkpointing_resnet(){
+    layer in = Input({3, 16, 16});
+    layer l = ReLu(Conv(in, 8, {3, 3}));
+    for (int i = 0; i < 3; i++) {
+        layer b = ReLu(BatchNormalization(Conv(l, 8, {3, 3})));
+        b = Conv(b, 8, {3, 3});
+        l = ReLu(Add(l, b));
+    }
+    l = Reshape(l, {-1});
+    layer out = Softmax(Dense(l, 10));
+    return Model({in}, {out});
+}
+
+TEST(NetTestSuite, net_checkpointing_gradients){
+    model net = checkpointing_resnet();
+    model net_ck = checkpointing_resnet();
+    build(net, sgd(0.01f), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU());
+    build(net_ck, sgd(0.01f), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU());
+    set_parameters(net_ck, get_parameters(net));
+    set_checkpointing(net_ck, 4);
+    ASSERT_GT(net_ck->checkpointed_bytes(), 0);
+
+    Tensor* x = Tensor::randn({4, 3, 16, 16});
+    Tensor* y = Tensor::zeros({4, 10});
+    for (int b = 0; b < 4; b++) y->ptr[b * 10 + b] = 1.0f;
+
+    for (model m : {net, net_ck}) {
+        zeroGrads(m);
+        forward(m, {x});
+        backward(m, {y});
+    }
+
+    // Same gradients, and the outputs inside the segments were freed again by the backward
+    int freed = 0;
+    for (int i = 0; i < net->vfts.size(); i++) {
+        Layer *l = net->vfts[i], *l_ck = net_ck->vfts[i];
+        for (int j = 0; j < l->gradients.size(); j++)
+            ASSERT_TRUE(Tensor::equivalent(l->gradients[j], l_ck->gradients[j], 1e-4f));
+        if (l_ck->output->ptr == nullptr) freed++;
+    }
+    ASSERT_GT(freed, 0);
+
+    // Back to regular forwards
+    set_checkpointing(net_ck, -1);
+    forward(net_ck, {x});
+    ASSERT_TRUE(Tensor::equivalent(net->lout[0]->output, net_ck->lout[0]->output, 1e-4f));
+
+    delete x; delete y;
+    delete net; delete net_ck;
+}
+
+TEST(NetTestSuite, net_checkpointing_frozen){
+    model net = checkpointing_resnet();
+    build(net, sgd(0.01f), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU());
+    set_checkpointing(net, 4);
+
+    // The backward stops at the first frozen layer, in the middle of a segment
+    Layer *frozen = nullptr;
+    for (int i = 0; i < net->vfts.size(); i++)
+        if ((i % 4 == 1) && (i > net->vfts.size() / 2) && (frozen == nullptr)) frozen = net->vfts[i];
+    ASSERT_NE(frozen, nullptr);
+    setTrainable(net, frozen->name, false);
+
+    Tensor* x = Tensor::randn({4, 3, 16, 16});
+    Tensor* y = Tensor::zeros({4, 10});
+    for (int b = 0; b < 4; b++) y->ptr[b * 10 + b] = 1.0f;
+    zeroGrads(net);
+    forward(net, {x});
+    backward(net, {y});
+
+    // The segments recomputed by the backward are freed again, the partial one included
+    for (int i = 0; i < net->vfts.size(); i++)
+        if (net->ck_free[i]) ASSERT_EQ(net->vfts[i]->output->ptr, nullptr) << net->vfts[i]->name;
+
+    delete x; delete y;
+    delete net;
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "eddl/apis/eddl.h"
+
+#include "eddl/tensor/tensor.h"
+
+
+using namespace eddl;
+
+TEST(NetTestSuite, net_checkpoint_resume){
+    auto mlp = [] {
+        layer in = Input({16});
+        layer l = ReLu(Dense(in, 32));
+        layer out = Softmax(Dense(l, 4));
+        return Model({in}, {out});
+    };
+    model net = mlp();
+    model resumed = mlp();
+    build(net, adam(0.01f), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU());
+    build(resumed, adam(0.01f), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU());
+
+    Tensor* x = Tensor::randn({8, 16});
+    Tensor* y = Tensor::zeros({8, 4});
+    for (int b = 0; b < 8; b++) y->ptr[b * 4 + b % 4] = 1.0f;
+    auto step = [&](model m) {
+        zeroGrads(m);
+        forward(m, {x});
+        backward(m, {y});
+        update(m);
+    };
+
+    string fname = "net_checkpoint_resume.ckpt";
+    for (int i = 0; i < 3; i++) step(net);
+    save_checkpoint(net, fname);
+    for (int i = 0; i < 2; i++) step(net);  // while the checkpoint is written
+    wait_checkpoint(net);
+
+    // Same params and Adam moments: the next steps match
+    load_checkpoint(resumed, fname);
+    ASSERT_EQ(((Adam *)resumed->optimizer)->t, 3);
+    for (int i = 0; i < 2; i++) step(resumed);
+    for (int i = 0; i < net->layers.size(); i++)
+        for (int j = 0; j < net->layers[i]->params.size(); j++)
+            ASSERT_TRUE(Tensor::equivalent(net->layers[i]->params[j], resumed->layers[i]->params[j], 1e-6f));
+
+    // Corrupted files are rejected
+    FILE *f = fopen(fname.c_str(), "r+b");
+    fseek(f, 100, SEEK_SET);
+    fputc(0x55, f);
+    fclose(f);
+    ASSERT_THROW(load_checkpoint(resumed, fname), std::runtime_error);
+
+    std::remove(fname.c_str());
+    delete x; delete y;
+    delete net; delete resumed;
+}
+
+TEST(NetTestSuite, net_checkpoint_rejected){
+    auto mlp = [](int hidden) {
+        layer in = Input({16});
+        layer l = ReLu(Dense(in, hidden));
+        layer out = Softmax(Dense(l, 4));
+        return Model({in}, {out});
+    };
+    model net = mlp(32);
+    model other = mlp(8);
+    build(net, sgd(0.01f, 0.9f), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU());
+    build(other, sgd(0.01f, 0.9f), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU());
+
+    Tensor* x = Tensor::randn({8, 16});
+    Tensor* y = Tensor::zeros({8, 4});
+    for (int b = 0; b < 8; b++) y->ptr[b * 4 + b % 4] = 1.0f;
+    zeroGrads(net);
+    forward(net, {x});
+    backward(net, {y});
+    update(net);
+
+    // A checkpoint of another net is rejected before anything is overwritten
+    string fname = "net_checkpoint_rejected.ckpt";
+    save_checkpoint(other, fname, false);
+    vtensor before;
+    for (auto l : net->layers)
+        for (auto p : l->params) before.push_back(p->clone());
+    vtensor state = net->optimizer->get_state();
+    for (auto t : state) before.push_back(t->clone());
+    ASSERT_THROW(load_checkpoint(net, fname), std::runtime_error);
+    int k = 0;
+    for (auto l : net->layers)
+        for (auto p : l->params) ASSERT_TRUE(Tensor::equivalent(p, before[k++], 0.0f));
+    for (auto t : state) ASSERT_TRUE(Tensor::equivalent(t, before[k++], 0.0f));
+
+    // Optimizers without a persistent state can not be checkpointed
+    model stateless = mlp(32);
+    build(stateless, adagrad(0.01f, 1e-8f, 0.0f), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU());
+    ASSERT_THROW(save_checkpoint(stateless, fname, false), std::runtime_error);
+    ASSERT_THROW(load_checkpoint(stateless, fname), std::runtime_error);
+
+    std::remove(fname.c_str());
+    for (auto t : before) delete t;
+    delete x; delete y;
+    delete net; delete other; delete stateless;
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "eddl/apis/eddl.h"
+
+#include "eddl/tensor/tensor.h"
+#include "eddl/serialization/exchange/eddl_exchange.h"
+
+
+using namespace eddl;
+
+TEST(NetTestSuite, net_exchange_messages){
+    auto cnn = [] {
+        layer in = Input({3, 8, 8});
+        layer l = ReLu(BatchNormalization(Conv(in, 4, {3, 3})));
+        l = Reshape(l, {-1});
+        layer out = Softmax(Dense(l, 5));
+        return Model({in}, {out});
+    };
+    model src = cnn();
+    model dst = cnn();
+    build(src, sgd(0.01f), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU());
+    build(dst, sgd(0.01f), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU());
+    vtensor ws = exchange_tensors(src, EXCHANGE_WEIGHTS), wd = exchange_tensors(dst, EXCHANGE_WEIGHTS);
+    vtensor gs = exchange_tensors(src, EXCHANGE_GRADIENTS), gd = exchange_tensors(dst, EXCHANGE_GRADIENTS);
+    ASSERT_EQ(ws.size(), 6);  // conv K and bias, bn gamma and beta, dense W and bias
+    vector<char> buf;
+
+    // Weights, fp32: exact copy
+    ExchangeEncoder weights(src, EXCHANGE_WEIGHTS, EXCHANGE_FP32);
+    size_t n = weights.encode(buf);
+    decode_exchange(dst, buf.data(), n);
+    for (int p = 0; p < ws.size(); p++) ASSERT_TRUE(Tensor::equivalent(ws[p], wd[p], 0.0f));
+
+    // Gradients, fp16: half the size, averaged into the destination
+    for (auto g : gs) g->fill_rand_normal_(0.0f, 1.0f);
+    for (auto g : gd) g->fill_(1.0f);
+    ExchangeEncoder fp16(src, EXCHANGE_GRADIENTS, EXCHANGE_FP16);
+    size_t n16 = fp16.encode(buf);
+    ASSERT_LT(n16, n / 2 + 128);
+    decode_exchange(dst, buf.data(), n16, 0.5f, true);
+    for (int p = 0; p < gs.size(); p++)
+        for (int i = 0; i < gs[p]->size; i++)
+            ASSERT_NEAR(gd[p]->ptr[i], 1.0f + 0.5f * gs[p]->ptr[i], 2e-3f);
+
+    // Gradients, top-k: nothing is lost, what was not sent yet stays in the residuals
+    ExchangeEncoder topk(src, EXCHANGE_GRADIENTS, EXCHANGE_TOPK, 0.1f);
+    vtensor total;
+    for (auto g : gd) total.push_back(Tensor::zeros(g->shape));
+    for (int it = 0; it < 3; it++) {
+        n = topk.encode(buf);
+        decode_exchange(dst, buf.data(), n);
+        for (int p = 0; p < gd.size(); p++) total[p]->add_(gd[p]);
+    }
+    for (int p = 0; p < gs.size(); p++)
+        for (int i = 0; i < gs[p]->size; i++)
+            ASSERT_NEAR(total[p]->ptr[i] + topk.feedback[p][i], 3.0f * gs[p]->ptr[i], 1e-4f);
+
+    for (auto t : total) delete t;
+    delete src; delete dst;
+}
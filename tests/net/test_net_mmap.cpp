@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "eddl/apis/eddl.h"
+
+#include "eddl/tensor/tensor.h"
+
+
+using namespace eddl;
+
+TEST(NetTestSuite, net_load_mmap){
+    auto cnn = [] {
+        layer in = Input({3, 8, 8});
+        layer l = ReLu(BatchNormalization(Conv(in, 4, {3, 3})));
+        l = Reshape(l, {-1});
+        layer out = Softmax(Dense(l, 5));
+        return Model({in}, {out});
+    };
+    model net = cnn();
+    model mapped = cnn();
+    build(net, sgd(0.01f), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU());
+    build(mapped, sgd(0.01f), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU());
+
+    // bin -> container
+    save(net, "net_load_mmap.bin");
+    convert_weights_to_mmap(net, "net_load_mmap.bin", "net_load_mmap.eddlw");
+
+    // The params point into the mapping, and give the same outputs
+    load(mapped, "net_load_mmap.eddlw");
+    ASSERT_TRUE(mapped->mmap_base != nullptr);
+    for (int i = 0; i < net->layers.size(); i++)
+        for (int j = 0; j < net->layers[i]->params.size(); j++) {
+            Tensor *p = mapped->layers[i]->params[j];
+            ASSERT_TRUE(p->isshared);
+            ASSERT_EQ(((size_t)p->ptr) % 64, 0);
+            ASSERT_TRUE(Tensor::equivalent(net->layers[i]->params[j], p, 0.0f));
+        }
+
+    Tensor* x = Tensor::randn({2, 3, 8, 8});
+    set_mode(net, TSMODE); set_mode(mapped, TSMODE);
+    forward(net, {x});
+    forward(mapped, {x});
+    ASSERT_TRUE(Tensor::equivalent(net->lout[0]->output, mapped->lout[0]->output, 1e-6f));
+
+    std::remove("net_load_mmap.bin");
+    std::remove("net_load_mmap.eddlw");
+    delete x;
+    delete net; delete mapped;
+}
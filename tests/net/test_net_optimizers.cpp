@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "eddl/apis/eddl.h"
+
+#include "eddl/tensor/tensor.h"
+
+
+using namespace eddl;
+
+// Embedding output {2 x 3}, trained towards zero with SGD and momentum
+static model embedding_net(layer &e, bool sparse_rows){
+    layer in = Input({2});
+    e = Embedding(in, 6, 2, 3);
+    model net = Model({in}, {e});
+    optimizer opt = sgd(0.1f, 0.9f);
+    opt->set_sparse_rows(sparse_rows);
+    build(net, opt, {"mse"}, {"mse"}, CS_CPU());
+    return net;
+}
+
+TEST(NetTestSuite, net_optimizer_sparse_rows_sgd){
+    layer e_dense, e_rows;
+    model dense = embedding_net(e_dense, false);
+    model rows = embedding_net(e_rows, true);
+    Tensor::copy(e_dense->params[0], e_rows->params[0]);
+
+    Tensor* x12 = new Tensor({1.0f, 2.0f}, {1, 2});
+    Tensor* x33 = new Tensor({3.0f, 3.0f}, {1, 2});
+    Tensor* y = Tensor::zeros({1, 6});
+
+    // The same rows at every step: the lazy update is the dense one
+    for (int i = 0; i < 3; i++) {
+        train_batch(dense, {x12}, {y});
+        train_batch(rows, {x12}, {y});
+    }
+    for (int i = 0; i < 18; i++)
+        ASSERT_NEAR(e_rows->params[0]->ptr[i], e_dense->params[0]->ptr[i], 1e-6);
+
+    // Rows 1 and 2 absent: the dense update still applies their momentum, the lazy one skips them
+    Tensor* before = e_dense->params[0]->clone();
+    train_batch(dense, {x33}, {y});
+    train_batch(rows, {x33}, {y});
+    for (int r = 0; r < 6; r++)
+        for (int j = 0; j < 3; j++) {
+            int i = r * 3 + j;
+            if ((r == 1) || (r == 2)) {
+                ASSERT_FLOAT_EQ(e_rows->params[0]->ptr[i], before->ptr[i]);
+                ASSERT_NE(e_dense->params[0]->ptr[i], before->ptr[i]);
+            }
+            else ASSERT_NEAR(e_rows->params[0]->ptr[i], e_dense->params[0]->ptr[i], 1e-6);
+        }
+
+    delete before;
+    delete x12; delete x33; delete y;
+    delete dense; delete rows;
+}
+
+TEST(NetTestSuite, net_optimizer_sparse_rows_rmsprop){
+    layer in1 = Input({2}), in2 = Input({2});
+    layer e_dense = Embedding(in1, 6, 2, 3), e_rows = Embedding(in2, 6, 2, 3);
+    model dense = Model({in1}, {e_dense});
+    model rows = Model({in2}, {e_rows});
+    optimizer opt = rmsprop(0.01f);
+    opt->set_sparse_rows(true);
+    build(dense, rmsprop(0.01f), {"mse"}, {"mse"}, CS_CPU());
+    build(rows, opt, {"mse"}, {"mse"}, CS_CPU());
+    Tensor::copy(e_dense->params[0], e_rows->params[0]);
+
+    // Words that come and go: the rows that skip a step must forget their last gradient
+    vector<Tensor*> xs = {new Tensor({1.0f, 2.0f}, {1, 2}), new Tensor({3.0f, 3.0f}, {1, 2}),
+                          new Tensor({1.0f, 4.0f}, {1, 2}), new Tensor({2.0f, 3.0f}, {1, 2})};
+    Tensor* y = Tensor::zeros({1, 6});
+    for (int k = 0; k < 8; k++) {
+        train_batch(dense, {xs[k % 4]}, {y});
+        train_batch(rows, {xs[k % 4]}, {y});
+        for (int i = 0; i < 18; i++)
+            ASSERT_NEAR(e_rows->params[0]->ptr[i], e_dense->params[0]->ptr[i], 1e-5);
+    }
+
+    for (auto x : xs) delete x;
+    delete y;
+    delete dense; delete rows;
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "eddl/apis/eddl.h"
+
+#include "eddl/tensor/tensor.h"
+
+
+using namespace eddl;
+
+TEST(NetTestSuite, net_predict_evaluate_batches){
+    layer in = Input({10});
+    layer l = ReLu(BatchNormalization(Dense(in, 16)));
+    layer out = Softmax(Dense(l, 4));
+    model net = Model({in}, {out});
+    build(net, sgd(0.01f), {"mse"}, {"categorical_accuracy"}, CS_CPU());  // mse: per-sample sums
+
+    int n = 70;
+    Tensor* x = Tensor::randn({n, 10});
+    Tensor* y = Tensor::zeros({n, 4});
+    for (int i = 0; i < n; i++) y->ptr[i * 4 + i % 4] = 1.0f;
+
+    // Whole input at once
+    set_mode(net, TSMODE);
+    forward(net, {x});
+    Tensor* ref = net->lout[0]->output->clone();
+
+    // In batches of 32 (the last one with 6 samples), without resizing the net to n
+    Tensor* pred = Tensor::empty({n, 4});
+    predict(net, {x}, {pred}, 32);
+    ASSERT_EQ(net->batch_size, 32);
+    ASSERT_TRUE(Tensor::equivalent(ref, pred, 1e-5f));
+
+    vector<Tensor*> outs = predict(net, {x});
+    ASSERT_TRUE(Tensor::equivalent(ref, outs[0], 1e-5f));
+
+    // The last batch is counted, and only with its own samples
+    evaluate(net, {x}, {y}, n);
+    float loss = get_losses(net)[0];
+    float metric = get_metrics(net)[0];
+    evaluate(net, {x}, {y}, 32);
+    ASSERT_EQ(net->inferenced_samples, n);
+    ASSERT_NEAR(get_losses(net)[0], loss, 1e-4f);
+    ASSERT_NEAR(get_metrics(net)[0], metric, 1e-5f);
+
+    delete x; delete y; delete ref; delete pred; delete outs[0];
+    delete net;
+}
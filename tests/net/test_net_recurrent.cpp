@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <cmath>
+
+#include "eddl/apis/eddl.h"
+
+#include "eddl/tensor/tensor.h"
+
+
+using namespace eddl;
+
+TEST(NetTestSuite, net_recurrent_timestep_views){
+    layer in = Input({4});
+    layer l = LSTM(in, 8);
+    layer out = Softmax(Dense(l, 3));
+    model net = Model({in}, {out});
+    build(net, sgd(0.01f), {"mse"}, {"categorical_accuracy"}, CS_CPU());
+
+    Tensor* x = Tensor::randn({10, 5, 4});  // batch x time x dim
+    Tensor* y = Tensor::zeros({10, 3});
+    for (int i = 0; i < 10; i++) y->ptr[i * 3 + i % 3] = 1.0f;
+
+    // One view per timestep, no time-major copies
+    vtensor xt, xtd, yt, tinr, toutr;
+    int inl, outl;
+    net->prepare_recurrent({x}, {y}, inl, outl, xt, xtd, yt, tinr, toutr);
+    ASSERT_EQ(inl, 5);
+    ASSERT_EQ(tinr.size(), 5);
+    ASSERT_TRUE(xt.empty());
+    for (int t = 0; t < 5; t++) {
+        ASSERT_TRUE(tinr[t]->isshared);
+        ASSERT_EQ(tinr[t]->ptr, x->ptr + t * 4);
+        ASSERT_EQ(tinr[t]->shape, vector<int>({10, 4}));
+    }
+
+    // Batches are gathered from the strided views
+    Tensor* b = Tensor::empty({3, 4});
+    Tensor::select(tinr[2], b, {7, 1, 3}, 0, 3);
+    int samples[3] = {7, 1, 3};
+    for (int i = 0; i < 3; i++)
+        for (int k = 0; k < 4; k++) ASSERT_EQ(b->ptr[i * 4 + k], x->ptr[samples[i] * 20 + 2 * 4 + k]);
+    for (auto t : tinr) delete t;
+
+    fit(net, {x}, {y}, 5, 1);
+    evaluate(net, {x}, {y}, 5);
+    ASSERT_TRUE(std::isfinite(get_losses(net)[0]));
+
+    delete x; delete y; delete b;
+    delete net;
+}
+
+TEST(NetTestSuite, net_decode_steps){
+    int voc = 6;
+    layer in = Input({1});
+    layer enc = LSTM(Embedding(in, voc, 1, 4), 8);
+
+    layer ld = Input({voc});
+    ld = Embedding(ReduceArgMax(ld, {0}), voc, 1, 4);
+    layer l = Decoder(LSTM(ld, 8), enc);
+    l = LSTM(l, 8);  // its first step has no previous timestep
+    layer out = Softmax(Dense(l, voc));
+    model net = Model({in}, {out});
+    build(net, sgd(0.01f), {"mse"}, {"categorical_accuracy"}, CS_CPU());
+
+    int n = 3, inl = 4, length = 5;
+    Tensor* x = Tensor::zeros({n, inl, 1});
+    for (int i = 0; i < x->size; i++) x->ptr[i] = 1 + (i * 7) % (voc - 1);
+
+    // Step by step, feeding the most likely token
+    vector<Tensor*> steps;
+    Tensor* tokens = Tensor::zeros({n});
+    Tensor* y = Tensor::zeros({n, length, voc});
+    vtensor o = net->decode_start({x});
+    for (int t = 0; t < length; t++) {
+        if (t > 0) o = net->decode_step(tokens);
+        ASSERT_EQ(o[0]->shape, vector<int>({n, voc}));
+        steps.push_back(o[0]->clone());
+        for (int b = 0; b < n; b++) {
+            const float *p = o[0]->ptr + b * voc;
+            int w = std::max_element(p, p + voc) - p;
+            tokens->ptr[b] = w;
+            y->ptr[(b * length + t) * voc + w] = 1.0f;
+        }
+    }
+
+    Tensor* greedy = decode_greedy(net, {x}, length);
+    Tensor* beam1 = decode_beam(net, {x}, length, 1);
+    Tensor* beam3 = decode_beam(net, {x}, length, 3);
+    ASSERT_EQ(greedy->shape, vector<int>({n, length}));
+    ASSERT_EQ(beam3->shape, vector<int>({n, length}));
+    for (int b = 0; b < n; b++)
+        for (int t = 0; t < length; t++) {
+            ASSERT_EQ(y->ptr[(b * length + t) * voc + (int)greedy->ptr[b * length + t]], 1.0f);
+            ASSERT_EQ(beam1->ptr[b * length + t], greedy->ptr[b * length + t]);
+            ASSERT_TRUE((beam3->ptr[b * length + t] >= 0) && (beam3->ptr[b * length + t] < voc));
+        }
+
+    // Same outputs as the unrolled net fed with the decoded tokens
+    evaluate(net, {x}, {y}, n);
+    ASSERT_EQ(net->rnet->lout.size(), length);
+    for (int t = 0; t < length; t++) {
+        ASSERT_TRUE(Tensor::equivalent(steps[t], net->rnet->lout[t]->output, 1e-5f, 1e-4f));
+        delete steps[t];
+    }
+
+    delete x; delete y; delete tokens;
+    delete greedy; delete beam1; delete beam3;
+    delete net;
+}
+
+TEST(NetTestSuite, net_decode_beam_exhaustive){
+    // With voc^(length-1) hypotheses nothing is pruned: the beam search finds the best sequence
+    int voc = 3, length = 3, beam = 9, nseq = 27;
+    layer in = Input({1});
+    layer enc = LSTM(Embedding(in, voc, 1, 4), 8);
+
+    layer ld = Input({voc});
+    ld = Embedding(ReduceArgMax(ld, {0}), voc, 1, 4);
+    layer l = Decoder(LSTM(ld, 8), enc);
+    layer out = Softmax(Dense(l, voc));
+    model net = Model({in}, {out});
+    build(net, sgd(0.01f), {"mse"}, {"categorical_accuracy"}, CS_CPU());
+
+    int n = 2, inl = 3;
+    Tensor* x = Tensor::zeros({n, inl, 1});
+    for (int i = 0; i < x->size; i++) x->ptr[i] = 1 + (i * 5) % (voc - 1);
+
+    // Brute force: every sequence of every sample in its own row
+    vector<int> rep(n * nseq);
+    for (int r = 0; r < n * nseq; r++) rep[r] = r / nseq;
+    Tensor* xr = Tensor::empty({n * nseq, inl, 1});
+    Tensor::select(x, xr, rep, 0, n * nseq);
+
+    vector<float> score(n * nseq, 0.0f);
+    Tensor* tokens = Tensor::zeros({n * nseq});
+    vtensor o = net->decode_start({xr});
+    for (int t = 0; t < length; t++) {
+        if (t > 0) o = net->decode_step(tokens);
+        for (int r = 0; r < n * nseq; r++) {
+            int w = ((r % nseq) / (int)std::pow(voc, length - 1 - t)) % voc;
+            score[r] += std::log(o[0]->ptr[r * voc + w]);
+            tokens->ptr[r] = w;
+        }
+    }
+
+    Tensor* best = decode_beam(net, {x}, length, beam);
+    for (int s = 0; s < n; s++) {
+        int q = std::max_element(score.begin() + s * nseq, score.begin() + (s + 1) * nseq) - (score.begin() + s * nseq);
+        for (int t = 0; t < length; t++)
+            ASSERT_EQ((int)best->ptr[s * length + t], (q / (int)std::pow(voc, length - 1 - t)) % voc);
+    }
+
+    delete x; delete xr; delete tokens; delete best;
+    delete net;
+}
@@ -129,3 +129,31 @@ TEST(ONNXTestSuite, onnx_import){
 
 }
 
+
+TEST(ONNXTestSuite, onnx_gru){
+    string fname = "onnx_gru_" + to_string(dist6(mt)) + ".onnx";
+
+    layer in = Input({5});
+    layer l = GRU(in, 6);
+    layer out = Dense(l, 3);
+    Net* net_export = Model({in}, {out});
+    build(net_export, sgd(0.01), {"mse"}, {"mse"}, CS_CPU(), true);
+    l->params[2]->fill_rand_uniform_(1.0f);
+    l->params[3]->fill_rand_uniform_(1.0f);
+    save_net_to_onnx_file(net_export, fname);
+
+    Net* net_import = import_net_from_onnx_file(fname);
+    build(net_import, sgd(0.01), {"mse"}, {"mse"}, CS_CPU(), false);
+    std::remove(fname.c_str());
+
+    // W, R and B are transposed and packed as in ONNX, and back
+    ASSERT_EQ(net_export->layers.size(), net_import->layers.size());
+    auto* gru = dynamic_cast<LGRU*>(net_import->layers[1]);
+    ASSERT_TRUE(gru != nullptr);
+    ASSERT_EQ(gru->units, 6);
+    for (int j = 0; j < l->params.size(); j++)
+        ASSERT_TRUE(Tensor::equivalent(l->params[j], gru->params[j]));
+
+    delete net_export;
+    delete net_import;
+}
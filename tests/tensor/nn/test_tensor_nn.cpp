@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <random>
 #include <string>
+#include <cmath>
+#include <algorithm>
 
 #include "eddl/tensor/tensor.h"
 #include "eddl/tensor/nn/tensor_nn.h"
@@ -82,3 +84,267 @@ TEST(TensorTestSuite, tensor_nn_full_softmax){
 
 #endif
 }
+
+
+TEST(TensorTestSuite, tensor_nn_dropout){
+    Tensor* t_in = Tensor::ones({100, 1000}, DEV_CPU);
+    Tensor* t_out = Tensor::empty_like(t_in);
+    Tensor* t_out2 = Tensor::empty_like(t_in);
+    float keep = 0.7f;
+    uint64_t seed = 1234;
+
+    // Forward: same seed => same mask, roughly "keep" of the units survive
+    tensorNN::Dropout(t_in, t_out, keep, 2.0f, seed);
+    tensorNN::Dropout(t_in, t_out2, keep, 2.0f, seed);
+    ASSERT_TRUE(Tensor::equivalent(t_out, t_out2, 10e-6));
+    float kept = t_out->sum() / (2.0f * (float)t_in->size);
+    ASSERT_NEAR(kept, keep, 0.01);
+
+    // Backward: the regenerated mask matches the forward one
+    Tensor* t_parent_delta = Tensor::zeros_like(t_in);
+    tensorNN::D_Dropout(t_in, t_parent_delta, keep, 2.0f, seed);
+    ASSERT_TRUE(Tensor::equivalent(t_out, t_parent_delta, 10e-6));
+
+    // A different seed gives a different mask
+    tensorNN::Dropout(t_in, t_out2, keep, 2.0f, seed + 1);
+    ASSERT_FALSE(Tensor::equivalent(t_out, t_out2, 10e-6));
+
+    delete t_in;
+    delete t_out;
+    delete t_out2;
+    delete t_parent_delta;
+}
+
+
+// Max abs error relative to the largest reference value
+static float quant_rel_error(Tensor *ref, Tensor *out){
+    float err = 0.0f, m = 0.0f;
+    for (int i = 0; i < ref->size; i++) {
+        err = std::max(err, std::fabs(ref->ptr[i] - out->ptr[i]));
+        m = std::max(m, std::fabs(ref->ptr[i]));
+    }
+    return err / m;
+}
+
+TEST(TensorTestSuite, tensor_nn_quantized_dense){
+    Tensor* t_in = Tensor::randn({8, 67}, DEV_CPU);  // odd size => vector and scalar tails
+    Tensor* t_w = Tensor::randn({67, 10}, DEV_CPU);
+    Tensor* t_bias = Tensor::randn({10}, DEV_CPU);
+
+    // fp32 reference
+    Tensor* t_ref = Tensor::empty({8, 10}, DEV_CPU);
+    Tensor::mult2D(t_in, 0, t_w, 0, t_ref, 0);
+    Tensor::sum2D_rowwise(t_ref, t_bias, t_ref);
+
+    for (bool per_channel : {true, false}) {
+        QuantDescriptor qd(per_channel, DEV_CPU);
+        qd.observe(t_in->ptr, t_in->size);
+        qd.calibrate();
+        qd.pack(t_w->ptr, 67, 10, true);
+
+        Tensor* t_out = Tensor::empty({8, 10}, DEV_CPU);
+        tensorNN::QDense(t_in, t_out, t_bias, &qd);
+        ASSERT_LT(quant_rel_error(t_ref, t_out), 0.03f);
+        delete t_out;
+    }
+
+    delete t_in;
+    delete t_w;
+    delete t_bias;
+    delete t_ref;
+}
+
+TEST(TensorTestSuite, tensor_nn_quantized_conv2d){
+    Tensor* t_in = Tensor::randn({2, 3, 9, 9}, DEV_CPU);
+
+    auto *cd = new ConvolDescriptor(5, {3, 3}, {1, 1}, "same", true);
+    cd->build(t_in);
+    cd->K->fill_rand_normal_(0.0f, 1.0f);
+    cd->bias->fill_rand_normal_(0.0f, 1.0f);
+
+    // fp32 reference
+    tensorNN::Conv2D(cd);
+    Tensor* t_ref = cd->O->clone();
+
+    QuantDescriptor qd(true, DEV_CPU);
+    qd.observe(t_in->ptr, t_in->size);
+    qd.calibrate();
+    qd.pack(cd->K->ptr, 3 * 3 * 3, 5, false);
+    cd->O->fill_(0.0f);
+
+    tensorNN::QConv2D(cd, &qd);
+    ASSERT_LT(quant_rel_error(t_ref, cd->O), 0.03f);
+
+    delete t_in;
+    delete t_ref;
+}
+
+
+TEST(TensorTestSuite, tensor_nn_sparse_embedding){
+    int vocsize = 6, dim = 3;
+    Tensor* E = Tensor::randn({vocsize, dim}, DEV_CPU);
+    Tensor* I = new Tensor({2.0f, 4.0f, 2.0f, 0.0f, 2.0f, 9.0f}, {2, 3}, DEV_CPU);  // 9 is out of vocabulary
+    Tensor* O = new Tensor({2, 3 * dim}, DEV_CPU);
+
+    // Forward: gather with masked zeros
+    vector<int> ind;
+    int oov = tensorNN::Embedding(E, I, O, ind, true);
+    ASSERT_EQ(oov, 1);
+    for (int i = 0; i < 6; i++)
+        for (int j = 0; j < dim; j++)
+            ASSERT_FLOAT_EQ(O->ptr[i * dim + j], (ind[i] == 0) ? 0.0f : E->ptr[ind[i] * dim + j]);
+
+    // Backward: repeated words are accumulated, only their rows are listed
+    Tensor* D = Tensor::ones({2, 3 * dim}, DEV_CPU);
+    Tensor* gE = Tensor::zeros({vocsize, dim}, DEV_CPU);
+    vector<int> rows;
+    tensorNN::Embedding_back(D, gE, ind, true, rows);
+    ASSERT_EQ(rows, vector<int>({2, 4}));
+    for (int j = 0; j < dim; j++) {
+        ASSERT_FLOAT_EQ(gE->ptr[2 * dim + j], 3.0f);
+        ASSERT_FLOAT_EQ(gE->ptr[4 * dim + j], 1.0f);
+        ASSERT_FLOAT_EQ(gE->ptr[0 * dim + j], 0.0f);
+    }
+
+    // Lazy Adam: present rows match the dense update, absent rows are untouched
+    Tensor* P = E->clone();
+    Tensor* M = Tensor::zeros({vocsize, dim}, DEV_CPU);
+    Tensor* V = Tensor::zeros({vocsize, dim}, DEV_CPU);
+    float lr = 0.1f, b1 = 0.9f, b2 = 0.999f, eps = 1e-8f;
+    tensorNN::Adam_rows(P, gE, M, V, rows, lr, b1, b2, eps, 1);
+    for (int r = 0; r < vocsize; r++)
+        for (int j = 0; j < dim; j++) {
+            float g = gE->ptr[r * dim + j];
+            float ref = E->ptr[r * dim + j];
+            if (r == 2 || r == 4) ref -= lr * g / std::sqrt(g * g + eps);
+            ASSERT_NEAR(P->ptr[r * dim + j], ref, 1e-5);
+        }
+
+    tensorNN::ZeroRows(gE, rows);
+    ASSERT_FLOAT_EQ(gE->sum(), 0.0f);
+
+    delete E; delete I; delete O; delete D; delete gE; delete P; delete M; delete V;
+}
+
+TEST(TensorTestSuite, tensor_nn_upsampling){
+    // Nearest 2D: same as repeating rows and columns
+    Tensor* A = Tensor::randn({2, 3, 4, 5}, DEV_CPU);
+    UpSamplingDescriptor* ud = new UpSamplingDescriptor({2, 3}, false, false, DEV_CPU);
+    ud->build(A->shape);
+    Tensor* B = new Tensor(ud->oshape, DEV_CPU);
+    Tensor* B_ref = new Tensor(ud->oshape, DEV_CPU);
+    tensorNN::upsampling(A, B, ud);
+    tensorNN::repeat_nn(A, B_ref, {2, 3});
+    ASSERT_TRUE(Tensor::equivalent(B, B_ref, 1e-6f));
+
+    Tensor* gA = Tensor::zeros(A->shape, DEV_CPU);
+    Tensor* D = Tensor::ones(B->shape, DEV_CPU);
+    tensorNN::d_upsampling(D, gA, ud);
+    ASSERT_FLOAT_EQ(gA->min(), 6.0f);
+    ASSERT_FLOAT_EQ(gA->max(), 6.0f);
+    delete A; delete B; delete B_ref; delete gA; delete D; delete ud;
+
+    // Linear 1D: half-pixel centers and aligned corners
+    Tensor* x = new Tensor({0.0f, 1.0f, 2.0f}, {1, 1, 3}, DEV_CPU);
+    Tensor* y = new Tensor({1, 1, 6}, DEV_CPU);
+    ud = new UpSamplingDescriptor({2}, true, false, DEV_CPU);
+    ud->build(x->shape);
+    tensorNN::upsampling(x, y, ud);
+    Tensor* y_ref = new Tensor({0.0f, 0.25f, 0.75f, 1.25f, 1.75f, 2.0f}, {1, 1, 6}, DEV_CPU);
+    ASSERT_TRUE(Tensor::equivalent(y, y_ref, 1e-6f));
+    delete ud; delete y_ref;
+
+    ud = new UpSamplingDescriptor({2}, true, true, DEV_CPU);
+    ud->build(x->shape);
+    tensorNN::upsampling(x, y, ud);
+    y_ref = new Tensor({0.0f, 0.4f, 0.8f, 1.2f, 1.6f, 2.0f}, {1, 1, 6}, DEV_CPU);
+    ASSERT_TRUE(Tensor::equivalent(y, y_ref, 1e-6f));
+    delete ud; delete x; delete y; delete y_ref;
+
+    // Trilinear 3D: the backward is the transpose of the forward, <up(A), D> == <A, d_up(D)>
+    for (bool align : {false, true}) {
+        A = Tensor::randn({2, 3, 3, 4, 5}, DEV_CPU);
+        ud = new UpSamplingDescriptor({2, 3, 2}, true, align, DEV_CPU);
+        ud->build(A->shape);
+        B = new Tensor(ud->oshape, DEV_CPU);
+        D = Tensor::randn(ud->oshape, DEV_CPU);
+        gA = Tensor::zeros(A->shape, DEV_CPU);
+        tensorNN::upsampling(A, B, ud);
+        tensorNN::d_upsampling(D, gA, ud);
+
+        double lhs = 0.0, rhs = 0.0;
+        for (int i = 0; i < B->size; i++) lhs += (double)B->ptr[i] * D->ptr[i];
+        for (int i = 0; i < A->size; i++) rhs += (double)A->ptr[i] * gA->ptr[i];
+        ASSERT_NEAR(lhs, rhs, 1e-3 * std::max(1.0, std::fabs(lhs)));
+        delete A; delete B; delete D; delete gA; delete ud;
+    }
+}
+
+TEST(TensorTestSuite, tensor_nn_attention){
+    // More queries and keys than a tile, and a causal offset (tk > tq)
+    int b = 2, heads = 2, dk = 8, dv = 4, tq = 70, tk = 90;
+    Tensor* Q = Tensor::randn({b, tq, heads * dk}, DEV_CPU);
+    Tensor* K = Tensor::randn({b, tk, heads * dk}, DEV_CPU);
+    Tensor* V = Tensor::randn({b, tk, heads * dv}, DEV_CPU);
+    Tensor* dO = Tensor::randn({b, tq, heads * dv}, DEV_CPU);
+    Tensor* O = new Tensor({b, tq, heads * dv}, DEV_CPU);
+    Tensor* L = new Tensor({b, heads, tq}, DEV_CPU);
+
+    for (bool causal : {false, true}) {
+        Tensor* dQ = Tensor::zeros(Q->shape, DEV_CPU);
+        Tensor* dK = Tensor::zeros(K->shape, DEV_CPU);
+        Tensor* dV = Tensor::zeros(V->shape, DEV_CPU);
+        tensorNN::MultiHeadAttention(Q, K, V, O, L, heads, causal);
+        tensorNN::D_MultiHeadAttention(Q, K, V, O, L, dO, dQ, dK, dV, heads, causal);
+
+        // Reference with the whole score matrix of each head
+        Tensor* O_ref = Tensor::zeros(O->shape, DEV_CPU);
+        Tensor* dQ_ref = Tensor::zeros(Q->shape, DEV_CPU);
+        Tensor* dK_ref = Tensor::zeros(K->shape, DEV_CPU);
+        Tensor* dV_ref = Tensor::zeros(V->shape, DEV_CPU);
+        double scale = 1.0 / std::sqrt((double)dk);
+        auto q = [&](Tensor* t, int s, int i, int h, int c) -> float& { return t->ptr[((s * tq) + i) * heads * dk + h * dk + c]; };
+        auto k = [&](Tensor* t, int s, int j, int h, int c) -> float& { return t->ptr[((s * tk) + j) * heads * dk + h * dk + c]; };
+        auto v = [&](Tensor* t, int s, int j, int h, int c) -> float& { return t->ptr[((s * tk) + j) * heads * dv + h * dv + c]; };
+        auto o = [&](Tensor* t, int s, int i, int h, int c) -> float& { return t->ptr[((s * tq) + i) * heads * dv + h * dv + c]; };
+        for (int s = 0; s < b; s++)
+            for (int h = 0; h < heads; h++)
+                for (int i = 0; i < tq; i++) {
+                    int nk = causal ? i + tk - tq + 1 : tk;
+                    vector<double> p(nk), dp(nk);
+                    double mx = -1e30, sum = 0.0, dsum = 0.0;
+                    for (int j = 0; j < nk; j++) {
+                        p[j] = 0.0;
+                        for (int c = 0; c < dk; c++) p[j] += (double)q(Q, s, i, h, c) * k(K, s, j, h, c);
+                        p[j] *= scale;
+                        mx = std::max(mx, p[j]);
+                    }
+                    for (int j = 0; j < nk; j++) { p[j] = std::exp(p[j] - mx); sum += p[j]; }
+                    for (int j = 0; j < nk; j++) {
+                        p[j] /= sum;
+                        dp[j] = 0.0;
+                        for (int c = 0; c < dv; c++) {
+                            o(O_ref, s, i, h, c) += p[j] * v(V, s, j, h, c);
+                            v(dV_ref, s, j, h, c) += p[j] * o(dO, s, i, h, c);
+                            dp[j] += (double)o(dO, s, i, h, c) * v(V, s, j, h, c);
+                        }
+                        dsum += p[j] * dp[j];
+                    }
+                    for (int j = 0; j < nk; j++) {
+                        double ds = scale * p[j] * (dp[j] - dsum);
+                        for (int c = 0; c < dk; c++) {
+                            q(dQ_ref, s, i, h, c) += ds * k(K, s, j, h, c);
+                            k(dK_ref, s, j, h, c) += ds * q(Q, s, i, h, c);
+                        }
+                    }
+                }
+
+        ASSERT_TRUE(Tensor::equivalent(O, O_ref, 1e-4f, 1e-3f));
+        ASSERT_TRUE(Tensor::equivalent(dQ, dQ_ref, 1e-4f, 1e-3f));
+        ASSERT_TRUE(Tensor::equivalent(dK, dK_ref, 1e-4f, 1e-3f));
+        ASSERT_TRUE(Tensor::equivalent(dV, dV_ref, 1e-4f, 1e-3f));
+        delete dQ; delete dK; delete dV;
+        delete O_ref; delete dQ_ref; delete dK_ref; delete dV_ref;
+    }
+    delete Q; delete K; delete V; delete dO; delete O; delete L;
+}
@@ -6,6 +6,7 @@
 #include "eddl/tensor/tensor_reduction.h"
 #include "eddl/tensor/nn/tensor_nn.h"
 #include "eddl/descriptors/descriptors.h"
+#include "eddl/utils.h"
 
 
 using namespace std;
@@ -132,3 +133,136 @@ TEST(TensorTestSuite, tensor_unsqueeze) {
     Tensor* t1_dim0 = t1->unsqueeze(2);
     ASSERT_TRUE(t1_dim0->shape == vector<int>({2, 3, 1, 4}));
 }
+
+
+TEST(TensorTestSuite, tensor_strided_select_permute) {
+    // Strided kernels against the address tables (output => input) that they replace
+    vector<pair<vector<int>, vector<int>>> permutes = {{{5, 7, 9}, {1, 2, 0}}, {{5, 7, 9}, {2, 0, 1}}, {{33, 17}, {1, 0}},
+                                                       {{3, 4, 5, 6}, {1, 0, 2, 3}}, {{3, 1, 5, 2}, {3, 2, 1, 0}}, {{8}, {0}}};
+    for (auto &p : permutes) {
+        Tensor *A = Tensor::randn(p.first);
+        Tensor *B = Tensor::permute(A, p.second);
+        int *addr = permute_indices(p.first, p.second);
+        for (int i = 0; i < B->size; i++) ASSERT_EQ(B->ptr[i], A->ptr[addr[i]]);
+
+        // Per sample (batch of 2), and back
+        auto *sd = new PermuteDescriptor(p.second, DEV_CPU);
+        sd->build(p.first);
+        vector<int> bshape(p.first), oshape(sd->oshape);
+        bshape.insert(bshape.begin(), 2);
+        oshape.insert(oshape.begin(), 2);
+        Tensor *Ab = Tensor::randn(bshape);
+        Tensor *Bb = Tensor::empty(oshape);
+        tensorNN::select(Ab, Bb, sd);
+        for (int b = 0; b < 2; b++)
+            for (int i = 0; i < A->size; i++) ASSERT_EQ(Bb->ptr[b * A->size + i], Ab->ptr[b * A->size + addr[i]]);
+
+        Tensor *Db = Tensor::ones(bshape);
+        tensorNN::select_back(Bb, Db, sd);
+        for (int b = 0; b < 2; b++)
+            for (int i = 0; i < A->size; i++) ASSERT_FLOAT_EQ(Db->ptr[b * A->size + addr[i]], 1.0f + Bb->ptr[b * A->size + i]);
+
+        delete[] addr;
+        delete A; delete B; delete Ab; delete Bb; delete Db; delete sd;
+    }
+
+    vector<pair<vector<int>, vector<string>>> selects = {{{6, 7, 8}, {"1:4", ":", "2:7"}}, {{6, 7, 8}, {"2", "3:5", ":"}},
+                                                         {{10, 12}, {":", "5"}}, {{4, 5, 6, 7}, {":", ":", "1:3", ":"}}};
+    for (auto &s : selects) {
+        Tensor *A = Tensor::randn(s.first);
+        auto *sd = new SelDescriptor(s.second, DEV_CPU);
+        sd->build(s.first);
+        int *addr = ranges2indices(s.first, sd->idxs_range);
+
+        Tensor *B = Tensor::empty(sd->oshape);
+        Tensor::select(A, B, sd);
+        for (int i = 0; i < B->size; i++) ASSERT_EQ(B->ptr[i], A->ptr[addr[i]]);
+
+        Tensor *C = A->clone();
+        Tensor::select_back(B, C, sd);
+        for (int i = 0; i < B->size; i++) ASSERT_FLOAT_EQ(C->ptr[addr[i]], 2.0f * A->ptr[addr[i]]);
+
+        Tensor *D = Tensor::zeros(s.first);
+        Tensor::set_select(D, B, sd);
+        Tensor *E = Tensor::ones(sd->oshape);
+        Tensor::set_select_back(D, E, sd);
+        for (int i = 0; i < B->size; i++) {
+            ASSERT_EQ(D->ptr[addr[i]], B->ptr[i]);
+            ASSERT_FLOAT_EQ(E->ptr[i], 1.0f + B->ptr[i]);
+        }
+
+        delete[] addr;
+        delete A; delete B; delete C; delete D; delete E; delete sd;
+    }
+}
+
+TEST(TensorTestSuite, tensor_strided_views) {
+    Tensor *A = Tensor::randn({6, 7, 8});
+
+    // A range of samples: contiguous, no copy
+    Tensor *V = A->select_view({"2:4"});
+    ASSERT_TRUE(V->is_contiguous());
+    ASSERT_EQ(V->ptr, A->ptr + 2 * 7 * 8);
+    ASSERT_TRUE(V->isshared);
+
+    // Views of views, against the copying versions
+    vector<pair<vector<string>, bool>> selects = {{{"1:4", ":", "2:7"}, false}, {{"2", "3:5", ":"}, true}, {{":", "5", ":"}, false}};
+    for (auto &sel : selects) {
+        auto &s = sel.first;
+        Tensor *S = A->select(s);
+        Tensor *W = A->select_view(s);
+        ASSERT_EQ(W->is_contiguous(), sel.second);
+        Tensor *C = W->clone();
+        ASSERT_TRUE(Tensor::equivalent(S, C, 0.0f, 0.0f));
+
+        Tensor *WT = W->permute_view({2, 0, 1});
+        Tensor *ST = Tensor::permute(S, {2, 0, 1});
+        Tensor *CT = WT->contiguous();
+        ASSERT_TRUE(Tensor::equivalent(ST, CT, 0.0f, 0.0f));
+
+        // Kernels that need contiguous data run over compact copies of the views
+        Tensor *U = Tensor::empty(CT->shape);
+        Tensor::add(2.0f, WT, -1.0f, CT, U, 0);
+        ASSERT_TRUE(Tensor::equivalent(U, CT, 1e-6f, 1e-6f));
+        ASSERT_FLOAT_EQ(Tensor::max(WT), Tensor::max(ST));
+        Tensor *T = WT->select({"1:3"});
+        Tensor *TS = ST->select({"1:3"});
+        ASSERT_TRUE(Tensor::equivalent(TS, T, 0.0f, 0.0f));
+
+        // ... and write the outputs back through them
+        Tensor::sqr(WT, WT);
+        Tensor::sqr(ST, ST);
+        ASSERT_TRUE(Tensor::equivalent(ST, WT, 0.0f, 0.0f));
+
+        delete S; delete W; delete C; delete WT; delete ST; delete CT; delete U; delete T; delete TS;
+    }
+
+    // Writes through a transposed view: copy and inc
+    Tensor *B = Tensor::zeros({5, 3});
+    Tensor *BT = B->permute_view({1, 0});
+    ASSERT_TRUE(BT->ptr2 == nullptr);  // No Eigen map over strided data
+    Tensor *D = Tensor::randn({3, 5});
+    Tensor::copy(D, BT);
+    Tensor::inc(D, BT);
+    Tensor *DT = Tensor::permute(D, {1, 0});
+    DT->mult_(2.0f);
+    ASSERT_TRUE(Tensor::equivalent(DT, B, 1e-6f, 1e-6f));
+
+    // Between views
+    Tensor *E = Tensor::zeros({3, 5});
+    Tensor *EV = E->select_view({":", "1:3"});
+    Tensor *BV = BT->select_view({":", "1:3"});
+    ASSERT_TRUE(Tensor::sameShape(EV, BV));
+    Tensor::copy(BV, EV);
+    for (int i = 0; i < 3; i++)
+        for (int j = 1; j < 3; j++) ASSERT_EQ(E->ptr[i * 5 + j], B->ptr[j * 3 + i]);
+
+    // Reshape: view if contiguous, copy otherwise
+    Tensor *R = V->reshape_view({14, -1});
+    ASSERT_EQ(R->ptr, V->ptr);
+    Tensor *RT = BT->reshape_view({15});
+    ASSERT_NE(RT->ptr, B->ptr);
+    for (int i = 0; i < 15; i++) ASSERT_EQ(RT->ptr[i], B->ptr[(i % 5) * 3 + i / 5]);
+
+    delete A; delete V; delete B; delete BT; delete D; delete DT; delete E; delete EV; delete BV; delete R; delete RT;
+}
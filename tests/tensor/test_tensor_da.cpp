@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "eddl/tensor/tensor.h"
+
+
+using namespace std;
+
+
+TEST(TensorTestSuite, tensor_da_augment_random){
+    Tensor* t_in = Tensor::randn({4, 3, 16, 20}, DEV_CPU);
+    Tensor* t_out = Tensor::empty_like(t_in);
+
+    // Test #1: No transformation => identity (both interpolations)
+    auto *ad_id = new AugmentDescriptor({}, {}, {}, {}, 0.0f, 0.0f, {}, {}, 0.0f, true, WrappingMode::Constant, 0.0f, DEV_CPU);
+    Tensor::augment_random(t_in, t_out, ad_id);
+    ASSERT_TRUE(Tensor::equivalent(t_in, t_out, 10e-4));
+
+    ad_id->bilinear = false;
+    Tensor::augment_random(t_in, t_out, ad_id);
+    ASSERT_TRUE(Tensor::equivalent(t_in, t_out, 10e-4));
+
+    // Test #2: Horizontal flip with probability 1 mirrors the columns
+    auto *ad_flip = new AugmentDescriptor({}, {}, {}, {}, 1.0f, 0.0f, {}, {}, 0.0f, false, WrappingMode::Constant, 0.0f, DEV_CPU);
+    Tensor::augment_random(t_in, t_out, ad_flip);
+    int w = t_in->shape[3];
+    for (int i = 0; i < t_in->size; i += 7) {
+        int j = i % w;
+        ASSERT_NEAR(t_out->ptr[i], t_in->ptr[i - j + (w - 1 - j)], 10e-4);
+    }
+
+    // Test #3: Brightness with a fixed factor scales every value
+    auto *ad_bright = new AugmentDescriptor({}, {}, {}, {}, 0.0f, 0.0f, {2.0f, 2.0f}, {}, 0.0f, false, WrappingMode::Constant, 0.0f, DEV_CPU);
+    Tensor::augment_random(t_in, t_out, ad_bright);
+    Tensor* t_ref = t_in->clone(); t_ref->mult_(2.0f);
+    ASSERT_TRUE(Tensor::equivalent(t_ref, t_out, 10e-4));
+
+    delete ad_id;
+    delete ad_flip;
+    delete ad_bright;
+    delete t_in;
+    delete t_out;
+    delete t_ref;
+}